@@ -6,11 +6,32 @@
  * @brief Program to process tables from input file
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
 
 // #define DEBUG
 
@@ -21,16 +42,80 @@
 #define BASE_NUMBER_OF_CELLS 3 /**< Base number of cells that will be allocated */
 #define BASE_CELL_LENGTH 6 /**< Base length of content in cell that will be allocated */
 
+#define ROWS_PER_PAGE 1024 /**< Number of rows in one page that is spilled to disk when memory budget is exceeded */
+#define SPILL_SLOT_ALIGNMENT 4096 /**< Slots of pages in spill file are multiples of this size */
+
+#define ARENA_CHUNK_SIZE (1 << 20) /**< Size of one chunk of memory arena */
+#define ARENA_ALIGNMENT 16 /**< Alignment of allocations from memory arena */
+#define MAX_NUMBER_OF_THREADS 64 /**< Maximum number of worker threads */
+#define MAX_NUMBER_OF_SHARDS 64 /**< Maximum number of processes of sharded execution */
+#define LOAD_BATCH_SIZE 16384 /**< Number of lines that are read before they are parsed in parallel */
+#define MAX_INTEGER_DIGITS 18 /**< Maximum number of digits of integer cell, so it always fits to long long int */
+#define LOAD_CHUNK_SIZE 512 /**< Number of lines parsed by one task of thread pool */
+#define ROW_CHUNK_SIZE 2048 /**< Number of rows processed by one task of parallel loop over table */
+#define TASK_DEQUE_SIZE 256 /**< Capacity of work-stealing deque of one worker */
+#define SAVE_ROUND_CHUNKS 32 /**< Number of chunks of rows that are formatted in parallel before they are written */
+
+#define SKETCH_PARTITIONS 64 /**< Maximum number of partitions of rows that are sketched in parallel and merged */
+#define HLL_PRECISION 12 /**< Number of hash bits that select register of HyperLogLog sketch */
+#define HLL_REGISTERS (1 << HLL_PRECISION) /**< Number of registers of HyperLogLog sketch (standard error about 1.6 %) */
+#define KLL_K 200 /**< Capacity of top level of KLL quantile sketch (rank error about 1 %) */
+#define KLL_MAX_LEVELS 64 /**< Maximum number of levels of KLL quantile sketch */
+#define PROFILE_SKETCH_MEMORY (64 * 1024 * 1024) /**< Maximum memory of HyperLogLog registers of all partitions of profile */
+#define BASE_NUMBER_OF_KEYS 64 /**< Base number of keys allocated in #KeyMap */
+#define TRANSPOSE_TILE 32 /**< Number of rows and columns of tile of cells that is transposed at once */
+#define PARTITION_OPEN_FILES 64 /**< Maximum number of partition files that are open at once */
+#define PARTITION_BUFFER_SIZE (64 * 1024) /**< Size of buffered rows of one partition that are written at once */
+#define PARTITION_BUFFER_MEMORY (64 * 1024 * 1024) /**< Maximum memory of buffered rows of all partitions */
+
 #define NUMBER_OF_TEMPORARY_VARIABLES 10 /**< Number of how much temporarz variables should be allocated/used */
 
 #define EMPTY_CELL "" /**< How should look like empty cell */
 
-const char *TABLE_EDITING_COMMANDS[] = { "irow", "arow", "drow", "icol", "acol", "dcol" };         /**< Spreadsheet with table editing commands */
-#define NUMBER_OF_TABLE_EDITING_COMMANDS 6                                                         /**< Number of table editing commands for iterating over array */
-const char *DATA_EDITING_COMMANDS[] = { "set", "clear", "swap", "sum", "avg", "count", "len" };    /**< Spreadsheet with data editing commands */
-#define NUMBER_OF_DATA_EDITING_COMMANDS 7                                                          /**< Number of data editing commands for iterating over array */
+#define IO_BUFFER_SIZE (1 << 20) /**< Size of one buffer used by read-ahead and write-behind threads */
+#define IO_BUFFER_ALIGNMENT 4096 /**< Alignment of IO buffers (page size) */
+#define NUMBER_OF_IO_BUFFERS 3 /**< Number of IO buffers in ring (triple buffering) */
+#define BASE_LINE_LENGTH 16 /**< Base length of line buffer that will be allocated */
+
+#define TAIL_STATE_MAGIC "SPSTAIL2" /**< Header of tail-follow state file */
+#define TEMP_FILE_SUFFIX ".tmp" /**< Suffix of temporary file that atomically replace its target when finished */
+#define SHARD_FILE_SUFFIX ".shard" /**< Suffix (followed by index of shard) of file where worker process saves its part of output */
+#define CHECKPOINT_MAGIC "SPSCKPT1" /**< Header of checkpoint manifest */
+#define CHECKPOINT_PAGES_SUFFIX ".pages" /**< Suffix (followed by generation) of file with pages of rows of checkpoint */
+#define CHECKPOINT_INTERVAL 60 /**< Minimum number of seconds between two checkpoints of execution */
+#define CHECKPOINT_COMPACT_RATIO 2 /**< Pages file is rewritten when it is this many times bigger than last records of pages */
+#define WATCH_BLOCK_LINES 4096 /**< Average number of lines of block of watched file (power of two), line whose hash is its multiple ends block */
+#define WATCH_EVENT_BUFFER 4096 /**< Size of buffer for events of watched directory */
+#define SHARED_TABLE_MAGIC "SPSSHM01" /**< Header of published table and of its control segment */
+#define SHARED_INPUT_PREFIX "shm:" /**< Prefix of input path that names published table instead of file */
+#define SHARED_ATTACH_RETRIES 16 /**< Number of attempts to attach table that is being replaced by new version */
+#define SERVE_MAX_CLIENTS 4096 /**< Maximum number of clients connected to daemon at once */
+#define SERVE_CLIENT_QUOTA (1 << 22) /**< Maximum number of bytes of unprocessed requests or of unsent responses of one client */
+#define SERVE_IO_CHUNK (1 << 16) /**< Maximum number of bytes read from or written to one client in one pass of event loop */
+#define SERVE_MAX_EVENTS 256 /**< Maximum number of events handled in one pass of event loop */
+#define READER_SLOT_SIZE 64 /**< Size of slot of reader of versions (cache line), so readers dont write to same line */
+#define RESULT_CACHE_SIZE 4096 /**< Number of entries of cache of aggregate results (power of two) */
+#define RESULT_CACHE_STRIPES 64 /**< Number of locks of entries of cache of aggregate results */
+#define COMPILED_ABI_VERSION 2 /**< Version of interface between engine and compiled script (change with #CompiledEngine or #CommandType) */
+#define COMPILED_SCRIPT_SYMBOL "sps_compiled_script" /**< Name of function of compiled script that executes commands */
+#define COMPILED_ABI_SYMBOL "sps_compiled_abi" /**< Name of constant of compiled script with its #COMPILED_ABI_VERSION */
+#define COMPILED_BLOCK_COMMANDS 64 /**< Number of commands translated to one function of compiled script */
+#define COMPILED_LAST_INDEX 0 /**< Row or column of compiled command or selector that is given by - (last row or column) */
+#define COMPILED_ALL_INDEX -1 /**< Row or column of compiled selector that is given by _ (all rows or columns) */
+#define DEFAULT_COMPILER "cc" /**< Compiler of scripts when CC environment variable isnt set */
+
+const char *TABLE_EDITING_COMMANDS[] = { "irow", "arow", "drow", "icol", "acol", "dcol",           /**< Spreadsheet with table editing commands */
+                                         "cat", "paste" };
+#define NUMBER_OF_TABLE_EDITING_COMMANDS 8                                                         /**< Number of table editing commands for iterating over array */
+const char *DATA_EDITING_COMMANDS[] = { "set", "clear", "swap", "sum", "avg", "count", "len",
+                                        "cumsum", "mavg", "mmin", "mmax", "median", "quantile",
+                                        "topk", "distinct", "aquantile", "profile", "pivot",       /**< Spreadsheet with data editing commands */
+                                        "transpose", "partition", "split", "hash", "diff" };
+#define NUMBER_OF_DATA_EDITING_COMMANDS 23                                                         /**< Number of data editing commands for iterating over array */
 const char *TEMP_VAR_COMMANDS[] = { "def", "use", "inc" };                                         /**< Spreadsheet with temporary variable commands */
 #define NUMBER_OF_TEMP_VAR_COMMANDS 3                                                              /**< Number of temporary variable commands for iterating over array */
+const char *FORMULA_FUNCTIONS[] = { "sum", "avg", "count", "len" };                                /**< Spreadsheet with functions that can be used in formula cells */
+#define NUMBER_OF_FORMULA_FUNCTIONS 4                                                              /**< Number of formula functions for iterating over array */
 
 /**
  * @enum CommandType
@@ -44,6 +129,29 @@ enum CommandType
     UNKNOWN,
 };
 
+/**
+ * @enum ColumnTypes
+ * @brief Inferred type of column, later type includes all previous ones
+ */
+enum ColumnTypes
+{
+    EMPTY_COLUMN,                 /**< All cells are empty */
+    INTEGER_COLUMN,               /**< Cells are empty or integers with at most #MAX_INTEGER_DIGITS digits */
+    DECIMAL_COLUMN,               /**< Cells are empty or numbers */
+    TEXT_COLUMN,                  /**< Cells can contain anything */
+};
+
+/**
+ * @enum FormulaStates
+ * @brief State of formula cell during recalculation
+ */
+enum FormulaStates
+{
+    FORMULA_CLEAN,                /**< Value of cell is up to date */
+    FORMULA_DIRTY,                /**< Some source cell changed and value must be recalculated */
+    FORMULA_VISITING,             /**< Formula is being recalculated (used to detect cycles) */
+};
+
 /**
  * @enum ErrorCodes
  * @brief Flags that will be returned on error
@@ -61,8 +169,68 @@ enum ErrorCodes
     COMMAND_ERROR,                /**< Error when received invalid commands or invalid value - 8 */
     SELECTOR_ERROR,               /**< Error when invalid selector is received - 9 */
     NUM_CONVERSION_FAILED,        /**< Error when converting string to numeric value failed - 10 */
+    IO_ERROR,                     /**< Error when reading from or writing to file failed - 11 */
 };
 
+/**
+ * @struct Formula
+ * @brief Formula cell (e.g. =sum(R1,C1,R2,C2)) with its source range
+ */
+typedef struct
+{
+    long long int row; /**< Row index of formula cell */
+    long long int col; /**< Column index of formula cell */
+    int function; /**< Index of function in #FORMULA_FUNCTIONS */
+    long long int r1; /**< First row of source range */
+    long long int c1; /**< First column of source range */
+    long long int r2; /**< Last row of source range */
+    long long int c2; /**< Last column of source range */
+    int state; /**< State from #FormulaStates */
+    _Bool changed; /**< Flag that source range was changed by table editing command */
+} Formula;
+
+/**
+ * @struct FormulaStore
+ * @brief All formula cells of table and dependency graph between them
+ *
+ * Graph is stored in compressed form, dependencies of formula i are
+ * dependencies[dependency_start[i]] .. dependencies[dependency_start[i + 1] - 1] (same for dependents)
+ */
+typedef struct
+{
+    Formula *formulas; /**< Array of formulas */
+    long long int num_of_formulas; /**< Number of formulas */
+    long long int allocated_formulas; /**< Number of allocated formulas */
+    long long int num_of_dirty; /**< Number of formulas that must be recalculated */
+    _Bool graph_valid; /**< Flag if graph matches current formulas */
+    long long int *dependency_start; /**< Start of dependencies of each formula */
+    long long int *dependencies; /**< Formulas whose cells are in source range of formula */
+    long long int *dependent_start; /**< Start of dependents of each formula */
+    long long int *dependents; /**< Formulas that have formula cell in their source range */
+} FormulaStore;
+
+/**
+ * @struct Options
+ * @brief Parsed arguments of program
+ */
+typedef struct
+{
+    char *delims; /**< Array of delimiters */
+    char *commands; /**< Raw commands argument (sequence of commands or -cFILE) */
+    char *input_path; /**< Path to input file */
+    char *output_path; /**< Path to output file (same as input file if not set by -o flag) */
+    char *state_path; /**< Path to state file of tail-follow mode (NULL if mode is disabled) */
+    long long int memory_budget; /**< Memory budget for cells of table in bytes (0 if not limited) */
+    int threads; /**< Number of threads including main thread */
+    int shards; /**< Number of processes of sharded execution (1 if input is processed by one process) */
+    char *checkpoint_path; /**< Path to checkpoint of execution (NULL if checkpoints are disabled) */
+    _Bool restart; /**< Flag if execution should be resumed from checkpoint */
+    long long int watch_delay; /**< Milliseconds without change of input file before script is executed again (-1 if watch mode is disabled) */
+    char *publish_name; /**< Name of shared memory table the result is published to (NULL if it isnt published) */
+    char *serve_path; /**< Path to socket of daemon that serves resident table (NULL if table isnt served) */
+    char *compile_dir; /**< Directory of cache of compiled scripts (NULL if commands are interpreted) */
+} Options;
+
 /**
  * @struct TempVariableStore
  * @brief Store for temporary variables
@@ -124,6 +292,7 @@ typedef struct
 {
     long long int allocated_chars; /**< Size of allocated space in content */
     char *content; /**< Raw content of single cell */
+    _Bool in_arena; /**< Flag if content is allocated in #Arena (it cant be freed or reallocated) */
 } Cell;
 
 /**
@@ -135,181 +304,1049 @@ typedef struct
     long long int num_of_cells; /**< Number of cells in row */
     long long int allocated_cells; /**< Number of cell pointers allocated in memory */
     Cell *cells; /**< Pointer to first cell in row */
+    _Bool cells_in_arena; /**< Flag if cells are allocated in #Arena (they cant be freed or reallocated) */
+    off_t spill_offset; /**< Offset of row in spill file if row is spilled, -1 if row is in memory */
 } Row;
 
 /**
- * @struct Table
- * @brief Store for data of whole table
+ * @struct ArenaChunk
+ * @brief One block of memory in #Arena
  */
-typedef struct
+typedef struct ArenaChunk
 {
-    long long int num_of_rows; /**< Number of rows in table */
-    long long int allocated_rows; /**< Number of row pointers allocated in memory */
-    Row *rows; /**< Pointer to first row in table */
-    char delim; /**< Delimiter for output */
-} Table;
+    struct ArenaChunk *next; /**< Previously filled chunk */
+    size_t size; /**< Size of data */
+    size_t used; /**< Number of used bytes of data */
+    char data[]; /**< Memory of chunk */
+} ArenaChunk;
 
-int trim_se(char *string)
+/**
+ * @struct Arena
+ * @brief Memory arena owned by one worker thread
+ *
+ * Memory is only allocated from arena and freed all at once \n
+ * Pages of chunks are first touched by worker that owns arena so they are placed on its NUMA node
+ */
+typedef struct
 {
-    /**
-     * @brief Trim start and end of string
-     *
-     * @param string String that we want to trim
-     *
-     * @return #NO_ERROR on success, #FUNCTION_ERROR on error
-     */
-
-    if (string == NULL)
-        return FUNCTION_ERROR;
+    ArenaChunk *chunks; /**< List of chunks (first one is currently filled) */
+} Arena;
 
-    unsigned long long int i = 1, len = strlen(string);
-    if (len > 1)
-    {
-        for(; i < (len - 1); i++)
-            string[i-1]=string[i];
-    }
-    string[i-1]='\0';
+/**
+ * @brief Function executed for one chunk of parallel loop
+ *
+ * Chunk covers items from @p start to @p end (excluded), @p worker_id is index of thread that runs it
+ */
+typedef void (*ChunkFunction)(void *arg, long long int chunk, long long int start, long long int end, int worker_id);
 
-    return NO_ERROR;
-}
+/**
+ * @struct PoolTask
+ * @brief Continuous range of chunks of parallel loop
+ */
+typedef struct
+{
+    long long int first_chunk; /**< Index of first chunk */
+    long long int end_chunk; /**< Index after last chunk */
+} PoolTask;
 
-int trim_start(char *string)
+/**
+ * @struct TaskDeque
+ * @brief Chase-Lev work-stealing deque with fixed capacity
+ *
+ * Owner pushes and pops tasks at bottom, other workers steal them from top
+ */
+typedef struct
 {
-    /**
-     * @brief Trim start and end of string
-     *
-     * @param string String that we want to trim
-     *
-     * @return #NO_ERROR on success, #FUNCTION_ERROR on error
-     */
+    long long int top; /**< Index of oldest task (changed by thieves) */
+    char padding[64]; /**< Keep top and bottom in different cache lines */
+    long long int bottom; /**< Index after newest task (changed by owner) */
+    PoolTask *tasks[TASK_DEQUE_SIZE]; /**< Circular buffer of tasks */
+} TaskDeque;
 
-    if (string == NULL)
-        return FUNCTION_ERROR;
+/**
+ * @struct PoolJob
+ * @brief Parallel loop currently executed by #ThreadPool
+ */
+typedef struct
+{
+    ChunkFunction function; /**< Function executed for each chunk */
+    void *arg; /**< Argument of function */
+    long long int num_of_items; /**< Number of items of loop */
+    long long int chunk_size; /**< Number of items in one chunk */
+    PoolTask *tasks; /**< Storage for tasks created by splitting (one per chunk) */
+    long long int used_tasks; /**< Number of used tasks */
+    long long int pending_chunks; /**< Number of chunks that are not finished yet */
+} PoolJob;
 
-    unsigned long long int i = 1, len = strlen(string);
-    if (len > 1)
-    {
-        for(; i < len; i++)
-            string[i-1]=string[i];
-    }
-    string[i-1]='\0';
+/**
+ * @struct WorkerContext
+ * @brief Argument of worker thread
+ */
+typedef struct
+{
+    struct ThreadPool *pool; /**< Pool of worker */
+    int id; /**< Index of worker in pool */
+    unsigned int seed; /**< State of random generator used to pick victim of stealing */
+} WorkerContext;
 
-    return NO_ERROR;
-}
+/**
+ * @struct ThreadPool
+ * @brief Pool of persistent worker threads that share parallel loops by work stealing
+ *
+ * Worker 0 is the thread that runs loops, other threads are started at the first loop that has more than one chunk
+ */
+typedef struct ThreadPool
+{
+    int max_workers; /**< Wanted number of workers including calling thread */
+    int num_of_workers; /**< Number of running workers including calling thread */
+    pthread_t threads[MAX_NUMBER_OF_THREADS]; /**< Worker threads (index 0 is not used) */
+    WorkerContext contexts[MAX_NUMBER_OF_THREADS]; /**< Arguments of worker threads */
+    TaskDeque deques[MAX_NUMBER_OF_THREADS]; /**< Deque of each worker */
+    PoolJob *job; /**< Currently executed loop */
+    long long int generation; /**< Counter of executed loops */
+    int finished; /**< Number of threads that finished current loop */
+    _Bool stop; /**< Flag for workers to exit */
+    pthread_mutex_t lock; /**< Lock for shared variables */
+    pthread_cond_t changed; /**< Signaled when shared variable changes */
+} ThreadPool;
 
-int string_copy(char **source, char **dest)
+/**
+ * @struct LoadBatch
+ * @brief Batch of read lines that are parsed in parallel
+ */
+typedef struct
 {
-    /**
-     * @brief Copy @p source string to @p dest string
-     *
-     * @param source Pointer to source string
-     * @param dest Pointer to destination string
-     *
-     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
-     */
+    char **lines; /**< Array of read lines */
+    long long int num_of_lines; /**< Number of lines in batch */
+    long long int first_row; /**< Index of row for first line */
+    const char *delims; /**< Array with all posible delimiters */
+    struct Table *table; /**< Table where rows are saved */
+    int results[LOAD_BATCH_SIZE / LOAD_CHUNK_SIZE]; /**< Result of each chunk of lines */
+    long long int failed_lines[LOAD_BATCH_SIZE / LOAD_CHUNK_SIZE]; /**< Index of line where chunk failed */
+    unsigned char *col_types[LOAD_BATCH_SIZE / LOAD_CHUNK_SIZE]; /**< Types of columns of each chunk of lines */
+    long long int num_of_col_types[LOAD_BATCH_SIZE / LOAD_CHUNK_SIZE]; /**< Number of typed columns of each chunk of lines */
+} LoadBatch;
 
-    if (source == NULL)
-        return NO_ERROR;
+/**
+ * @struct TopValue
+ * @brief Item of bounded heap of #top_cells
+ */
+typedef struct
+{
+    long double value; /**< Numeric value of cell */
+    long long int order; /**< Order of cell in selection (earlier cell wins tie) */
+} TopValue;
 
-    *dest = (char*)malloc((strlen(*source) + 1) * sizeof(char));
-    if (*dest == NULL)
-        return ALLOCATION_FAILED;
+/**
+ * @struct KllSketch
+ * @brief KLL quantile sketch
+ *
+ * Level h holds items with weight 2^h, full level is sorted and every second item is promoted to next level
+ */
+typedef struct
+{
+    long double *levels[KLL_MAX_LEVELS]; /**< Items of each level */
+    long long int sizes[KLL_MAX_LEVELS]; /**< Number of items of each level */
+    long long int allocated[KLL_MAX_LEVELS]; /**< Number of allocated items of each level */
+    _Bool offsets[KLL_MAX_LEVELS]; /**< Which half of items was promoted last time (alternates) */
+    int num_of_levels; /**< Number of used levels */
+} KllSketch;
 
-    strcpy(*dest, *source);
+/**
+ * @struct SketchPartitions
+ * @brief Sketches of partitions of selected rows that are merged in order of partitions
+ */
+typedef struct
+{
+    struct Table *table; /**< Table with data */
+    Selector *selector; /**< Selected area */
+    unsigned char *registers; /**< HyperLogLog registers of each partition (NULL if not computed) */
+    KllSketch *sketches; /**< KLL sketch of each partition (NULL if not computed) */
+    _Bool *non_numeric; /**< Flag of each partition if non numeric cell was found */
+    int *results; /**< Result of each partition */
+} SketchPartitions;
 
-    return NO_ERROR;
-}
+/**
+ * @struct KeyMap
+ * @brief Hash map of distinct strings to their indexes in order of first insertion
+ */
+typedef struct
+{
+    char **keys; /**< Copies of keys in order of insertion */
+    uint64_t *hashes; /**< Hash of each key */
+    long long int num_of_keys; /**< Number of keys */
+    long long int allocated_keys; /**< Number of allocated keys */
+    long long int *slots; /**< Open addressing slots with index of key + 1 (0 when slot is free) */
+    long long int num_of_slots; /**< Number of slots (power of two, at least twice number of keys) */
+} KeyMap;
 
-_Bool string_end_with(const char *base_string, const char *end_string)
+/**
+ * @struct PivotCell
+ * @brief Aggregate of values of one pair of row key and column key
+ */
+typedef struct
 {
-    /**
-     * @brief Check if string ends with other string
-     *
-     * Check if @p base_string ends with @p end_string
-     *
-     * @param base_string String where to look for substring
-     * @param end_string Substring to look for at the end of base_string
-     *
-     * @return true if @p base_string ends with @p end_string, false if dont
-     */
+    long double sum; /**< Sum of numeric values */
+    long long int num_of_values; /**< Number of values (or non empty values for count) */
+    _Bool used; /**< Flag if pair of keys occurs in data */
+    _Bool nan; /**< Flag if non numeric value was found */
+} PivotCell;
 
-    char *end_start = strrchr(base_string, end_string[0]);
-    if (end_start && strcmp(end_start, end_string) == 0)
-        return true;
-    return false;
-}
+/**
+ * @struct TransposeJob
+ * @brief Tiles of cells that are moved from table to transposed table
+ */
+typedef struct
+{
+    struct Table *table; /**< Source table */
+    struct Table *transposed; /**< Transposed table with allocated rows */
+    long long int num_of_rows; /**< Number of rows of source table */
+    long long int num_of_cols; /**< Number of columns of source table (width of widest row) */
+    long long int col_tiles; /**< Number of tiles across columns of source table */
+    int *results; /**< Result of each tile */
+} TransposeJob;
 
-_Bool string_start_with(const char *base_string, const char *start_string)
+/**
+ * @struct ColumnProfile
+ * @brief Statistics of one column of selection
+ */
+typedef struct
 {
-    /**
-     * @brief Check if string starts with other string
-     *
-     * Check if @p base_string starts with @p start_string
-     *
-     * @param base_string String where to look for substring
-     * @param start_string Substring to look for at start of base_string
-     *
-     * @return true if @p base_string starts with @p start_string, false if dont
-     */
+    long long int num_of_numeric; /**< Number of numeric cells */
+    long long int num_of_empty; /**< Number of empty cells */
+    long long int num_of_cells; /**< Number of all cells */
+    long double min; /**< Minimum of numeric cells */
+    long double max; /**< Maximum of numeric cells */
+    long double sum; /**< Sum of numeric cells */
+    long long int min_length; /**< Minimum length of non empty cells */
+    long long int max_length; /**< Maximum length of non empty cells */
+    long long int total_length; /**< Sum of lengths of non empty cells */
+    unsigned char *registers; /**< HyperLogLog registers of non empty cells */
+} ColumnProfile;
 
-    if (strlen(start_string) > strlen(base_string))
-        return false;
+/**
+ * @struct ProfilePartitions
+ * @brief Column profiles of partitions of selected rows that are merged in order of partitions
+ */
+typedef struct
+{
+    struct Table *table; /**< Table with data */
+    Selector *selector; /**< Selected area */
+    long long int num_of_cols; /**< Number of profiled columns */
+    ColumnProfile *profiles; /**< Profiles of columns of each partition (partition major) */
+} ProfilePartitions;
 
-    return strncmp(start_string, base_string, strlen(start_string)) == 0;
-}
+/**
+ * @struct SelectionReduction
+ * @brief Partial results of chunks of rows of selection that are combined in order of chunks
+ */
+typedef struct
+{
+    struct Table *table; /**< Table with data */
+    Selector *selector; /**< Selected area */
+    long long int first_row; /**< Index of first selected row */
+    _Bool want_max; /**< Flag if maximum (or minimum) is searched */
+    int type; /**< Type of selected columns from #ColumnTypes that selects kernel */
+    long double *values; /**< Partial sum or extreme value of each chunk */
+    long double *counts; /**< Number of values of each chunk */
+    long long int *rows; /**< Row of extreme value of each chunk */
+    long long int *cols; /**< Column of extreme value of each chunk */
+    _Bool *flags; /**< Flag of each chunk (non numeric cell found or extreme value found) */
+    int *results; /**< Result of each chunk */
+} SelectionReduction;
 
-_Bool strings_equal(const char *s1, const char *s2)
+/**
+ * @struct RowHashes
+ * @brief Hashes of selected rows computed in parallel by chunks of rows
+ */
+typedef struct
 {
-    /**
-     * @brief Check if two string @p s1 and @p s2 are same
-     *
-     * @param s1 First string
-     * @param s2 Second string
-     *
-     * @return true if string are equal, false if dont
-     */
+    struct Table *table; /**< Table with data */
+    Selector *selector; /**< Selected area */
+    long long int first_row; /**< Index of first selected row */
+    long long int skipped_col; /**< Column that isnt hashed (-1 if none) */
+    uint64_t *hashes; /**< Hash of each selected row (NULL if only digest is computed) */
+    uint64_t *sums; /**< Sum of digest terms of rows of each chunk */
+} RowHashes;
 
-    if (s1 == NULL && s2 == NULL)
-        return true;
+/**
+ * @struct DiffEntry
+ * @brief Row of other file in hash join of table diff
+ */
+typedef struct
+{
+    uint64_t key; /**< Hash of key cell of row (position of row when rows are compared by position) */
+    uint64_t hash; /**< Hash of content of row */
+    _Bool matched; /**< Flag that row was matched by row of table */
+} DiffEntry;
 
-    if (s1 == NULL || s2 == NULL)
-        return false;
+/**
+ * @struct DiffIndex
+ * @brief Hashes of all rows of other file (build side of hash join), index of entry is index of row in file
+ */
+typedef struct
+{
+    DiffEntry *entries; /**< Entry of each row of file */
+    long long int num_of_entries; /**< Number of entries */
+    long long int allocated_entries; /**< Number of allocated entries */
+    long long int *slots; /**< Open addressing slots with index of entry + 1 (0 when slot is free, NULL when rows are compared by position) */
+    long long int num_of_slots; /**< Number of slots (power of two, more than twice number of entries) */
+} DiffIndex;
 
-    return strcmp(s1, s2) == 0;
-}
+/**
+ * @struct DiffHashes
+ * @brief Key and content hashes of batch of rows computed in parallel
+ */
+typedef struct
+{
+    struct Table *table; /**< Table with rows */
+    long long int first_row; /**< Index of first row of batch */
+    long long int key_col; /**< Index of key column (-1 when rows are compared by position) */
+    uint64_t keys[LOAD_BATCH_SIZE]; /**< Hash of key cell of each row */
+    uint64_t hashes[LOAD_BATCH_SIZE]; /**< Hash of content of each row */
+} DiffHashes;
 
-_Bool is_string_llint(char *string)
+/**
+ * @struct OutputBuffer
+ * @brief Growable buffer with formatted part of output
+ */
+typedef struct
 {
-    /**
-     * @brief Check if @p string should be converted to long long int
-     *
-     * @param string String that we want to test
-     *
-     * @return true if it can be converted, false if not
-     */
+    char *data; /**< Formatted data */
+    size_t length; /**< Length of data */
+    size_t allocated; /**< Size of allocated memory */
+} OutputBuffer;
 
-    if (string == NULL)
-        return false;
+/**
+ * @struct SaveRound
+ * @brief Chunks of rows formatted in parallel before they are written in order
+ */
+typedef struct
+{
+    struct Table *table; /**< Saved table */
+    long long int first_row; /**< Index of first row of round */
+    OutputBuffer *buffers; /**< Buffer of each chunk */
+    _Bool *ended; /**< Flag of each chunk if row without data was found */
+    int *results; /**< Result of each chunk */
+} SaveRound;
 
-    char *rest;
-    strtoll(string, &rest, 10);
-    if (strings_equal(rest, EMPTY_CELL))
-        return true;
-    return false;
-}
+/**
+ * @struct PartitionRound
+ * @brief Chunks of selected rows formatted in parallel before they are distributed to partitions
+ */
+typedef struct
+{
+    struct Table *table; /**< Partitioned table */
+    long long int first_row; /**< Index of first row of round */
+    OutputBuffer *buffers; /**< Buffer of each chunk */
+    size_t *row_ends; /**< End of each formatted row in buffer of its chunk (#ROW_CHUNK_SIZE rows per chunk) */
+    Cell *scratch; /**< Cell of each chunk where content is formatted */
+    int *results; /**< Result of each chunk */
+} PartitionRound;
 
-_Bool is_string_ldouble(char *string)
+/**
+ * @struct PartitionWriter
+ * @brief Buffered writer of one output partition
+ */
+typedef struct
 {
-    /**
-     * @brief Check if @p string should be converted to long double
-     *
-     * @param string String that we want to test
-     *
-     * @return true if it can be converted, false if not
-     */
+    char *path; /**< Path to file of partition */
+    OutputBuffer buffer; /**< Rows that were not written yet */
+    int fd; /**< Descriptor of opened file (-1 when file is closed) */
+    _Bool created; /**< Flag that file was already created (next open appends) */
+    _Bool referenced; /**< Flag that file was written since eviction hand passed it */
+} PartitionWriter;
 
-    if (string == NULL)
-        return false;
+/**
+ * @struct PartitionSet
+ * @brief Writers of all partitions with bounded cache of opened files
+ */
+typedef struct
+{
+    PartitionWriter *writers; /**< Writer of each partition */
+    long long int num_of_writers; /**< Number of partitions */
+    long long int allocated_writers; /**< Number of allocated writers */
+    long long int open_files[PARTITION_OPEN_FILES]; /**< Index of partition in each slot of opened files (-1 when slot is free) */
+    int hand; /**< Slot where search for file to evict starts (clock algorithm) */
+    size_t buffered; /**< Number of buffered bytes of all partitions */
+} PartitionSet;
+
+/**
+ * @struct TableChunks
+ * @brief Argument of parallel loop that edits cells of table row by row
+ */
+typedef struct
+{
+    struct Table *table; /**< Edited table */
+    long long int first_row; /**< Index of first edited row */
+    const char *delims; /**< Array of chars that was used as delims */
+    int *results; /**< Result of each chunk */
+} TableChunks;
+
+/**
+ * @struct RowPage
+ * @brief Bookkeeping of one page of #ROWS_PER_PAGE rows for memory budget
+ */
+typedef struct
+{
+    long long int last_access; /**< Tick of last access to any row in page */
+    long long int measured_at; /**< Tick when size of page was measured (-1 if never) */
+    long long int bytes; /**< Number of bytes used by cells of resident rows in page */
+    long long int slot; /**< Index of slot of page in spill file (-1 if page was never spilled) */
+    uint64_t image_hash; /**< Hash of rows that were last written to or read from slot of page */
+} RowPage;
+
+/**
+ * @struct SpillSlot
+ * @brief Region of spill file where spilled rows of one page are stored
+ */
+typedef struct
+{
+    off_t offset; /**< Offset of slot in spill file */
+    long long int capacity; /**< Size of slot in bytes */
+    long long int used; /**< Number of bytes of rows written to slot */
+    long long int live_rows; /**< Number of spilled rows whose cells are stored in slot */
+    long long int page; /**< Page that owns slot (-1 if it isnt owned, slot is free when it has no live rows) */
+} SpillSlot;
+
+/**
+ * @struct SpillStore
+ * @brief Store for rows spilled to temporary file when memory budget is exceeded
+ */
+typedef struct
+{
+    FILE *file; /**< Temporary file with spilled rows */
+    long long int budget; /**< Memory budget for cells of table in bytes */
+    long long int tick; /**< Counter of row accesses used for LRU */
+    RowPage *pages; /**< Array of pages */
+    long long int allocated_pages; /**< Number of allocated pages */
+    long long int recent_pages[2]; /**< Two most recently used pages that are never spilled */
+    SpillSlot *slots; /**< Slots of spill file sorted by offset */
+    long long int num_of_slots; /**< Number of slots */
+    long long int allocated_slots; /**< Number of allocated slots */
+    off_t file_size; /**< Size of spill file (end of last slot) */
+} SpillStore;
+
+/**
+ * @struct IOBuffer
+ * @brief Single aligned buffer passed between IO thread and main thread
+ */
+typedef struct
+{
+    char *data; /**< Aligned memory of buffer */
+    size_t length; /**< Number of valid bytes in buffer */
+    _Bool last; /**< Flag that this buffer is last one in stream */
+} IOBuffer;
+
+/**
+ * @struct IORing
+ * @brief Ring of #IOBuffer structures shared by producer and consumer thread
+ */
+typedef struct
+{
+    IOBuffer buffers[NUMBER_OF_IO_BUFFERS]; /**< Buffers in ring */
+    long long int produced; /**< Number of buffers published by producer */
+    long long int consumed; /**< Number of buffers released by consumer */
+    int fd; /**< File descriptor of file that is read or written */
+    off_t offset; /**< Offset in file for next read/write */
+    off_t end; /**< Offset in file where reading stops (-1 to read until end of file) */
+    int error; /**< Error from IO thread (#NO_ERROR if everything is fine) */
+    _Bool stop; /**< Flag for IO thread to stop as soon as possible */
+    _Bool threaded; /**< Flag if IO thread is running (if not, IO is done synchronously) */
+    pthread_t thread; /**< IO thread */
+    pthread_mutex_t lock; /**< Lock for counters */
+    pthread_cond_t changed; /**< Signaled when any counter changes */
+} IORing;
+
+/**
+ * @struct ReadAheadReader
+ * @brief Reader of lines that is fed by read-ahead thread
+ */
+typedef struct
+{
+    IORing ring; /**< Ring of buffers filled by read-ahead thread */
+    IOBuffer *current; /**< Buffer that is currently parsed (NULL if none is acquired) */
+    size_t position; /**< Position of parser in current buffer */
+    _Bool finished; /**< Flag that last buffer was already consumed */
+    off_t consumed; /**< Offset in file right after last returned line */
+    _Bool line_complete; /**< Flag if last returned line was terminated by new line character */
+} ReadAheadReader;
+
+/**
+ * @struct WriteBehindWriter
+ * @brief Writer that hands filled buffers to write-behind thread
+ */
+typedef struct
+{
+    IORing ring; /**< Ring of buffers flushed by write-behind thread */
+    IOBuffer *current; /**< Buffer that is currently filled (NULL if none is acquired) */
+} WriteBehindWriter;
+
+/**
+ * @struct ShardContext
+ * @brief Process of sharded execution that holds rows of one byte range of input file
+ *
+ * Shard 0 is coordinator, it forks workers for other shards and merges their partial results
+ */
+typedef struct
+{
+    int index; /**< Index of shard of this process */
+    int num_of_shards; /**< Number of shards */
+    off_t start; /**< Offset of first byte of shard in input file */
+    off_t end; /**< Offset after last byte of shard in input file */
+    long long int first_row; /**< Index of first row of shard in whole table */
+    long long int num_of_rows; /**< Number of rows of whole table */
+    int to_coordinator; /**< Pipe to coordinator (workers only) */
+    int from_coordinator; /**< Pipe from coordinator (workers only) */
+    int to_workers[MAX_NUMBER_OF_SHARDS]; /**< Pipe to each worker (coordinator only) */
+    int from_workers[MAX_NUMBER_OF_SHARDS]; /**< Pipe from each worker (coordinator only) */
+    pid_t workers[MAX_NUMBER_OF_SHARDS]; /**< Process of each worker (coordinator only) */
+} ShardContext;
+
+/**
+ * @struct ShardPartial
+ * @brief Partial result of aggregate of one shard that is merged in order of shards
+ */
+typedef struct
+{
+    int result; /**< Result of shard (first error of merged shards) */
+    _Bool flag; /**< Flag that non numeric cell was found (sum) or that extreme value was found (max, min) */
+    _Bool want_max; /**< Flag if maximum (or minimum) is searched */
+    long double value; /**< Sum or extreme value */
+    long double count; /**< Number of values or cells */
+    long long int row; /**< Row of extreme value in whole table */
+    long long int col; /**< Column of extreme value */
+} ShardPartial;
+
+/**
+ * @struct ShardLayout
+ * @brief Shape of every shard that all shards agree on before commands are executed
+ */
+typedef struct
+{
+    int result; /**< Result of shard (first error of merged shards) */
+    _Bool formulas; /**< Flag that some shard has formula cells */
+    long long int num_of_cols; /**< Number of columns of widest shard */
+    long long int rows[MAX_NUMBER_OF_SHARDS]; /**< Number of rows of each shard */
+} ShardLayout;
+
+typedef void (*ShardMergeFunction)(void *target, void *source, size_t size); /**< Merge partial result of later shard to @p target */
+
+/**
+ * @struct SharedTableHeader
+ * @brief Header of table published to shared memory segment
+ *
+ * Segment contains only offsets from its start, so it can be mapped on any address: \n
+ * header, array of index of first cell of every row (and total number of cells after last row),
+ * array of offsets of cell contents and null terminated cell contents
+ */
+typedef struct
+{
+    char magic[8]; /**< #SHARED_TABLE_MAGIC */
+    uint64_t size; /**< Size of segment in bytes */
+    uint64_t num_of_rows; /**< Number of rows */
+    uint64_t rows_offset; /**< Offset of array of indexes of first cells of rows */
+    uint64_t cells_offset; /**< Offset of array of offsets of cell contents */
+} SharedTableHeader;
+
+/**
+ * @struct SharedTableControl
+ * @brief Control segment with generation of currently published segment of table
+ *
+ * New version is written to segment of next generation and published by atomic store of generation
+ */
+typedef struct
+{
+    char magic[8]; /**< #SHARED_TABLE_MAGIC */
+    uint64_t generation; /**< Generation of published segment (0 if nothing was published) */
+} SharedTableControl;
+
+/**
+ * @struct SharedTable
+ * @brief Table published to shared memory mapped by reader
+ */
+typedef struct
+{
+    unsigned char *data; /**< Mapped segment (NULL if no table is attached) */
+    size_t size; /**< Size of mapped segment */
+    long long int num_of_rows; /**< Number of rows */
+    const uint64_t *rows; /**< Indexes of first cells of rows */
+    const uint64_t *cells; /**< Offsets of cell contents */
+} SharedTable;
+
+/**
+ * @struct CheckpointPage
+ * @brief Last record of page of rows in pages file of checkpoint
+ */
+typedef struct
+{
+    long long int offset; /**< Offset of record in pages file (-1 if page wasnt saved yet) */
+    long long int size; /**< Size of record in bytes */
+    uint64_t hash; /**< Hash of rows of page when record was saved */
+} CheckpointPage;
+
+/**
+ * @struct Checkpoint
+ * @brief Periodic snapshot of table and state of execution that interrupted run can be resumed from
+ *
+ * Page of rows is appended to pages file only when its content changed since last checkpoint,
+ * manifest with state of execution and offsets of pages then atomically replaces old one
+ */
+typedef struct
+{
+    const char *path; /**< Path to manifest of checkpoint (NULL if checkpoints are disabled) */
+    uint64_t script_hash; /**< Hash of executed commands */
+    long long int generation; /**< Generation of pages file (suffix of its name, 0 if there is none) */
+    FILE *pages_file; /**< Pages file of current generation (NULL if it isnt opened) */
+    long long int file_size; /**< Size of pages file */
+    CheckpointPage *pages; /**< Last record of each page of table */
+    long long int num_of_pages; /**< Number of pages of table in last checkpoint */
+    long long int allocated_pages; /**< Number of allocated records of pages */
+    time_t last_time; /**< Monotonic time of last checkpoint in seconds */
+    _Bool resumed; /**< Flag that state of execution below was loaded from checkpoint */
+    long long int next_command; /**< Index of first command that wasnt executed */
+    Selector selector; /**< Selector after last executed command */
+    Selector temp_selector; /**< Temporary selector after last executed command */
+    char *variables[NUMBER_OF_TEMPORARY_VARIABLES]; /**< Temporary variables after last executed command */
+} Checkpoint;
+
+/**
+ * @struct Table
+ * @brief Store for data of whole table
+ */
+typedef struct Table
+{
+    long long int num_of_rows; /**< Number of rows in table */
+    long long int allocated_rows; /**< Number of row pointers allocated in memory */
+    Row *rows; /**< Pointer to first row in table */
+    char delim; /**< Delimiter for output */
+    const char *input_delims; /**< Array with all posible delimiters of input files */
+    SpillStore *spill; /**< Store for spilled rows (NULL if memory budget is not set) */
+    Arena *arenas; /**< Arenas of loading workers (NULL if not used) */
+    struct ThreadPool *pool; /**< Pool for parallel loops over table (NULL if everything runs on main thread) */
+    FormulaStore formulas; /**< Formula cells of table */
+    unsigned char *col_types; /**< Type of each column from #ColumnTypes (columns after last typed one are empty) */
+    long long int num_of_col_types; /**< Number of typed columns */
+    int num_of_arenas; /**< Number of arenas */
+    ShardContext *shard; /**< Sharded execution of table (NULL if table holds whole input) */
+    struct TableVersion *version; /**< Version whose rows table views (NULL if table isnt view of version) */
+    struct ResultCache *cache; /**< Cache of aggregate results of views of versions (NULL if results arent cached) */
+} Table;
+
+/**
+ * @struct WatchBlock
+ * @brief Block of lines of watched input file with its parsed rows
+ *
+ * Blocks end at content defined boundaries, so change of file changes only blocks around it
+ */
+typedef struct
+{
+    uint64_t hash; /**< Hash of lines of block */
+    long long int num_of_lines; /**< Number of lines of block (-1 when rows were moved to block of new scan) */
+    Table rows; /**< Parsed and filtered rows of lines (derived table) */
+} WatchBlock;
+
+/**
+ * @struct WatchState
+ * @brief Resident blocks of watched input file
+ */
+typedef struct
+{
+    WatchBlock *blocks; /**< Blocks in order of file */
+    long long int num_of_blocks; /**< Number of blocks */
+    long long int allocated_blocks; /**< Number of allocated blocks */
+} WatchState;
+
+/**
+ * @struct RowBlock
+ * @brief Immutable copy of page of rows shared by all versions of table in which page didnt change
+ */
+typedef struct
+{
+    long long int references; /**< Number of versions that contain block */
+    uint64_t id; /**< Unique identifier of block, so same identifier means same rows */
+    uint64_t hash; /**< Hash of rows of block */
+    long long int num_of_rows; /**< Number of rows */
+    Row *rows; /**< Rows with cells owned by block */
+} RowBlock;
+
+/**
+ * @struct TableVersion
+ * @brief Immutable version of served table
+ *
+ * Version is never changed after it is published, readers that pinned it can read it without any locks
+ */
+typedef struct TableVersion
+{
+    uint64_t generation; /**< Generation of version (first published version has 1) */
+    long long int num_of_rows; /**< Number of rows */
+    Row *rows; /**< Copies of rows of blocks (cells are owned by blocks), so version can be read as table */
+    RowBlock **blocks; /**< Blocks of version, one per #ROWS_PER_PAGE rows */
+    long long int num_of_blocks; /**< Number of blocks */
+    unsigned char *col_types; /**< Types of columns */
+    long long int num_of_col_types; /**< Number of typed columns */
+    uint64_t retired_epoch; /**< Epoch in which version was replaced by newer one */
+    struct TableVersion *next_retired; /**< Next replaced version that waits for reclamation */
+} TableVersion;
+
+/**
+ * @struct ReaderSlot
+ * @brief Epoch pinned by one reader, alone in cache line
+ */
+typedef struct
+{
+    uint64_t epoch; /**< Epoch in which reader pinned version (0 if reader doesnt read any version) */
+    char padding[READER_SLOT_SIZE - sizeof(uint64_t)]; /**< Padding to size of cache line */
+} ReaderSlot;
+
+/**
+ * @enum CachedOperations
+ * @brief Aggregations whose results are cached
+ */
+enum CachedOperations
+{
+    CACHED_SUM, /**< Sum and number of values (average is computed from them) */
+    CACHED_COUNT, /**< Number of non empty cells */
+    CACHED_MAX, /**< Cell with maximum */
+    CACHED_MIN, /**< Cell with minimum */
+};
+
+/**
+ * @struct CachedResult
+ * @brief Result of aggregation of selection
+ */
+typedef struct
+{
+    long double value; /**< Sum or number of non empty cells */
+    long double count; /**< Number of summed values */
+    _Bool flag; /**< Flag if non numeric cell was found (sum) or if extreme was found (maximum and minimum) */
+    long long int row; /**< Row of extreme */
+    long long int col; /**< Column of extreme */
+} CachedResult;
+
+/**
+ * @struct CacheEntry
+ * @brief Cached result of aggregation of selection
+ */
+typedef struct
+{
+    _Bool used; /**< Flag if entry contains result */
+    int operation; /**< Operation from #CachedOperations */
+    long long int rows[2]; /**< First and last selected row */
+    long long int cols[2]; /**< First and last selected column */
+    uint64_t region; /**< Signature of blocks of selected rows and of types of selected columns */
+    CachedResult result; /**< Result */
+} CacheEntry;
+
+/**
+ * @struct ResultCache
+ * @brief Cache of aggregate results shared by all readers of versions
+ *
+ * Entry is valid only while selected rows are in same blocks, so write to block invalidates entries that selected its rows
+ */
+typedef struct ResultCache
+{
+    CacheEntry entries[RESULT_CACHE_SIZE]; /**< Entries addressed by hash of operation and selection */
+    pthread_mutex_t locks[RESULT_CACHE_STRIPES]; /**< Locks of entries (entry uses lock of its index modulo number of locks) */
+} ResultCache;
+
+/**
+ * @struct VersionStore
+ * @brief Published versions of served table with epoch based reclamation of replaced versions
+ *
+ * Writer changes its own table, copies pages that changed to new blocks and publishes new version by swap of pointer \n
+ * Replaced version is freed when no reader pinned it, which is when every reader is idle or pinned later epoch
+ */
+typedef struct
+{
+    TableVersion *current; /**< Current version (accessed atomically) */
+    uint64_t epoch; /**< Global epoch, incremented with every replaced version (accessed atomically) */
+    ReaderSlot *readers; /**< Slots of readers */
+    int num_of_readers; /**< Number of slots of readers */
+    TableVersion *retired; /**< Replaced versions that can still be read (only writer accesses them) */
+    pthread_mutex_t writer_lock; /**< Lock of writer table and of publishing of versions */
+    Table *table; /**< Table of writer */
+    uint64_t next_block_id; /**< Identifier of next created block (only writer accesses it) */
+    ResultCache *cache; /**< Cache of aggregate results */
+} VersionStore;
+
+/**
+ * @struct ServeClient
+ * @brief Connection of client of daemon handled by event loop
+ *
+ * Requests of client are executed one at a time, so pipelined responses are sent in order of requests
+ */
+typedef struct
+{
+    int fd; /**< Socket of connection */
+    long long int index; /**< Index of client in array of clients of event loop */
+    OutputBuffer input; /**< Received bytes */
+    size_t input_start; /**< Offset of first unprocessed byte of input */
+    OutputBuffer output; /**< Responses that werent sent yet */
+    size_t output_start; /**< Offset of first unsent byte of output */
+    uint32_t events; /**< Events the loop waits for */
+    _Bool busy; /**< Flag if request of client is executed by worker */
+    _Bool end_of_input; /**< Flag if client ended sending of requests */
+    _Bool failed; /**< Flag if connection failed and client will be closed */
+} ServeClient;
+
+/**
+ * @struct ServeRequest
+ * @brief Request of client executed by worker
+ */
+typedef struct ServeRequest
+{
+    ServeClient *client; /**< Client that sent request */
+    char *line; /**< Request line */
+    OutputBuffer response; /**< Response */
+    struct ServeRequest *next; /**< Next request in queue */
+} ServeRequest;
+
+/**
+ * @struct ServeQueue
+ * @brief Queues of requests between event loop and workers
+ *
+ * Workers take requests from pending queue and return them to done queue, event loop is woken by event descriptor
+ */
+typedef struct
+{
+    VersionStore *store; /**< Served versions */
+    pthread_mutex_t lock; /**< Lock of queues */
+    pthread_cond_t ready; /**< Signaled when request is added to pending queue or when workers are stopped */
+    ServeRequest *pending; /**< First pending request */
+    ServeRequest *last_pending; /**< Last pending request */
+    ServeRequest *done; /**< Executed requests (in any order) */
+    int wake_fd; /**< Event descriptor that wakes event loop */
+    _Bool stop; /**< Flag that workers should end */
+} ServeQueue;
+
+/**
+ * @struct ServeWorker
+ * @brief Worker that executes requests with its own reader slot
+ */
+typedef struct
+{
+    pthread_t thread; /**< Thread of worker */
+    ServeQueue *queue; /**< Queues of requests */
+    int slot; /**< Index of reader slot of worker */
+} ServeWorker;
+
+/**
+ * @struct CompiledEngine
+ * @brief Functions of engine that are called by compiled script
+ *
+ * Compiled script declares same structure (see generate_compiled_script()), so it doesnt need any header of engine \n
+ * Commands with arguments that were parsed when script was generated have their own functions, other commands are interpreted by execute
+ */
+typedef struct CompiledEngine
+{
+    void *context; /**< Pointer to #CompiledContext of execution */
+    int (*select_area)(struct CompiledEngine *engine, int num_of_parts, long long int r1, long long int c1, long long int r2, long long int c2); /**< Set selector to area of 2 or 4 parts (numbers from 1, #COMPILED_LAST_INDEX or #COMPILED_ALL_INDEX) */
+    int (*select)(struct CompiledEngine *engine, const char *selector); /**< Set selector by selector command that doesnt select area */
+    int (*execute)(struct CompiledEngine *engine, int type, const char *function, const char *arguments); /**< Interpret command of type from #CommandType that isnt specialized */
+    int (*recalculate)(struct CompiledEngine *engine); /**< Recalculate formula cells */
+    int (*edit)(struct CompiledEngine *engine, int command, const char *arguments); /**< Execute table editing command of index in #TABLE_EDITING_COMMANDS */
+    int (*set)(struct CompiledEngine *engine, const char *value); /**< set STR and clear */
+    int (*swap)(struct CompiledEngine *engine, long long int row, long long int col); /**< swap [R,C] (row and col from 1 or #COMPILED_LAST_INDEX) */
+    int (*sum)(struct CompiledEngine *engine, long long int row, long long int col); /**< sum [R,C] (row and col from 1 or #COMPILED_LAST_INDEX) */
+    int (*avg)(struct CompiledEngine *engine, long long int row, long long int col); /**< avg [R,C] (row and col from 1 or #COMPILED_LAST_INDEX) */
+    int (*count)(struct CompiledEngine *engine, long long int row, long long int col); /**< count [R,C] (row and col from 1 or #COMPILED_LAST_INDEX) */
+    int (*len)(struct CompiledEngine *engine, long long int row, long long int col); /**< len [R,C] (row and col from 1 or #COMPILED_LAST_INDEX) */
+    int (*median)(struct CompiledEngine *engine, long long int row, long long int col); /**< median [R,C] (row and col from 1 or #COMPILED_LAST_INDEX) */
+    int (*distinct)(struct CompiledEngine *engine, long long int row, long long int col); /**< distinct [R,C] (row and col from 1 or #COMPILED_LAST_INDEX) */
+    int (*window)(struct CompiledEngine *engine, int function, long long int window, long long int col); /**< cumsum [C], mavg [W,C], mmin [W,C] and mmax [W,C] (function of window_cells()) */
+    int (*topk)(struct CompiledEngine *engine, long long int k, long long int col); /**< topk [K,C] */
+    int (*quantile)(struct CompiledEngine *engine, int approximate, long double quantile, long long int row, long long int col); /**< quantile [Q,R,C] and aquantile [Q,R,C] */
+    int (*def)(struct CompiledEngine *engine, char **variable); /**< def _X with variable of compiled script */
+    int (*use)(struct CompiledEngine *engine, char **variable); /**< use _X with variable of compiled script */
+    int (*inc)(struct CompiledEngine *engine, char **variable); /**< inc _X with variable of compiled script */
+    void (*release)(struct CompiledEngine *engine, char **variable); /**< Deallocate variable of compiled script */
+} CompiledEngine;
+
+/**
+ * @struct CompiledContext
+ * @brief State of execution of compiled script
+ */
+typedef struct
+{
+    Table *table; /**< Table of execution */
+    Selector selector; /**< Main selector */
+    Selector temp_selector; /**< Temporary selector */
+} CompiledContext;
+
+/**
+ * @struct CompiledScript
+ * @brief Loaded library of compiled script
+ */
+typedef struct
+{
+    void *handle; /**< Handle of loaded library (NULL if script isnt loaded) */
+    int (*function)(CompiledEngine *engine); /**< Function that executes commands */
+} CompiledScript;
+
+volatile sig_atomic_t stop_requested = 0; /**< Flag that watch mode or daemon was interrupted by signal */
+
+int trim_se(char *string)
+{
+    /**
+     * @brief Trim start and end of string
+     *
+     * @param string String that we want to trim
+     *
+     * @return #NO_ERROR on success, #FUNCTION_ERROR on error
+     */
+
+    if (string == NULL)
+        return FUNCTION_ERROR;
+
+    unsigned long long int i = 1, len = strlen(string);
+    if (len > 1)
+    {
+        for(; i < (len - 1); i++)
+            string[i-1]=string[i];
+    }
+    string[i-1]='\0';
+
+    return NO_ERROR;
+}
+
+int trim_start(char *string)
+{
+    /**
+     * @brief Trim start and end of string
+     *
+     * @param string String that we want to trim
+     *
+     * @return #NO_ERROR on success, #FUNCTION_ERROR on error
+     */
+
+    if (string == NULL)
+        return FUNCTION_ERROR;
+
+    unsigned long long int i = 1, len = strlen(string);
+    if (len > 1)
+    {
+        for(; i < len; i++)
+            string[i-1]=string[i];
+    }
+    string[i-1]='\0';
+
+    return NO_ERROR;
+}
+
+int string_copy(char **source, char **dest)
+{
+    /**
+     * @brief Copy @p source string to @p dest string
+     *
+     * @param source Pointer to source string
+     * @param dest Pointer to destination string
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    if (source == NULL)
+        return NO_ERROR;
+
+    *dest = (char*)malloc((strlen(*source) + 1) * sizeof(char));
+    if (*dest == NULL)
+        return ALLOCATION_FAILED;
+
+    strcpy(*dest, *source);
+
+    return NO_ERROR;
+}
+
+_Bool string_end_with(const char *base_string, const char *end_string)
+{
+    /**
+     * @brief Check if string ends with other string
+     *
+     * Check if @p base_string ends with @p end_string
+     *
+     * @param base_string String where to look for substring
+     * @param end_string Substring to look for at the end of base_string
+     *
+     * @return true if @p base_string ends with @p end_string, false if dont
+     */
+
+    char *end_start = strrchr(base_string, end_string[0]);
+    if (end_start && strcmp(end_start, end_string) == 0)
+        return true;
+    return false;
+}
+
+_Bool string_start_with(const char *base_string, const char *start_string)
+{
+    /**
+     * @brief Check if string starts with other string
+     *
+     * Check if @p base_string starts with @p start_string
+     *
+     * @param base_string String where to look for substring
+     * @param start_string Substring to look for at start of base_string
+     *
+     * @return true if @p base_string starts with @p start_string, false if dont
+     */
+
+    if (strlen(start_string) > strlen(base_string))
+        return false;
+
+    return strncmp(start_string, base_string, strlen(start_string)) == 0;
+}
+
+_Bool strings_equal(const char *s1, const char *s2)
+{
+    /**
+     * @brief Check if two string @p s1 and @p s2 are same
+     *
+     * @param s1 First string
+     * @param s2 Second string
+     *
+     * @return true if string are equal, false if dont
+     */
+
+    if (s1 == NULL && s2 == NULL)
+        return true;
+
+    if (s1 == NULL || s2 == NULL)
+        return false;
+
+    return strcmp(s1, s2) == 0;
+}
+
+_Bool is_string_llint(char *string)
+{
+    /**
+     * @brief Check if @p string should be converted to long long int
+     *
+     * @param string String that we want to test
+     *
+     * @return true if it can be converted, false if not
+     */
+
+    if (string == NULL)
+        return false;
+
+    char *rest;
+    strtoll(string, &rest, 10);
+    if (strings_equal(rest, EMPTY_CELL))
+        return true;
+    return false;
+}
+
+_Bool is_string_ldouble(char *string)
+{
+    /**
+     * @brief Check if @p string should be converted to long double
+     *
+     * @param string String that we want to test
+     *
+     * @return true if it can be converted, false if not
+     */
+
+    if (string == NULL)
+        return false;
 
     char *rest;
     strtold(string, &rest);
@@ -318,3194 +1355,14692 @@ _Bool is_string_ldouble(char *string)
     return false;
 }
 
-_Bool is_ldouble_lint(long double val)
-{
-    /**
-     * @brief Check if long double could be converted to long int without loss of precision
-     *
-     * @param val Long double value to check
-     *
-     * @return true if can be converted, false if not
-     */
+_Bool is_ldouble_lint(long double val)
+{
+    /**
+     * @brief Check if long double could be converted to long int without loss of precision
+     *
+     * @param val Long double value to check
+     *
+     * @return true if can be converted, false if not
+     */
+
+    return (long int)(val) == val;
+}
+
+int string_to_llint(char *string, long long int *val)
+{
+    /**
+     * @brief Convert string to long long int
+     *
+     * @param string String we want to convert
+     * @param val Pointer to long long int where output will be saved
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (string == NULL)
+        return FUNCTION_ARGUMENT_ERROR;
+
+    char *rest;
+    *val = strtoll(string, &rest, 10);
+
+    if (!strings_equal(rest, EMPTY_CELL))
+        return NUM_CONVERSION_FAILED;
+
+    return NO_ERROR;
+}
+
+int string_to_ldouble(char *string, long double *val)
+{
+    /**
+     * @brief Convert string to long double
+     *
+     * @param string String we want to convert
+     * @param val Pointer to long double where output will be saved
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (string == NULL)
+        return FUNCTION_ARGUMENT_ERROR;
+
+    char *rest;
+    *val = strtold(string, &rest);
+
+    if (!strings_equal(rest, EMPTY_CELL))
+        return NUM_CONVERSION_FAILED;
+
+    return NO_ERROR;
+}
+
+_Bool string_to_integer(const char *string, long long int *val)
+{
+    /**
+     * @brief Fast conversion of integer cell to long long int
+     *
+     * Accepts only optional sign and at most #MAX_INTEGER_DIGITS digits, empty string is 0 as in #is_string_ldouble
+     *
+     * @param string String we want to convert
+     * @param val Pointer to long long int where output will be saved
+     *
+     * @return true if @p string is integer, false if not
+     */
+
+    const char *c = string;
+    _Bool negative = false;
+
+    if (*c == '\0')
+    {
+        *val = 0;
+        return true;
+    }
+
+    if (*c == '-' || *c == '+')
+        negative = (*c++ == '-');
+
+    long long int value = 0;
+    int digits = 0;
+    for (; *c >= '0' && *c <= '9'; c++, digits++)
+        value = value * 10 + (*c - '0');
+
+    if (*c != '\0' || digits == 0 || digits > MAX_INTEGER_DIGITS)
+        return false;
+
+    *val = negative ? -value : value;
+    return true;
+}
+
+int get_cell_type(const char *string)
+{
+    /**
+     * @brief Get type of cell content
+     *
+     * @param string Content of cell
+     *
+     * @return Type from #ColumnTypes
+     */
+
+    if (string == NULL || *string == '\0')
+        return EMPTY_COLUMN;
+
+    // Plain integers and decimals are recognized without conversion
+    const char *c = string;
+    int digits = 0, dots = 0;
+
+    if (*c == '-' || *c == '+')
+        c++;
+    for (; (*c >= '0' && *c <= '9') || *c == '.'; c++)
+        (*c == '.') ? dots++ : digits++;
+
+    if (*c == '\0' && digits > 0)
+    {
+        if (dots == 0 && digits <= MAX_INTEGER_DIGITS)
+            return INTEGER_COLUMN;
+        if (dots <= 1)
+            return DECIMAL_COLUMN;
+    }
+
+    if (is_string_ldouble((char*)string))
+        return DECIMAL_COLUMN;
+    return TEXT_COLUMN;
+}
+
+int widen_column_type(unsigned char **col_types, long long int *num_of_col_types, long long int col, int type)
+{
+    /**
+     * @brief Widen type of column so it includes @p type
+     *
+     * Array of types is extended with empty columns when @p col is after last typed column
+     *
+     * @param col_types Pointer to array of types of columns
+     * @param num_of_col_types Pointer to number of typed columns
+     * @param col Index of column
+     * @param type Type from #ColumnTypes that column must include
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    if (col >= *num_of_col_types)
+    {
+        if (type == EMPTY_COLUMN)
+            return NO_ERROR;
+
+        long long int new_num_of_types = (*num_of_col_types * 2 > col + 1) ? *num_of_col_types * 2 : col + 1;
+        unsigned char *tmp = (unsigned char*)realloc(*col_types, (size_t)new_num_of_types);
+        if (tmp == NULL)
+            return ALLOCATION_FAILED;
+
+        memset(tmp + *num_of_col_types, EMPTY_COLUMN, (size_t)(new_num_of_types - *num_of_col_types));
+        *col_types = tmp;
+        *num_of_col_types = new_num_of_types;
+    }
+
+    if (type > (*col_types)[col])
+        (*col_types)[col] = (unsigned char)type;
+
+    return NO_ERROR;
+}
+
+int widen_row_types(unsigned char **col_types, long long int *num_of_col_types, Row *row)
+{
+    /**
+     * @brief Widen types of columns by all cells of @p row
+     *
+     * @param col_types Pointer to array of types of columns
+     * @param num_of_col_types Pointer to number of typed columns
+     * @param row Pointer to instance of #Row structure
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    int ret_val = NO_ERROR;
+
+    for (long long int i = 0; i < row->num_of_cells && ret_val == NO_ERROR; i++)
+    {
+        // Text is widest type so there is nothing to check
+        if (i < *num_of_col_types && (*col_types)[i] == TEXT_COLUMN)
+            continue;
+
+        ret_val = widen_column_type(col_types, num_of_col_types, i, get_cell_type(row->cells[i].content));
+    }
+
+    return ret_val;
+}
+
+int get_selection_type(Table *table, Selector *selector)
+{
+    /**
+     * @brief Get widest type of selected columns
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure
+     *
+     * @return Type from #ColumnTypes
+     */
+
+    int type = EMPTY_COLUMN;
+
+    for (long long int i = selector->lld_ic1; i <= selector->lld_ic2 && i < table->num_of_col_types; i++)
+        if (table->col_types[i] > type)
+            type = table->col_types[i];
+
+    return type;
+}
+
+int ldouble_to_string(long double value, char **output_string)
+{
+    /**
+     * @brief Convert long double @p value to string
+     *
+     * @param value Long double value that we want to convert to string
+     * @param output_string Pointer to output string
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    char *temp_string = (char*)malloc(BASE_CELL_LENGTH * sizeof(char));
+    if (temp_string == NULL)
+        return ALLOCATION_FAILED;
+
+    unsigned long long int tlength = snprintf(temp_string, BASE_CELL_LENGTH, "%Lg", value);
+    if ((tlength + 1) > BASE_CELL_LENGTH)
+    {
+        char *tmp = (char*)realloc(temp_string, (tlength + 1) * sizeof(char));
+        if (tmp == NULL)
+        {
+            free(temp_string);
+            return ALLOCATION_FAILED;
+        }
+
+        temp_string = tmp;
+        snprintf(temp_string, tlength + 1, "%Lg", value);
+    }
+
+    *output_string = temp_string;
+    return NO_ERROR;
+}
+
+int lint_to_string(long int value, char **output_string)
+{
+    /**
+     * @brief Convert long int @p value to string
+     *
+     * @param value Long int value that we want to convert to string
+     * @param output_string Pointer to output string
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    char *temp_string = (char*)malloc(BASE_CELL_LENGTH * sizeof(char));
+    if (temp_string == NULL)
+        return ALLOCATION_FAILED;
+
+    unsigned long long int tlength = snprintf(temp_string, BASE_CELL_LENGTH, "%li", value);
+    if ((tlength + 1) > BASE_CELL_LENGTH)
+    {
+        char *tmp = (char*)realloc(temp_string, (tlength + 1) * sizeof(char));
+        if (tmp == NULL)
+        {
+            free(temp_string);
+            return ALLOCATION_FAILED;
+        }
+
+        temp_string = tmp;
+        snprintf(temp_string, tlength + 1, "%li", value);
+    }
+
+    *output_string = temp_string;
+    return NO_ERROR;
+}
+
+long long int count_char(char *string, char c, _Bool ignore_escapes)
+{
+    /**
+     * @brief Count specific character in string
+     *
+     * Count ocurences of specific character in string with option to ignore escaped characters and parts in parentecies
+     *
+     * @param string Input string
+     * @param c Character we want to search
+     * @param ignore_escapes Flag if we want ignore if characte is escaped or in parentecies and count it too
+     *
+     * @return Number of ocurences of searched character
+     */
+
+    if (string == NULL)
+        return 0;
+
+    size_t lenght_of_string = strlen(string);
+    _Bool in_double_parentecies = false;
+    long long int counter = 0;
+
+    long long int possible_occurencies = 0;
+    for (size_t i = 0; i < lenght_of_string; i++)
+        if (string[i] == '"')
+            possible_occurencies++;
+
+    if ((possible_occurencies % 2) > 0)
+        possible_occurencies --;
+
+    long long int occurencies = 0;
+
+    for (size_t i = 0; i < lenght_of_string; i++)
+    {
+        char cc = string[i];
+
+        if (cc == '"')
+        {
+            occurencies++;
+            if ((i == 0 || string[i-1] != '\\') && (occurencies <= possible_occurencies))
+                in_double_parentecies = !in_double_parentecies;
+        }
+
+        if (cc == c)
+        {
+            if (ignore_escapes || (!in_double_parentecies && (i != 0 && string[i-1] != '\\')))
+            {
+                counter++;
+            }
+        }
+    }
+
+    return counter;
+}
+
+long long int get_position_of_character(char *string, char ch, long long int index, _Bool ignore_escapes)
+{
+    /**
+     * @brief Get position of character of certain index in string
+     *
+     * Iterate over each character in string and count character ocurences
+     * If ocurence counter coresponse to @p index then return position of current char in string
+     *
+     * @param string String where to find char
+     * @param ch Character we are looking for
+     * @param index Index of occurence of character in string we want position for
+     * @param ignore_escapes Flag if we want ignore if characte is escaped or in parentecies and count it too
+     *
+     * @return Position of @p index ocurence of @p ch in string if valid ocurence is found, if not -1
+     *
+     * @todo Rework to strchr
+     */
+
+    long long int counter = 0;
+    _Bool in_double_parentecies = false;
+
+    long long int possible_occurencies = count_char(string, '"', true);
+    if ((possible_occurencies % 2) > 0)
+        possible_occurencies --;
+
+    long long int occurencies = 0;
+
+    for (size_t i = 0; string[i]; i++)
+    {
+        if (string[i] == '"')
+        {
+            occurencies++;
+            if ((i == 0 || string[i-1] != '\\') && (occurencies <= possible_occurencies))
+                in_double_parentecies = !in_double_parentecies;
+        }
+
+        if (string[i] == ch)
+        {
+            if (ignore_escapes || (!in_double_parentecies && (i != 0 && string[i-1] != '\\')))
+            {
+                counter++;
+                if ((counter - 1) == index)
+                    return i;
+            }
+        }
+    }
+
+    return -1;
+}
+
+void rm_newline_chars(char *s) {
+    /**
+     * @brief Removing new line character from string
+     *
+     * Iterate over string until it new line character then replace it with 0
+     * @warning
+     * Rest of the string is REMOVED!
+     *
+     * @param s Pointer to string from which is new line character removed
+     */
+
+    while(*s && *s != '\n' && *s != '\r')
+        s++;
+
+    *s = 0;
+}
+
+int get_substring(char *string, char **substring, char delim, long long int index, _Bool ignore_escapes, char **rest, _Bool want_rest)
+{
+    /**
+     * @brief Get substring from string
+     *
+     * Extract Portion of string delimited by @p delim or by borders of main string @p string \n
+     * Wantend portion is selected by @p index
+     *
+     * @param string Base string
+     * @param substring Place where result will be saved, should be allocated large enough but if its not provided this function will allocate it
+     * @param delim Deliminator character
+     * @param index Index of substring
+     * @param ignore_escapes Flag if we want ignore if characte is escaped or in parentecies and count it too
+     * @param rest There will be saved rest of the string
+     * @param want_rest Flag if we want save rest of the flag
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (string == NULL)
+        return FUNCTION_ERROR;
+
+    long long int number_of_delims = count_char(string, delim, ignore_escapes);
+    size_t string_length = strlen(string);
+
+    long long int start_index = (index == 0) ? 0 : get_position_of_character(string, delim, index - 1, ignore_escapes) + 1;
+    long long int end_index = (index >= number_of_delims) ? ((long long int)string_length - 1) : get_position_of_character(string, delim, index, ignore_escapes) - 1;
+
+    // If there is no substring pointer init it
+    if ((*substring) == NULL)
+    {
+        if ((end_index - start_index + 1) == 0)
+            return NO_ERROR;
+
+        (*substring) = (char*)malloc((string_length + 1) * sizeof(char));
+        if ((*substring) == NULL)
+            return ALLOCATION_FAILED;
+    }
+
+    long long int i = 0, j = start_index;
+
+    for (; j <= end_index; i++, j++)
+    {
+        (*substring)[i] = string[j];
+    }
+    (*substring)[end_index - start_index + 1] = '\0';
+
+    if (want_rest)
+    {
+        j += 1;
+        long long int rest_len = (long long int)string_length - j + 1;
+
+        if (rest_len == 0)
+            return NO_ERROR;
+
+        (*rest) = (char*)malloc((rest_len) * sizeof(char));
+        if (rest == NULL)
+        {
+            free(*substring);
+            (*substring) = NULL;
+            return ALLOCATION_FAILED;
+        }
+
+        i = 0;
+        for (; j < (long long int)string_length; j++, i++)
+        {
+            (*rest)[i] = string[j];
+        }
+        (*rest)[i] = '\0';
+    }
+
+    return NO_ERROR;
+}
+
+void normalize_delims(char *line, const char *delims)
+{
+    /**
+     * @brief Normalize all delims to the first one
+     *
+     * Iterate over all delims and all characters in line and replace and valid delim from delims array in line by the first delim in delims array
+     *
+     * @param line Line string
+     * @param delims Array of deliminator characters
+     */
+
+    size_t num_of_delims = strlen(delims);
+    size_t length_of_line = strlen(line);
+
+    long long int possible_occurencies = count_char(line, '"', true);
+    if ((possible_occurencies % 2) > 0)
+        possible_occurencies --;
+
+    for (size_t i = 1; i < num_of_delims; i++)
+    {
+        _Bool in_double_parentecies = false;
+        long long int occurencies = 0;
+
+        for (size_t j = 0; j < length_of_line; j++)
+        {
+            char cc = line[j];
+
+            if (cc == '"')
+            {
+                occurencies++;
+                if ((j == 0 || line[j-1] != '\\') && (occurencies <= possible_occurencies))
+                    in_double_parentecies = !in_double_parentecies;
+            }
+
+            if (cc == delims[i])
+            {
+                if (!in_double_parentecies && (j != 0 && line[j-1] != '\\'))
+                {
+                    line[j] = delims[0];
+                }
+            }
+        }
+    }
+}
+
+void *arena_alloc(Arena *arena, size_t size)
+{
+    /**
+     * @brief Allocate memory from arena
+     *
+     * @param arena Pointer to instance of #Arena structure
+     * @param size Number of bytes to allocate
+     *
+     * @return Pointer to allocated memory or NULL on error
+     */
+
+    size = (size + ARENA_ALIGNMENT - 1) & ~((size_t)ARENA_ALIGNMENT - 1);
+
+    if (arena->chunks == NULL || (arena->chunks->size - arena->chunks->used) < size)
+    {
+        size_t chunk_size = (size > ARENA_CHUNK_SIZE) ? size : ARENA_CHUNK_SIZE;
+
+        // Pages of chunk are not touched here so they are placed on NUMA node of thread that fills them
+        ArenaChunk *chunk = (ArenaChunk*)malloc(sizeof(ArenaChunk) + chunk_size);
+        if (chunk == NULL)
+            return NULL;
+
+        chunk->size = chunk_size;
+        chunk->used = 0;
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+    }
+
+    void *memory = arena->chunks->data + arena->chunks->used;
+    arena->chunks->used += size;
+
+    return memory;
+}
+
+void arena_destroy(Arena *arena)
+{
+    /**
+     * @brief Free all memory allocated from arena
+     *
+     * @param arena Pointer to instance of #Arena structure
+     */
+
+    while (arena->chunks != NULL)
+    {
+        ArenaChunk *next = arena->chunks->next;
+        free(arena->chunks);
+        arena->chunks = next;
+    }
+}
+
+int allocate_arenas(Table *table, int num_of_arenas)
+{
+    /**
+     * @brief Allocate at least @p num_of_arenas arenas in table
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param num_of_arenas Number of wanted arenas
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    if (table->num_of_arenas >= num_of_arenas)
+        return NO_ERROR;
+
+    Arena *tmp = (Arena*)realloc(table->arenas, num_of_arenas * sizeof(Arena));
+    if (tmp == NULL)
+        return ALLOCATION_FAILED;
+
+    for (int i = table->num_of_arenas; i < num_of_arenas; i++)
+        tmp[i].chunks = NULL;
+
+    table->arenas = tmp;
+    table->num_of_arenas = num_of_arenas;
+
+    return NO_ERROR;
+}
+
+_Bool task_deque_push(TaskDeque *deque, PoolTask *task)
+{
+    /**
+     * @brief Push task to bottom of deque
+     *
+     * Only owner of deque can call this function
+     *
+     * @param deque Pointer to instance of #TaskDeque structure
+     * @param task Task to push
+     *
+     * @return true on success, false when deque is full
+     */
+
+    long long int bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    long long int top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+
+    if ((bottom - top) >= TASK_DEQUE_SIZE)
+        return false;
+
+    // Release store publishes task to thieves
+    __atomic_store_n(&deque->tasks[bottom % TASK_DEQUE_SIZE], task, __ATOMIC_RELAXED);
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+PoolTask *task_deque_pop(TaskDeque *deque)
+{
+    /**
+     * @brief Pop newest task from bottom of deque
+     *
+     * Only owner of deque can call this function
+     *
+     * @param deque Pointer to instance of #TaskDeque structure
+     *
+     * @return Task or NULL when deque is empty
+     */
+
+    // Reservation of bottom task must be visible before top is read
+    long long int bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&deque->bottom, bottom, __ATOMIC_SEQ_CST);
+    long long int top = __atomic_load_n(&deque->top, __ATOMIC_SEQ_CST);
+
+    PoolTask *task = NULL;
+    if (top <= bottom)
+    {
+        task = __atomic_load_n(&deque->tasks[bottom % TASK_DEQUE_SIZE], __ATOMIC_RELAXED);
+
+        // Last task can be stolen at the same time
+        if (top == bottom)
+        {
+            if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+                task = NULL;
+            __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        }
+    }
+    else
+    {
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+    }
+
+    return task;
+}
+
+PoolTask *task_deque_steal(TaskDeque *deque)
+{
+    /**
+     * @brief Steal oldest task from top of deque
+     *
+     * @param deque Pointer to instance of #TaskDeque structure
+     *
+     * @return Task or NULL when deque is empty or other thread took the task first
+     */
+
+    long long int top = __atomic_load_n(&deque->top, __ATOMIC_SEQ_CST);
+    long long int bottom = __atomic_load_n(&deque->bottom, __ATOMIC_SEQ_CST);
+
+    if (top >= bottom)
+        return NULL;
+
+    PoolTask *task = __atomic_load_n(&deque->tasks[top % TASK_DEQUE_SIZE], __ATOMIC_RELAXED);
+    if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+        return NULL;
+
+    return task;
+}
+
+void thread_pool_run_task(ThreadPool *pool, PoolJob *job, PoolTask *task, int worker_id)
+{
+    /**
+     * @brief Run all chunks of task
+     *
+     * Upper half of task is repeatedly split off and pushed to deque of worker so idle workers can steal it
+     *
+     * @param pool Pointer to instance of #ThreadPool structure
+     * @param job Pointer to instance of #PoolJob structure with executed loop
+     * @param task Task to run
+     * @param worker_id Index of worker that runs task
+     */
+
+    long long int first_chunk = task->first_chunk;
+    long long int end_chunk = task->end_chunk;
+
+    while ((end_chunk - first_chunk) > 1)
+    {
+        long long int middle_chunk = first_chunk + (end_chunk - first_chunk) / 2;
+
+        PoolTask *upper_half = &job->tasks[__atomic_fetch_add(&job->used_tasks, 1, __ATOMIC_RELAXED)];
+        upper_half->first_chunk = middle_chunk;
+        upper_half->end_chunk = end_chunk;
+
+        // When deque is full rest of task is run without splitting
+        if (!task_deque_push(&pool->deques[worker_id], upper_half))
+            break;
+
+        end_chunk = middle_chunk;
+    }
+
+    for (long long int chunk = first_chunk; chunk < end_chunk; chunk++)
+    {
+        long long int start = chunk * job->chunk_size;
+        long long int end = (start + job->chunk_size < job->num_of_items) ? start + job->chunk_size : job->num_of_items;
+
+        job->function(job->arg, chunk, start, end, worker_id);
+    }
+
+    __atomic_sub_fetch(&job->pending_chunks, end_chunk - first_chunk, __ATOMIC_ACQ_REL);
+}
+
+void thread_pool_work(ThreadPool *pool, PoolJob *job, int worker_id)
+{
+    /**
+     * @brief Run tasks of @p job until all its chunks are finished
+     *
+     * Worker takes tasks from its own deque first and when it is empty it steals from random other worker
+     *
+     * @param pool Pointer to instance of #ThreadPool structure
+     * @param job Pointer to instance of #PoolJob structure with executed loop
+     * @param worker_id Index of worker
+     */
+
+    WorkerContext *context = &pool->contexts[worker_id];
+
+    while (__atomic_load_n(&job->pending_chunks, __ATOMIC_ACQUIRE) > 0)
+    {
+        PoolTask *task = task_deque_pop(&pool->deques[worker_id]);
+
+        if (task == NULL && pool->num_of_workers > 1)
+        {
+            // Simple LCG is enough to spread thieves over victims
+            context->seed = context->seed * 1103515245 + 12345;
+            int victim = (int)((context->seed >> 16) % (unsigned int)pool->num_of_workers);
+            if (victim != worker_id)
+                task = task_deque_steal(&pool->deques[victim]);
+        }
+
+        if (task != NULL)
+            thread_pool_run_task(pool, job, task, worker_id);
+        else
+            sched_yield();
+    }
+}
+
+void *worker_thread(void *arg)
+{
+    /**
+     * @brief Body of worker thread of #ThreadPool
+     *
+     * Wait for new loop and help with it until pool is stopped
+     *
+     * @param arg Pointer to instance of #WorkerContext structure
+     *
+     * @return NULL
+     */
+
+    WorkerContext *context = (WorkerContext*)arg;
+    ThreadPool *pool = context->pool;
+    long long int seen_generation = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (true)
+    {
+        while (!pool->stop && pool->generation == seen_generation)
+            pthread_cond_wait(&pool->changed, &pool->lock);
+
+        if (pool->stop)
+            break;
+
+        seen_generation = pool->generation;
+        PoolJob *job = pool->job;
+        pthread_mutex_unlock(&pool->lock);
+
+        thread_pool_work(pool, job, context->id);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->finished++;
+        pthread_cond_broadcast(&pool->changed);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+int thread_pool_init(ThreadPool *pool, int num_of_workers)
+{
+    /**
+     * @brief Initialize pool of @p num_of_workers workers
+     *
+     * Threads are not started until they are needed
+     *
+     * @param pool Pointer to instance of #ThreadPool structure
+     * @param num_of_workers Wanted number of workers including calling thread
+     *
+     * @return #NO_ERROR on success, #FUNCTION_ERROR when synchronization primitives cant be created
+     */
+
+    if (num_of_workers < 1)
+        num_of_workers = 1;
+    if (num_of_workers > MAX_NUMBER_OF_THREADS)
+        num_of_workers = MAX_NUMBER_OF_THREADS;
+
+    pool->max_workers = num_of_workers;
+    pool->num_of_workers = 1;
+    pool->job = NULL;
+    pool->generation = 0;
+    pool->finished = 0;
+    pool->stop = false;
+
+    for (int i = 0; i < MAX_NUMBER_OF_THREADS; i++)
+    {
+        pool->deques[i].top = 0;
+        pool->deques[i].bottom = 0;
+        pool->contexts[i].pool = pool;
+        pool->contexts[i].id = i;
+        pool->contexts[i].seed = (unsigned int)i * 2654435761u + 1;
+    }
+
+    if (pthread_mutex_init(&pool->lock, NULL) != 0)
+        return FUNCTION_ERROR;
+
+    if (pthread_cond_init(&pool->changed, NULL) != 0)
+    {
+        pthread_mutex_destroy(&pool->lock);
+        return FUNCTION_ERROR;
+    }
+
+    return NO_ERROR;
+}
+
+void thread_pool_start(ThreadPool *pool)
+{
+    /**
+     * @brief Start worker threads of pool if they are not running yet
+     *
+     * If some threads cant be started then pool works with less workers
+     *
+     * @param pool Pointer to instance of #ThreadPool structure
+     */
+
+    while (pool->num_of_workers < pool->max_workers)
+    {
+        int id = pool->num_of_workers;
+
+        if (pthread_create(&pool->threads[id], NULL, worker_thread, &pool->contexts[id]) != 0)
+        {
+            pool->max_workers = pool->num_of_workers;
+            break;
+        }
+
+        pool->num_of_workers++;
+    }
+}
+
+long long int get_number_of_chunks(long long int num_of_items, long long int chunk_size)
+{
+    /**
+     * @brief Get number of chunks of parallel loop
+     *
+     * @param num_of_items Number of items
+     * @param chunk_size Number of items in one chunk
+     *
+     * @return Number of chunks
+     */
+
+    return (num_of_items + chunk_size - 1) / chunk_size;
+}
+
+void thread_pool_for(ThreadPool *pool, long long int num_of_items, long long int chunk_size, ChunkFunction function, void *arg)
+{
+    /**
+     * @brief Run @p function for all chunks of @p num_of_items items in parallel and wait until all of them finish
+     *
+     * Items are split to chunks of @p chunk_size items, so chunks (and results of reductions combined in order of chunks)
+     * does not depend on number of workers \n
+     * When @p pool is NULL or there is only one chunk then loop runs on calling thread
+     * @warning
+     * Loops cant be nested, @p function must not call this function
+     *
+     * @param pool Pointer to instance of #ThreadPool structure (can be NULL)
+     * @param num_of_items Number of items
+     * @param chunk_size Number of items in one chunk
+     * @param function Function executed for each chunk
+     * @param arg Argument of function
+     */
+
+    long long int num_of_chunks = get_number_of_chunks(num_of_items, chunk_size);
+
+    PoolJob job;
+    job.function = function;
+    job.arg = arg;
+    job.num_of_items = num_of_items;
+    job.chunk_size = chunk_size;
+    job.used_tasks = 1;
+    job.pending_chunks = num_of_chunks;
+    job.tasks = NULL;
+
+    if (pool != NULL && pool->max_workers > 1 && num_of_chunks > 1)
+        job.tasks = (PoolTask*)malloc(num_of_chunks * sizeof(PoolTask));
+
+    PoolTask root = {0, num_of_chunks};
+
+    // Sequential loop when there is nothing to share
+    if (job.tasks == NULL)
+    {
+        for (long long int chunk = 0; chunk < num_of_chunks; chunk++)
+        {
+            long long int start = chunk * chunk_size;
+            long long int end = (start + chunk_size < num_of_items) ? start + chunk_size : num_of_items;
+
+            function(arg, chunk, start, end, 0);
+        }
+        return;
+    }
+
+    thread_pool_start(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->job = &job;
+    pool->finished = 0;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->changed);
+    pthread_mutex_unlock(&pool->lock);
+
+    thread_pool_run_task(pool, &job, &root, 0);
+    thread_pool_work(pool, &job, 0);
+
+    // Job cant be released until all workers stop looking at it
+    pthread_mutex_lock(&pool->lock);
+    while (pool->finished < (pool->num_of_workers - 1))
+        pthread_cond_wait(&pool->changed, &pool->lock);
+    pool->job = NULL;
+    pthread_mutex_unlock(&pool->lock);
+
+    free(job.tasks);
+}
+
+void thread_pool_destroy(ThreadPool *pool)
+{
+    /**
+     * @brief Stop and join all worker threads
+     *
+     * @param pool Pointer to instance of #ThreadPool structure
+     */
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->changed);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 1; i < pool->num_of_workers; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    pthread_cond_destroy(&pool->changed);
+    pthread_mutex_destroy(&pool->lock);
+    pool->num_of_workers = 0;
+}
+
+ThreadPool *get_table_pool(Table *table)
+{
+    /**
+     * @brief Get pool that can be used for parallel loops over rows of @p table
+     *
+     * Rows of table with memory budget can be loaded back from disk by #get_row so they must be accessed sequentially
+     *
+     * @param table Pointer to instance of #Table structure
+     *
+     * @return Pointer to pool or NULL when loops must be sequential
+     */
+
+    return (table->spill == NULL) ? table->pool : NULL;
+}
+
+int get_number_of_cpus(void)
+{
+    /**
+     * @brief Get number of online processors
+     *
+     * @return Number of processors (at least 1 and at most #MAX_NUMBER_OF_THREADS)
+     */
+
+    long int cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1)
+        return 1;
+    if (cpus > MAX_NUMBER_OF_THREADS)
+        return MAX_NUMBER_OF_THREADS;
+
+    return (int)cpus;
+}
+
+void deallocate_cell(Cell *cell)
+{
+    /**
+     * @brief Deallocate cell
+     *
+     * Free content of cell
+     *
+     * @param cell Pointer to instance of #Cell strucutre
+     */
+
+    if (cell->content == NULL)
+        return;
+
+    // Content in arena is freed with whole arena
+    if (!cell->in_arena)
+        free(cell->content);
+    cell->content = NULL;
+    cell->allocated_chars = 0;
+    cell->in_arena = false;
+}
+
+void deallocate_row(Row *row)
+{
+    /**
+     * @brief Deallocate row
+     *
+     * Iterate over all cells and deallocate them
+     *
+     * @param row Pointer to instance of #Row structure
+     */
+
+    if (row->cells == NULL)
+        return;
+
+    for (long long int i = 0; i < row->num_of_cells; i++)
+    {
+        deallocate_cell(&row->cells[i]);
+    }
+
+    // Cells in arena are freed with whole arena
+    if (!row->cells_in_arena)
+        free(row->cells);
+    row->cells = NULL;
+    row->cells_in_arena = false;
+    row->num_of_cells = 0;
+    row->allocated_cells = 0;
+}
+
+void free_formula_graph(FormulaStore *store)
+{
+    /**
+     * @brief Free dependency graph of formulas
+     *
+     * @param store Pointer to instance of #FormulaStore structure
+     */
+
+    free(store->dependency_start);
+    free(store->dependencies);
+    free(store->dependent_start);
+    free(store->dependents);
+    store->dependency_start = NULL;
+    store->dependencies = NULL;
+    store->dependent_start = NULL;
+    store->dependents = NULL;
+    store->graph_valid = false;
+}
+
+void init_formula_store(FormulaStore *store)
+{
+    /**
+     * @brief Initialize @p store to empty store
+     *
+     * @param store Pointer to instance of #FormulaStore structure
+     */
+
+    store->formulas = NULL;
+    store->num_of_formulas = 0;
+    store->allocated_formulas = 0;
+    store->num_of_dirty = 0;
+    store->graph_valid = false;
+    store->dependency_start = NULL;
+    store->dependencies = NULL;
+    store->dependent_start = NULL;
+    store->dependents = NULL;
+}
+
+void deallocate_formula_store(FormulaStore *store)
+{
+    /**
+     * @brief Deallocate all formulas and their graph
+     *
+     * @param store Pointer to instance of #FormulaStore structure
+     */
+
+    free_formula_graph(store);
+    free(store->formulas);
+    init_formula_store(store);
+}
+
+void spill_store_reset(SpillStore *spill)
+{
+    /**
+     * @brief Forget all pages and slots of spill store, so spill file can be reused from the beginning
+     *
+     * @param spill Pointer to instance of #SpillStore structure
+     */
+
+    for (long long int i = 0; i < spill->allocated_pages; i++)
+    {
+        spill->pages[i].last_access = 0;
+        spill->pages[i].measured_at = -1;
+        spill->pages[i].bytes = 0;
+        spill->pages[i].slot = -1;
+    }
+    spill->recent_pages[0] = spill->recent_pages[1] = -1;
+
+    spill->num_of_slots = 0;
+    spill->file_size = 0;
+
+    // Failed truncation only leaves unused space in temporary file
+    if (spill->file != NULL && ftruncate(fileno(spill->file), 0) != 0)
+        fprintf(stderr, "[WARNING] Failed to truncate spill file\n");
+}
+
+void deallocate_table(Table *table)
+{
+    /**
+     * @brief Dealocate whole table from memory
+     *
+     * Iterate over all rows and dealocate them and then free arenas
+     *
+     * @param table Pointer to instance of #Table structure
+     */
+
+    if (table->rows != NULL)
+    {
+        // Spilled rows have no cells in memory so there is no need to load them
+        for (long long int i = 0; i < table->num_of_rows; i++)
+        {
+            deallocate_row(&table->rows[i]);
+        }
+
+        free(table->rows);
+        table->rows = NULL;
+        table->num_of_rows = 0;
+        table->allocated_rows = 0;
+    }
+
+    // Spilled rows of deallocated table are never read again
+    if (table->spill != NULL)
+        spill_store_reset(table->spill);
+
+    for (int i = 0; i < table->num_of_arenas; i++)
+        arena_destroy(&table->arenas[i]);
+
+    free(table->arenas);
+    table->arenas = NULL;
+    table->num_of_arenas = 0;
+
+    deallocate_formula_store(&table->formulas);
+
+    free(table->col_types);
+    table->col_types = NULL;
+    table->num_of_col_types = 0;
+}
+
+void deallocate_raw_commands(Raw_commands *commands_store)
+{
+    /**
+     * @brief Deallocate raw commands structure
+     *
+     * @param commands_store Pointer to instance of #Raw_commands structure
+     */
+
+    if (commands_store->commands == NULL)
+        return;
+
+    for (long long int i = 0; i < commands_store->num_of_commands; i++)
+    {
+        free(commands_store->commands[i]);
+        commands_store->commands[i] = NULL;
+    }
+
+    free(commands_store->commands);
+    commands_store->commands = NULL;
+    commands_store->num_of_commands = 0;
+}
+
+void deallocate_base_commands(Commands *base_commands)
+{
+    /**
+     * @brief Deallocate content of istance @p base_commands of #Commands structure
+     *
+     * @param base_commands Pointer to instance of #Commands structure
+     */
+
+    if (base_commands->commands == NULL)
+        return;
+
+    for (long long int i = 0; i < base_commands->num_of_commands; i++)
+    {
+        free(base_commands->commands[i].function);
+        base_commands->commands[i].function = NULL;
+        free(base_commands->commands[i].arguments);
+        base_commands->commands[i].arguments = NULL;
+    }
+
+    free(base_commands->commands);
+    base_commands->commands = NULL;
+}
+
+void deallocate_temp_var_store(TempVariableStore *temp_var_store)
+{
+    /**
+     * @brief Deallocate temporary variable store
+     *
+     * @param temp_var_store Pointer to instance of #TempVariableStore structure
+     */
+
+    if (temp_var_store != NULL && temp_var_store->variables != NULL)
+    {
+        for (long long int i = 0; i < NUMBER_OF_TEMPORARY_VARIABLES; i++)
+        {
+            free(temp_var_store->variables[i]);
+            temp_var_store->variables[i] = NULL;
+        }
+
+        free(temp_var_store->variables);
+        temp_var_store->variables = NULL;
+    }
+}
+
+int allocate_pages(SpillStore *spill, long long int allocated_rows)
+{
+    /**
+     * @brief Extend array of pages to cover @p allocated_rows rows
+     *
+     * @param spill Pointer to instance of #SpillStore structure
+     * @param allocated_rows Number of rows allocated in table
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    long long int needed_pages = (allocated_rows + ROWS_PER_PAGE - 1) / ROWS_PER_PAGE;
+    if (needed_pages <= spill->allocated_pages)
+        return NO_ERROR;
+
+    // Allocate with reserve so array is not reallocated with every new rows
+    needed_pages *= 2;
+
+    RowPage *tmp = (RowPage*)realloc(spill->pages, needed_pages * sizeof(RowPage));
+    if (tmp == NULL)
+        return ALLOCATION_FAILED;
+
+    for (long long int i = spill->allocated_pages; i < needed_pages; i++)
+    {
+        tmp[i].last_access = 0;
+        tmp[i].measured_at = -1;
+        tmp[i].bytes = 0;
+        tmp[i].slot = -1;
+        tmp[i].image_hash = 0;
+    }
+
+    spill->pages = tmp;
+    spill->allocated_pages = needed_pages;
+
+    return NO_ERROR;
+}
+
+int allocate_rows(Table *table)
+{
+    /**
+     * @brief Allocate rows in table structure
+     *
+     * Allocate new rows array or extend existing one
+     *
+     * @param table Pointer to instance of #Table structure
+     *
+     * @return #NO_ERROR when table is allocated properly in other cases return #ALLOCATION_FAILED
+     */
+
+    if (table->rows == NULL)
+    {
+        table->rows = (Row*)malloc(BASE_NUMBER_OF_ROWS * sizeof(Row));
+        if (table->rows == NULL)
+            return ALLOCATION_FAILED;
+
+        table->num_of_rows = 0;
+        table->allocated_rows = BASE_NUMBER_OF_ROWS;
+    }
+    else
+    {
+        Row *tmp = (Row*)realloc(table->rows, (table->allocated_rows + BASE_NUMBER_OF_ROWS) * sizeof(Row));
+        if (tmp == NULL)
+            return ALLOCATION_FAILED;
+
+        table->allocated_rows += BASE_NUMBER_OF_ROWS;
+        table->rows = tmp;
+    }
+
+    // Set default values
+    for (long long int i = table->num_of_rows; i < table->allocated_rows; i++)
+    {
+        table->rows[i].cells = NULL;
+        table->rows[i].num_of_cells = 0;
+        table->rows[i].allocated_cells = 0;
+        table->rows[i].cells_in_arena = false;
+        table->rows[i].spill_offset = -1;
+    }
+
+    if (table->spill != NULL && allocate_pages(table->spill, table->allocated_rows) != NO_ERROR)
+        return ALLOCATION_FAILED;
+
+    return NO_ERROR;
+}
+
+int reserve_rows(Table *table, long long int num_of_rows)
+{
+    /**
+     * @brief Make sure that at least @p num_of_rows rows are allocated in table
+     *
+     * Array of rows is extended at least twice so appending many rows has linear complexity
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param num_of_rows Number of rows that must fit to table
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    if (table->rows != NULL && num_of_rows <= table->allocated_rows)
+        return NO_ERROR;
+
+    long long int new_allocated = (table->allocated_rows * 2 > num_of_rows) ? table->allocated_rows * 2 : num_of_rows;
+    if (new_allocated < BASE_NUMBER_OF_ROWS)
+        new_allocated = BASE_NUMBER_OF_ROWS;
+
+    Row *tmp = (Row*)realloc(table->rows, new_allocated * sizeof(Row));
+    if (tmp == NULL)
+        return ALLOCATION_FAILED;
+
+    if (table->rows == NULL)
+        table->num_of_rows = 0;
+
+    table->rows = tmp;
+    table->allocated_rows = new_allocated;
+
+    // Set default values
+    for (long long int i = table->num_of_rows; i < table->allocated_rows; i++)
+    {
+        table->rows[i].cells = NULL;
+        table->rows[i].num_of_cells = 0;
+        table->rows[i].allocated_cells = 0;
+        table->rows[i].cells_in_arena = false;
+        table->rows[i].spill_offset = -1;
+    }
+
+    if (table->spill != NULL && allocate_pages(table->spill, table->allocated_rows) != NO_ERROR)
+        return ALLOCATION_FAILED;
+
+    return NO_ERROR;
+}
+
+int allocate_raw_commands(Raw_commands *commands_store, long long int number_of_commands)
+{
+    /**
+     * @brief Allocate commands store
+     *
+     * @param commands_store Pointer to instance of #Raw_commands structure
+     * @param number_of_commands Number of commands we want to allocate
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on fail
+     */
+
+    commands_store->commands = (char**)malloc(number_of_commands * sizeof(char*));
+    if (commands_store->commands == NULL)
+        return ALLOCATION_FAILED;
+
+    commands_store->num_of_commands = number_of_commands;
+    return NO_ERROR;
+}
+
+int allocate_cells(Row *row)
+{
+    /**
+     * @brief Allocate cells in row
+     *
+     * Allocate cell array in instance of #Row structure or extend existing one
+     *
+     * @param row Pointer to instance of #Row structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (row->cells == NULL)
+    {
+        row->cells = (Cell*)malloc(BASE_NUMBER_OF_CELLS * sizeof(Cell));
+        if (row->cells == NULL)
+            return ALLOCATION_FAILED;
+
+        row->num_of_cells = 0;
+        row->allocated_cells = BASE_NUMBER_OF_CELLS;
+    }
+    else if (row->cells_in_arena)
+    {
+        // Cells in arena cant be reallocated so move them to heap
+        Cell *tmp = (Cell*)malloc((row->allocated_cells + BASE_NUMBER_OF_CELLS) * sizeof(Cell));
+        if (tmp == NULL)
+            return ALLOCATION_FAILED;
+
+        memcpy(tmp, row->cells, row->num_of_cells * sizeof(Cell));
+        row->allocated_cells += BASE_NUMBER_OF_CELLS;
+        row->cells = tmp;
+        row->cells_in_arena = false;
+    }
+    else
+    {
+        Cell *tmp = (Cell*)realloc(row->cells, (row->allocated_cells + BASE_NUMBER_OF_CELLS) * sizeof(Cell));
+        if (tmp == NULL)
+            return ALLOCATION_FAILED;
+
+        row->allocated_cells += BASE_NUMBER_OF_CELLS;
+        row->cells = tmp;
+    }
+
+    // Set default values
+    for (long long int i = row->num_of_cells; i < row->allocated_cells; i++)
+    {
+        row->cells[i].content = NULL;
+        row->cells[i].allocated_chars = 0;
+        row->cells[i].in_arena = false;
+    }
+
+    return NO_ERROR;
+}
+
+int allocate_content(Cell *cell)
+{
+    /**
+     * @brief Allocate content in cell
+     *
+     * Allocate content (char array) in instance of #Cell strucutre or extend existing one
+     *
+     * @param cell Pointer to instance of #Cell structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (cell->content == NULL)
+    {
+        cell->content = (char*)malloc(BASE_CELL_LENGTH * sizeof(char));
+        if (cell->content == NULL)
+            return ALLOCATION_FAILED;
+
+        cell->allocated_chars = BASE_CELL_LENGTH * sizeof(char);
+        memset(cell->content, 0, cell->allocated_chars);
+    }
+    else if (cell->in_arena)
+    {
+        // Content in arena cant be reallocated so move it to heap
+        char *tmp = (char*)malloc((cell->allocated_chars + BASE_CELL_LENGTH) * sizeof(char));
+        if (tmp == NULL)
+            return ALLOCATION_FAILED;
+
+        cell->allocated_chars += BASE_CELL_LENGTH;
+        memset(tmp, 0, cell->allocated_chars);
+        strcpy(tmp, cell->content);
+
+        cell->content = tmp;
+        cell->in_arena = false;
+    }
+    else
+    {
+        char *temp = NULL;
+        if (string_copy(&cell->content, &temp) != NO_ERROR)
+            return ALLOCATION_FAILED;
+
+        char *tmp = (char*)realloc(cell->content, (cell->allocated_chars + BASE_CELL_LENGTH) * sizeof(char));
+        if (tmp == NULL)
+        {
+            free(temp);
+            return ALLOCATION_FAILED;
+        }
+
+        cell->allocated_chars += BASE_CELL_LENGTH;
+        cell->content = tmp;
+
+        memset(cell->content, 0, cell->allocated_chars);
+        strcpy(cell->content, temp);
+        free(temp);
+    }
+
+    return NO_ERROR;
+}
+
+int write_row_binary(Row *row, FILE *file)
+{
+    /**
+     * @brief Write row to file in binary form
+     *
+     * Row is written as number of cells followed by length and content of each cell
+     *
+     * @param row Pointer to instance of #Row structure
+     * @param file Pointer to output file
+     *
+     * @return #NO_ERROR on success, #IO_ERROR on error
+     */
+
+    if (fwrite(&row->num_of_cells, sizeof(long long int), 1, file) != 1)
+        return IO_ERROR;
+
+    for (long long int i = 0; i < row->num_of_cells; i++)
+    {
+        long long int length = (row->cells[i].content != NULL) ? (long long int)strlen(row->cells[i].content) : 0;
+
+        if (fwrite(&length, sizeof(long long int), 1, file) != 1)
+            return IO_ERROR;
+
+        if (length > 0 && fwrite(row->cells[i].content, sizeof(char), length, file) != (size_t)length)
+            return IO_ERROR;
+    }
+
+    return NO_ERROR;
+}
+
+int read_row_binary(Row *row, FILE *file)
+{
+    /**
+     * @brief Read row written by #write_row_binary from file
+     *
+     * @param row Pointer to instance of #Row structure (should be empty)
+     * @param file Pointer to input file
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    long long int num_of_cells;
+    if (fread(&num_of_cells, sizeof(long long int), 1, file) != 1 || num_of_cells < 0)
+        return IO_ERROR;
+
+    for (long long int i = 0; i < num_of_cells; i++)
+    {
+        long long int length;
+        if (fread(&length, sizeof(long long int), 1, file) != 1 || length < 0)
+            return IO_ERROR;
+
+        if (row->cells == NULL || row->num_of_cells == row->allocated_cells)
+            if (allocate_cells(row) != NO_ERROR)
+                return ALLOCATION_FAILED;
+
+        Cell *cell = &row->cells[row->num_of_cells];
+        cell->content = (char*)malloc((length + 1) * sizeof(char));
+        if (cell->content == NULL)
+            return ALLOCATION_FAILED;
+
+        cell->allocated_chars = length + 1;
+        row->num_of_cells++;
+
+        if (length > 0 && fread(cell->content, sizeof(char), length, file) != (size_t)length)
+            return IO_ERROR;
+        cell->content[length] = '\0';
+    }
+
+    return NO_ERROR;
+}
+
+int spill_store_init(SpillStore *spill, long long int budget)
+{
+    /**
+     * @brief Init store for spilled rows
+     *
+     * @param spill Pointer to instance of #SpillStore structure
+     * @param budget Memory budget for cells of table in bytes
+     *
+     * @return #NO_ERROR on success, #IO_ERROR when temporary file cant be created
+     */
+
+    spill->file = tmpfile();
+    if (spill->file == NULL)
+        return IO_ERROR;
+
+    spill->budget = budget;
+    spill->tick = 0;
+    spill->pages = NULL;
+    spill->allocated_pages = 0;
+    spill->recent_pages[0] = spill->recent_pages[1] = -1;
+    spill->slots = NULL;
+    spill->num_of_slots = 0;
+    spill->allocated_slots = 0;
+    spill->file_size = 0;
+
+    return NO_ERROR;
+}
+
+void spill_store_destroy(SpillStore *spill)
+{
+    /**
+     * @brief Close temporary file and deallocate pages of spill store
+     *
+     * @param spill Pointer to instance of #SpillStore structure
+     */
+
+    if (spill->file != NULL)
+        fclose(spill->file);
+    spill->file = NULL;
+
+    free(spill->pages);
+    spill->pages = NULL;
+    spill->allocated_pages = 0;
+
+    free(spill->slots);
+    spill->slots = NULL;
+    spill->num_of_slots = 0;
+    spill->allocated_slots = 0;
+}
+
+long long int measure_page(Table *table, long long int page)
+{
+    /**
+     * @brief Get number of bytes used by cells of resident rows in @p page
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param page Index of page
+     *
+     * @return Number of used bytes
+     */
+
+    long long int bytes = 0;
+
+    for (long long int i = page * ROWS_PER_PAGE; (i < (page + 1) * ROWS_PER_PAGE) && (i < table->num_of_rows); i++)
+    {
+        Row *row = &table->rows[i];
+        if (row->cells == NULL)
+            continue;
+
+        bytes += row->allocated_cells * (long long int)sizeof(Cell);
+        for (long long int j = 0; j < row->num_of_cells; j++)
+            bytes += row->cells[j].allocated_chars;
+    }
+
+    return bytes;
+}
+
+uint64_t hash_bytes(const char *data, size_t length, uint64_t seed)
+{
+    /**
+     * @brief Compute fast non-cryptographic 64-bit hash of @p data
+     *
+     * Data are read by 8 bytes that are mixed by multiplication and xor-shift, final value is mixed by splitmix64 finalizer
+     *
+     * @param data Hashed data
+     * @param length Length of @p data
+     * @param seed Seed of hash
+     *
+     * @return Hash of data
+     */
+
+    const uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+    uint64_t hash = seed ^ (length * multiplier);
+
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ (word * multiplier)) * 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 29;
+    }
+
+    if (i < length)
+    {
+        uint64_t word = 0;
+        memcpy(&word, data + i, length - i);
+        hash = (hash ^ (word * multiplier)) * 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 29;
+    }
+
+    hash ^= hash >> 30;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94D049BB133111EBULL;
+    hash ^= hash >> 31;
+
+    return hash;
+}
+
+long long int find_spill_slot(SpillStore *spill, off_t offset)
+{
+    /**
+     * @brief Find slot of spill file that contains @p offset
+     *
+     * @param spill Pointer to instance of #SpillStore structure
+     * @param offset Offset in spill file
+     *
+     * @return Index of slot, -1 if no slot contains offset
+     */
+
+    long long int low = 0, high = spill->num_of_slots - 1;
+
+    while (low <= high)
+    {
+        long long int middle = low + (high - low) / 2;
+
+        if (offset < spill->slots[middle].offset)
+            high = middle - 1;
+        else if (offset >= spill->slots[middle].offset + spill->slots[middle].capacity)
+            low = middle + 1;
+        else
+            return middle;
+    }
+
+    return -1;
+}
+
+void release_spilled_row(SpillStore *spill, Row *row)
+{
+    /**
+     * @brief Mark that cells of spilled @p row are no longer needed in spill file
+     *
+     * @param spill Pointer to instance of #SpillStore structure
+     * @param row Pointer to instance of #Row structure
+     */
+
+    if (row->spill_offset < 0)
+        return;
+
+    long long int slot = find_spill_slot(spill, row->spill_offset);
+    if (slot >= 0)
+        spill->slots[slot].live_rows--;
+
+    row->spill_offset = -1;
+}
+
+long long int acquire_spill_slot(SpillStore *spill, long long int page, long long int size)
+{
+    /**
+     * @brief Get slot of at least @p size bytes for @p page
+     *
+     * Smallest free slot that is big enough is reused, new slot is appended to end of spill file only when there is none
+     *
+     * @param spill Pointer to instance of #SpillStore structure
+     * @param page Index of page that will own slot
+     * @param size Number of bytes of rows of page
+     *
+     * @return Index of slot, -1 on allocation error
+     */
+
+    long long int best = -1;
+
+    for (long long int i = 0; i < spill->num_of_slots; i++)
+    {
+        SpillSlot *slot = &spill->slots[i];
+        if (slot->page == -1 && slot->live_rows == 0 && slot->capacity >= size && (best == -1 || slot->capacity < spill->slots[best].capacity))
+            best = i;
+    }
+
+    if (best == -1)
+    {
+        if (spill->num_of_slots == spill->allocated_slots)
+        {
+            long long int allocated = (spill->allocated_slots > 0) ? spill->allocated_slots * 2 : BASE_NUMBER_OF_KEYS;
+            SpillSlot *tmp = (SpillSlot*)realloc(spill->slots, (size_t)allocated * sizeof(SpillSlot));
+            if (tmp == NULL)
+                return -1;
+
+            spill->slots = tmp;
+            spill->allocated_slots = allocated;
+        }
+
+        // Reserve for growth of page, so small change doesnt need new slot
+        long long int capacity = size + size / 4;
+        capacity = (capacity + SPILL_SLOT_ALIGNMENT - 1) / SPILL_SLOT_ALIGNMENT * SPILL_SLOT_ALIGNMENT;
+
+        // Slots are appended to end of file, so array stays sorted by offset
+        best = spill->num_of_slots++;
+        spill->slots[best].offset = spill->file_size;
+        spill->slots[best].capacity = capacity;
+        spill->slots[best].live_rows = 0;
+        spill->file_size += (off_t)capacity;
+    }
+
+    spill->slots[best].used = 0;
+    spill->slots[best].page = page;
+
+    return best;
+}
+
+int spill_page(Table *table, long long int page)
+{
+    /**
+     * @brief Write all resident rows of @p page to its slot in spill file and free their cells
+     *
+     * Rows are serialized to memory first, when they are same as rows that were last written to or read from slot of page
+     * (page is clean) they are only dropped from memory without writing \n
+     * Slot is rewritten in place when it is big enough and no spilled row of other page points to it
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param page Index of page
+     *
+     * @return #NO_ERROR on success, #IO_ERROR or #ALLOCATION_FAILED on error
+     */
+
+    int ret_val = NO_ERROR;
+    SpillStore *spill = table->spill;
+    RowPage *row_page = &spill->pages[page];
+
+    long long int first = page * ROWS_PER_PAGE;
+    long long int end = (first + ROWS_PER_PAGE < table->num_of_rows) ? first + ROWS_PER_PAGE : table->num_of_rows;
+
+    // Position of each row in image of page (-1 if row isnt written)
+    off_t positions[ROWS_PER_PAGE];
+    char *image = NULL;
+    size_t size = 0;
+
+    FILE *stream = open_memstream(&image, &size);
+    if (stream == NULL)
+        return IO_ERROR;
+
+    long long int num_of_written = 0;
+
+    for (long long int i = first; i < end && ret_val == NO_ERROR; i++)
+    {
+        Row *row = &table->rows[i];
+        positions[i - first] = -1;
+
+        if (row->cells == NULL || row->spill_offset >= 0)
+            continue;
+
+        if ((positions[i - first] = ftello(stream)) < 0 || write_row_binary(row, stream) != NO_ERROR)
+            ret_val = IO_ERROR;
+        num_of_written++;
+    }
+
+    if (fclose(stream) != 0 && ret_val == NO_ERROR)
+        ret_val = IO_ERROR;
+
+    if (ret_val != NO_ERROR || num_of_written == 0)
+    {
+        free(image);
+        return ret_val;
+    }
+
+    uint64_t hash = hash_bytes(image, size, 0);
+    long long int slot = row_page->slot;
+
+    if (slot < 0 || spill->slots[slot].used != (long long int)size || row_page->image_hash != hash)
+    {
+        // Old image can still hold rows that were moved to other page, so it is kept until they are loaded
+        if (slot < 0 || spill->slots[slot].live_rows > 0 || spill->slots[slot].capacity < (long long int)size)
+        {
+            if (slot >= 0)
+                spill->slots[slot].page = -1;
+
+            if ((slot = acquire_spill_slot(spill, page, (long long int)size)) < 0)
+            {
+                row_page->slot = -1;
+                free(image);
+                return ALLOCATION_FAILED;
+            }
+            row_page->slot = slot;
+        }
+
+        int fd = fileno(spill->file);
+        for (size_t written = 0; written < size;)
+        {
+            ssize_t ret = pwrite(fd, image + written, size - written, spill->slots[slot].offset + (off_t)written);
+            if (ret < 0 && errno == EINTR)
+                continue;
+            if (ret <= 0)
+            {
+                // Slot contains partially written image that must not be considered clean
+                spill->slots[slot].used = 0;
+                free(image);
+                return IO_ERROR;
+            }
+            written += (size_t)ret;
+        }
+
+        spill->slots[slot].used = (long long int)size;
+        row_page->image_hash = hash;
+    }
+
+    free(image);
+
+    for (long long int i = first; i < end; i++)
+    {
+        if (positions[i - first] < 0)
+            continue;
+
+        Row *row = &table->rows[i];
+        deallocate_row(row);
+        row->spill_offset = spill->slots[slot].offset + positions[i - first];
+        spill->slots[slot].live_rows++;
+    }
+
+    row_page->bytes = 0;
+    row_page->measured_at = spill->tick;
+
+    return NO_ERROR;
+}
+
+int fault_page(Table *table, long long int page)
+{
+    /**
+     * @brief Load all spilled rows of @p page back to memory
+     *
+     * Slot of page keeps its image, so page that isnt changed before it is spilled again isnt written
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param page Index of page
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+    SpillStore *spill = table->spill;
+    int fd = fileno(spill->file);
+
+    char *image = NULL;
+    FILE *stream = NULL;
+    long long int loaded_slot = -1;
+
+    for (long long int i = page * ROWS_PER_PAGE; (i < (page + 1) * ROWS_PER_PAGE) && (i < table->num_of_rows) && ret_val == NO_ERROR; i++)
+    {
+        Row *row = &table->rows[i];
+        if (row->spill_offset < 0)
+            continue;
+
+        // Rows moved from other pages point to slots of those pages
+        long long int slot = find_spill_slot(spill, row->spill_offset);
+        if (slot < 0)
+        {
+            ret_val = IO_ERROR;
+            break;
+        }
+
+        if (slot != loaded_slot)
+        {
+            if (stream != NULL)
+                fclose(stream);
+            stream = NULL;
+            loaded_slot = -1;
+
+            size_t used = (size_t)spill->slots[slot].used;
+            char *tmp = (char*)realloc(image, used);
+            if (tmp == NULL)
+            {
+                ret_val = ALLOCATION_FAILED;
+                break;
+            }
+            image = tmp;
+
+            for (size_t loaded = 0; loaded < used && ret_val == NO_ERROR;)
+            {
+                ssize_t ret = pread(fd, image + loaded, used - loaded, spill->slots[slot].offset + (off_t)loaded);
+                if (ret < 0 && errno == EINTR)
+                    continue;
+                if (ret <= 0)
+                    ret_val = IO_ERROR;
+                else
+                    loaded += (size_t)ret;
+            }
+
+            if (ret_val == NO_ERROR && (stream = fmemopen(image, used, "rb")) == NULL)
+                ret_val = IO_ERROR;
+            if (ret_val != NO_ERROR)
+                break;
+
+            loaded_slot = slot;
+        }
+
+        if (fseeko(stream, row->spill_offset - spill->slots[slot].offset, SEEK_SET) != 0)
+        {
+            ret_val = IO_ERROR;
+            break;
+        }
+
+        if ((ret_val = read_row_binary(row, stream)) != NO_ERROR)
+            break;
+
+        release_spilled_row(spill, row);
+    }
+
+    if (stream != NULL)
+        fclose(stream);
+    free(image);
+
+    // Page was changed so it has to be measured again
+    spill->pages[page].measured_at = -1;
+
+    return ret_val;
+}
+
+int enforce_memory_budget(Table *table, long long int loading_page)
+{
+    /**
+     * @brief Spill least recently used pages until cells of table fit to memory budget
+     *
+     * Two most recently used pages and @p loading_page are never spilled
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param loading_page Index of page that is going to be loaded (-1 if none)
+     *
+     * @return #NO_ERROR on success, #IO_ERROR on error
+     */
+
+    SpillStore *spill = table->spill;
+    if (spill == NULL)
+        return NO_ERROR;
+
+    long long int used_pages = (table->num_of_rows + ROWS_PER_PAGE - 1) / ROWS_PER_PAGE;
+    if (used_pages > spill->allocated_pages)
+        used_pages = spill->allocated_pages;
+
+    long long int resident_bytes = 0;
+
+    // Only pages accessed since last measurement can change their size
+    for (long long int i = 0; i < used_pages; i++)
+    {
+        if (spill->pages[i].measured_at < spill->pages[i].last_access)
+        {
+            spill->pages[i].bytes = measure_page(table, i);
+            spill->pages[i].measured_at = spill->tick;
+        }
+
+        resident_bytes += spill->pages[i].bytes;
+    }
+
+    while (resident_bytes > spill->budget)
+    {
+        long long int victim = -1;
+
+        for (long long int i = 0; i < used_pages; i++)
+        {
+            if (spill->pages[i].bytes == 0 || i == loading_page || i == spill->recent_pages[0] || i == spill->recent_pages[1])
+                continue;
+
+            if (victim == -1 || spill->pages[i].last_access < spill->pages[victim].last_access)
+                victim = i;
+        }
+
+        // Everything that can be spilled is already spilled
+        if (victim == -1)
+            break;
+
+        resident_bytes -= spill->pages[victim].bytes;
+
+        if (spill_page(table, victim) != NO_ERROR)
+            return IO_ERROR;
+    }
+
+    return NO_ERROR;
+}
+
+Row *get_row(Table *table, long long int index)
+{
+    /**
+     * @brief Get row of @p table on @p index
+     *
+     * When memory budget is set then access to row is recorded and if row is spilled then its whole page is loaded back \n
+     * Loading of page can spill other least recently used pages
+     * @warning
+     * Program is terminated when spilled rows cant be loaded back because there is no way to continue without them
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param index Index of row
+     *
+     * @return Pointer to row
+     */
+
+    SpillStore *spill = table->spill;
+    if (spill == NULL)
+        return &table->rows[index];
+
+    long long int page = index / ROWS_PER_PAGE;
+
+    if (table->rows[index].spill_offset >= 0)
+    {
+        if (enforce_memory_budget(table, page) != NO_ERROR || fault_page(table, page) != NO_ERROR)
+        {
+            fprintf(stderr, "Failed to load spilled rows\n");
+            exit(IO_ERROR);
+        }
+    }
+
+    spill->pages[page].last_access = ++spill->tick;
+
+    if (spill->recent_pages[0] != page)
+    {
+        spill->recent_pages[1] = spill->recent_pages[0];
+        spill->recent_pages[0] = page;
+    }
+
+    return &table->rows[index];
+}
+
+long long int get_line(char **line_buffer, FILE *file)
+{
+    /**
+     * @brief Load one line from file
+     *
+     * Load one line from file and save it to buffer
+     *
+     * @param line_buffer Empty pointer to char pointer where will be saved loaded line
+     * @param file Pointer to file from which will be line loaded
+     *
+     * @return Number of alloacated bits in memory or -1 when there is nothing else to load
+     */
+
+    int c;
+    long long int index = 0;
+    long long int allocated = 16;
+
+    *line_buffer = NULL;
+
+    *line_buffer = (char*)malloc(allocated);
+    if (!*line_buffer)
+        return 0;
+
+    while ((c = fgetc(file)) != '\n' && c != EOF)
+    {
+        // Save loaded char to char array
+        (*line_buffer)[index++] = (char)c;
+
+        // If there is no space in allocated array try to reallocate it to larger array
+        // +1 for end string bit
+        if (index + 1 >= allocated)
+        {
+            char *tmp = (char*)realloc (*line_buffer, allocated + 16);
+
+            // If reallocating failed free already used memory and return
+            if (!tmp)
+            {
+                free(*line_buffer);
+                *line_buffer = NULL;
+                return 0;
+            }
+
+            *line_buffer = tmp;
+            allocated += 16;
+        }
+    }
+
+    // To the end add end string bit
+    (*line_buffer)[index] = 0;
+
+    // If we are here and no char is saved and current char in buffer is eof then there is nothing to load
+    if (index == 0 && c == EOF) {
+        free (*line_buffer);
+        *line_buffer = NULL;
+        return -1;
+    }
+
+    return allocated;
+}
+
+int io_ring_init(IORing *ring, int fd)
+{
+    /**
+     * @brief Init ring of IO buffers
+     *
+     * Allocate aligned buffers and init synchronization primitives
+     *
+     * @param ring Pointer to instance of #IORing structure
+     * @param fd File descriptor of file that will be read or written
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    ring->produced = 0;
+    ring->consumed = 0;
+    ring->fd = fd;
+    ring->offset = 0;
+    ring->end = -1;
+    ring->error = NO_ERROR;
+    ring->stop = false;
+    ring->threaded = false;
+
+    for (int i = 0; i < NUMBER_OF_IO_BUFFERS; i++)
+    {
+        ring->buffers[i].length = 0;
+        ring->buffers[i].last = false;
+
+        void *data = NULL;
+        if (posix_memalign(&data, IO_BUFFER_ALIGNMENT, IO_BUFFER_SIZE) != 0)
+        {
+            for (int j = 0; j < i; j++)
+                free(ring->buffers[j].data);
+            return ALLOCATION_FAILED;
+        }
+
+        ring->buffers[i].data = (char*)data;
+    }
+
+    if (pthread_mutex_init(&ring->lock, NULL) != 0)
+    {
+        for (int i = 0; i < NUMBER_OF_IO_BUFFERS; i++)
+            free(ring->buffers[i].data);
+        return FUNCTION_ERROR;
+    }
+
+    if (pthread_cond_init(&ring->changed, NULL) != 0)
+    {
+        pthread_mutex_destroy(&ring->lock);
+        for (int i = 0; i < NUMBER_OF_IO_BUFFERS; i++)
+            free(ring->buffers[i].data);
+        return FUNCTION_ERROR;
+    }
+
+    return NO_ERROR;
+}
+
+void io_ring_destroy(IORing *ring)
+{
+    /**
+     * @brief Deallocate buffers of ring and destroy synchronization primitives
+     *
+     * @param ring Pointer to instance of #IORing structure
+     */
+
+    for (int i = 0; i < NUMBER_OF_IO_BUFFERS; i++)
+    {
+        free(ring->buffers[i].data);
+        ring->buffers[i].data = NULL;
+    }
+
+    pthread_cond_destroy(&ring->changed);
+    pthread_mutex_destroy(&ring->lock);
+}
+
+IOBuffer *io_ring_acquire_free(IORing *ring)
+{
+    /**
+     * @brief Get buffer that producer can fill
+     *
+     * Block until there is free buffer in ring
+     *
+     * @param ring Pointer to instance of #IORing structure
+     *
+     * @return Pointer to free buffer or NULL when ring was stopped
+     */
+
+    IOBuffer *buffer = NULL;
+
+    pthread_mutex_lock(&ring->lock);
+    while (!ring->stop && (ring->produced - ring->consumed) >= NUMBER_OF_IO_BUFFERS)
+        pthread_cond_wait(&ring->changed, &ring->lock);
+
+    if (!ring->stop)
+        buffer = &ring->buffers[ring->produced % NUMBER_OF_IO_BUFFERS];
+    pthread_mutex_unlock(&ring->lock);
+
+    return buffer;
+}
+
+void io_ring_publish(IORing *ring)
+{
+    /**
+     * @brief Hand buffer acquired by #io_ring_acquire_free to consumer
+     *
+     * @param ring Pointer to instance of #IORing structure
+     */
+
+    pthread_mutex_lock(&ring->lock);
+    ring->produced++;
+    pthread_cond_broadcast(&ring->changed);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+IOBuffer *io_ring_acquire_filled(IORing *ring)
+{
+    /**
+     * @brief Get buffer that was published by producer
+     *
+     * Block until there is filled buffer in ring
+     *
+     * @param ring Pointer to instance of #IORing structure
+     *
+     * @return Pointer to filled buffer or NULL when ring was stopped
+     */
+
+    IOBuffer *buffer = NULL;
+
+    pthread_mutex_lock(&ring->lock);
+    while (!ring->stop && ring->consumed >= ring->produced)
+        pthread_cond_wait(&ring->changed, &ring->lock);
+
+    if (ring->consumed < ring->produced)
+        buffer = &ring->buffers[ring->consumed % NUMBER_OF_IO_BUFFERS];
+    pthread_mutex_unlock(&ring->lock);
+
+    return buffer;
+}
+
+void io_ring_release(IORing *ring)
+{
+    /**
+     * @brief Return buffer acquired by #io_ring_acquire_filled back to producer
+     *
+     * @param ring Pointer to instance of #IORing structure
+     */
+
+    pthread_mutex_lock(&ring->lock);
+    ring->consumed++;
+    pthread_cond_broadcast(&ring->changed);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+void io_ring_stop(IORing *ring)
+{
+    /**
+     * @brief Wake up and stop IO thread and wait for it to finish
+     *
+     * @param ring Pointer to instance of #IORing structure
+     */
+
+    if (!ring->threaded)
+        return;
+
+    pthread_mutex_lock(&ring->lock);
+    ring->stop = true;
+    pthread_cond_broadcast(&ring->changed);
+    pthread_mutex_unlock(&ring->lock);
+
+    pthread_join(ring->thread, NULL);
+    ring->threaded = false;
+}
+
+_Bool read_ahead_fill_buffer(IORing *ring)
+{
+    /**
+     * @brief Fill next free buffer in ring with data from file
+     *
+     * @param ring Pointer to instance of #IORing structure
+     *
+     * @return true if end of file was reached (or reading failed), false if there is more to read
+     */
+
+    IOBuffer *buffer = io_ring_acquire_free(ring);
+    if (buffer == NULL)
+        return true;
+
+    buffer->length = 0;
+    buffer->last = false;
+
+    while (buffer->length < IO_BUFFER_SIZE)
+    {
+        size_t space = IO_BUFFER_SIZE - buffer->length;
+        if (ring->end >= 0 && (off_t)space > ring->end - ring->offset)
+            space = (size_t)(ring->end - ring->offset);
+
+        if (space == 0)
+        {
+            buffer->last = true;
+            break;
+        }
+
+        ssize_t loaded = pread(ring->fd, buffer->data + buffer->length, space, ring->offset);
+        if (loaded < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            ring->error = IO_ERROR;
+            buffer->last = true;
+            break;
+        }
+
+        if (loaded == 0)
+        {
+            buffer->last = true;
+            break;
+        }
+
+        buffer->length += (size_t)loaded;
+        ring->offset += loaded;
+    }
+
+    _Bool last = buffer->last;
+    io_ring_publish(ring);
+
+    return last;
+}
+
+void *read_ahead_thread(void *arg)
+{
+    /**
+     * @brief Body of read-ahead thread
+     *
+     * Fill buffers in ring until end of file is reached
+     *
+     * @param arg Pointer to instance of #IORing structure
+     *
+     * @return NULL
+     */
+
+    IORing *ring = (IORing*)arg;
+    while (!read_ahead_fill_buffer(ring));
+
+    return NULL;
+}
+
+int read_ahead_open(ReadAheadReader *reader, const char *path, off_t offset, off_t end)
+{
+    /**
+     * @brief Open file and start read-ahead thread
+     *
+     * If thread cant be started then file will be read synchronously
+     *
+     * @param reader Pointer to instance of #ReadAheadReader structure
+     * @param path Path to input file
+     * @param offset Offset in file where reading will start
+     * @param end Offset in file where reading stops (-1 to read until end of file)
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return CANT_OPEN_FILE;
+
+    if ((ret_val = io_ring_init(&reader->ring, fd)) != NO_ERROR)
+    {
+        close(fd);
+        return ret_val;
+    }
+
+    reader->ring.offset = offset;
+    reader->ring.end = end;
+    reader->current = NULL;
+    reader->position = 0;
+    reader->finished = false;
+    reader->consumed = offset;
+    reader->line_complete = false;
+
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    if (pthread_create(&reader->ring.thread, NULL, read_ahead_thread, &reader->ring) == 0)
+        reader->ring.threaded = true;
+
+    return NO_ERROR;
+}
+
+int read_ahead_close(ReadAheadReader *reader)
+{
+    /**
+     * @brief Stop read-ahead thread and close file
+     *
+     * @param reader Pointer to instance of #ReadAheadReader structure
+     *
+     * @return #NO_ERROR when whole file was read without error, #IO_ERROR if reading failed
+     */
+
+    io_ring_stop(&reader->ring);
+
+    int ret_val = reader->ring.error;
+
+    close(reader->ring.fd);
+    io_ring_destroy(&reader->ring);
+    reader->current = NULL;
+
+    return ret_val;
+}
+
+long long int read_ahead_get_line(ReadAheadReader *reader, char **line_buffer)
+{
+    /**
+     * @brief Load one line from read-ahead buffers
+     *
+     * Same behaviour as #get_line, but data are taken from buffers filled by read-ahead thread
+     *
+     * @param reader Pointer to instance of #ReadAheadReader structure
+     * @param line_buffer Empty pointer to char pointer where will be saved loaded line
+     *
+     * @return Number of alloacated bits in memory or -1 when there is nothing else to load
+     */
+
+    long long int index = 0;
+    long long int allocated = BASE_LINE_LENGTH;
+    _Bool found_newline = false;
+
+    *line_buffer = (char*)malloc(allocated);
+    if (!*line_buffer)
+        return 0;
+
+    while (!found_newline)
+    {
+        if (reader->current == NULL)
+        {
+            if (reader->finished)
+                break;
+
+            // Without read-ahead thread we have to fill buffer ourself
+            if (!reader->ring.threaded)
+                read_ahead_fill_buffer(&reader->ring);
+
+            reader->current = io_ring_acquire_filled(&reader->ring);
+            reader->position = 0;
+
+            if (reader->current == NULL)
+            {
+                reader->finished = true;
+                break;
+            }
+        }
+
+        char *start = reader->current->data + reader->position;
+        size_t available = reader->current->length - reader->position;
+        char *newline = (char*)memchr(start, '\n', available);
+        size_t chunk_length = (newline != NULL) ? (size_t)(newline - start) : available;
+
+        // +1 for end string bit
+        if (index + (long long int)chunk_length + 1 > allocated)
+        {
+            long long int new_allocated = allocated * 2;
+            if (new_allocated < index + (long long int)chunk_length + 1)
+                new_allocated = index + (long long int)chunk_length + 1;
+
+            char *tmp = (char*)realloc(*line_buffer, new_allocated);
+            if (!tmp)
+            {
+                free(*line_buffer);
+                *line_buffer = NULL;
+                return 0;
+            }
+
+            *line_buffer = tmp;
+            allocated = new_allocated;
+        }
+
+        memcpy(*line_buffer + index, start, chunk_length);
+        index += (long long int)chunk_length;
+        reader->position += chunk_length;
+        reader->consumed += (off_t)chunk_length;
+
+        if (newline != NULL)
+        {
+            reader->position++;
+            reader->consumed++;
+            found_newline = true;
+        }
+
+        // Whole buffer is parsed so give it back to read-ahead thread
+        if (reader->position >= reader->current->length)
+        {
+            if (reader->current->last)
+                reader->finished = true;
+
+            io_ring_release(&reader->ring);
+            reader->current = NULL;
+        }
+    }
+
+    // To the end add end string bit
+    (*line_buffer)[index] = 0;
+    reader->line_complete = found_newline;
+
+    // Nothing was loaded and there is nothing else to load
+    if (index == 0 && !found_newline)
+    {
+        free(*line_buffer);
+        *line_buffer = NULL;
+        return -1;
+    }
+
+    return allocated;
+}
+
+_Bool write_behind_flush_buffer(IORing *ring)
+{
+    /**
+     * @brief Write next filled buffer in ring to file
+     *
+     * When writing fails all following buffers are only released
+     *
+     * @param ring Pointer to instance of #IORing structure
+     *
+     * @return true if last buffer was processed, false if there are more buffers to come
+     */
+
+    IOBuffer *buffer = io_ring_acquire_filled(ring);
+    if (buffer == NULL)
+        return true;
+
+    size_t written = 0;
+    while (ring->error == NO_ERROR && written < buffer->length)
+    {
+        ssize_t ret = pwrite(ring->fd, buffer->data + written, buffer->length - written, ring->offset);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            ring->error = IO_ERROR;
+            break;
+        }
+
+        written += (size_t)ret;
+        ring->offset += ret;
+    }
+
+    _Bool last = buffer->last;
+    io_ring_release(ring);
+
+    return last;
+}
+
+void *write_behind_thread(void *arg)
+{
+    /**
+     * @brief Body of write-behind thread
+     *
+     * Write buffers from ring until last one is written
+     *
+     * @param arg Pointer to instance of #IORing structure
+     *
+     * @return NULL
+     */
+
+    IORing *ring = (IORing*)arg;
+    while (!write_behind_flush_buffer(ring));
+
+    return NULL;
+}
+
+int write_behind_open(WriteBehindWriter *writer, const char *path)
+{
+    /**
+     * @brief Open (truncate) file and start write-behind thread
+     *
+     * If thread cant be started then file will be written synchronously
+     *
+     * @param writer Pointer to instance of #WriteBehindWriter structure
+     * @param path Path to output file
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val;
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+        return CANT_OPEN_FILE;
+
+    if ((ret_val = io_ring_init(&writer->ring, fd)) != NO_ERROR)
+    {
+        close(fd);
+        return ret_val;
+    }
+
+    writer->current = NULL;
+
+    if (pthread_create(&writer->ring.thread, NULL, write_behind_thread, &writer->ring) == 0)
+        writer->ring.threaded = true;
+
+    return NO_ERROR;
+}
+
+void write_behind_publish(WriteBehindWriter *writer)
+{
+    /**
+     * @brief Hand current buffer to write-behind thread
+     *
+     * @param writer Pointer to instance of #WriteBehindWriter structure
+     */
+
+    io_ring_publish(&writer->ring);
+    writer->current = NULL;
+
+    // Without write-behind thread we have to write buffer ourself
+    if (!writer->ring.threaded)
+        write_behind_flush_buffer(&writer->ring);
+}
+
+void write_behind_put(WriteBehindWriter *writer, const char *data, size_t length)
+{
+    /**
+     * @brief Append data to output
+     *
+     * @param writer Pointer to instance of #WriteBehindWriter structure
+     * @param data Data to write
+     * @param length Length of @p data
+     */
+
+    while (length > 0)
+    {
+        if (writer->current == NULL)
+        {
+            writer->current = io_ring_acquire_free(&writer->ring);
+            writer->current->length = 0;
+            writer->current->last = false;
+        }
+
+        size_t space = IO_BUFFER_SIZE - writer->current->length;
+        size_t chunk_length = (length < space) ? length : space;
+
+        memcpy(writer->current->data + writer->current->length, data, chunk_length);
+        writer->current->length += chunk_length;
+        data += chunk_length;
+        length -= chunk_length;
+
+        if (writer->current->length == IO_BUFFER_SIZE)
+            write_behind_publish(writer);
+    }
+}
+
+int write_behind_close(WriteBehindWriter *writer)
+{
+    /**
+     * @brief Flush rest of data, wait for write-behind thread and close file
+     *
+     * @param writer Pointer to instance of #WriteBehindWriter structure
+     *
+     * @return #NO_ERROR when all data were written, #IO_ERROR if writing failed
+     */
+
+    if (writer->current == NULL)
+    {
+        writer->current = io_ring_acquire_free(&writer->ring);
+        writer->current->length = 0;
+    }
+
+    writer->current->last = true;
+    write_behind_publish(writer);
+
+    if (writer->ring.threaded)
+    {
+        pthread_join(writer->ring.thread, NULL);
+        writer->ring.threaded = false;
+    }
+
+    int ret_val = writer->ring.error;
+
+    if (close(writer->ring.fd) != 0 && ret_val == NO_ERROR)
+        ret_val = IO_ERROR;
+
+    io_ring_destroy(&writer->ring);
+
+    return ret_val;
+}
+
+int parse_options(int argc, char *argv[], Options *options)
+{
+    /**
+     * @brief Parse program arguments
+     *
+     * Arguments have form: [-d DELIM] [-o OUTPUT] [-t STATE] [-m MEGABYTES] [--threads N] [--shards N] [--checkpoint PATH | --restart PATH] [--watch MILLISECONDS] [--publish NAME] [--serve SOCKET] [--compile DIR] CMD_SEQUENCE FILE \n
+     * --restart resumes execution from checkpoint at PATH (if there is one) and continues saving checkpoints there \n
+     * --watch executes script again whenever input file changes and stays unchanged for given time \n
+     * --publish publishes result to shared memory table NAME, FILE in form shm:NAME reads published table \n
+     * --serve keeps result resident and serves queries and updates of clients connected to unix socket SOCKET \n
+     * --compile executes commands compiled to native library that is cached in directory DIR
+     *
+     * @param argc Number of arguments
+     * @param argv Array of arguments
+     * @param options Pointer to instance of #Options structure where parsed arguments will be saved
+     *
+     * @return #NO_ERROR on success, #MISSING_ARGS when some argument is missing, #VALUE_ERROR when value of flag is invalid
+     */
+
+    options->delims = DEFAULT_DELIM;
+    options->commands = NULL;
+    options->input_path = NULL;
+    options->output_path = NULL;
+    options->state_path = NULL;
+    options->memory_budget = 0;
+    options->threads = get_number_of_cpus();
+    options->shards = 1;
+    options->checkpoint_path = NULL;
+    options->restart = false;
+    options->watch_delay = -1;
+    options->publish_name = NULL;
+    options->serve_path = NULL;
+    options->compile_dir = NULL;
+
+    int i = 1;
+
+    // Flags with value, last two arguments are always commands and file
+    for (; (i + 2) < argc; i += 2)
+    {
+        if (strings_equal(argv[i], "-d"))
+            options->delims = argv[i + 1];
+        else if (strings_equal(argv[i], "-o"))
+            options->output_path = argv[i + 1];
+        else if (strings_equal(argv[i], "-t"))
+            options->state_path = argv[i + 1];
+        else if (strings_equal(argv[i], "-m"))
+        {
+            long long int megabytes;
+            if (string_to_llint(argv[i + 1], &megabytes) != NO_ERROR || megabytes <= 0)
+                return VALUE_ERROR;
+
+            options->memory_budget = megabytes * 1024 * 1024;
+        }
+        else if (strings_equal(argv[i], "--threads"))
+        {
+            long long int threads;
+            if (string_to_llint(argv[i + 1], &threads) != NO_ERROR || threads <= 0 || threads > MAX_NUMBER_OF_THREADS)
+                return VALUE_ERROR;
+
+            options->threads = (int)threads;
+        }
+        else if (strings_equal(argv[i], "--shards"))
+        {
+            long long int shards;
+            if (string_to_llint(argv[i + 1], &shards) != NO_ERROR || shards <= 0 || shards > MAX_NUMBER_OF_SHARDS)
+                return VALUE_ERROR;
+
+            options->shards = (int)shards;
+        }
+        else if (strings_equal(argv[i], "--checkpoint") || strings_equal(argv[i], "--restart"))
+        {
+            options->checkpoint_path = argv[i + 1];
+            options->restart = strings_equal(argv[i], "--restart");
+        }
+        else if (strings_equal(argv[i], "--watch"))
+        {
+            if (string_to_llint(argv[i + 1], &options->watch_delay) != NO_ERROR || options->watch_delay < 0)
+                return VALUE_ERROR;
+        }
+        else if (strings_equal(argv[i], "--publish"))
+        {
+            // Name is used as name of shared memory segment
+            if (argv[i + 1][0] == '\0' || strchr(argv[i + 1], '/') != NULL)
+                return VALUE_ERROR;
+            options->publish_name = argv[i + 1];
+        }
+        else if (strings_equal(argv[i], "--serve"))
+        {
+            options->serve_path = argv[i + 1];
+        }
+        else if (strings_equal(argv[i], "--compile"))
+        {
+            options->compile_dir = argv[i + 1];
+        }
+        else
+            break;
+    }
+
+    if ((i + 1) >= argc || strings_equal(argv[i], "-d") || strings_equal(argv[i], "-o") || strings_equal(argv[i], "-t") || strings_equal(argv[i], "-m") || strings_equal(argv[i], "--threads") ||
+        strings_equal(argv[i], "--shards") || strings_equal(argv[i], "--checkpoint") || strings_equal(argv[i], "--restart") ||
+        strings_equal(argv[i], "--watch") || strings_equal(argv[i], "--publish") ||
+        strings_equal(argv[i], "--serve") || strings_equal(argv[i], "--compile"))
+        return MISSING_ARGS;
+
+    options->commands = argv[i];
+    options->input_path = argv[argc - 1];
+
+    if (options->output_path == NULL)
+        options->output_path = options->input_path;
+
+    return NO_ERROR;
+}
+
+int get_commands(char *raw_commands, Raw_commands *commands_store)
+{
+    /**
+     * @brief Get raw commands
+     *
+     * Get command string for aguments and open it as file and parse it to individual commands or parse the argument as individual commands
+     *
+     * @param raw_commands Commands argument
+     * @param commands_store Pointer to instance of #Raw_commands structure where individual commands will be saved
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    long long int num_of_commands = 0;
+
+    if (string_start_with(raw_commands, "-c"))
+    {
+        // Raw commands are path to command file
+        // Parse commands from commands file
+
+        // Trim out prefix
+        size_t len = strlen(raw_commands);
+        memmove(raw_commands, raw_commands + 2, len - 1);
+
+        // Try to open command file
+        FILE *file = fopen(raw_commands, "r");
+        if (file == NULL)
+            return CANT_OPEN_FILE;
+
+        char *line = NULL;
+
+        // Count number of lines (commands because individual commands are on separated lines)
+        while (get_line(&line, file) != -1)
+        {
+            rm_newline_chars(line);
+            if (line[0] != '\0')
+                num_of_commands++;
+
+            free(line);
+            line = NULL;
+        }
+
+        // Rewind to start of file
+        rewind(file);
+
+        if (allocate_raw_commands(commands_store, num_of_commands) != NO_ERROR)
+            return ALLOCATION_FAILED;
+
+        long long int i = 0;
+        while (get_line(&line, file) != -1)
+        {
+            rm_newline_chars(line);
+            if (line[0] == '\0')
+            {
+                free(line);
+                line = NULL;
+                continue;
+            }
+
+            commands_store->commands[i] = line;
+            line = NULL;
+
+            i++;
+        }
+
+        fclose(file);
+    }
+    else
+    {
+        // Parse commands from argument
+
+        num_of_commands = count_char(raw_commands, ';', true) + 1;
+        char *command = NULL;
+        int ret_val;
+
+        if (num_of_commands == 1 && strings_equal(raw_commands, EMPTY_CELL))
+            return NO_ERROR;
+
+        if (allocate_raw_commands(commands_store, num_of_commands) != NO_ERROR)
+            return ALLOCATION_FAILED;
+
+        for (long long int i = 0; i < num_of_commands; i++)
+        {
+            if ((ret_val = get_substring(raw_commands, &command, ';', i, true, NULL, false)) != NO_ERROR)
+                return ret_val;
+
+            commands_store->commands[i] = command;
+            command = NULL;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+int parse_commands(Raw_commands *raw_command_store, Commands *base_command_store)
+{
+    /**
+     * @brief Parse raw commands to base commands
+     *
+     * Split raw commands to function part and argument part
+     *
+     * @param raw_command_store Pointer to instance of #Raw_commands structure where raw commands are stored
+     * @param base_command_store Pointer to instance #Commands structure where parsed commands will be stored
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (raw_command_store == NULL)
+        return FUNCTION_ERROR;
+
+    if (raw_command_store->num_of_commands != 0)
+    {
+        base_command_store->commands = (Command*)malloc(raw_command_store->num_of_commands * sizeof(Command));
+        if (base_command_store->commands == NULL)
+            return ALLOCATION_FAILED;
+
+        base_command_store->num_of_commands = raw_command_store->num_of_commands;
+
+        for (long long int i = 0; i < base_command_store->num_of_commands; i++)
+        {
+            base_command_store->commands[i].function = NULL;
+            base_command_store->commands[i].arguments = NULL;
+        }
+
+        char *substring_buf = NULL;
+        char *rest = NULL;
+        int ret_val;
+
+        for (long long int i = 0; i < raw_command_store->num_of_commands; i++)
+        {
+            // This is to not split find selector command
+            if (string_start_with(raw_command_store->commands[i], "[") && string_end_with(raw_command_store->commands[i], "]"))
+            {
+                if ((ret_val = get_substring(raw_command_store->commands[i], &substring_buf, '\0', 0, false, &rest, true)) != NO_ERROR)
+                    return ret_val;
+            }
+            else
+            {
+                if ((ret_val = get_substring(raw_command_store->commands[i], &substring_buf, ' ', 0, false, &rest, true)) != NO_ERROR)
+                    return ret_val;
+            }
+
+            if (rest != NULL && strings_equal(rest, EMPTY_CELL))
+            {
+                free(rest);
+                rest = NULL;
+            }
+
+            base_command_store->commands[i].function = substring_buf;
+            base_command_store->commands[i].arguments = rest;
+
+            substring_buf = NULL;
+            rest = NULL;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+long long int get_number_of_rows(Table *table)
+{
+    /**
+     * @brief Get number of rows of whole table
+     *
+     * @param table Pointer to instance of #Table structure
+     *
+     * @return Number of rows of all shards in sharded execution, number of rows of @p table otherwise
+     */
+
+    return (table->shard != NULL) ? table->shard->num_of_rows : table->num_of_rows;
+}
+
+int parse_command_argument(char *command_argument, long long int **output_indexes, Table *table)
+{
+    /**
+     * @brief Parse command arguments
+     *
+     * Split command arguments, convert them to numbers and return as array
+     *
+     * @param command_argument String with command arguments
+     * @param output_indexes Pointer to output array of parsed arguments
+     * @param table Pointer to instance of #Table structure for checking if values in argument are right
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    if (command_argument == NULL)
+        return COMMAND_ERROR;
+
+    if (!string_start_with(command_argument, "[") || !string_end_with(command_argument, "]"))
+        return COMMAND_ERROR;
+
+    if ((ret_val = trim_se(command_argument)) != NO_ERROR)
+        return ret_val;
+
+    long long int num_of_parts = count_char(command_argument, ',', true) + 1;
+    if (num_of_parts != 2)
+        return COMMAND_ERROR;
+
+    if (table->num_of_rows == 0 || get_row(table, 0)->num_of_cells == 0)
+        return FUNCTION_ERROR;
+
+    char *parts[2] = { NULL };
+    long long int *indexes = (long long int*)malloc(2 * sizeof(long long int));
+    if (indexes == NULL)
+        return ALLOCATION_FAILED;
+
+    memset(indexes, 0, 2 * sizeof(long long int));
+
+    for (long long int i = 0; i < num_of_parts; i++)
+    {
+        if ((ret_val = get_substring(command_argument, &parts[i], ',', i, true, NULL, false)) != NO_ERROR)
+            break;
+
+        if (is_string_llint(parts[i]))
+        {
+            if ((ret_val = string_to_llint(parts[i], &indexes[i])) != NO_ERROR)
+                break;
+        }
+        else
+        {
+            if (strings_equal(parts[i], "-"))
+                indexes[i] = (i == 0) ? get_number_of_rows(table) : get_row(table, 0)->num_of_cells;
+            else
+            {
+                ret_val = COMMAND_ERROR;
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < num_of_parts; i++)
+    {
+        free(parts[i]);
+        indexes[i] -= 1;
+
+        if (ret_val == NO_ERROR)
+            if ((indexes[i]) < 0 || indexes[i] >= (((i == 0) ? get_number_of_rows(table) : get_row(table, 0)->num_of_cells)))
+                ret_val = COMMAND_ERROR;
+    }
+
+    (*output_indexes) = indexes;
+    return ret_val;
+}
+
+void print_table(Table *table)
+{
+    /**
+     * @brief Print table to console
+     *
+     * Debug functing for printing loaded table to console
+     * @todo Remove
+     *
+     * @param table Pointer to instance of #Table structure
+     */
+
+    if (table->rows == NULL)
+        return;
+
+    for (long long int i = 0; i < table->num_of_rows; i++)
+    {
+        if (get_row(table, i)->cells == NULL)
+            return;
+
+        for (long long int j = 0; j < get_row(table, i)->num_of_cells; j++)
+        {
+            if (get_row(table, i)->cells[j].content != NULL)
+            {
+                printf("%s", get_row(table, i)->cells[j].content);
+                if (j < (get_row(table, i)->num_of_cells - 1))
+                    printf("%c", table->delim);
+            }
+        }
+
+        printf("\n");
+    }
+}
+
+int output_buffer_append(OutputBuffer *buffer, const char *data, size_t length)
+{
+    /**
+     * @brief Append @p data to @p buffer
+     *
+     * @param buffer Pointer to instance of #OutputBuffer structure
+     * @param data Data to append
+     * @param length Length of @p data
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    if (length == 0)
+        return NO_ERROR;
+
+    if ((buffer->length + length) > buffer->allocated)
+    {
+        size_t new_allocated = (buffer->allocated > 0) ? buffer->allocated * 2 : BASE_LINE_LENGTH;
+        while (new_allocated < (buffer->length + length))
+            new_allocated *= 2;
+
+        char *tmp = (char*)realloc(buffer->data, new_allocated);
+        if (tmp == NULL)
+            return ALLOCATION_FAILED;
+
+        buffer->data = tmp;
+        buffer->allocated = new_allocated;
+    }
+
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+
+    return NO_ERROR;
+}
+
+void save_chunk(void *arg, long long int chunk, long long int start, long long int end, int worker_id)
+{
+    /**
+     * @brief Format chunk of rows of save round to its buffer
+     *
+     * @param arg Pointer to instance of #SaveRound structure
+     * @param chunk Index of chunk
+     * @param start Index of first row of chunk (relative to round)
+     * @param end Index after last row of chunk (relative to round)
+     * @param worker_id Index of worker (not used)
+     */
+
+    (void)worker_id;
+
+    SaveRound *round = (SaveRound*)arg;
+    Table *table = round->table;
+    OutputBuffer *buffer = &round->buffers[chunk];
+    int ret_val = NO_ERROR;
+
+    buffer->length = 0;
+    round->ended[chunk] = false;
+
+    for (long long int i = round->first_row + start; (i < round->first_row + end) && (ret_val == NO_ERROR); i++)
+    {
+        // This only means that there is no data left
+        if (get_row(table, i)->cells == NULL)
+        {
+            round->ended[chunk] = true;
+            break;
+        }
+
+        for (long long int j = 0; (j < get_row(table, i)->num_of_cells) && (ret_val == NO_ERROR); j++)
+        {
+            if (get_row(table, i)->cells[j].content != NULL)
+            {
+                ret_val = output_buffer_append(buffer, get_row(table, i)->cells[j].content, strlen(get_row(table, i)->cells[j].content));
+                if (ret_val == NO_ERROR && j < (get_row(table, i)->num_of_cells - 1))
+                    ret_val = output_buffer_append(buffer, &table->delim, 1);
+            }
+        }
+
+        if (ret_val == NO_ERROR)
+            ret_val = output_buffer_append(buffer, "\n", 1);
+    }
+
+    round->results[chunk] = ret_val;
+}
+
+int save_table(Table *table, char *path)
+{
+    /**
+     * @brief Save table to file
+     *
+     * Rows are formatted in rounds of #SAVE_ROUND_CHUNKS chunks that are formatted in parallel \n
+     * Buffers of chunks are then written in order to buffers that are written to file by write-behind thread
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param path Path to output file
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val;
+    WriteBehindWriter writer;
+
+    OutputBuffer buffers[SAVE_ROUND_CHUNKS];
+    _Bool ended[SAVE_ROUND_CHUNKS];
+    int results[SAVE_ROUND_CHUNKS];
+
+    for (int i = 0; i < SAVE_ROUND_CHUNKS; i++)
+    {
+        buffers[i].data = NULL;
+        buffers[i].length = 0;
+        buffers[i].allocated = 0;
+    }
+
+    SaveRound round;
+    round.table = table;
+    round.buffers = buffers;
+    round.ended = ended;
+    round.results = results;
+
+    // Try to open output file
+    if ((ret_val = write_behind_open(&writer, path)) != NO_ERROR)
+        return ret_val;
+
+    _Bool end_of_data = false;
+    for (round.first_row = 0; (round.first_row < table->num_of_rows) && !end_of_data && (ret_val == NO_ERROR); round.first_row += SAVE_ROUND_CHUNKS * ROW_CHUNK_SIZE)
+    {
+        long long int rows_left = table->num_of_rows - round.first_row;
+        long long int num_of_rows = (rows_left < SAVE_ROUND_CHUNKS * ROW_CHUNK_SIZE) ? rows_left : SAVE_ROUND_CHUNKS * ROW_CHUNK_SIZE;
+
+        thread_pool_for(get_table_pool(table), num_of_rows, ROW_CHUNK_SIZE, save_chunk, &round);
+
+        for (long long int i = 0; i < get_number_of_chunks(num_of_rows, ROW_CHUNK_SIZE); i++)
+        {
+            if ((ret_val = results[i]) != NO_ERROR)
+                break;
+
+            write_behind_put(&writer, buffers[i].data, buffers[i].length);
+
+            if ((end_of_data = ended[i]))
+                break;
+        }
+    }
+
+    for (int i = 0; i < SAVE_ROUND_CHUNKS; i++)
+        free(buffers[i].data);
+
+    int close_ret_val = write_behind_close(&writer);
+
+    return (ret_val != NO_ERROR) ? ret_val : close_ret_val;
+}
+
+_Bool check_sanity_of_delims(char *delims)
+{
+    /**
+     * @brief Check delims
+     *
+     * Check if in delims are no blacklisted characters
+     *
+     * @param delims Array of deliminators
+     *
+     * @return true if deliminator are without blacklisted characters else false
+     */
+
+    size_t length_of_delims = strlen(delims);
+    size_t length_of_blacklisted_delims = strlen(BLACKLISTED_DELIMS);
+
+    for (size_t i = 0; i < length_of_delims; i++)
+    {
+        for (size_t j = 0; j < length_of_blacklisted_delims; j++)
+        {
+            if (delims[i] == BLACKLISTED_DELIMS[j])
+                return false;
+        }
+    }
+
+    return true;
+}
+
+int add_backslashes(Cell *cell)
+{
+    /**
+     * @brief Add backslashes to cell if its needed
+     *
+     * @param cell Pointer to instance of #Cell structure that we want edit
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    unsigned long long int length_of_string = strlen(cell->content);
+    int occurences = 0;
+    for (unsigned long long int i = 0; i < length_of_string; i++)
+    {
+        char c = cell->content[i];
+        if (c == '\\' || c == '\"')
+        {
+            if ((unsigned long long int)cell->allocated_chars <= (length_of_string + 1))
+                if (allocate_content(cell) != NO_ERROR)
+                    return ALLOCATION_FAILED;
+
+            memmove(cell->content + i + 1, cell->content + i, strlen(cell->content + i));
+            cell->content[i] = '\\';
+            occurences++;
+            length_of_string++;
+            i++;
+            cell->content[length_of_string - occurences + 2] = '\0';
+        }
+    }
+
+    return NO_ERROR;
+}
+
+int filter_string(char *string)
+{
+    /**
+     * @brief Filter special characters from string
+     *
+     * @param string String to filter
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    // If string string have parentecies on the both sides then trim them
+    if ((string_start_with(string, "\"") && string_end_with(string, "\"")) ||
+        (string_start_with(string, "\'") && string_end_with(string, "\'")))
+    {
+        if ((ret_val = trim_se(string)) != NO_ERROR)
+            return ret_val;
+    }
+
+    // Remove backslashes that are not in use
+    unsigned long long int lenghth_of_string = strlen(string);
+    for (unsigned long long int i = 0; i < lenghth_of_string; i++)
+    {
+        char c = string[i];
+
+        if (c == '\\' && (i + 1) < lenghth_of_string && (string[i + 1] != '\\' || string[i + 1] != '\"'))
+        {
+            memmove(string + i, string + i + 1, strlen(string + i));
+        }
+    }
+
+    return NO_ERROR;
+}
+
+void filter_chunk(void *arg, long long int chunk, long long int start, long long int end, int worker_id)
+{
+    /**
+     * @brief Filter special characters from cells of chunk of rows
+     *
+     * @param arg Pointer to instance of #TableChunks structure
+     * @param chunk Index of chunk
+     * @param start Index of first row of chunk (relative to first edited row)
+     * @param end Index after last row of chunk (relative to first edited row)
+     * @param worker_id Index of worker (not used)
+     */
+
+    (void)worker_id;
+
+    TableChunks *chunks = (TableChunks*)arg;
+    Table *table = chunks->table;
+    int ret_val = NO_ERROR;
+
+    for (long long int i = chunks->first_row + start; (i < chunks->first_row + end) && (ret_val == NO_ERROR); i++)
+    {
+        for (long long int j = 0; (j < get_row(table, i)->num_of_cells) && (ret_val == NO_ERROR); j++)
+        {
+            if ((ret_val = filter_string(get_row(table, i)->cells[j].content)) != NO_ERROR)
+                break;
+
+            if (is_string_ldouble(get_row(table, i)->cells[j].content) && string_start_with(get_row(table, i)->cells[j].content, " "))
+            {
+                while (string_start_with(get_row(table, i)->cells[j].content, " "))
+                {
+                    if ((ret_val = trim_start(get_row(table, i)->cells[j].content)) != NO_ERROR)
+                        break;
+                }
+            }
+        }
+    }
+
+    chunks->results[chunk] = ret_val;
+}
+
+int run_table_chunks(Table *table, long long int first_row, const char *delims, ChunkFunction function)
+{
+    /**
+     * @brief Run @p function for all rows of @p table from @p first_row in parallel
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param first_row Index of first edited row
+     * @param delims Array of chars that was used as delims (can be NULL if @p function doesnt need them)
+     * @param function Function that edits chunk of rows
+     *
+     * @return #NO_ERROR on success, otherwise result of first failed chunk
+     */
+
+    long long int num_of_rows = table->num_of_rows - first_row;
+    long long int num_of_chunks = get_number_of_chunks(num_of_rows, ROW_CHUNK_SIZE);
+
+    TableChunks chunks;
+    chunks.table = table;
+    chunks.first_row = first_row;
+    chunks.delims = delims;
+    chunks.results = (int*)calloc((num_of_chunks > 0) ? (size_t)num_of_chunks : 1, sizeof(int));
+    if (chunks.results == NULL)
+        return ALLOCATION_FAILED;
+
+    thread_pool_for(get_table_pool(table), num_of_rows, ROW_CHUNK_SIZE, function, &chunks);
+
+    int ret_val = NO_ERROR;
+    for (long long int i = 0; (i < num_of_chunks) && (ret_val == NO_ERROR); i++)
+        ret_val = chunks.results[i];
+
+    free(chunks.results);
+
+    return ret_val;
+}
+
+int filter_table(Table *table, long long int first_row)
+{
+    /**
+     * @brief Filter special characters from all cells in rows from @p first_row
+     *
+     * Rows are filtered in parallel, each row can be filtered only once
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param first_row Index of first row that was not filtered yet
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    return run_table_chunks(table, first_row, NULL, filter_chunk);
+}
+
+int surround_with_dparentecies(Cell *cell)
+{
+    /**
+     * @brief Surround content of cell with parentecies
+     *
+     * @param cell Pointer to instance of #Cell structure where content string is located
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    size_t lenght_of_cell = strlen(cell->content);
+
+    if ((unsigned long long int)cell->allocated_chars <= (lenght_of_cell + 3))
+    {
+        if (allocate_content(cell) != NO_ERROR)
+            return ALLOCATION_FAILED;
+    }
+
+    memmove(cell->content + 1, cell->content, lenght_of_cell);
+    cell->content[0] = '\"';
+    cell->content[lenght_of_cell + 1] = '\"';
+    cell->content[lenght_of_cell + 2] = '\0';
+
+    return NO_ERROR;
+}
+
+void format_chunk(void *arg, long long int chunk, long long int start, long long int end, int worker_id)
+{
+    /**
+     * @brief Format cells of chunk of rows for output
+     *
+     * @param arg Pointer to instance of #TableChunks structure
+     * @param chunk Index of chunk
+     * @param start Index of first row of chunk (relative to first edited row)
+     * @param end Index after last row of chunk (relative to first edited row)
+     * @param worker_id Index of worker (not used)
+     */
+
+    (void)worker_id;
+
+    TableChunks *chunks = (TableChunks*)arg;
+    Table *table = chunks->table;
+    int ret_val = NO_ERROR;
+    size_t number_of_delims = strlen(chunks->delims);
+
+    for (long long int i = chunks->first_row + start; (i < chunks->first_row + end) && (ret_val == NO_ERROR); i++)
+    {
+        for (long long int j = 0; j < get_row(table, i)->num_of_cells; j++)
+        {
+            if ((ret_val = add_backslashes(&get_row(table, i)->cells[j])) != NO_ERROR)
+                break;
+
+            for (size_t k = 0; k < number_of_delims; k++)
+            {
+                if (count_char(get_row(table, i)->cells[j].content, chunks->delims[k], false) > 0)
+                {
+                    if ((ret_val = surround_with_dparentecies(&get_row(table, i)->cells[j])) != NO_ERROR)
+                        break;
+                }
+            }
+        }
+    }
+
+    chunks->results[chunk] = ret_val;
+}
+
+int format_table_for_output(Table *table, const char *delims)
+{
+    /**
+     * @brief Format @p table for output
+     *
+     * Rows are formatted in parallel
+     *
+     * @param table Pointer to instance of #Table structure that will be eddited
+     * @param delims Array of chars that was used as delims
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    return run_table_chunks(table, 0, delims, format_chunk);
+}
+
+int set_cell(char *string, Cell *cell)
+{
+    /**
+     * @brief Set value to cell content
+     *
+     * Try to allocate content in #Cell structure if content doesnt exist or rewrite existing data in it \n
+     * If content is too small then extend it
+     * @warning
+     * If there are some data in cell it will be rewritten
+     *
+     * @param string String we want to set to cell
+     * @param cell Pointer to instance of #Cell structure
+     *
+     * @return #NO_ERROR when setting value is successful or when allocation fails #ALLOCATION_FAILED
+     */
+
+    if (string == NULL)
+        return FUNCTION_ARGUMENT_ERROR;
+
+    if (cell->content == NULL)
+    {
+        // Allocate base cell
+        if (allocate_content(cell) != NO_ERROR)
+            return ALLOCATION_FAILED;
+    }
+
+    while ((strlen(string) + 1) > (unsigned long long)cell->allocated_chars)
+        if (allocate_content(cell) != NO_ERROR)
+            return ALLOCATION_FAILED;
+
+    if (strcpy(cell->content, string) == NULL)
+        return FUNCTION_ERROR;
+
+    return NO_ERROR;
+}
+
+int set_table_cell(Table *table, long long int r, long long int c, char *string)
+{
+    /**
+     * @brief Set value to cell of table and widen type of its column
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param r Row index of cell
+     * @param c Column index of cell
+     * @param string String we want to set to cell
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = set_cell(string, &get_row(table, r)->cells[c]);
+    if (ret_val == NO_ERROR)
+        ret_val = widen_column_type(&table->col_types, &table->num_of_col_types, c, get_cell_type(string));
+
+    return ret_val;
+}
+
+_Bool parse_formula(char *string, Formula *formula)
+{
+    /**
+     * @brief Parse formula in form =FUNC(R1,C1,R2,C2) or =FUNC(R,C)
+     *
+     * Indexes are counted from 1 as in selectors, FUNC is one of #FORMULA_FUNCTIONS
+     *
+     * @param string String to parse
+     * @param formula Pointer to instance of #Formula structure where function and source range will be saved
+     *
+     * @return true if @p string is valid formula, otherwise false
+     */
+
+    if (string == NULL || string[0] != '=')
+        return false;
+
+    char name[16];
+    long long int indexes[4];
+    int consumed = -1;
+    size_t length = strlen(string);
+
+    if (sscanf(string, "=%15[a-z](%lld,%lld,%lld,%lld)%n", name, &indexes[0], &indexes[1], &indexes[2], &indexes[3], &consumed) != 5 ||
+        consumed != (int)length)
+    {
+        consumed = -1;
+        if (sscanf(string, "=%15[a-z](%lld,%lld)%n", name, &indexes[0], &indexes[1], &consumed) != 3 || consumed != (int)length)
+            return false;
+
+        indexes[2] = indexes[0];
+        indexes[3] = indexes[1];
+    }
+
+    if (indexes[0] < 1 || indexes[1] < 1 || indexes[2] < indexes[0] || indexes[3] < indexes[1])
+        return false;
+
+    formula->function = -1;
+    for (int i = 0; i < NUMBER_OF_FORMULA_FUNCTIONS; i++)
+        if (strings_equal(name, FORMULA_FUNCTIONS[i]))
+            formula->function = i;
+
+    if (formula->function == -1)
+        return false;
+
+    formula->r1 = indexes[0] - 1;
+    formula->c1 = indexes[1] - 1;
+    formula->r2 = indexes[2] - 1;
+    formula->c2 = indexes[3] - 1;
+    formula->state = FORMULA_DIRTY;
+    formula->changed = false;
+
+    return true;
+}
+
+int compare_formula_positions(const void *a, const void *b)
+{
+    /**
+     * @brief Compare positions of formula cells (row first) for qsort
+     *
+     * @param a Pointer to first #Formula
+     * @param b Pointer to second #Formula
+     *
+     * @return Negative number, zero or positive number when @p a is before, at the same place or after @p b
+     */
+
+    const Formula *first = (const Formula*)a;
+    const Formula *second = (const Formula*)b;
+
+    if (first->row != second->row)
+        return (first->row < second->row) ? -1 : 1;
+    if (first->col != second->col)
+        return (first->col < second->col) ? -1 : 1;
+
+    return 0;
+}
+
+int build_formula_graph(FormulaStore *store)
+{
+    /**
+     * @brief Build dependency graph of formulas
+     *
+     * Formulas are sorted by position, so formulas in source range of each formula are found by binary search of its first row
+     *
+     * @param store Pointer to instance of #FormulaStore structure
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    if (store->graph_valid)
+        return NO_ERROR;
+
+    free_formula_graph(store);
+
+    long long int n = store->num_of_formulas;
+    qsort(store->formulas, (size_t)n, sizeof(Formula), compare_formula_positions);
+
+    store->dependency_start = (long long int*)calloc((size_t)n + 1, sizeof(long long int));
+    store->dependent_start = (long long int*)calloc((size_t)n + 1, sizeof(long long int));
+    if (store->dependency_start == NULL || store->dependent_start == NULL)
+    {
+        free_formula_graph(store);
+        return ALLOCATION_FAILED;
+    }
+
+    // First pass count edges, second one save them
+    for (int pass = 0; pass < 2; pass++)
+    {
+        long long int num_of_edges = 0;
+
+        for (long long int i = 0; i < n; i++)
+        {
+            Formula *formula = &store->formulas[i];
+
+            // Find first formula that is not above source range
+            long long int low = 0, high = n;
+            while (low < high)
+            {
+                long long int middle = low + (high - low) / 2;
+                if (store->formulas[middle].row < formula->r1)
+                    low = middle + 1;
+                else
+                    high = middle;
+            }
+
+            if (pass == 0)
+                store->dependency_start[i] = num_of_edges;
+
+            for (long long int j = low; j < n && store->formulas[j].row <= formula->r2; j++)
+            {
+                if (store->formulas[j].col < formula->c1 || store->formulas[j].col > formula->c2)
+                    continue;
+
+                if (pass == 0)
+                    store->dependent_start[j]++;
+                else
+                    store->dependencies[num_of_edges] = j;
+
+                num_of_edges++;
+            }
+        }
+
+        if (pass == 0)
+        {
+            store->dependency_start[n] = num_of_edges;
+
+            // Counts of dependents to starts
+            long long int start = 0;
+            for (long long int i = 0; i <= n; i++)
+            {
+                long long int count = store->dependent_start[i];
+                store->dependent_start[i] = start;
+                start += count;
+            }
+
+            store->dependencies = (long long int*)malloc(((size_t)num_of_edges + 1) * sizeof(long long int));
+            store->dependents = (long long int*)malloc(((size_t)num_of_edges + 1) * sizeof(long long int));
+            if (store->dependencies == NULL || store->dependents == NULL)
+            {
+                free_formula_graph(store);
+                return ALLOCATION_FAILED;
+            }
+        }
+    }
+
+    // Reverse edges
+    long long int *filled = (long long int*)calloc((size_t)n + 1, sizeof(long long int));
+    if (filled == NULL)
+    {
+        free_formula_graph(store);
+        return ALLOCATION_FAILED;
+    }
+
+    for (long long int i = 0; i < n; i++)
+    {
+        for (long long int k = store->dependency_start[i]; k < store->dependency_start[i + 1]; k++)
+        {
+            long long int j = store->dependencies[k];
+            store->dependents[store->dependent_start[j] + filled[j]++] = i;
+        }
+    }
+
+    free(filled);
+    store->graph_valid = true;
+
+    return NO_ERROR;
+}
+
+int set_formula_dirty(FormulaStore *store, long long int index)
+{
+    /**
+     * @brief Mark formula and all formulas that depend on it as dirty
+     *
+     * @param store Pointer to instance of #FormulaStore structure with valid graph
+     * @param index Index of formula
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    if (store->formulas[index].state == FORMULA_DIRTY)
+        return NO_ERROR;
+
+    long long int *stack = (long long int*)malloc((size_t)store->num_of_formulas * sizeof(long long int));
+    if (stack == NULL)
+        return ALLOCATION_FAILED;
+
+    long long int stack_size = 0;
+    stack[stack_size++] = index;
+    store->formulas[index].state = FORMULA_DIRTY;
+    store->num_of_dirty++;
+
+    // Each formula is pushed only once, when it becomes dirty
+    while (stack_size > 0)
+    {
+        long long int current = stack[--stack_size];
+
+        for (long long int k = store->dependent_start[current]; k < store->dependent_start[current + 1]; k++)
+        {
+            long long int dependent = store->dependents[k];
+            if (store->formulas[dependent].state != FORMULA_DIRTY)
+            {
+                store->formulas[dependent].state = FORMULA_DIRTY;
+                store->num_of_dirty++;
+                stack[stack_size++] = dependent;
+            }
+        }
+    }
+
+    free(stack);
+
+    return NO_ERROR;
+}
+
+int add_formula(FormulaStore *store, Formula *formula)
+{
+    /**
+     * @brief Add dirty formula to store
+     *
+     * @warning
+     * There must not be other formula on the same position
+     *
+     * @param store Pointer to instance of #FormulaStore structure
+     * @param formula Pointer to instance of #Formula structure with position and source range
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    if (store->num_of_formulas == store->allocated_formulas)
+    {
+        long long int new_allocated = (store->allocated_formulas > 0) ? store->allocated_formulas * 2 : BASE_NUMBER_OF_ROWS;
+
+        Formula *tmp = (Formula*)realloc(store->formulas, (size_t)new_allocated * sizeof(Formula));
+        if (tmp == NULL)
+            return ALLOCATION_FAILED;
+
+        store->formulas = tmp;
+        store->allocated_formulas = new_allocated;
+    }
+
+    store->formulas[store->num_of_formulas] = *formula;
+    store->formulas[store->num_of_formulas].state = FORMULA_DIRTY;
+    store->num_of_formulas++;
+    store->num_of_dirty++;
+    store->graph_valid = false;
+
+    return NO_ERROR;
+}
+
+int formula_cells_written(Table *table, long long int r1, long long int c1, long long int r2, long long int c2)
+{
+    /**
+     * @brief Record that cells in area were rewritten by plain value
+     *
+     * Formulas in area are removed and all formulas that read some cell of area are marked dirty
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param r1 First row of area
+     * @param c1 First column of area
+     * @param r2 Last row of area
+     * @param c2 Last column of area
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    FormulaStore *store = &table->formulas;
+    if (store->num_of_formulas == 0)
+        return NO_ERROR;
+
+    // Remove overwritten formulas
+    long long int kept = 0;
+    for (long long int i = 0; i < store->num_of_formulas; i++)
+    {
+        Formula *formula = &store->formulas[i];
+        if (formula->row >= r1 && formula->row <= r2 && formula->col >= c1 && formula->col <= c2)
+        {
+            if (formula->state == FORMULA_DIRTY)
+                store->num_of_dirty--;
+            store->graph_valid = false;
+            continue;
+        }
+
+        store->formulas[kept++] = *formula;
+    }
+    store->num_of_formulas = kept;
+
+    int ret_val = NO_ERROR;
+    if ((ret_val = build_formula_graph(store)) != NO_ERROR)
+        return ret_val;
+
+    for (long long int i = 0; i < store->num_of_formulas; i++)
+    {
+        Formula *formula = &store->formulas[i];
+        if (formula->r1 <= r2 && formula->r2 >= r1 && formula->c1 <= c2 && formula->c2 >= c1)
+            if ((ret_val = set_formula_dirty(store, i)) != NO_ERROR)
+                return ret_val;
+    }
+
+    return NO_ERROR;
+}
+
+void shift_formula_index(long long int *index, long long int start, long long int count, _Bool is_end)
+{
+    /**
+     * @brief Move row or column index after rows or columns were inserted or deleted
+     *
+     * @param index Pointer to moved index
+     * @param start Index of first inserted or deleted row or column
+     * @param count Number of inserted (positive) or deleted (negative) rows or columns
+     * @param is_end Flag if index is end of range (end moves before deleted part, start after it)
+     */
+
+    if (count > 0)
+    {
+        if (*index >= start)
+            *index += count;
+    }
+    else if (*index >= (start - count))
+    {
+        *index += count;
+    }
+    else if (*index >= start)
+    {
+        *index = is_end ? start - 1 : start;
+    }
+}
+
+int shift_formulas(Table *table, _Bool rows, long long int start, long long int count)
+{
+    /**
+     * @brief Move formulas after rows or columns were inserted or deleted
+     *
+     * Formulas on deleted cells are removed and formulas whose source range was changed are marked dirty
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param rows Flag if rows (or columns) were changed
+     * @param start Index of first inserted or deleted row or column
+     * @param count Number of inserted (positive) or deleted (negative) rows or columns
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    FormulaStore *store = &table->formulas;
+    if (store->num_of_formulas == 0)
+        return NO_ERROR;
+
+    long long int kept = 0;
+    for (long long int i = 0; i < store->num_of_formulas; i++)
+    {
+        Formula formula = store->formulas[i];
+        long long int *position = rows ? &formula.row : &formula.col;
+        long long int *first = rows ? &formula.r1 : &formula.c1;
+        long long int *last = rows ? &formula.r2 : &formula.c2;
+
+        // Deleted formula cell
+        if (count < 0 && *position >= start && *position < (start - count))
+        {
+            if (formula.state == FORMULA_DIRTY)
+                store->num_of_dirty--;
+            continue;
+        }
+
+        // Inserted cells inside of range or deleted cells that were part of it
+        if (count > 0)
+            formula.changed = (*first < start && start <= *last);
+        else
+            formula.changed = (*first < (start - count) && *last >= start);
+
+        shift_formula_index(position, start, count, false);
+        shift_formula_index(first, start, count, false);
+        shift_formula_index(last, start, count, true);
+
+        store->formulas[kept++] = formula;
+    }
+
+    store->num_of_formulas = kept;
+    store->graph_valid = false;
+
+    int ret_val = NO_ERROR;
+    if ((ret_val = build_formula_graph(store)) != NO_ERROR)
+        return ret_val;
+
+    for (long long int i = 0; i < store->num_of_formulas; i++)
+    {
+        if (store->formulas[i].changed)
+        {
+            store->formulas[i].changed = false;
+            if ((ret_val = set_formula_dirty(store, i)) != NO_ERROR)
+                return ret_val;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+int set_value_in_area(Table *table, Selector *selector, char *string)
+{
+    /**
+     * @brief Set value of @p string in table area selected by @p selector in @p table
+     *
+     * If @p string is formula (e.g. =sum(1,1,3,1)) then all cells in area become formula cells
+     * that are recalculated when some cell from their source range changes
+     *
+     * @param table Pointer to instance of #Table structure that will be eddited
+     * @param selector Pointer to instance of #Selector structure for selecting are where we will set values
+     * @param string String that we will set
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+    if (table->num_of_rows == 0 || get_row(table, 0)->num_of_cells == 0 || string == NULL)
+        return COMMAND_ERROR;
+
+    if ((ret_val = formula_cells_written(table, selector->lld_ir1, selector->lld_ic1, selector->lld_ir2, selector->lld_ic2)) != NO_ERROR)
+        return ret_val;
+
+    Formula formula;
+    _Bool is_formula = parse_formula(string, &formula);
+    int type = get_cell_type(string);
+
+    for (long long int i = selector->lld_ic1; (i <= selector->lld_ic2) && (i < get_row(table, 0)->num_of_cells); i++)
+        if ((ret_val = widen_column_type(&table->col_types, &table->num_of_col_types, i, type)) != NO_ERROR)
+            return ret_val;
+
+    for (long long int i = selector->lld_ir1; (i <= selector->lld_ir2) && (i < table->num_of_rows); i++)
+    {
+        for (long long j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < get_row(table, i)->num_of_cells); j++)
+        {
+            if ((ret_val = set_cell(string, &get_row(table, i)->cells[j])) != NO_ERROR)
+                return ret_val;
+
+            if (is_formula)
+            {
+                formula.row = i;
+                formula.col = j;
+                if ((ret_val = add_formula(&table->formulas, &formula)) != NO_ERROR)
+                    return ret_val;
+            }
+        }
+    }
+
+    return ret_val;
+}
+
+int swap_cells(Table *table, Selector *selector, long long int r, long long int c)
+{
+    /**
+     * @brief Swap cell with another one
+     *
+     * @warning
+     * If more than one cell is selected then all selected cells will be swaped row by row and then cell by cell \n
+     * Only values are swaped, swaped formula cells become plain values
+     *
+     * @param table Pointer to instance of #Table structure where output data will be saved
+     * @param selector Pointer to instance of #Selector structure that tell us where to find data
+     * @param r Row index of base cell for swap
+     * @param c Column index of base cell for swap
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (r < 0 || r > (table->num_of_rows - 1) || c < 0 || c > (get_row(table, 0)->num_of_cells - 1))
+        return FUNCTION_ARGUMENT_ERROR;
+
+    int ret_val = NO_ERROR;
+
+    if ((ret_val = formula_cells_written(table, selector->lld_ir1, selector->lld_ic1, selector->lld_ir2, selector->lld_ic2)) != NO_ERROR ||
+        (ret_val = formula_cells_written(table, r, c, r, c)) != NO_ERROR)
+        return ret_val;
+
+    for (long long int i = selector->lld_ir1; (i <= selector->lld_ir2) && (i < table->num_of_rows); i++)
+    {
+        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < get_row(table, i)->num_of_cells); j++)
+        {
+            if ((i == r) && (j == c))
+                continue;
+
+            // Cells are swaped without copying their content
+            Cell tmp = get_row(table, r)->cells[c];
+            get_row(table, r)->cells[c] = get_row(table, i)->cells[j];
+            get_row(table, i)->cells[j] = tmp;
+        }
+    }
+
+    // Column types only have to be widened when swaped columns have different types
+    int type = get_selection_type(table, selector);
+    int base_type = (c < table->num_of_col_types) ? table->col_types[c] : EMPTY_COLUMN;
+
+    if (type != base_type)
+    {
+        int widest_type = (type > base_type) ? type : base_type;
+        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (ret_val == NO_ERROR); j++)
+            ret_val = widen_column_type(&table->col_types, &table->num_of_col_types, j, widest_type);
+        if (ret_val == NO_ERROR)
+            ret_val = widen_column_type(&table->col_types, &table->num_of_col_types, c, widest_type);
+    }
+
+    return ret_val;
+}
+
+int read_fully(int fd, void *data, size_t length)
+{
+    /**
+     * @brief Read exactly @p length bytes from file descriptor
+     *
+     * @param fd File descriptor
+     * @param data Buffer where data will be saved
+     * @param length Number of bytes to read
+     *
+     * @return #NO_ERROR on success, #IO_ERROR if reading failed or end of file was reached
+     */
+
+    size_t done = 0;
+    while (done < length)
+    {
+        ssize_t count = read(fd, (char*)data + done, length - done);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return IO_ERROR;
+
+        done += (size_t)count;
+    }
+
+    return NO_ERROR;
+}
+
+int write_fully(int fd, const void *data, size_t length)
+{
+    /**
+     * @brief Write exactly @p length bytes to file descriptor
+     *
+     * @param fd File descriptor
+     * @param data Data to write
+     * @param length Number of bytes to write
+     *
+     * @return #NO_ERROR on success, #IO_ERROR on error
+     */
+
+    size_t done = 0;
+    while (done < length)
+    {
+        ssize_t count = write(fd, (const char*)data + done, length - done);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return IO_ERROR;
+
+        done += (size_t)count;
+    }
+
+    return NO_ERROR;
+}
+
+int shard_exchange(ShardContext *shard, void *partial, size_t size, ShardMergeFunction merge)
+{
+    /**
+     * @brief Merge partial results of all shards
+     *
+     * Workers send their partial result to coordinator and wait for merged one \n
+     * Coordinator merges partial results in order of shards (its own is first) and sends merged result back to every worker
+     *
+     * @param shard Pointer to instance of #ShardContext structure
+     * @param partial Partial result of this shard (replaced by merged result)
+     * @param size Size of partial result
+     * @param merge Function that merges partial result of later shard
+     *
+     * @return #NO_ERROR on success, #IO_ERROR if some shard cant be reached
+     */
+
+    if (shard->index > 0)
+    {
+        if (write_fully(shard->to_coordinator, partial, size) != NO_ERROR)
+            return IO_ERROR;
+
+        return read_fully(shard->from_coordinator, partial, size);
+    }
+
+    void *source = malloc(size);
+    if (source == NULL)
+        return ALLOCATION_FAILED;
+
+    int ret_val = NO_ERROR;
+    for (int i = 1; i < shard->num_of_shards && ret_val == NO_ERROR; i++)
+    {
+        if ((ret_val = read_fully(shard->from_workers[i], source, size)) == NO_ERROR)
+            merge(partial, source, size);
+    }
+
+    for (int i = 1; i < shard->num_of_shards && ret_val == NO_ERROR; i++)
+        ret_val = write_fully(shard->to_workers[i], partial, size);
+
+    free(source);
+
+    return ret_val;
+}
+
+void merge_shard_sums(void *target, void *source, size_t size)
+{
+    /**
+     * @brief Merge sum and count of later shard
+     *
+     * @param target Pointer to instance of #ShardPartial structure where result will be saved
+     * @param source Pointer to instance of #ShardPartial structure of later shard
+     * @param size Size of #ShardPartial structure (not used)
+     */
+
+    (void)size;
+
+    ShardPartial *merged = (ShardPartial*)target;
+    ShardPartial *partial = (ShardPartial*)source;
+
+    if (merged->result == NO_ERROR)
+        merged->result = partial->result;
+
+    merged->flag = merged->flag || partial->flag;
+    merged->value += partial->value;
+    merged->count += partial->count;
+}
+
+void merge_shard_extremes(void *target, void *source, size_t size)
+{
+    /**
+     * @brief Merge extreme value of later shard
+     *
+     * When values are equal then extreme of earlier shard (earlier row) is kept
+     *
+     * @param target Pointer to instance of #ShardPartial structure where result will be saved
+     * @param source Pointer to instance of #ShardPartial structure of later shard
+     * @param size Size of #ShardPartial structure (not used)
+     */
+
+    (void)size;
+
+    ShardPartial *merged = (ShardPartial*)target;
+    ShardPartial *partial = (ShardPartial*)source;
+
+    if (merged->result == NO_ERROR)
+        merged->result = partial->result;
+
+    if (partial->flag && (!merged->flag || (merged->want_max ? (partial->value > merged->value) : (partial->value < merged->value))))
+    {
+        merged->value = partial->value;
+        merged->row = partial->row;
+        merged->col = partial->col;
+        merged->flag = true;
+    }
+}
+
+void shard_localize_selector(Table *table, Selector *selector)
+{
+    /**
+     * @brief Convert rows of @p selector from whole table to rows of shard
+     *
+     * Selected rows that are not held by shard are cut off, so selection can become empty
+     *
+     * @param table Pointer to instance of #Table structure with rows of shard
+     * @param selector Pointer to instance of #Selector structure
+     */
+
+    selector->lld_ir1 -= table->shard->first_row;
+    selector->lld_ir2 -= table->shard->first_row;
+
+    if (selector->lld_ir1 < 0)
+        selector->lld_ir1 = 0;
+    if (selector->lld_ir2 > table->num_of_rows - 1)
+        selector->lld_ir2 = table->num_of_rows - 1;
+}
+
+int set_result_cell(Table *table, long long int r, long long int c, char *string)
+{
+    /**
+     * @brief Save result of aggregate to cell of table
+     *
+     * In sharded execution @p r is row of whole table and cell is saved only by shard that holds it
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param r Row index of output cell
+     * @param c Column index of output cell
+     * @param string Result
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (table->shard != NULL)
+    {
+        r -= table->shard->first_row;
+        if (r < 0 || r >= table->num_of_rows)
+            return NO_ERROR;
+    }
+
+    return set_table_cell(table, r, c, string);
+}
+
+long long int get_number_of_selected_rows(Table *table, Selector *selector)
+{
+    /**
+     * @brief Get number of rows of @p table that are in selection
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure
+     *
+     * @return Number of selected rows
+     */
+
+    long long int last_row = (selector->lld_ir2 < table->num_of_rows) ? selector->lld_ir2 : table->num_of_rows - 1;
+
+    return (last_row >= selector->lld_ir1) ? last_row - selector->lld_ir1 + 1 : 0;
+}
+
+uint64_t cache_region(Table *table, Selector *selector)
+{
+    /**
+     * @brief Compute signature of blocks of selected rows and of types of selected columns of version
+     *
+     * @param table Pointer to instance of #Table structure with view of version
+     * @param selector Pointer to instance of #Selector structure
+     *
+     * @return Signature of selected region
+     */
+
+    TableVersion *version = table->version;
+    uint64_t region = (uint64_t)get_selection_type(table, selector);
+
+    long long int last_row = (selector->lld_ir2 < version->num_of_rows) ? selector->lld_ir2 : version->num_of_rows - 1;
+
+    for (long long int page = selector->lld_ir1 / ROWS_PER_PAGE; page <= last_row / ROWS_PER_PAGE && page < version->num_of_blocks; page++)
+        region = hash_bytes((const char*)&version->blocks[page]->id, sizeof(uint64_t), region);
+
+    return region;
+}
+
+long long int cache_entry_index(Selector *selector, int operation)
+{
+    /**
+     * @brief Get index of cache entry of @p operation on selection
+     *
+     * @param selector Pointer to instance of #Selector structure
+     * @param operation Operation from #CachedOperations
+     *
+     * @return Index of entry
+     */
+
+    long long int key[5] = { operation, selector->lld_ir1, selector->lld_ic1, selector->lld_ir2, selector->lld_ic2 };
+
+    return (long long int)(hash_bytes((const char*)key, sizeof(key), 0) & (RESULT_CACHE_SIZE - 1));
+}
+
+_Bool cache_lookup(Table *table, Selector *selector, int operation, CachedResult *result)
+{
+    /**
+     * @brief Find cached result of @p operation on selection of version
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure
+     * @param operation Operation from #CachedOperations
+     * @param result Pointer where cached result will be saved
+     *
+     * @return True if valid result was found
+     */
+
+    if (table->cache == NULL || table->version == NULL)
+        return false;
+
+    long long int index = cache_entry_index(selector, operation);
+    uint64_t region = cache_region(table, selector);
+    CacheEntry *entry = &table->cache->entries[index];
+    pthread_mutex_t *lock = &table->cache->locks[index % RESULT_CACHE_STRIPES];
+
+    pthread_mutex_lock(lock);
+
+    _Bool found = entry->used && entry->operation == operation && entry->region == region &&
+                  entry->rows[0] == selector->lld_ir1 && entry->rows[1] == selector->lld_ir2 &&
+                  entry->cols[0] == selector->lld_ic1 && entry->cols[1] == selector->lld_ic2;
+    if (found)
+        *result = entry->result;
+
+    pthread_mutex_unlock(lock);
+
+    return found;
+}
+
+void cache_store(Table *table, Selector *selector, int operation, CachedResult *result)
+{
+    /**
+     * @brief Save result of @p operation on selection of version to cache
+     *
+     * Entry replaces older entry with same index
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure
+     * @param operation Operation from #CachedOperations
+     * @param result Pointer to instance of #CachedResult structure
+     */
+
+    if (table->cache == NULL || table->version == NULL)
+        return;
+
+    long long int index = cache_entry_index(selector, operation);
+    uint64_t region = cache_region(table, selector);
+    CacheEntry *entry = &table->cache->entries[index];
+    pthread_mutex_t *lock = &table->cache->locks[index % RESULT_CACHE_STRIPES];
+
+    pthread_mutex_lock(lock);
+
+    entry->used = true;
+    entry->operation = operation;
+    entry->region = region;
+    entry->rows[0] = selector->lld_ir1;
+    entry->rows[1] = selector->lld_ir2;
+    entry->cols[0] = selector->lld_ic1;
+    entry->cols[1] = selector->lld_ic2;
+    entry->result = *result;
+
+    pthread_mutex_unlock(lock);
+}
+
+int init_selection_reduction(SelectionReduction *reduction, Table *table, Selector *selector)
+{
+    /**
+     * @brief Allocate partial results for all chunks of selected rows
+     *
+     * @param reduction Pointer to instance of #SelectionReduction structure
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    long long int num_of_chunks = get_number_of_chunks(get_number_of_selected_rows(table, selector), ROW_CHUNK_SIZE);
+    size_t size = (num_of_chunks > 0) ? (size_t)num_of_chunks : 1;
+
+    reduction->table = table;
+    reduction->selector = selector;
+    reduction->first_row = selector->lld_ir1;
+    reduction->want_max = false;
+    reduction->type = get_selection_type(table, selector);
+    reduction->values = (long double*)calloc(size, sizeof(long double));
+    reduction->counts = (long double*)calloc(size, sizeof(long double));
+    reduction->rows = (long long int*)calloc(size, sizeof(long long int));
+    reduction->cols = (long long int*)calloc(size, sizeof(long long int));
+    reduction->flags = (_Bool*)calloc(size, sizeof(_Bool));
+    reduction->results = (int*)calloc(size, sizeof(int));
+
+    if (reduction->values == NULL || reduction->counts == NULL || reduction->rows == NULL ||
+        reduction->cols == NULL || reduction->flags == NULL || reduction->results == NULL)
+        return ALLOCATION_FAILED;
+
+    return NO_ERROR;
+}
+
+void deallocate_selection_reduction(SelectionReduction *reduction)
+{
+    /**
+     * @brief Deallocate partial results of reduction
+     *
+     * @param reduction Pointer to instance of #SelectionReduction structure
+     */
+
+    free(reduction->values);
+    free(reduction->counts);
+    free(reduction->rows);
+    free(reduction->cols);
+    free(reduction->flags);
+    free(reduction->results);
+}
+
+void sum_chunk(void *arg, long long int chunk, long long int start, long long int end, int worker_id)
+{
+    /**
+     * @brief Sum numeric cells of chunk of selected rows
+     *
+     * Chunk stops at first non numeric cell and sets its flag \n
+     * Integer columns are summed exactly in long long int, numeric columns are converted without checking
+     *
+     * @param arg Pointer to instance of #SelectionReduction structure
+     * @param chunk Index of chunk
+     * @param start Index of first row of chunk (relative to selection)
+     * @param end Index after last row of chunk (relative to selection)
+     * @param worker_id Index of worker (not used)
+     */
+
+    (void)worker_id;
+
+    SelectionReduction *reduction = (SelectionReduction*)arg;
+    Table *table = reduction->table;
+    Selector *selector = reduction->selector;
+
+    long double sum = 0;
+    long double num_of_vals = 0;
+
+    if (reduction->type <= DECIMAL_COLUMN)
+    {
+        long long int integer_sum = 0;
+
+        for (long long int i = reduction->first_row + start; i < (reduction->first_row + end); i++)
+        {
+            Row *row = get_row(table, i);
+            for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < row->num_of_cells); j++)
+            {
+                long long int integer;
+                long double tmp;
+
+                if (reduction->type <= INTEGER_COLUMN && string_to_integer(row->cells[j].content, &integer))
+                {
+                    // Partial sum is moved to long double before it can overflow
+                    if (__builtin_add_overflow(integer_sum, integer, &integer_sum))
+                    {
+                        sum += integer_sum;
+                        integer_sum = integer;
+                    }
+                }
+                else if (string_to_ldouble(row->cells[j].content, &tmp) == NO_ERROR)
+                {
+                    sum += tmp;
+                }
+                else
+                {
+                    reduction->flags[chunk] = true;
+                    return;
+                }
+
+                num_of_vals++;
+            }
+        }
+
+        reduction->values[chunk] = sum + integer_sum;
+        reduction->counts[chunk] = num_of_vals;
+        return;
+    }
+
+    for (long long int i = reduction->first_row + start; i < (reduction->first_row + end); i++)
+    {
+        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < get_row(table, i)->num_of_cells); j++)
+        {
+            if (!is_string_ldouble(get_row(table, i)->cells[j].content))
+            {
+                reduction->flags[chunk] = true;
+                return;
+            }
+
+            long double tmp = 0;
+            if ((reduction->results[chunk] = string_to_ldouble(get_row(table, i)->cells[j].content, &tmp)) != NO_ERROR)
+                return;
+
+            sum += tmp;
+            num_of_vals++;
+        }
+    }
+
+    reduction->values[chunk] = sum;
+    reduction->counts[chunk] = num_of_vals;
+}
+
+int sum_selection(Table *table, Selector *selector, long double *sum, long double *num_of_vals, _Bool *nan)
+{
+    /**
+     * @brief Sum numeric cells in selection
+     *
+     * Chunks of rows are summed in parallel and partial sums are added in order of chunks so result does not depend on number of threads
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure
+     * @param sum Pointer where sum will be saved
+     * @param num_of_vals Pointer where number of summed cells will be saved
+     * @param nan Pointer where flag if non numeric cell was found will be saved
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+    SelectionReduction reduction;
+    CachedResult cached = { .value = 0, .count = 0, .flag = false, .row = 0, .col = 0 };
+
+    if (cache_lookup(table, selector, CACHED_SUM, &cached))
+    {
+        *sum = cached.value;
+        *num_of_vals = cached.count;
+        *nan = cached.flag;
+        return NO_ERROR;
+    }
+
+    *sum = 0;
+    *num_of_vals = 0;
+    *nan = false;
+
+    if ((ret_val = init_selection_reduction(&reduction, table, selector)) == NO_ERROR)
+    {
+        long long int num_of_rows = get_number_of_selected_rows(table, selector);
+        thread_pool_for(get_table_pool(table), num_of_rows, ROW_CHUNK_SIZE, sum_chunk, &reduction);
+
+        for (long long int i = 0; i < get_number_of_chunks(num_of_rows, ROW_CHUNK_SIZE); i++)
+        {
+            if ((ret_val = reduction.results[i]) != NO_ERROR)
+                break;
+
+            if (reduction.flags[i])
+            {
+                *nan = true;
+                break;
+            }
+
+            *sum += reduction.values[i];
+            *num_of_vals += reduction.counts[i];
+        }
+    }
+
+    deallocate_selection_reduction(&reduction);
+
+    // Shards add their sums in order of shards
+    if (table->shard != NULL)
+    {
+        ShardPartial partial = { .result = ret_val, .flag = *nan, .value = *sum, .count = *num_of_vals };
+        int exchange_ret_val = shard_exchange(table->shard, &partial, sizeof(partial), merge_shard_sums);
+
+        ret_val = (exchange_ret_val != NO_ERROR) ? exchange_ret_val : partial.result;
+        *sum = partial.value;
+        *num_of_vals = partial.count;
+        *nan = partial.flag;
+    }
+
+    if (ret_val == NO_ERROR)
+    {
+        cached.value = *sum;
+        cached.count = *num_of_vals;
+        cached.flag = *nan;
+        cache_store(table, selector, CACHED_SUM, &cached);
+    }
+
+    return ret_val;
+}
+
+int sum_cells(Table *table, Selector *selector, long long int r, long long int c)
+{
+    /**
+     * @brief Set sum of all numeric cells to output cell
+     *
+     * @warning
+     * If non numeric cell is found then NaN will be outputed
+     *
+     * @param table Pointer to instance of #Table structure where output data will be saved
+     * @param selector Pointer to instance of #Selector structure that tell us where to find data
+     * @param r Row index of output cell
+     * @param c Column index of output cell
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (r < 0 || r > (get_number_of_rows(table) - 1) || c < 0 || c > (get_row(table, 0)->num_of_cells - 1))
+        return FUNCTION_ARGUMENT_ERROR;
+
+    int ret_val = NO_ERROR;
+
+    long double sum = 0;
+    long double num_of_vals = 0;
+    _Bool nan = false;
+
+    if ((ret_val = sum_selection(table, selector, &sum, &num_of_vals, &nan)) != NO_ERROR)
+        return ret_val;
+
+    if (nan)
+    {
+        ret_val = set_result_cell(table, r, c, "NaN");
+    }
+    else
+    {
+        char *temp_string = NULL;
+        if ((ret_val = ldouble_to_string(sum, &temp_string)) == NO_ERROR)
+        {
+            ret_val = set_result_cell(table, r, c, temp_string);
+            free(temp_string);
+        }
+    }
+
+    return ret_val;
+}
+
+int avg_cells(Table *table, Selector *selector, long long int r, long long int c)
+{
+    /**
+     * @brief Set average value of numeric cells to output cell
+     *
+     * @warning
+     * If non numeric cell is found then NaN will be outputed
+     *
+     * @param table Pointer to instance of #Table structure where output data will be saved
+     * @param selector Pointer to instance of #Selector structure that tell us where to find data
+     * @param r Row index of output cell
+     * @param c Column index of output cell
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (r < 0 || r > (get_number_of_rows(table) - 1) || c < 0 || c > (get_row(table, 0)->num_of_cells - 1))
+        return FUNCTION_ARGUMENT_ERROR;
+
+    int ret_val = NO_ERROR;
+
+    long double sum = 0;
+    long double num_of_vals = 0;
+    _Bool nan = false;
+
+    if ((ret_val = sum_selection(table, selector, &sum, &num_of_vals, &nan)) != NO_ERROR)
+        return ret_val;
+
+    if (nan)
+    {
+        ret_val = set_result_cell(table, r, c, "NaN");
+    }
+    else
+    {
+        sum = sum / num_of_vals;
+
+        char *temp_string = NULL;
+        if ((ret_val = ldouble_to_string(sum, &temp_string)) == NO_ERROR)
+        {
+            ret_val = set_result_cell(table, r, c, temp_string);
+            free(temp_string);
+        }
+    }
+
+    return ret_val;
+}
+
+void count_chunk(void *arg, long long int chunk, long long int start, long long int end, int worker_id)
+{
+    /**
+     * @brief Count non empty cells of chunk of selected rows
+     *
+     * @param arg Pointer to instance of #SelectionReduction structure
+     * @param chunk Index of chunk
+     * @param start Index of first row of chunk (relative to selection)
+     * @param end Index after last row of chunk (relative to selection)
+     * @param worker_id Index of worker (not used)
+     */
+
+    (void)worker_id;
+
+    SelectionReduction *reduction = (SelectionReduction*)arg;
+    Table *table = reduction->table;
+    Selector *selector = reduction->selector;
+
+    long double num_of_cells = 0;
+
+    for (long long int i = reduction->first_row + start; i < (reduction->first_row + end); i++)
+    {
+        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < get_row(table, i)->num_of_cells); j++)
+        {
+            if (!strings_equal(get_row(table, i)->cells[j].content, EMPTY_CELL))
+                num_of_cells++;
+        }
+    }
+
+    reduction->counts[chunk] = num_of_cells;
+}
+
+int count_selection(Table *table, Selector *selector, long double *count)
+{
+    /**
+     * @brief Count non empty cells in selection
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure
+     * @param count Pointer where number of non empty cells will be saved
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    long double num_of_cells = 0;
+    SelectionReduction reduction;
+    CachedResult cached = { .value = 0, .count = 0, .flag = false, .row = 0, .col = 0 };
+
+    if (cache_lookup(table, selector, CACHED_COUNT, &cached))
+    {
+        *count = cached.value;
+        return NO_ERROR;
+    }
+
+    if ((ret_val = init_selection_reduction(&reduction, table, selector)) == NO_ERROR)
+    {
+        long long int num_of_rows = get_number_of_selected_rows(table, selector);
+        thread_pool_for(get_table_pool(table), num_of_rows, ROW_CHUNK_SIZE, count_chunk, &reduction);
+
+        for (long long int i = 0; i < get_number_of_chunks(num_of_rows, ROW_CHUNK_SIZE); i++)
+            num_of_cells += reduction.counts[i];
+    }
+
+    deallocate_selection_reduction(&reduction);
+
+    // Shards add their counts in order of shards
+    if (table->shard != NULL)
+    {
+        ShardPartial partial = { .result = ret_val, .count = num_of_cells };
+        int exchange_ret_val = shard_exchange(table->shard, &partial, sizeof(partial), merge_shard_sums);
+
+        ret_val = (exchange_ret_val != NO_ERROR) ? exchange_ret_val : partial.result;
+        num_of_cells = partial.count;
+    }
+
+    *count = num_of_cells;
+
+    if (ret_val == NO_ERROR)
+    {
+        cached.value = num_of_cells;
+        cache_store(table, selector, CACHED_COUNT, &cached);
+    }
+
+    return ret_val;
+}
+
+int count_cells(Table *table, Selector *selector, long long int r, long long int c)
+{
+    /**
+     * @brief Set number of non empty cells to output cell
+     *
+     * @param table Pointer to instance of #Table structure where output data will be saved
+     * @param selector Pointer to instance of #Selector structure that tell us where to find data
+     * @param r Row index of output cell
+     * @param c Column index of output cell
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (r < 0 || r > (get_number_of_rows(table) - 1) || c < 0 || c > (get_row(table, 0)->num_of_cells - 1))
+        return FUNCTION_ARGUMENT_ERROR;
+
+    int ret_val;
+    long double num_of_cells = 0;
+
+    if ((ret_val = count_selection(table, selector, &num_of_cells)) != NO_ERROR)
+        return ret_val;
+
+    char *temp_string = NULL;
+    if ((ret_val = ldouble_to_string(num_of_cells, &temp_string)) == NO_ERROR)
+    {
+        ret_val = set_result_cell(table, r, c, temp_string);
+        free(temp_string);
+    }
+
+    return ret_val;
+}
+
+int cell_len(Table *table, Selector *selector, long long int r, long long int c)
+{
+    /**
+     * @brief Set length of string to output cell
+     *
+     * @warning
+     * If more that one cell is selected then only length of last cell will be outputed
+     *
+     * @param table Pointer to instance of #Table structure where output data will be saved
+     * @param selector Pointer to instance of #Selector structure that tell us where to find data
+     * @param r Row index of output cell
+     * @param c Column index of output cell
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (r < 0 || r > (table->num_of_rows - 1) || c < 0 || c > (get_row(table, 0)->num_of_cells - 1))
+        return FUNCTION_ARGUMENT_ERROR;
+
+    int ret_val = NO_ERROR;
+
+    unsigned long int cell_length = (get_row(table, selector->lld_ir2)->cells[selector->lld_ic2].content != NULL) ? strlen(get_row(table, selector->lld_ir2)->cells[selector->lld_ic2].content) : 0;
+
+    char *temp_string = NULL;
+    if ((ret_val = ldouble_to_string((long double)cell_length, &temp_string)) == NO_ERROR)
+    {
+        ret_val = set_table_cell(table, r, c, temp_string);
+        free(temp_string);
+    }
+
+    return ret_val;
+}
+
+int parse_window_argument(char *argument, _Bool has_window, long long int *window, long long int *col, Table *table)
+{
+    /**
+     * @brief Parse argument of running and windowed commands in form [C] or [W,C]
+     *
+     * @param argument Argument of command (NULL if command has no argument)
+     * @param has_window Flag if argument contains window size
+     * @param window Pointer where window size will be saved (can be NULL if @p has_window is false)
+     * @param col Pointer where index of target column will be saved
+     * @param table Pointer to instance of #Table structure for checking if column exists
+     *
+     * @return #NO_ERROR on success, #COMMAND_ERROR when argument is invalid
+     */
+
+    if (argument == NULL)
+        return COMMAND_ERROR;
+
+    int consumed = -1;
+    int parsed = has_window ? sscanf(argument, "[%lld,%lld]%n", window, col, &consumed) : sscanf(argument, "[%lld]%n", col, &consumed);
+
+    if (parsed != (has_window ? 2 : 1) || consumed != (int)strlen(argument))
+        return COMMAND_ERROR;
+
+    if ((has_window && *window < 1) || *col < 1 || *col > get_row(table, 0)->num_of_cells)
+        return COMMAND_ERROR;
+
+    (*col)--;
+
+    return NO_ERROR;
+}
+
+int write_running_value(Table *table, long long int r, long long int c, long double value, _Bool nan)
+{
+    /**
+     * @brief Write value of running or windowed aggregate to cell
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param r Row index of cell
+     * @param c Column index of cell
+     * @param value Value to write
+     * @param nan Flag if NaN should be written instead of @p value
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    if (nan)
+        return set_table_cell(table, r, c, "NaN");
+
+    char *temp_string = NULL;
+    int ret_val = ldouble_to_string(value, &temp_string);
+    if (ret_val == NO_ERROR)
+    {
+        ret_val = set_table_cell(table, r, c, temp_string);
+        free(temp_string);
+    }
+
+    return ret_val;
+}
+
+int window_cells(Table *table, Selector *selector, int function, long long int window, long long int c)
+{
+    /**
+     * @brief Fill column @p c with running or windowed aggregate of first selected column
+     *
+     * All selected rows are processed in one pass, each source cell is converted to number only once \n
+     * Functions: 0 - cumulative sum, 1 - moving average, 2 - moving minimum, 3 - moving maximum \n
+     * Window of row contains the row and @p window - 1 rows above it (only selected ones) \n
+     * Non numeric cell makes sum or average NaN, minimum and maximum ignore it (NaN when there is no number in window) \n
+     * Minimum and maximum use deque of candidate rows that is monotonic in value, so every row is pushed and popped at most once
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure with source rows and column
+     * @param function Index of function
+     * @param window Size of window (ignored by cumulative sum)
+     * @param c Index of target column
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    long long int num_of_rows = get_number_of_selected_rows(table, selector);
+    long long int first_row = selector->lld_ir1;
+    long long int source_col = selector->lld_ic1;
+
+    if (num_of_rows == 0)
+        return NO_ERROR;
+
+    long double *values = (long double*)malloc((size_t)num_of_rows * sizeof(long double));
+    _Bool *numeric = (_Bool*)malloc((size_t)num_of_rows * sizeof(_Bool));
+    long long int *deque = (long long int*)malloc((size_t)num_of_rows * sizeof(long long int));
+    if (values == NULL || numeric == NULL || deque == NULL)
+    {
+        free(values);
+        free(numeric);
+        free(deque);
+        return ALLOCATION_FAILED;
+    }
+
+    int ret_val = NO_ERROR;
+
+    // Convert source cells only once
+    for (long long int i = 0; i < num_of_rows && ret_val == NO_ERROR; i++)
+    {
+        Row *row = get_row(table, first_row + i);
+        numeric[i] = (source_col < row->num_of_cells && is_string_ldouble(row->cells[source_col].content));
+        values[i] = 0;
+        if (numeric[i])
+            ret_val = string_to_ldouble(row->cells[source_col].content, &values[i]);
+    }
+
+    long double sum = 0;
+    long long int non_numeric = 0;
+    long long int deque_start = 0, deque_end = 0;
+
+    for (long long int i = 0; i < num_of_rows && ret_val == NO_ERROR; i++)
+    {
+        long long int leaving = i - window;
+
+        switch (function)
+        {
+            // cumsum
+            case 0:
+                sum += values[i];
+                non_numeric += !numeric[i];
+                ret_val = write_running_value(table, first_row + i, c, sum, non_numeric > 0);
+                break;
+
+            // mavg
+            case 1:
+                sum += values[i];
+                non_numeric += !numeric[i];
+                if (leaving >= 0)
+                {
+                    sum -= values[leaving];
+                    non_numeric -= !numeric[leaving];
+                }
+                ret_val = write_running_value(table, first_row + i, c, sum / ((leaving >= 0) ? window : i + 1), non_numeric > 0);
+                break;
+
+            // mmin, mmax
+            case 2:
+            case 3:
+                if (deque_start < deque_end && deque[deque_start] <= leaving)
+                    deque_start++;
+
+                if (numeric[i])
+                {
+                    // Drop candidates that can never be extreme again
+                    while (deque_start < deque_end &&
+                           ((function == 2) ? (values[deque[deque_end - 1]] >= values[i]) : (values[deque[deque_end - 1]] <= values[i])))
+                        deque_end--;
+
+                    deque[deque_end++] = i;
+                }
+
+                ret_val = write_running_value(table, first_row + i, c, (deque_start < deque_end) ? values[deque[deque_start]] : 0, deque_start == deque_end);
+                break;
+
+            default:
+                ret_val = FUNCTION_ERROR;
+                break;
+        }
+    }
+
+    free(values);
+    free(numeric);
+    free(deque);
+
+    if (ret_val == NO_ERROR)
+        ret_val = formula_cells_written(table, first_row, c, first_row + num_of_rows - 1, c);
+
+    return ret_val;
+}
+
+int get_selection_values(Table *table, Selector *selector, long double **values, long long int *num_of_values, _Bool *non_numeric)
+{
+    /**
+     * @brief Convert all numeric cells in selection to array of numbers
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure
+     * @param values Pointer where allocated array of numbers will be saved (caller must free it)
+     * @param num_of_values Pointer where number of numbers will be saved
+     * @param non_numeric Pointer where flag if some non numeric cell was found will be saved
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+    long long int allocated = BASE_NUMBER_OF_CELLS;
+
+    *num_of_values = 0;
+    *non_numeric = false;
+    *values = (long double*)malloc((size_t)allocated * sizeof(long double));
+    if (*values == NULL)
+        return ALLOCATION_FAILED;
+
+    for (long long int i = selector->lld_ir1; (i <= selector->lld_ir2) && (i < table->num_of_rows) && (ret_val == NO_ERROR); i++)
+    {
+        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < get_row(table, i)->num_of_cells); j++)
+        {
+            if (!is_string_ldouble(get_row(table, i)->cells[j].content))
+            {
+                *non_numeric = true;
+                continue;
+            }
+
+            if (*num_of_values == allocated)
+            {
+                long double *tmp = (long double*)realloc(*values, (size_t)allocated * 2 * sizeof(long double));
+                if (tmp == NULL)
+                {
+                    ret_val = ALLOCATION_FAILED;
+                    break;
+                }
+
+                *values = tmp;
+                allocated *= 2;
+            }
+
+            if ((ret_val = string_to_ldouble(get_row(table, i)->cells[j].content, &(*values)[*num_of_values])) != NO_ERROR)
+                break;
+
+            (*num_of_values)++;
+        }
+    }
+
+    if (ret_val != NO_ERROR)
+    {
+        free(*values);
+        *values = NULL;
+    }
+
+    return ret_val;
+}
+
+void swap_values(long double *values, long long int a, long long int b)
+{
+    /**
+     * @brief Swap two numbers in array
+     *
+     * @param values Array of numbers
+     * @param a Index of first number
+     * @param b Index of second number
+     */
+
+    long double tmp = values[a];
+    values[a] = values[b];
+    values[b] = tmp;
+}
+
+void sift_down_values(long double *values, long long int start, long long int root, long long int size)
+{
+    /**
+     * @brief Restore max-heap property of heap stored in @p values from @p start
+     *
+     * @param values Array of numbers
+     * @param start Index of first item of heap
+     * @param root Index of root of subtree (relative to @p start)
+     * @param size Number of items in heap
+     */
+
+    while (true)
+    {
+        long long int largest = root;
+        long long int left = 2 * root + 1, right = 2 * root + 2;
+
+        if (left < size && values[start + left] > values[start + largest])
+            largest = left;
+        if (right < size && values[start + right] > values[start + largest])
+            largest = right;
+
+        if (largest == root)
+            return;
+
+        swap_values(values, start + root, start + largest);
+        root = largest;
+    }
+}
+
+void introselect(long double *values, long long int num_of_values, long long int k)
+{
+    /**
+     * @brief Reorder @p values so k-th smallest number is on index @p k
+     *
+     * All numbers before index @p k are not greater and all numbers after it are not smaller \n
+     * Quickselect with median of three pivot is used and when it does not shrink the range fast enough
+     * (recursion depth over 2 * log2(n)) the rest is heapsorted, so worst case is O(n log n)
+     *
+     * @param values Array of numbers
+     * @param num_of_values Number of numbers
+     * @param k Wanted index
+     */
+
+    long long int left = 0, right = num_of_values - 1;
+
+    int depth_limit = 0;
+    for (long long int n = num_of_values; n > 1; n >>= 1)
+        depth_limit += 2;
+
+    while (right > left)
+    {
+        if (depth_limit-- == 0)
+        {
+            // Heapsort of rest of range
+            long long int size = right - left + 1;
+            for (long long int i = size / 2 - 1; i >= 0; i--)
+                sift_down_values(values, left, i, size);
+            for (long long int i = size - 1; i > 0; i--)
+            {
+                swap_values(values, left, left + i);
+                sift_down_values(values, left, 0, i);
+            }
+            return;
+        }
+
+        // Median of three to the middle position
+        long long int middle = left + (right - left) / 2;
+        if (values[middle] < values[left])
+            swap_values(values, middle, left);
+        if (values[right] < values[left])
+            swap_values(values, right, left);
+        if (values[right] < values[middle])
+            swap_values(values, right, middle);
+
+        long double pivot = values[middle];
+
+        // Hoare partition
+        long long int i = left, j = right;
+        while (i <= j)
+        {
+            while (values[i] < pivot)
+                i++;
+            while (values[j] > pivot)
+                j--;
+
+            if (i <= j)
+            {
+                swap_values(values, i, j);
+                i++;
+                j--;
+            }
+        }
+
+        if (k <= j)
+            right = j;
+        else if (k >= i)
+            left = i;
+        else
+            return;
+    }
+}
+
+int quantile_cells(Table *table, Selector *selector, long double quantile, long long int r, long long int c)
+{
+    /**
+     * @brief Set quantile of numeric cells in selection to output cell
+     *
+     * Quantile is interpolated linearly between two closest numbers, both of them are found by #introselect in O(n)
+     *
+     * @warning
+     * If non numeric cell is found then NaN will be outputed
+     *
+     * @param table Pointer to instance of #Table structure where output data will be saved
+     * @param selector Pointer to instance of #Selector structure that tell us where to find data
+     * @param quantile Wanted quantile (0 - minimum, 0.5 - median, 1 - maximum)
+     * @param r Row index of output cell
+     * @param c Column index of output cell
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (r < 0 || r > (table->num_of_rows - 1) || c < 0 || c > (get_row(table, 0)->num_of_cells - 1) || quantile < 0 || quantile > 1)
+        return FUNCTION_ARGUMENT_ERROR;
+
+    int ret_val = NO_ERROR;
+    long double *values = NULL;
+    long long int num_of_values = 0;
+    _Bool non_numeric = false;
+
+    if ((ret_val = get_selection_values(table, selector, &values, &num_of_values, &non_numeric)) != NO_ERROR)
+        return ret_val;
+
+    long double result = 0;
+    if (!non_numeric && num_of_values > 0)
+    {
+        long double position = quantile * (num_of_values - 1);
+        long long int lower = (long long int)position;
+
+        introselect(values, num_of_values, lower);
+        result = values[lower];
+
+        // Next number is the smallest one after selected index
+        if (lower + 1 < num_of_values && position > lower)
+        {
+            long double upper = values[lower + 1];
+            for (long long int i = lower + 2; i < num_of_values; i++)
+                if (values[i] < upper)
+                    upper = values[i];
+
+            result += (position - lower) * (upper - result);
+        }
+    }
+
+    free(values);
+
+    ret_val = write_running_value(table, r, c, result, non_numeric || num_of_values == 0);
+    if (ret_val == NO_ERROR)
+        ret_val = formula_cells_written(table, r, c, r, c);
+
+    return ret_val;
+}
+
+_Bool top_value_worse(TopValue *a, TopValue *b)
+{
+    /**
+     * @brief Check if @p a is worse than @p b (smaller value or same value later in selection)
+     *
+     * @param a Pointer to first item
+     * @param b Pointer to second item
+     *
+     * @return true if @p a is worse
+     */
+
+    return (a->value < b->value) || (a->value == b->value && a->order > b->order);
+}
+
+void sift_down_top_values(TopValue *heap, long long int root, long long int size)
+{
+    /**
+     * @brief Restore heap property of heap with the worst item on top
+     *
+     * @param heap Array of items
+     * @param root Index of root of subtree
+     * @param size Number of items in heap
+     */
+
+    while (true)
+    {
+        long long int worst = root;
+        long long int left = 2 * root + 1, right = 2 * root + 2;
+
+        if (left < size && top_value_worse(&heap[left], &heap[worst]))
+            worst = left;
+        if (right < size && top_value_worse(&heap[right], &heap[worst]))
+            worst = right;
+
+        if (worst == root)
+            return;
+
+        TopValue tmp = heap[root];
+        heap[root] = heap[worst];
+        heap[worst] = tmp;
+        root = worst;
+    }
+}
+
+int top_cells(Table *table, Selector *selector, long long int k, long long int c)
+{
+    /**
+     * @brief Write @p k largest numbers of selection in descending order to column @p c
+     *
+     * Numbers are written from first selected row down, non numeric cells are ignored \n
+     * Bounded heap of @p k items with the worst one on top is used, so it takes O(n log k)
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure that tell us where to find data
+     * @param k Number of wanted numbers
+     * @param c Index of target column
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+    long long int rows_left = table->num_of_rows - selector->lld_ir1;
+
+    // There is no place for more numbers than rows under selection
+    if (k > rows_left)
+        k = rows_left;
+    if (k <= 0)
+        return NO_ERROR;
+
+    TopValue *heap = (TopValue*)malloc((size_t)k * sizeof(TopValue));
+    if (heap == NULL)
+        return ALLOCATION_FAILED;
+
+    long long int size = 0, order = 0;
+
+    for (long long int i = selector->lld_ir1; (i <= selector->lld_ir2) && (i < table->num_of_rows) && (ret_val == NO_ERROR); i++)
+    {
+        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < get_row(table, i)->num_of_cells); j++)
+        {
+            if (!is_string_ldouble(get_row(table, i)->cells[j].content))
+                continue;
+
+            TopValue item = { .value = 0, .order = order++ };
+            if ((ret_val = string_to_ldouble(get_row(table, i)->cells[j].content, &item.value)) != NO_ERROR)
+                break;
+
+            if (size < k)
+            {
+                // Sift up
+                long long int child = size++;
+                heap[child] = item;
+                while (child > 0 && top_value_worse(&heap[child], &heap[(child - 1) / 2]))
+                {
+                    TopValue tmp = heap[child];
+                    heap[child] = heap[(child - 1) / 2];
+                    heap[(child - 1) / 2] = tmp;
+                    child = (child - 1) / 2;
+                }
+            }
+            else if (top_value_worse(&heap[0], &item))
+            {
+                heap[0] = item;
+                sift_down_top_values(heap, 0, size);
+            }
+        }
+    }
+
+    // Pop the worst items to the end so array is sorted from the best one
+    for (long long int i = size - 1; i > 0 && ret_val == NO_ERROR; i--)
+    {
+        TopValue tmp = heap[0];
+        heap[0] = heap[i];
+        heap[i] = tmp;
+        sift_down_top_values(heap, 0, i);
+    }
+
+    for (long long int i = 0; i < size && ret_val == NO_ERROR; i++)
+        ret_val = write_running_value(table, selector->lld_ir1 + i, c, heap[i].value, false);
+
+    free(heap);
+
+    if (ret_val == NO_ERROR && size > 0)
+        ret_val = formula_cells_written(table, selector->lld_ir1, c, selector->lld_ir1 + size - 1, c);
+
+    return ret_val;
+}
+
+uint64_t hash_row(Row *row, Selector *selector, long long int skipped_col)
+{
+    /**
+     * @brief Compute hash of selected cells of @p row
+     *
+     * Hash of each cell is seeded by hash of previous cell, so order of cells and their boundaries change the hash
+     *
+     * @param row Pointer to instance of #Row structure
+     * @param selector Pointer to instance of #Selector structure with selected columns
+     * @param skipped_col Column that isnt hashed (-1 if none)
+     *
+     * @return Hash of row
+     */
+
+    uint64_t hash = 0;
+
+    for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < row->num_of_cells); j++)
+    {
+        if (j == skipped_col)
+            continue;
+
+        const char *content = (row->cells[j].content != NULL) ? row->cells[j].content : "";
+        hash = hash_bytes(content, strlen(content), hash);
+    }
+
+    return hash;
+}
+
+void hash_chunk(void *arg, long long int chunk, long long int start, long long int end, int worker_id)
+{
+    /**
+     * @brief Hash chunk of selected rows
+     *
+     * Digest term of row is hash of row hash seeded by position of row in selection,
+     * terms are added, so digest doesnt depend on chunks and threads but depends on order of rows
+     *
+     * @param arg Pointer to instance of #RowHashes structure
+     * @param chunk Index of chunk
+     * @param start Index of first row of chunk (relative to selection)
+     * @param end Index after last row of chunk (relative to selection)
+     * @param worker_id Index of worker (not used)
+     */
+
+    (void)worker_id;
+
+    RowHashes *job = (RowHashes*)arg;
+    uint64_t sum = 0;
+
+    for (long long int i = start; i < end; i++)
+    {
+        uint64_t hash = hash_row(get_row(job->table, job->first_row + i), job->selector, job->skipped_col);
+
+        if (job->hashes != NULL)
+            job->hashes[i] = hash;
+
+        sum += hash_bytes((const char*)&hash, sizeof(hash), (uint64_t)i);
+    }
+
+    job->sums[chunk] = sum;
+}
+
+int compute_row_hashes(Table *table, Selector *selector, long long int skipped_col, uint64_t *hashes, uint64_t *digest)
+{
+    /**
+     * @brief Hash all selected rows in parallel and combine them to digest of selection
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure
+     * @param skipped_col Column that isnt hashed (-1 if none)
+     * @param hashes Array where hash of each selected row will be saved (can be NULL)
+     * @param digest Pointer where digest of selection will be saved
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    long long int num_of_rows = get_number_of_selected_rows(table, selector);
+    long long int num_of_chunks = get_number_of_chunks(num_of_rows, ROW_CHUNK_SIZE);
+
+    RowHashes job;
+    job.table = table;
+    job.selector = selector;
+    job.first_row = selector->lld_ir1;
+    job.skipped_col = skipped_col;
+    job.hashes = hashes;
+    job.sums = (uint64_t*)calloc((num_of_chunks > 0) ? (size_t)num_of_chunks : 1, sizeof(uint64_t));
+    if (job.sums == NULL)
+        return ALLOCATION_FAILED;
+
+    thread_pool_for(get_table_pool(table), num_of_rows, ROW_CHUNK_SIZE, hash_chunk, &job);
+
+    uint64_t sum = 0;
+    for (long long int i = 0; i < num_of_chunks; i++)
+        sum += job.sums[i];
+
+    free(job.sums);
+
+    // Number of rows is mixed in, so rows with empty hash cant be appended without change of digest
+    *digest = hash_bytes((const char*)&sum, sizeof(sum), (uint64_t)num_of_rows);
+
+    return NO_ERROR;
+}
+
+int hash_rows(Table *table, Selector *selector, long long int c)
+{
+    /**
+     * @brief Write hash of selected cells of each selected row to column @p c of the row
+     *
+     * Hash is written as 16 hexadecimal digits, column @p c itself isnt hashed, so repeated command writes same hashes
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure
+     * @param c Index of target column
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    long long int num_of_rows = get_number_of_selected_rows(table, selector);
+    if (num_of_rows == 0)
+        return NO_ERROR;
+
+    uint64_t *hashes = (uint64_t*)malloc((size_t)num_of_rows * sizeof(uint64_t));
+    if (hashes == NULL)
+        return ALLOCATION_FAILED;
+
+    uint64_t digest;
+    int ret_val = compute_row_hashes(table, selector, c, hashes, &digest);
+
+    char string[2 * sizeof(uint64_t) + 1];
+    for (long long int i = 0; (i < num_of_rows) && (ret_val == NO_ERROR); i++)
+    {
+        snprintf(string, sizeof(string), "%016llx", (unsigned long long int)hashes[i]);
+        ret_val = set_table_cell(table, selector->lld_ir1 + i, c, string);
+    }
+
+    free(hashes);
+
+    if (ret_val == NO_ERROR)
+        ret_val = formula_cells_written(table, selector->lld_ir1, c, selector->lld_ir1 + num_of_rows - 1, c);
+
+    return ret_val;
+}
+
+int hash_selection(Table *table, Selector *selector, long long int r, long long int c)
+{
+    /**
+     * @brief Write digest of whole selection to cell [@p r, @p c]
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure
+     * @param r Row index of output cell
+     * @param c Column index of output cell
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    uint64_t digest;
+    int ret_val = compute_row_hashes(table, selector, -1, NULL, &digest);
+    if (ret_val != NO_ERROR)
+        return ret_val;
+
+    char string[2 * sizeof(uint64_t) + 1];
+    snprintf(string, sizeof(string), "%016llx", (unsigned long long int)digest);
+
+    return set_table_cell(table, r, c, string);
+}
+
+void key_map_init(KeyMap *map)
+{
+    /**
+     * @brief Initialize @p map to empty map
+     *
+     * @param map Pointer to instance of #KeyMap structure
+     */
+
+    map->keys = NULL;
+    map->hashes = NULL;
+    map->num_of_keys = 0;
+    map->allocated_keys = 0;
+    map->slots = NULL;
+    map->num_of_slots = 0;
+}
+
+void key_map_destroy(KeyMap *map)
+{
+    /**
+     * @brief Free all keys and slots of @p map
+     *
+     * @param map Pointer to instance of #KeyMap structure
+     */
+
+    for (long long int i = 0; i < map->num_of_keys; i++)
+        free(map->keys[i]);
+
+    free(map->keys);
+    free(map->hashes);
+    free(map->slots);
+    key_map_init(map);
+}
+
+int key_map_grow(KeyMap *map)
+{
+    /**
+     * @brief Double number of keys and slots of @p map and rehash all keys
+     *
+     * @param map Pointer to instance of #KeyMap structure
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    long long int allocated_keys = (map->allocated_keys > 0) ? map->allocated_keys * 2 : BASE_NUMBER_OF_KEYS;
+
+    char **keys = (char**)realloc(map->keys, (size_t)allocated_keys * sizeof(char*));
+    if (keys == NULL)
+        return ALLOCATION_FAILED;
+    map->keys = keys;
+
+    uint64_t *hashes = (uint64_t*)realloc(map->hashes, (size_t)allocated_keys * sizeof(uint64_t));
+    if (hashes == NULL)
+        return ALLOCATION_FAILED;
+    map->hashes = hashes;
+
+    long long int *slots = (long long int*)calloc((size_t)allocated_keys * 2, sizeof(long long int));
+    if (slots == NULL)
+        return ALLOCATION_FAILED;
+
+    free(map->slots);
+    map->slots = slots;
+    map->num_of_slots = allocated_keys * 2;
+    map->allocated_keys = allocated_keys;
+
+    for (long long int i = 0; i < map->num_of_keys; i++)
+    {
+        long long int slot = (long long int)(map->hashes[i] & (uint64_t)(map->num_of_slots - 1));
+        while (map->slots[slot] != 0)
+            slot = (slot + 1) & (map->num_of_slots - 1);
+        map->slots[slot] = i + 1;
+    }
+
+    return NO_ERROR;
+}
+
+int key_map_insert(KeyMap *map, const char *key, long long int *index)
+{
+    /**
+     * @brief Find index of @p key in @p map or insert it as new key
+     *
+     * @param map Pointer to instance of #KeyMap structure
+     * @param key Key to find (it is copied when inserted)
+     * @param index Pointer where index of key will be saved
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    size_t length = strlen(key);
+    uint64_t hash = hash_bytes(key, length, 0);
+
+    if (map->num_of_slots > 0)
+    {
+        long long int slot = (long long int)(hash & (uint64_t)(map->num_of_slots - 1));
+        for (; map->slots[slot] != 0; slot = (slot + 1) & (map->num_of_slots - 1))
+        {
+            long long int candidate = map->slots[slot] - 1;
+            if (map->hashes[candidate] == hash && strcmp(map->keys[candidate], key) == 0)
+            {
+                *index = candidate;
+                return NO_ERROR;
+            }
+        }
+    }
+
+    if (map->num_of_keys == map->allocated_keys && key_map_grow(map) != NO_ERROR)
+        return ALLOCATION_FAILED;
+
+    char *copy = (char*)malloc(length + 1);
+    if (copy == NULL)
+        return ALLOCATION_FAILED;
+    memcpy(copy, key, length + 1);
+
+    long long int slot = (long long int)(hash & (uint64_t)(map->num_of_slots - 1));
+    while (map->slots[slot] != 0)
+        slot = (slot + 1) & (map->num_of_slots - 1);
+
+    map->keys[map->num_of_keys] = copy;
+    map->hashes[map->num_of_keys] = hash;
+    map->slots[slot] = map->num_of_keys + 1;
+    *index = map->num_of_keys++;
+
+    return NO_ERROR;
+}
+
+void hll_add(unsigned char *registers, uint64_t hash)
+{
+    /**
+     * @brief Add hashed value to HyperLogLog sketch
+     *
+     * @param registers Array of #HLL_REGISTERS registers
+     * @param hash Hash of value
+     */
+
+    uint64_t index = hash >> (64 - HLL_PRECISION);
+    uint64_t rest = (hash << HLL_PRECISION) | ((uint64_t)1 << (HLL_PRECISION - 1));
+    unsigned char rank = (unsigned char)(__builtin_clzll(rest) + 1);
+
+    if (rank > registers[index])
+        registers[index] = rank;
+}
+
+long double hll_estimate(unsigned char *registers)
+{
+    /**
+     * @brief Estimate number of distinct values in HyperLogLog sketch
+     *
+     * Linear counting is used for small cardinalities
+     *
+     * @param registers Array of #HLL_REGISTERS registers
+     *
+     * @return Estimated number of distinct values
+     */
+
+    long double m = HLL_REGISTERS;
+    long double sum = 0;
+    long long int zeros = 0;
+
+    for (int i = 0; i < HLL_REGISTERS; i++)
+    {
+        sum += ldexpl(1.0L, -registers[i]);
+        if (registers[i] == 0)
+            zeros++;
+    }
+
+    long double estimate = (0.7213L / (1 + 1.079L / m)) * m * m / sum;
+
+    if (estimate <= 2.5L * m && zeros > 0)
+        estimate = m * logl(m / zeros);
+
+    return roundl(estimate);
+}
+
+long long int kll_capacity(KllSketch *sketch, int level)
+{
+    /**
+     * @brief Get capacity of level of KLL sketch
+     *
+     * Capacity shrinks by factor 2/3 for each level under the top one
+     *
+     * @param sketch Pointer to instance of #KllSketch structure
+     * @param level Index of level
+     *
+     * @return Maximum number of items of level
+     */
+
+    long double capacity = KLL_K;
+    for (int i = level; i < sketch->num_of_levels - 1; i++)
+        capacity = capacity * 2 / 3;
+
+    return (capacity < 2) ? 2 : (long long int)ceill(capacity);
+}
+
+int kll_push(KllSketch *sketch, int level, long double value)
+{
+    /**
+     * @brief Append item to level of KLL sketch
+     *
+     * @param sketch Pointer to instance of #KllSketch structure
+     * @param level Index of level
+     * @param value Appended item
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    if (level >= KLL_MAX_LEVELS)
+        return FUNCTION_ERROR;
+
+    while (sketch->num_of_levels <= level)
+    {
+        sketch->levels[sketch->num_of_levels] = NULL;
+        sketch->sizes[sketch->num_of_levels] = 0;
+        sketch->allocated[sketch->num_of_levels] = 0;
+        sketch->offsets[sketch->num_of_levels] = false;
+        sketch->num_of_levels++;
+    }
+
+    if (sketch->sizes[level] == sketch->allocated[level])
+    {
+        long long int new_allocated = (sketch->allocated[level] > 0) ? sketch->allocated[level] * 2 : KLL_K;
+        long double *tmp = (long double*)realloc(sketch->levels[level], (size_t)new_allocated * sizeof(long double));
+        if (tmp == NULL)
+            return ALLOCATION_FAILED;
+
+        sketch->levels[level] = tmp;
+        sketch->allocated[level] = new_allocated;
+    }
+
+    sketch->levels[level][sketch->sizes[level]++] = value;
+
+    return NO_ERROR;
+}
+
+int compare_ldoubles(const void *a, const void *b)
+{
+    /**
+     * @brief Compare two long doubles for qsort
+     *
+     * @param a Pointer to first number
+     * @param b Pointer to second number
+     *
+     * @return Negative number, zero or positive number when @p a is smaller, equal or greater than @p b
+     */
+
+    long double first = *(const long double*)a;
+    long double second = *(const long double*)b;
+
+    return (first > second) - (first < second);
+}
+
+int kll_compress(KllSketch *sketch)
+{
+    /**
+     * @brief Compact all levels of KLL sketch that are over capacity
+     *
+     * Level is sorted and every second item (alternately odd and even ones) is promoted to next level with double weight
+     *
+     * @param sketch Pointer to instance of #KllSketch structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    for (int level = 0; level < sketch->num_of_levels; level++)
+    {
+        if (sketch->sizes[level] < kll_capacity(sketch, level))
+            continue;
+
+        long double *items = sketch->levels[level];
+        long long int size = sketch->sizes[level];
+        qsort(items, (size_t)size, sizeof(long double), compare_ldoubles);
+
+        // Odd item stays on its level
+        long long int pairs = size / 2;
+        int offset = sketch->offsets[level] ? 1 : 0;
+        sketch->offsets[level] = !sketch->offsets[level];
+
+        for (long long int i = 0; i < pairs; i++)
+            if ((ret_val = kll_push(sketch, level + 1, items[2 * i + offset])) != NO_ERROR)
+                return ret_val;
+
+        // Level array could be reallocated by push to new level only if it is the same level, so refresh pointer
+        items = sketch->levels[level];
+        if (size % 2 == 1)
+            items[0] = items[size - 1];
+        sketch->sizes[level] = size % 2;
+    }
+
+    return NO_ERROR;
+}
+
+void kll_destroy(KllSketch *sketch)
+{
+    /**
+     * @brief Free all levels of KLL sketch
+     *
+     * @param sketch Pointer to instance of #KllSketch structure
+     */
+
+    for (int i = 0; i < sketch->num_of_levels; i++)
+        free(sketch->levels[i]);
+    sketch->num_of_levels = 0;
+}
+
+int kll_merge(KllSketch *target, KllSketch *source)
+{
+    /**
+     * @brief Merge @p source sketch to @p target sketch
+     *
+     * @param target Pointer to instance of #KllSketch structure where result will be saved
+     * @param source Pointer to instance of #KllSketch structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    for (int level = 0; level < source->num_of_levels; level++)
+        for (long long int i = 0; i < source->sizes[level]; i++)
+            if ((ret_val = kll_push(target, level, source->levels[level][i])) != NO_ERROR)
+                return ret_val;
+
+    return kll_compress(target);
+}
+
+int kll_quantile(KllSketch *sketch, long double quantile, long double *value, _Bool *empty)
+{
+    /**
+     * @brief Get approximate quantile from KLL sketch
+     *
+     * @param sketch Pointer to instance of #KllSketch structure
+     * @param quantile Wanted quantile (0 - 1)
+     * @param value Pointer where quantile will be saved
+     * @param empty Pointer where flag that sketch is empty will be saved
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    long long int num_of_items = 0;
+    for (int level = 0; level < sketch->num_of_levels; level++)
+        num_of_items += sketch->sizes[level];
+
+    *empty = (num_of_items == 0);
+    if (*empty)
+        return NO_ERROR;
+
+    // Items with weights, weight of item on level h is 2^h
+    TopValue *items = (TopValue*)malloc((size_t)num_of_items * sizeof(TopValue));
+    if (items == NULL)
+        return ALLOCATION_FAILED;
+
+    long long int k = 0;
+    long double total_weight = 0;
+    for (int level = 0; level < sketch->num_of_levels; level++)
+    {
+        for (long long int i = 0; i < sketch->sizes[level]; i++)
+        {
+            items[k].value = sketch->levels[level][i];
+            items[k].order = (long long int)1 << level;
+            total_weight += items[k].order;
+            k++;
+        }
+    }
+
+    qsort(items, (size_t)num_of_items, sizeof(TopValue), compare_ldoubles);
+
+    long double wanted_weight = quantile * total_weight;
+    long double weight = 0;
+    *value = items[num_of_items - 1].value;
+
+    for (long long int i = 0; i < num_of_items; i++)
+    {
+        weight += items[i].order;
+        if (weight >= wanted_weight)
+        {
+            *value = items[i].value;
+            break;
+        }
+    }
+
+    free(items);
+
+    return NO_ERROR;
+}
+
+void sketch_chunk(void *arg, long long int chunk, long long int start, long long int end, int worker_id)
+{
+    /**
+     * @brief Sketch one partition of selected rows
+     *
+     * @param arg Pointer to instance of #SketchPartitions structure
+     * @param chunk Index of partition
+     * @param start Index of first row of partition (relative to selection)
+     * @param end Index after last row of partition (relative to selection)
+     * @param worker_id Index of worker (not used)
+     */
+
+    (void)worker_id;
+
+    SketchPartitions *partitions = (SketchPartitions*)arg;
+    Table *table = partitions->table;
+    Selector *selector = partitions->selector;
+    int ret_val = NO_ERROR;
+
+    for (long long int i = selector->lld_ir1 + start; i < (selector->lld_ir1 + end) && ret_val == NO_ERROR; i++)
+    {
+        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < get_row(table, i)->num_of_cells) && ret_val == NO_ERROR; j++)
+        {
+            char *content = get_row(table, i)->cells[j].content;
+
+            if (partitions->registers != NULL)
+            {
+                if (!strings_equal(content, EMPTY_CELL))
+                    hll_add(&partitions->registers[chunk * HLL_REGISTERS], hash_bytes(content, strlen(content), 0));
+            }
+            else if (is_string_ldouble(content))
+            {
+                long double value;
+                if ((ret_val = string_to_ldouble(content, &value)) == NO_ERROR &&
+                    (ret_val = kll_push(&partitions->sketches[chunk], 0, value)) == NO_ERROR &&
+                    partitions->sketches[chunk].sizes[0] >= kll_capacity(&partitions->sketches[chunk], 0))
+                    ret_val = kll_compress(&partitions->sketches[chunk]);
+            }
+            else
+            {
+                partitions->non_numeric[chunk] = true;
+            }
+        }
+    }
+
+    partitions->results[chunk] = ret_val;
+}
+
+int sketch_cells(Table *table, Selector *selector, _Bool distinct, long double quantile, long long int r, long long int c)
+{
+    /**
+     * @brief Set approximate distinct count or approximate quantile of selection to output cell
+     *
+     * Selected rows are split to at most #SKETCH_PARTITIONS partitions that are sketched in parallel
+     * and merged in order of partitions, so memory is bounded and result does not depend on number of threads \n
+     * Distinct count counts non empty cells by HyperLogLog, quantile of numeric cells is taken from KLL sketch
+     *
+     * @warning
+     * If non numeric cell is found then NaN will be outputed as quantile
+     *
+     * @param table Pointer to instance of #Table structure where output data will be saved
+     * @param selector Pointer to instance of #Selector structure that tell us where to find data
+     * @param distinct Flag if distinct count (or quantile) is computed
+     * @param quantile Wanted quantile (0 - 1)
+     * @param r Row index of output cell
+     * @param c Column index of output cell
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (r < 0 || r > (table->num_of_rows - 1) || c < 0 || c > (get_row(table, 0)->num_of_cells - 1) || quantile < 0 || quantile > 1)
+        return FUNCTION_ARGUMENT_ERROR;
+
+    long long int num_of_rows = get_number_of_selected_rows(table, selector);
+    long long int partition_size = get_number_of_chunks(num_of_rows, SKETCH_PARTITIONS);
+    if (partition_size < ROW_CHUNK_SIZE)
+        partition_size = ROW_CHUNK_SIZE;
+    long long int num_of_partitions = get_number_of_chunks(num_of_rows, partition_size);
+    size_t size = (num_of_partitions > 0) ? (size_t)num_of_partitions : 1;
+
+    SketchPartitions partitions;
+    partitions.table = table;
+    partitions.selector = selector;
+    partitions.registers = distinct ? (unsigned char*)calloc(size * HLL_REGISTERS, sizeof(unsigned char)) : NULL;
+    partitions.sketches = distinct ? NULL : (KllSketch*)calloc(size, sizeof(KllSketch));
+    partitions.non_numeric = (_Bool*)calloc(size, sizeof(_Bool));
+    partitions.results = (int*)calloc(size, sizeof(int));
+
+    int ret_val = NO_ERROR;
+    if ((distinct ? (partitions.registers == NULL) : (partitions.sketches == NULL)) || partitions.non_numeric == NULL || partitions.results == NULL)
+        ret_val = ALLOCATION_FAILED;
+
+    long double result = 0;
+    _Bool nan = false;
+
+    if (ret_val == NO_ERROR)
+    {
+        thread_pool_for(get_table_pool(table), num_of_rows, partition_size, sketch_chunk, &partitions);
+
+        for (long long int i = 0; i < num_of_partitions && ret_val == NO_ERROR; i++)
+        {
+            ret_val = partitions.results[i];
+            nan = nan || partitions.non_numeric[i];
+
+            if (ret_val != NO_ERROR || i == 0)
+                continue;
+
+            if (distinct)
+            {
+                for (int j = 0; j < HLL_REGISTERS; j++)
+                    if (partitions.registers[i * HLL_REGISTERS + j] > partitions.registers[j])
+                        partitions.registers[j] = partitions.registers[i * HLL_REGISTERS + j];
+            }
+            else
+            {
+                ret_val = kll_merge(&partitions.sketches[0], &partitions.sketches[i]);
+            }
+        }
+
+        if (ret_val == NO_ERROR)
+        {
+            if (distinct)
+            {
+                result = hll_estimate(partitions.registers);
+                nan = false;
+            }
+            else
+            {
+                _Bool empty = true;
+                if (num_of_partitions > 0)
+                    ret_val = kll_quantile(&partitions.sketches[0], quantile, &result, &empty);
+                nan = nan || empty;
+            }
+        }
+    }
+
+    if (partitions.sketches != NULL)
+        for (long long int i = 0; i < num_of_partitions; i++)
+            kll_destroy(&partitions.sketches[i]);
+
+    free(partitions.registers);
+    free(partitions.sketches);
+    free(partitions.non_numeric);
+    free(partitions.results);
+
+    if (ret_val == NO_ERROR)
+        ret_val = write_running_value(table, r, c, result, nan);
+    if (ret_val == NO_ERROR)
+        ret_val = formula_cells_written(table, r, c, r, c);
+
+    return ret_val;
+}
+
+int evaluate_formula(Table *table, Formula *formula, _Bool cyclic)
+{
+    /**
+     * @brief Calculate value of formula and save it to its cell
+     *
+     * Source range is limited to current size of table, formula with empty range or formula in cycle gets NaN
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param formula Pointer to instance of #Formula structure
+     * @param cyclic Flag if formula is part of cycle
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (formula->row >= table->num_of_rows || formula->col >= get_row(table, formula->row)->num_of_cells)
+        return NO_ERROR;
+
+    Selector selector;
+    selector.initialized = true;
+    selector.lld_ir1 = formula->r1;
+    selector.lld_ic1 = formula->c1;
+    selector.lld_ir2 = (formula->r2 < table->num_of_rows) ? formula->r2 : table->num_of_rows - 1;
+    selector.lld_ic2 = (formula->c2 < get_row(table, 0)->num_of_cells) ? formula->c2 : get_row(table, 0)->num_of_cells - 1;
+
+    if (cyclic || selector.lld_ir1 > selector.lld_ir2 || selector.lld_ic1 > selector.lld_ic2)
+        return set_table_cell(table, formula->row, formula->col, "NaN");
+
+    switch (formula->function)
+    {
+        case 0:
+            return sum_cells(table, &selector, formula->row, formula->col);
+        case 1:
+            return avg_cells(table, &selector, formula->row, formula->col);
+        case 2:
+            return count_cells(table, &selector, formula->row, formula->col);
+        case 3:
+            return cell_len(table, &selector, formula->row, formula->col);
+        default:
+            return FUNCTION_ERROR;
+    }
+}
+
+int recalculate_formulas(Table *table)
+{
+    /**
+     * @brief Recalculate all dirty formulas
+     *
+     * Dirty formulas are visited by depth first search over their dependencies,
+     * so each formula is calculated after all formulas in its source range (topological order) \n
+     * Formulas in cycle are set to NaN
+     *
+     * @param table Pointer to instance of #Table structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    FormulaStore *store = &table->formulas;
+    if (store->num_of_dirty == 0)
+        return NO_ERROR;
+
+    int ret_val = NO_ERROR;
+    if ((ret_val = build_formula_graph(store)) != NO_ERROR)
+        return ret_val;
+
+    long long int n = store->num_of_formulas;
+    long long int *stack = (long long int*)malloc((size_t)n * sizeof(long long int));
+    long long int *next_dependency = (long long int*)malloc((size_t)n * sizeof(long long int));
+    _Bool *cyclic = (_Bool*)calloc((size_t)n, sizeof(_Bool));
+
+    if (stack == NULL || next_dependency == NULL || cyclic == NULL)
+        ret_val = ALLOCATION_FAILED;
+
+    for (long long int i = 0; i < n && ret_val == NO_ERROR; i++)
+    {
+        if (store->formulas[i].state != FORMULA_DIRTY)
+            continue;
+
+        long long int stack_size = 0;
+        stack[stack_size++] = i;
+        next_dependency[i] = store->dependency_start[i];
+        store->formulas[i].state = FORMULA_VISITING;
+
+        while (stack_size > 0 && ret_val == NO_ERROR)
+        {
+            long long int current = stack[stack_size - 1];
+
+            if (next_dependency[current] < store->dependency_start[current + 1])
+            {
+                long long int dependency = store->dependencies[next_dependency[current]++];
+
+                if (store->formulas[dependency].state == FORMULA_DIRTY)
+                {
+                    stack[stack_size++] = dependency;
+                    next_dependency[dependency] = store->dependency_start[dependency];
+                    store->formulas[dependency].state = FORMULA_VISITING;
+                }
+                else if (store->formulas[dependency].state == FORMULA_VISITING)
+                {
+                    // All formulas on stack from dependency to current are in cycle
+                    for (long long int k = stack_size - 1; k >= 0; k--)
+                    {
+                        cyclic[stack[k]] = true;
+                        if (stack[k] == dependency)
+                            break;
+                    }
+                }
+                continue;
+            }
+
+            // All dependencies are calculated
+            stack_size--;
+            ret_val = evaluate_formula(table, &store->formulas[current], cyclic[current]);
+            store->formulas[current].state = FORMULA_CLEAN;
+            store->num_of_dirty--;
+        }
+    }
+
+    free(stack);
+    free(next_dependency);
+    free(cyclic);
+
+    return ret_val;
+}
+
+int register_formula_cells(Table *table, long long int first_row, long long int first_col)
+{
+    /**
+     * @brief Find formula cells in loaded part of table and add them to formula store
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param first_row Index of first loaded row
+     * @param first_col Index of first loaded column
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    int ret_val = NO_ERROR;
+    Formula formula;
+
+    for (long long int i = first_row; i < table->num_of_rows; i++)
+    {
+        for (long long int j = first_col; j < get_row(table, i)->num_of_cells; j++)
+        {
+            if (parse_formula(get_row(table, i)->cells[j].content, &formula))
+            {
+                formula.row = i;
+                formula.col = j;
+                if ((ret_val = add_formula(&table->formulas, &formula)) != NO_ERROR)
+                    return ret_val;
+            }
+        }
+    }
+
+    return NO_ERROR;
+}
+
+int append_empty_cell(Row *row)
+{
+    /**
+     * @brief Append empty cell to the end of the row
+     *
+     * @param row Pointer to instance of #Row structure where we want to append empty cell
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    // If row have no cells or its already full allocate new cols
+    if (row->cells == NULL || row->num_of_cells == row->allocated_cells)
+        if (allocate_cells(row) != NO_ERROR)
+            return ALLOCATION_FAILED;
+
+    if (set_cell(EMPTY_CELL, &row->cells[row->num_of_cells]) != NO_ERROR)
+        return ALLOCATION_FAILED;
+
+    row->num_of_cells++;
+
+    return NO_ERROR;
+}
+
+int normalize_row_lengths(Table *table)
+{
+    /**
+     * @brief Normalize lengths of rows
+     *
+     * Append empty cells to the end of smaller rows than the longest one to make all rows same length
+     *
+     * @param table Pointer to instance of #Table structure
+     *
+     * @return #NO_ERROR on success and #ALLOCATION_FAILED on error
+     */
+
+    long long int max_number_of_cols = 0;
+
+    // Get maximum cols in whole table
+    for (long long int i = 0; i < table->num_of_rows; i++)
+    {
+        if (get_row(table, i)->num_of_cells > max_number_of_cols)
+            max_number_of_cols = get_row(table, i)->num_of_cells;
+    }
+
+    for (long long int i = 0; i < table->num_of_rows; i++)
+    {
+        long long int length_diff = max_number_of_cols - get_row(table, i)->num_of_cells;
+
+        if (length_diff > 0)
+        {
+            for (long long int j = 0; j < length_diff; j++)
+                if (append_empty_cell(get_row(table, i)) != NO_ERROR)
+                    return ALLOCATION_FAILED;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+void normalize_empty_cols(Table *table)
+{
+    /**
+     * @brief Trim excess colms
+     *
+     * Destroy empty cols on the end of rows
+     *
+     * @param table Pointer to instance of #Table structure
+     */
+
+    if (table->num_of_rows > 0)
+    {
+        for (long long int i = (get_row(table, 0)->num_of_cells - 1); i > 0; i--)
+        {
+            _Bool all_empty = true;
+
+            for (long long int j = 0; j < table->num_of_rows; j++)
+            {
+                if (!strings_equal(get_row(table, j)->cells[i].content, EMPTY_CELL))
+                    all_empty = false;
+            }
+
+            if (all_empty)
+            {
+                // Destroy the empty ones
+                for (long long int j = 0; j < table->num_of_rows; j++)
+                {
+                    deallocate_cell(&get_row(table, j)->cells[i]);
+                    get_row(table, j)->num_of_cells--;
+                }
+
+                continue;
+            }
+
+            break;
+        }
+    }
+}
+
+int normalize_number_of_cols(Table *table)
+{
+    /**
+     * @brief Normalize end of the rows
+     *
+     * Fill short rows to same size as the longest one and then trim all empty cols at the end
+     *
+     * @param table Pointer to instance of #Table structure
+     *
+     * @return #NO_ERROR on success and #ALLOCATION_FAILED on error
+     */
+
+    int ret_code;
+    if ((ret_code = normalize_row_lengths(table) != NO_ERROR))
+        return ret_code;
+
+    normalize_empty_cols(table);
+
+    return ret_code;
+}
+
+int parse_row(char *line, Row *row, char delim, Arena *arena)
+{
+    /**
+     * @brief Split line to cells of row
+     *
+     * Line is split in one pass by the same rules as #count_char and #get_substring use
+     * (delimiters in double parentecies, escaped delimiters and delimiter at the beginning of line are not counted)
+     *
+     * @param line Input string to parse
+     * @param row Pointer to empty instance of #Row structure where cells will be saved
+     * @param delim Deliminator character
+     * @param arena Pointer to instance of #Arena structure where cells will be allocated (if NULL heap is used)
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    size_t length_of_line = strlen(line);
+
+    long long int possible_occurencies = 0;
+    for (size_t i = 0; i < length_of_line; i++)
+        if (line[i] == '"')
+            possible_occurencies++;
+
+    if ((possible_occurencies % 2) > 0)
+        possible_occurencies--;
+
+    // First pass count cells, second one save them
+    long long int number_of_cells = 0;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        _Bool in_double_parentecies = false;
+        long long int occurencies = 0;
+        long long int cell_index = 0;
+        size_t cell_start = 0;
+
+        for (size_t i = 0; i <= length_of_line; i++)
+        {
+            char cc = line[i];
+
+            if (cc == '"')
+            {
+                occurencies++;
+                if ((i == 0 || line[i-1] != '\\') && (occurencies <= possible_occurencies))
+                    in_double_parentecies = !in_double_parentecies;
+            }
+
+            // End of line is end of last cell
+            if (i < length_of_line && (cc != delim || in_double_parentecies || i == 0 || line[i-1] == '\\'))
+                continue;
+
+            if (pass == 1)
+            {
+                size_t length_of_cell = i - cell_start;
+                Cell *cell = &row->cells[cell_index];
+
+                cell->content = (arena != NULL) ? (char*)arena_alloc(arena, length_of_cell + 1) : (char*)malloc(length_of_cell + 1);
+                if (cell->content == NULL)
+                    return ALLOCATION_FAILED;
+
+                cell->in_arena = (arena != NULL);
+                cell->allocated_chars = (long long int)length_of_cell + 1;
+                memcpy(cell->content, line + cell_start, length_of_cell);
+                cell->content[length_of_cell] = '\0';
+                row->num_of_cells++;
+            }
+
+            cell_index++;
+            cell_start = i + 1;
+        }
+
+        if (pass == 0)
+        {
+            number_of_cells = cell_index;
+
+            row->cells = (arena != NULL) ? (Cell*)arena_alloc(arena, number_of_cells * sizeof(Cell)) : (Cell*)malloc(number_of_cells * sizeof(Cell));
+            if (row->cells == NULL)
+                return ALLOCATION_FAILED;
+
+            row->cells_in_arena = (arena != NULL);
+            row->num_of_cells = 0;
+            row->allocated_cells = number_of_cells;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+int create_row_from_data(char *line, Table *table)
+{
+    /**
+     * @brief Create row from line data
+     *
+     * Parse and save line data as new row at the end of table
+     *
+     * @param line Input string to parse
+     * @param table Pointer to instance #Table structure where row will be saved
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (line == NULL)
+        return FUNCTION_ERROR;
+
+    int ret_val;
+    if ((ret_val = parse_row(line, get_row(table, table->num_of_rows), table->delim, NULL)) != NO_ERROR)
+        return ret_val;
+
+    table->num_of_rows++;
+    return NO_ERROR;
+}
+
+void profile_chunk(void *arg, long long int chunk, long long int start, long long int end, int worker_id)
+{
+    /**
+     * @brief Profile columns of one partition of selected rows
+     *
+     * @param arg Pointer to instance of #ProfilePartitions structure
+     * @param chunk Index of partition
+     * @param start Index of first row of partition (relative to selection)
+     * @param end Index after last row of partition (relative to selection)
+     * @param worker_id Index of worker (not used)
+     */
+
+    (void)worker_id;
+
+    ProfilePartitions *partitions = (ProfilePartitions*)arg;
+    Table *table = partitions->table;
+    Selector *selector = partitions->selector;
+    ColumnProfile *profiles = &partitions->profiles[chunk * partitions->num_of_cols];
+
+    for (long long int i = selector->lld_ir1 + start; i < (selector->lld_ir1 + end); i++)
+    {
+        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < get_row(table, i)->num_of_cells); j++)
+        {
+            ColumnProfile *profile = &profiles[j - selector->lld_ic1];
+            char *content = get_row(table, i)->cells[j].content;
+            profile->num_of_cells++;
+
+            if (strings_equal(content, EMPTY_CELL))
+            {
+                profile->num_of_empty++;
+                continue;
+            }
+
+            long long int length = (long long int)strlen(content);
+            if (profile->num_of_cells == profile->num_of_empty + 1 || length < profile->min_length)
+                profile->min_length = length;
+            if (length > profile->max_length)
+                profile->max_length = length;
+            profile->total_length += length;
+
+            hll_add(profile->registers, hash_bytes(content, (size_t)length, 0));
+
+            long double value;
+            if (is_string_ldouble(content) && string_to_ldouble(content, &value) == NO_ERROR)
+            {
+                if (profile->num_of_numeric == 0 || value < profile->min)
+                    profile->min = value;
+                if (profile->num_of_numeric == 0 || value > profile->max)
+                    profile->max = value;
+                profile->sum += value;
+                profile->num_of_numeric++;
+            }
+        }
+    }
+}
+
+void merge_column_profiles(ColumnProfile *target, ColumnProfile *source)
+{
+    /**
+     * @brief Merge profile of column of later partition to profile of earlier partition
+     *
+     * @param target Pointer to instance of #ColumnProfile structure where result will be saved
+     * @param source Pointer to instance of #ColumnProfile structure
+     */
+
+    long long int target_filled = target->num_of_cells - target->num_of_empty;
+    long long int source_filled = source->num_of_cells - source->num_of_empty;
+
+    if (source_filled > 0 && (target_filled == 0 || source->min_length < target->min_length))
+        target->min_length = source->min_length;
+    if (source->max_length > target->max_length)
+        target->max_length = source->max_length;
+    target->total_length += source->total_length;
+
+    if (source->num_of_numeric > 0)
+    {
+        if (target->num_of_numeric == 0 || source->min < target->min)
+            target->min = source->min;
+        if (target->num_of_numeric == 0 || source->max > target->max)
+            target->max = source->max;
+    }
+    target->sum += source->sum;
+    target->num_of_numeric += source->num_of_numeric;
+    target->num_of_empty += source->num_of_empty;
+    target->num_of_cells += source->num_of_cells;
+
+    for (int i = 0; i < HLL_REGISTERS; i++)
+        if (source->registers[i] > target->registers[i])
+            target->registers[i] = source->registers[i];
+}
+
+void print_profile_json(ColumnProfile *profiles, long long int num_of_cols, long long int first_col)
+{
+    /**
+     * @brief Print profiles of columns to stderr as JSON
+     *
+     * Statistics that are not defined (e.g. mean of column without numbers) are printed as null
+     *
+     * @param profiles Array of merged profiles of columns
+     * @param num_of_cols Number of columns
+     * @param first_col Index of first profiled column
+     */
+
+    fprintf(stderr, "{\"columns\":[");
+
+    for (long long int i = 0; i < num_of_cols; i++)
+    {
+        ColumnProfile *profile = &profiles[i];
+        long long int filled = profile->num_of_cells - profile->num_of_empty;
+
+        fprintf(stderr, "%s{\"column\":%lld,\"cells\":%lld,\"numeric\":%lld,\"empty\":%lld,",
+                (i > 0) ? "," : "", first_col + i + 1, profile->num_of_cells, profile->num_of_numeric, profile->num_of_empty);
+
+        if (profile->num_of_numeric > 0)
+            fprintf(stderr, "\"min\":%.*Lg,\"max\":%.*Lg,\"mean\":%.*Lg,", LDBL_DIG, profile->min, LDBL_DIG, profile->max,
+                    LDBL_DIG, profile->sum / profile->num_of_numeric);
+        else
+            fprintf(stderr, "\"min\":null,\"max\":null,\"mean\":null,");
+
+        fprintf(stderr, "\"distinct\":%.0Lf,", hll_estimate(profile->registers));
+
+        if (filled > 0)
+            fprintf(stderr, "\"min_length\":%lld,\"max_length\":%lld,\"avg_length\":%Lg}",
+                    profile->min_length, profile->max_length, (long double)profile->total_length / filled);
+        else
+            fprintf(stderr, "\"min_length\":null,\"max_length\":null,\"avg_length\":null}");
+    }
+
+    fprintf(stderr, "]}\n");
+}
+
+void init_derived_table(Table *table, Table *source)
+{
+    /**
+     * @brief Initialize @p table as empty table that shares delimiter and thread pool with @p source
+     *
+     * Derived table is always kept in memory
+     *
+     * @param table Pointer to instance of #Table structure that will be initialized
+     * @param source Pointer to instance of #Table structure
+     */
+
+    table->rows = NULL;
+    table->num_of_rows = 0;
+    table->allocated_rows = 0;
+    table->delim = source->delim;
+    table->input_delims = source->input_delims;
+    table->spill = NULL;
+    table->arenas = NULL;
+    table->num_of_arenas = 0;
+    table->pool = source->pool;
+    table->col_types = NULL;
+    table->num_of_col_types = 0;
+    table->shard = NULL;
+    table->version = NULL;
+    table->cache = NULL;
+    init_formula_store(&table->formulas);
+}
+
+int replace_table(Table *table, Table *source)
+{
+    /**
+     * @brief Replace all data of @p table with data of derived table @p source
+     *
+     * Rows, arenas and types of columns are moved from @p source, which stays empty \n
+     * Formulas of old table are dropped and pages of spill store are reset for new rows
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param source Pointer to instance of #Table structure created by #init_derived_table
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    deallocate_table(table);
+
+    table->rows = source->rows;
+    table->num_of_rows = source->num_of_rows;
+    table->allocated_rows = source->allocated_rows;
+    table->arenas = source->arenas;
+    table->num_of_arenas = source->num_of_arenas;
+    table->col_types = source->col_types;
+    table->num_of_col_types = source->num_of_col_types;
+
+    source->rows = NULL;
+    source->arenas = NULL;
+    source->num_of_arenas = 0;
+    source->col_types = NULL;
+    deallocate_table(source);
+
+    // Pages of spill store were reset when old rows were deallocated
+    if (table->spill != NULL && allocate_pages(table->spill, table->allocated_rows) != NO_ERROR)
+        return ALLOCATION_FAILED;
+
+    return NO_ERROR;
+}
+
+int create_row_cells(Row *row, long long int num_of_cells)
+{
+    /**
+     * @brief Create @p num_of_cells empty cells in row without cells
+     *
+     * @param row Pointer to instance of #Row structure
+     * @param num_of_cells Number of cells
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    row->cells = (Cell*)malloc((size_t)num_of_cells * sizeof(Cell));
+    if (row->cells == NULL)
+        return ALLOCATION_FAILED;
+
+    row->allocated_cells = num_of_cells;
+    row->num_of_cells = 0;
+
+    for (long long int i = 0; i < num_of_cells; i++)
+    {
+        row->cells[i].content = NULL;
+        row->cells[i].allocated_chars = 0;
+        row->cells[i].in_arena = false;
+
+        if (set_cell(EMPTY_CELL, &row->cells[i]) != NO_ERROR)
+            return ALLOCATION_FAILED;
+
+        row->num_of_cells++;
+    }
+
+    return NO_ERROR;
+}
+
+int save_profile_table(Table *table, ColumnProfile *profiles, long long int num_of_cols, long long int first_col, char *path)
+{
+    /**
+     * @brief Save profiles of columns as new table to file
+     *
+     * First row is header and every other row holds statistics of one column, undefined statistics are NaN
+     *
+     * @param table Pointer to instance of #Table structure with profiled data (delimiter and pool are shared)
+     * @param profiles Array of merged profiles of columns
+     * @param num_of_cols Number of columns
+     * @param first_col Index of first profiled column
+     * @param path Path to output file
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    Table profile_table;
+    init_derived_table(&profile_table, table);
+
+    char line[1024];
+    char d = table->delim;
+
+    int ret_val = reserve_rows(&profile_table, num_of_cols + 1);
+    if (ret_val == NO_ERROR)
+    {
+        snprintf(line, sizeof(line), "column%ccells%cnumeric%cempty%cmin%cmax%cmean%cdistinct%cmin_length%cmax_length%cavg_length",
+                 d, d, d, d, d, d, d, d, d, d);
+        ret_val = create_row_from_data(line, &profile_table);
+    }
+
+    for (long long int i = 0; i < num_of_cols && ret_val == NO_ERROR; i++)
+    {
+        ColumnProfile *profile = &profiles[i];
+        long long int filled = profile->num_of_cells - profile->num_of_empty;
+        long double values[] = { profile->min, profile->max, profile->sum / profile->num_of_numeric, profile->min_length,
+                                 profile->max_length, (long double)profile->total_length / filled };
+        _Bool defined[] = { profile->num_of_numeric > 0, profile->num_of_numeric > 0, profile->num_of_numeric > 0,
+                            filled > 0, filled > 0, filled > 0 };
+        char fields[6][64];
+
+        for (int j = 0; j < 6; j++)
+        {
+            if (defined[j])
+                snprintf(fields[j], sizeof(fields[j]), "%Lg", values[j]);
+            else
+                snprintf(fields[j], sizeof(fields[j]), "NaN");
+        }
+
+        snprintf(line, sizeof(line), "%lld%c%lld%c%lld%c%lld%c%s%c%s%c%s%c%.0Lf%c%s%c%s%c%s",
+                 first_col + i + 1, d, profile->num_of_cells, d, profile->num_of_numeric, d, profile->num_of_empty, d,
+                 fields[0], d, fields[1], d, fields[2], d, hll_estimate(profile->registers), d, fields[3], d, fields[4], d, fields[5]);
+        ret_val = create_row_from_data(line, &profile_table);
+    }
+
+    if (ret_val == NO_ERROR)
+        ret_val = save_table(&profile_table, path);
+
+    deallocate_table(&profile_table);
+
+    return ret_val;
+}
+
+void merge_shard_profiles(void *target, void *source, size_t size)
+{
+    /**
+     * @brief Merge column profiles of later shard
+     *
+     * Profiles are packed as #ShardPartial header followed by array of #ColumnProfile structures and their HyperLogLog registers
+     *
+     * @param target Packed profiles where result will be saved
+     * @param source Packed profiles of later shard
+     * @param size Size of packed profiles
+     */
+
+    ShardPartial *merged = (ShardPartial*)target;
+    ShardPartial *partial = (ShardPartial*)source;
+
+    if (merged->result == NO_ERROR)
+        merged->result = partial->result;
+
+    long long int num_of_cols = (long long int)((size - sizeof(ShardPartial)) / (sizeof(ColumnProfile) + HLL_REGISTERS));
+    ColumnProfile *targets = (ColumnProfile*)(merged + 1);
+    ColumnProfile *sources = (ColumnProfile*)(partial + 1);
+    unsigned char *target_registers = (unsigned char*)(targets + num_of_cols);
+    unsigned char *source_registers = (unsigned char*)(sources + num_of_cols);
+
+    for (long long int i = 0; i < num_of_cols; i++)
+    {
+        targets[i].registers = &target_registers[i * HLL_REGISTERS];
+        sources[i].registers = &source_registers[i * HLL_REGISTERS];
+        merge_column_profiles(&targets[i], &sources[i]);
+    }
+}
+
+int shard_merge_profiles(ShardContext *shard, ColumnProfile *profiles, long long int num_of_cols, int ret_val)
+{
+    /**
+     * @brief Replace column profiles of shard by profiles merged from all shards
+     *
+     * @param shard Pointer to instance of #ShardContext structure
+     * @param profiles Array of @p num_of_cols profiles of shard (NULL if they could not be computed)
+     * @param num_of_cols Number of profiled columns
+     * @param ret_val Result of profiling of shard
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes (result of any shard)
+     */
+
+    size_t size = sizeof(ShardPartial) + (size_t)num_of_cols * (sizeof(ColumnProfile) + HLL_REGISTERS);
+    ShardPartial *packed = (ShardPartial*)calloc(1, size);
+    if (packed == NULL)
+        return ALLOCATION_FAILED;
+
+    ColumnProfile *packed_profiles = (ColumnProfile*)(packed + 1);
+    unsigned char *packed_registers = (unsigned char*)(packed_profiles + num_of_cols);
+
+    packed->result = ret_val;
+    if (ret_val == NO_ERROR)
+    {
+        for (long long int i = 0; i < num_of_cols; i++)
+        {
+            packed_profiles[i] = profiles[i];
+            memcpy(&packed_registers[i * HLL_REGISTERS], profiles[i].registers, HLL_REGISTERS);
+        }
+    }
+
+    int exchange_ret_val = shard_exchange(shard, packed, size, merge_shard_profiles);
+    ret_val = (exchange_ret_val != NO_ERROR) ? exchange_ret_val : packed->result;
+
+    if (ret_val == NO_ERROR)
+    {
+        for (long long int i = 0; i < num_of_cols; i++)
+        {
+            unsigned char *registers = profiles[i].registers;
+            profiles[i] = packed_profiles[i];
+            profiles[i].registers = registers;
+            memcpy(registers, &packed_registers[i * HLL_REGISTERS], HLL_REGISTERS);
+        }
+    }
+
+    free(packed);
+
+    return ret_val;
+}
+
+int profile_columns(Table *table, Selector *selector, char *path)
+{
+    /**
+     * @brief Profile every selected column in one pass over selected rows
+     *
+     * For every column count numeric and empty cells, min, max and mean of numbers, estimate of distinct values
+     * and min, max and average length of non empty cells \n
+     * Selected rows are split to fixed partitions that are profiled in parallel and merged in order of partitions,
+     * number of partitions is limited so HyperLogLog registers fit to #PROFILE_SKETCH_MEMORY
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure with profiled area
+     * @param path Path of file where profile table will be saved (NULL to print JSON to stderr)
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    long long int num_of_cols = selector->lld_ic2 - selector->lld_ic1 + 1;
+    long long int num_of_rows = get_number_of_selected_rows(table, selector);
+
+    long long int max_partitions = SKETCH_PARTITIONS;
+    while (max_partitions > 1 && max_partitions * num_of_cols * HLL_REGISTERS > PROFILE_SKETCH_MEMORY)
+        max_partitions /= 2;
+
+    long long int partition_size = get_number_of_chunks(num_of_rows, max_partitions);
+    if (partition_size < ROW_CHUNK_SIZE)
+        partition_size = ROW_CHUNK_SIZE;
+    long long int num_of_partitions = get_number_of_chunks(num_of_rows, partition_size);
+    if (num_of_partitions < 1)
+        num_of_partitions = 1;
+
+    long long int num_of_profiles = num_of_partitions * num_of_cols;
+    ProfilePartitions partitions;
+    partitions.table = table;
+    partitions.selector = selector;
+    partitions.num_of_cols = num_of_cols;
+    partitions.profiles = (ColumnProfile*)calloc((size_t)num_of_profiles, sizeof(ColumnProfile));
+    unsigned char *registers = (unsigned char*)calloc((size_t)num_of_profiles * HLL_REGISTERS, sizeof(unsigned char));
+
+    int ret_val = NO_ERROR;
+    if (partitions.profiles == NULL || registers == NULL)
+        ret_val = ALLOCATION_FAILED;
+
+    if (ret_val == NO_ERROR)
+    {
+        for (long long int i = 0; i < num_of_profiles; i++)
+            partitions.profiles[i].registers = &registers[i * HLL_REGISTERS];
+
+        thread_pool_for(get_table_pool(table), num_of_rows, partition_size, profile_chunk, &partitions);
+
+        for (long long int i = 1; i < num_of_partitions; i++)
+            for (long long int j = 0; j < num_of_cols; j++)
+                merge_column_profiles(&partitions.profiles[j], &partitions.profiles[i * num_of_cols + j]);
+    }
+
+    // Shards merge their profiles in order of shards and coordinator outputs them
+    if (table->shard != NULL)
+        ret_val = shard_merge_profiles(table->shard, partitions.profiles, num_of_cols, ret_val);
+
+    if (ret_val == NO_ERROR && (table->shard == NULL || table->shard->index == 0))
+    {
+        if (path == NULL)
+            print_profile_json(partitions.profiles, num_of_cols, selector->lld_ic1);
+        else
+            ret_val = save_profile_table(table, partitions.profiles, num_of_cols, selector->lld_ic1, path);
+    }
+
+    free(partitions.profiles);
+    free(registers);
+
+    return ret_val;
+}
+
+void init_selector(Selector *selector)
+{
+    /**
+     * @brief Initialize @p selector to default values
+     *
+     * @param selector Pointer to instance of #Selector structure
+     */
+
+    selector->lld_ic1 = 0;
+    selector->lld_ic2 = 0;
+    selector->lld_ir1 = 0;
+    selector->lld_ir2 = 0;
+    selector->initialized = true;
+}
+
+int pivot_table(Table *table, Selector *selector, long long int key_col, long long int pivot_col, long long int value_col, int function)
+{
+    /**
+     * @brief Replace table with pivot table of selected rows
+     *
+     * Keys of rows and columns are assigned in one pass over selected rows by two #KeyMap hash maps,
+     * values are then aggregated to grid of row keys by column keys \n
+     * First row of pivot table holds column keys and first column holds row keys, pairs of keys without data stay empty
+     *
+     * @warning
+     * If non numeric value is found then NaN will be outputed for its pair of keys (sum and avg)
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure with selected rows
+     * @param key_col Index of column with row keys
+     * @param pivot_col Index of column with column keys
+     * @param value_col Index of column with values
+     * @param function Aggregate function (0 - sum, 1 - count, 2 - avg)
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    long long int num_of_cols = get_row(table, 0)->num_of_cells;
+    if (key_col < 0 || key_col >= num_of_cols || pivot_col < 0 || pivot_col >= num_of_cols || value_col < 0 || value_col >= num_of_cols)
+        return FUNCTION_ARGUMENT_ERROR;
+
+    long long int num_of_rows = get_number_of_selected_rows(table, selector);
+    size_t size = (num_of_rows > 0) ? (size_t)num_of_rows : 1;
+
+    KeyMap row_keys, col_keys;
+    key_map_init(&row_keys);
+    key_map_init(&col_keys);
+
+    long long int *key_indexes = (long long int*)malloc(size * 2 * sizeof(long long int));
+    PivotCell *values = NULL;
+    Table pivot;
+    init_derived_table(&pivot, table);
+
+    int ret_val = (key_indexes == NULL) ? ALLOCATION_FAILED : NO_ERROR;
+
+    // Assign keys to selected rows
+    for (long long int i = 0; i < num_of_rows && ret_val == NO_ERROR; i++)
+    {
+        Row *row = get_row(table, selector->lld_ir1 + i);
+        if ((ret_val = key_map_insert(&row_keys, row->cells[key_col].content, &key_indexes[2 * i])) == NO_ERROR)
+            ret_val = key_map_insert(&col_keys, row->cells[pivot_col].content, &key_indexes[2 * i + 1]);
+    }
+
+    if (ret_val == NO_ERROR)
+    {
+        values = (PivotCell*)calloc((size_t)(row_keys.num_of_keys * col_keys.num_of_keys) + 1, sizeof(PivotCell));
+        if (values == NULL)
+            ret_val = ALLOCATION_FAILED;
+    }
+
+    // Aggregate values to grid of keys
+    for (long long int i = 0; i < num_of_rows && ret_val == NO_ERROR; i++)
+    {
+        PivotCell *cell = &values[key_indexes[2 * i] * col_keys.num_of_keys + key_indexes[2 * i + 1]];
+        char *content = get_row(table, selector->lld_ir1 + i)->cells[value_col].content;
+        cell->used = true;
+
+        if (function == 1)
+        {
+            if (!strings_equal(content, EMPTY_CELL))
+                cell->num_of_values++;
+        }
+        else
+        {
+            long double value;
+            if (is_string_ldouble(content) && string_to_ldouble(content, &value) == NO_ERROR)
+                cell->sum += value;
+            else
+                cell->nan = true;
+            cell->num_of_values++;
+        }
+    }
+
+    if (ret_val == NO_ERROR)
+        ret_val = reserve_rows(&pivot, row_keys.num_of_keys + 1);
+
+    for (long long int i = 0; i <= row_keys.num_of_keys && ret_val == NO_ERROR; i++)
+    {
+        Row *row = &pivot.rows[i];
+        pivot.num_of_rows++;
+
+        if ((ret_val = create_row_cells(row, col_keys.num_of_keys + 1)) != NO_ERROR)
+            break;
+
+        if (i == 0)
+        {
+            for (long long int j = 0; j < col_keys.num_of_keys && ret_val == NO_ERROR; j++)
+                ret_val = set_cell(col_keys.keys[j], &row->cells[j + 1]);
+            continue;
+        }
+
+        ret_val = set_cell(row_keys.keys[i - 1], &row->cells[0]);
+
+        for (long long int j = 0; j < col_keys.num_of_keys && ret_val == NO_ERROR; j++)
+        {
+            PivotCell *cell = &values[(i - 1) * col_keys.num_of_keys + j];
+            if (!cell->used)
+                continue;
+
+            if (cell->nan && function != 1)
+            {
+                ret_val = set_cell("NaN", &row->cells[j + 1]);
+                continue;
+            }
+
+            long double result = (function == 0) ? cell->sum : (function == 1) ? (long double)cell->num_of_values : cell->sum / cell->num_of_values;
+            char *temp_string = NULL;
+            if ((ret_val = ldouble_to_string(result, &temp_string)) == NO_ERROR)
+            {
+                ret_val = set_cell(temp_string, &row->cells[j + 1]);
+                free(temp_string);
+            }
+        }
+    }
+
+    for (long long int i = 0; i < pivot.num_of_rows && ret_val == NO_ERROR; i++)
+        ret_val = widen_row_types(&pivot.col_types, &pivot.num_of_col_types, &pivot.rows[i]);
+
+    if (ret_val == NO_ERROR)
+    {
+        ret_val = replace_table(table, &pivot);
+        init_selector(selector);
+    }
+
+    deallocate_table(&pivot);
+    key_map_destroy(&row_keys);
+    key_map_destroy(&col_keys);
+    free(key_indexes);
+    free(values);
+
+    return ret_val;
+}
+
+int move_cells_to_column(Table *transposed, Row *row, long long int r, long long int c1, long long int c2, _Bool move)
+{
+    /**
+     * @brief Move cells @p c1 - @p c2 of @p row to column @p r of transposed table
+     *
+     * Cells are moved as handles without copying content, missing cells of short rows are created empty
+     *
+     * @param transposed Pointer to instance of #Table structure with allocated rows and cells without content
+     * @param row Pointer to source row
+     * @param r Index of source row
+     * @param c1 Index of first moved column
+     * @param c2 Index after last moved column
+     * @param move Flag if cells are moved (or their content is copied)
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    for (long long int j = c1; j < c2; j++)
+    {
+        Cell *cell = &transposed->rows[j].cells[r];
+
+        if (move && j < row->num_of_cells)
+            *cell = row->cells[j];
+        else if (set_cell((j < row->num_of_cells) ? row->cells[j].content : EMPTY_CELL, cell) != NO_ERROR)
+            return ALLOCATION_FAILED;
+    }
+
+    return NO_ERROR;
+}
+
+void transpose_chunk(void *arg, long long int chunk, long long int start, long long int end, int worker_id)
+{
+    /**
+     * @brief Move tiles of cells to transposed table
+     *
+     * Every tile writes different cells of transposed table, so tiles can be moved in parallel
+     *
+     * @param arg Pointer to instance of #TransposeJob structure
+     * @param chunk Index of chunk (not used)
+     * @param start Index of first tile
+     * @param end Index after last tile
+     * @param worker_id Index of worker (not used)
+     */
+
+    (void)chunk;
+    (void)worker_id;
+
+    TransposeJob *job = (TransposeJob*)arg;
+
+    for (long long int tile = start; tile < end; tile++)
+    {
+        long long int r1 = (tile / job->col_tiles) * TRANSPOSE_TILE;
+        long long int c1 = (tile % job->col_tiles) * TRANSPOSE_TILE;
+        long long int r2 = (r1 + TRANSPOSE_TILE < job->num_of_rows) ? r1 + TRANSPOSE_TILE : job->num_of_rows;
+        long long int c2 = (c1 + TRANSPOSE_TILE < job->num_of_cols) ? c1 + TRANSPOSE_TILE : job->num_of_cols;
+
+        for (long long int i = r1; i < r2 && job->results[tile] == NO_ERROR; i++)
+            job->results[tile] = move_cells_to_column(job->transposed, &job->table->rows[i], i, c1, c2, true);
+    }
+}
+
+int transpose_table(Table *table)
+{
+    /**
+     * @brief Replace table with its transposition
+     *
+     * Cells are moved as handles without copying content in tiles of #TRANSPOSE_TILE x #TRANSPOSE_TILE cells
+     * that are moved in parallel, short rows are padded with empty cells \n
+     * With memory budget rows are copied one by one, because rows can be spilled while they are accessed
+     * @warning
+     * Formulas are dropped and their cells keep last calculated values
+     *
+     * @param table Pointer to instance of #Table structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    long long int num_of_cols = 0;
+    for (long long int i = 0; i < table->num_of_rows; i++)
+        if (get_row(table, i)->num_of_cells > num_of_cols)
+            num_of_cols = get_row(table, i)->num_of_cells;
+
+    Table transposed;
+    init_derived_table(&transposed, table);
+
+    int ret_val = reserve_rows(&transposed, num_of_cols);
+
+    for (long long int j = 0; j < num_of_cols && ret_val == NO_ERROR; j++)
+    {
+        Row *row = &transposed.rows[j];
+        row->cells = (Cell*)calloc((size_t)table->num_of_rows, sizeof(Cell));
+        if (row->cells == NULL)
+        {
+            ret_val = ALLOCATION_FAILED;
+            break;
+        }
+
+        row->allocated_cells = table->num_of_rows;
+        row->num_of_cells = table->num_of_rows;
+        transposed.num_of_rows++;
+    }
+
+    if (ret_val != NO_ERROR)
+    {
+        deallocate_table(&transposed);
+        return ret_val;
+    }
+
+    if (table->spill != NULL)
+    {
+        for (long long int i = 0; i < table->num_of_rows && ret_val == NO_ERROR; i++)
+            ret_val = move_cells_to_column(&transposed, get_row(table, i), i, 0, num_of_cols, false);
+    }
+    else
+    {
+        TransposeJob job;
+        job.table = table;
+        job.transposed = &transposed;
+        job.num_of_rows = table->num_of_rows;
+        job.num_of_cols = num_of_cols;
+        job.col_tiles = get_number_of_chunks(num_of_cols, TRANSPOSE_TILE);
+
+        long long int num_of_tiles = get_number_of_chunks(table->num_of_rows, TRANSPOSE_TILE) * job.col_tiles;
+        job.results = (int*)calloc((num_of_tiles > 0) ? (size_t)num_of_tiles : 1, sizeof(int));
+        if (job.results == NULL)
+            ret_val = ALLOCATION_FAILED;
+
+        if (ret_val == NO_ERROR)
+        {
+            thread_pool_for(get_table_pool(table), num_of_tiles, 1, transpose_chunk, &job);
+
+            for (long long int i = 0; i < num_of_tiles && ret_val == NO_ERROR; i++)
+                ret_val = job.results[i];
+        }
+
+        free(job.results);
+
+        // Moved cells belong to only one of tables
+        for (long long int i = 0; i < table->num_of_rows; i++)
+        {
+            Row *row = &table->rows[i];
+            if (ret_val == NO_ERROR)
+            {
+                row->num_of_cells = 0;
+                continue;
+            }
+
+            for (long long int j = 0; j < row->num_of_cells; j++)
+                transposed.rows[j].cells[i].content = NULL;
+        }
+    }
+
+    for (long long int j = 0; j < transposed.num_of_rows && ret_val == NO_ERROR; j++)
+        ret_val = widen_row_types(&transposed.col_types, &transposed.num_of_col_types, &transposed.rows[j]);
+
+    if (ret_val == NO_ERROR)
+    {
+        // Content in arenas now belongs to transposed table
+        transposed.arenas = table->arenas;
+        transposed.num_of_arenas = table->num_of_arenas;
+        table->arenas = NULL;
+        table->num_of_arenas = 0;
+
+        ret_val = replace_table(table, &transposed);
+    }
+
+    deallocate_table(&transposed);
+
+    return ret_val;
+}
+
+int format_cell_copy(Cell *scratch, const char *content, const char *delims)
+{
+    /**
+     * @brief Format copy of cell content for output to @p scratch cell
+     *
+     * Same rules as #format_chunk are applied, but content of table stays untouched
+     *
+     * @param scratch Pointer to instance of #Cell structure with heap allocated content (reused between calls)
+     * @param content Content of cell
+     * @param delims Array of deliminators
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    size_t length = strlen(content);
+    size_t number_of_delims = strlen(delims);
+
+    // Every character can be escaped and every delim can surround content once
+    size_t needed = 2 * length + 2 * number_of_delims + 3;
+    if ((size_t)scratch->allocated_chars < needed)
+    {
+        char *tmp = (char*)realloc(scratch->content, needed);
+        if (tmp == NULL)
+            return ALLOCATION_FAILED;
+
+        scratch->content = tmp;
+        scratch->allocated_chars = (long long int)needed;
+    }
+
+    memset(scratch->content, 0, needed);
+    memcpy(scratch->content, content, length);
+
+    if (add_backslashes(scratch) != NO_ERROR)
+        return ALLOCATION_FAILED;
+
+    for (size_t k = 0; k < number_of_delims; k++)
+    {
+        if (count_char(scratch->content, delims[k], false) > 0)
+        {
+            if (surround_with_dparentecies(scratch) != NO_ERROR)
+                return ALLOCATION_FAILED;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+void partition_chunk(void *arg, long long int chunk, long long int start, long long int end, int worker_id)
+{
+    /**
+     * @brief Format chunk of rows of partition round to its buffer
+     *
+     * @param arg Pointer to instance of #PartitionRound structure
+     * @param chunk Index of chunk
+     * @param start Index of first row of chunk (relative to round)
+     * @param end Index after last row of chunk (relative to round)
+     * @param worker_id Index of worker (not used)
+     */
+
+    (void)worker_id;
+
+    PartitionRound *round = (PartitionRound*)arg;
+    Table *table = round->table;
+    OutputBuffer *buffer = &round->buffers[chunk];
+    size_t *row_ends = round->row_ends + chunk * ROW_CHUNK_SIZE;
+    Cell *scratch = &round->scratch[chunk];
+    int ret_val = NO_ERROR;
+
+    buffer->length = 0;
+
+    for (long long int i = start; (i < end) && (ret_val == NO_ERROR); i++)
+    {
+        Row *row = get_row(table, round->first_row + i);
+
+        // Row without data is not written to any partition
+        if (row->cells != NULL)
+        {
+            for (long long int j = 0; (j < row->num_of_cells) && (ret_val == NO_ERROR); j++)
+            {
+                if (row->cells[j].content != NULL)
+                {
+                    if ((ret_val = format_cell_copy(scratch, row->cells[j].content, table->input_delims)) != NO_ERROR)
+                        break;
+
+                    ret_val = output_buffer_append(buffer, scratch->content, strlen(scratch->content));
+                    if (ret_val == NO_ERROR && j < (row->num_of_cells - 1))
+                        ret_val = output_buffer_append(buffer, &table->delim, 1);
+                }
+            }
+
+            if (ret_val == NO_ERROR)
+                ret_val = output_buffer_append(buffer, "\n", 1);
+        }
+
+        row_ends[i - start] = buffer->length;
+    }
+
+    round->results[chunk] = ret_val;
+}
+
+void partition_set_init(PartitionSet *set)
+{
+    /**
+     * @brief Init empty set of partitions
+     *
+     * @param set Pointer to instance of #PartitionSet structure
+     */
+
+    set->writers = NULL;
+    set->num_of_writers = 0;
+    set->allocated_writers = 0;
+    set->hand = 0;
+    set->buffered = 0;
+
+    for (int i = 0; i < PARTITION_OPEN_FILES; i++)
+        set->open_files[i] = -1;
+}
+
+int partition_set_add(PartitionSet *set, const char *prefix, const char *name)
+{
+    /**
+     * @brief Add writer of new partition to @p set
+     *
+     * File of partition is not opened until first rows are written
+     *
+     * @param set Pointer to instance of #PartitionSet structure
+     * @param prefix Prefix of path of partition file
+     * @param name Name of partition appended to @p prefix
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    if (set->num_of_writers == set->allocated_writers)
+    {
+        long long int new_allocated = (set->allocated_writers > 0) ? set->allocated_writers * 2 : BASE_NUMBER_OF_KEYS;
+        PartitionWriter *tmp = (PartitionWriter*)realloc(set->writers, (size_t)new_allocated * sizeof(PartitionWriter));
+        if (tmp == NULL)
+            return ALLOCATION_FAILED;
+
+        set->writers = tmp;
+        set->allocated_writers = new_allocated;
+    }
+
+    size_t prefix_length = strlen(prefix);
+    size_t name_length = strlen(name);
+
+    PartitionWriter *writer = &set->writers[set->num_of_writers];
+    writer->path = (char*)malloc(prefix_length + name_length + 1);
+    if (writer->path == NULL)
+        return ALLOCATION_FAILED;
+
+    memcpy(writer->path, prefix, prefix_length);
+    memcpy(writer->path + prefix_length, name, name_length + 1);
+
+    writer->buffer.data = NULL;
+    writer->buffer.length = 0;
+    writer->buffer.allocated = 0;
+    writer->fd = -1;
+    writer->created = false;
+    writer->referenced = false;
+
+    set->num_of_writers++;
+
+    return NO_ERROR;
+}
+
+int partition_set_open(PartitionSet *set, long long int index)
+{
+    /**
+     * @brief Open file of partition, evict other opened file if cache of opened files is full
+     *
+     * File is truncated when it is opened for first time, later it is only appended \n
+     * Evicted file is choosen by clock algorithm, so recently written files stay opened
+     *
+     * @param set Pointer to instance of #PartitionSet structure
+     * @param index Index of partition
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    PartitionWriter *writer = &set->writers[index];
+
+    for (;;)
+    {
+        long long int victim = set->open_files[set->hand];
+
+        if (victim >= 0 && set->writers[victim].referenced)
+        {
+            // Give recently written file second chance
+            set->writers[victim].referenced = false;
+            set->hand = (set->hand + 1) % PARTITION_OPEN_FILES;
+            continue;
+        }
+
+        if (victim >= 0)
+        {
+            int closed = close(set->writers[victim].fd);
+            set->writers[victim].fd = -1;
+            set->open_files[set->hand] = -1;
+
+            if (closed != 0)
+                return IO_ERROR;
+        }
+
+        break;
+    }
+
+    int flags = O_WRONLY | O_CREAT | (writer->created ? O_APPEND : O_TRUNC);
+    writer->fd = open(writer->path, flags, 0666);
+    if (writer->fd < 0)
+        return CANT_OPEN_FILE;
+
+    writer->created = true;
+    writer->referenced = true;
+    set->open_files[set->hand] = index;
+    set->hand = (set->hand + 1) % PARTITION_OPEN_FILES;
+
+    return NO_ERROR;
+}
+
+int partition_set_flush(PartitionSet *set, long long int index)
+{
+    /**
+     * @brief Write buffered rows of partition to its file
+     *
+     * @param set Pointer to instance of #PartitionSet structure
+     * @param index Index of partition
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val;
+    PartitionWriter *writer = &set->writers[index];
+
+    // Partition without rows has to be created too
+    if (writer->buffer.length == 0 && writer->created)
+        return NO_ERROR;
+
+    if (writer->fd < 0 && (ret_val = partition_set_open(set, index)) != NO_ERROR)
+        return ret_val;
+
+    size_t written = 0;
+    while (written < writer->buffer.length)
+    {
+        ssize_t count = write(writer->fd, writer->buffer.data + written, writer->buffer.length - written);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return IO_ERROR;
+        }
+
+        written += (size_t)count;
+    }
+
+    set->buffered -= writer->buffer.length;
+    writer->buffer.length = 0;
+    writer->referenced = true;
+
+    return NO_ERROR;
+}
+
+int partition_set_put(PartitionSet *set, long long int index, const char *data, size_t length)
+{
+    /**
+     * @brief Append formatted rows to partition
+     *
+     * Rows are buffered until buffer of partition is full or all partitions together exceed #PARTITION_BUFFER_MEMORY
+     *
+     * @param set Pointer to instance of #PartitionSet structure
+     * @param index Index of partition
+     * @param data Formatted rows
+     * @param length Length of @p data
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val;
+    PartitionWriter *writer = &set->writers[index];
+
+    if ((ret_val = output_buffer_append(&writer->buffer, data, length)) != NO_ERROR)
+        return ret_val;
+
+    set->buffered += length;
+
+    if (writer->buffer.length >= PARTITION_BUFFER_SIZE)
+        return partition_set_flush(set, index);
+
+    if (set->buffered >= PARTITION_BUFFER_MEMORY)
+    {
+        // Write all partitions and release their buffers
+        for (long long int i = 0; i < set->num_of_writers; i++)
+        {
+            if ((ret_val = partition_set_flush(set, i)) != NO_ERROR)
+                return ret_val;
+
+            free(set->writers[i].buffer.data);
+            set->writers[i].buffer.data = NULL;
+            set->writers[i].buffer.allocated = 0;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+int partition_set_close(PartitionSet *set, _Bool flush)
+{
+    /**
+     * @brief Write rest of buffered rows, close all files and free @p set
+     *
+     * @param set Pointer to instance of #PartitionSet structure
+     * @param flush Flag if buffered rows should be written (false on error)
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    for (long long int i = 0; (i < set->num_of_writers) && flush && (ret_val == NO_ERROR); i++)
+        ret_val = partition_set_flush(set, i);
+
+    for (int i = 0; i < PARTITION_OPEN_FILES; i++)
+    {
+        if (set->open_files[i] >= 0 && close(set->writers[set->open_files[i]].fd) != 0 && ret_val == NO_ERROR)
+            ret_val = IO_ERROR;
+    }
+
+    for (long long int i = 0; i < set->num_of_writers; i++)
+    {
+        free(set->writers[i].path);
+        free(set->writers[i].buffer.data);
+    }
+
+    free(set->writers);
+    partition_set_init(set);
+
+    return ret_val;
+}
+
+int partition_rows(Table *table, Selector *selector, long long int key_col, long long int rows_per_file, const char *prefix)
+{
+    /**
+     * @brief Write selected rows to separate files by value of key column or by number of rows
+     *
+     * Rows are formatted in rounds of #SAVE_ROUND_CHUNKS chunks that are formatted in parallel \n
+     * Formatted rows are then distributed in order to buffered writers of their partitions \n
+     * When @p key_col is valid rows are written to file @p prefix followed by key (characters '/' and
+     * control characters are replaced by '_', empty key is named '_'), otherwise every @p rows_per_file rows
+     * are written to file @p prefix followed by number of file (starting with 1)
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure with selected rows
+     * @param key_col Index of column with partition keys (-1 to split by number of rows)
+     * @param rows_per_file Number of rows in one file (used when @p key_col is -1)
+     * @param prefix Prefix of paths of partition files
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (key_col < -1 || key_col >= get_row(table, 0)->num_of_cells || (key_col == -1 && rows_per_file < 1))
+        return FUNCTION_ARGUMENT_ERROR;
+
+    long long int num_of_rows = get_number_of_selected_rows(table, selector);
+
+    OutputBuffer buffers[SAVE_ROUND_CHUNKS];
+    Cell scratch[SAVE_ROUND_CHUNKS];
+    int results[SAVE_ROUND_CHUNKS];
+
+    for (int i = 0; i < SAVE_ROUND_CHUNKS; i++)
+    {
+        buffers[i].data = NULL;
+        buffers[i].length = 0;
+        buffers[i].allocated = 0;
+        scratch[i].content = NULL;
+        scratch[i].allocated_chars = 0;
+        scratch[i].in_arena = false;
+    }
+
+    PartitionRound round;
+    round.table = table;
+    round.buffers = buffers;
+    round.scratch = scratch;
+    round.results = results;
+    round.row_ends = (size_t*)malloc(SAVE_ROUND_CHUNKS * ROW_CHUNK_SIZE * sizeof(size_t));
+
+    PartitionSet set;
+    partition_set_init(&set);
+
+    KeyMap names;
+    key_map_init(&names);
+
+    char *name = NULL;
+    size_t allocated_name = 0;
+
+    int ret_val = (round.row_ends == NULL) ? ALLOCATION_FAILED : NO_ERROR;
+
+    for (long long int first = 0; (first < num_of_rows) && (ret_val == NO_ERROR); first += SAVE_ROUND_CHUNKS * ROW_CHUNK_SIZE)
+    {
+        long long int rows_left = num_of_rows - first;
+        long long int round_rows = (rows_left < SAVE_ROUND_CHUNKS * ROW_CHUNK_SIZE) ? rows_left : SAVE_ROUND_CHUNKS * ROW_CHUNK_SIZE;
+
+        round.first_row = selector->lld_ir1 + first;
+        thread_pool_for(get_table_pool(table), round_rows, ROW_CHUNK_SIZE, partition_chunk, &round);
+
+        // Distribute formatted rows to partitions in order
+        for (long long int i = 0; (i < round_rows) && (ret_val == NO_ERROR); i++)
+        {
+            long long int chunk = i / ROW_CHUNK_SIZE;
+            if ((ret_val = results[chunk]) != NO_ERROR)
+                break;
+
+            size_t row_start = (i % ROW_CHUNK_SIZE == 0) ? 0 : round.row_ends[i - 1];
+            size_t row_end = round.row_ends[i];
+            if (row_end == row_start)
+                continue;
+
+            long long int index;
+            char number[32];
+            const char *partition_name = number;
+
+            if (key_col >= 0)
+            {
+                const char *key = get_row(table, round.first_row + i)->cells[key_col].content;
+                size_t length = (key != NULL) ? strlen(key) : 0;
+
+                if (allocated_name < length + 2)
+                {
+                    char *tmp = (char*)realloc(name, length + 2);
+                    if (tmp == NULL)
+                    {
+                        ret_val = ALLOCATION_FAILED;
+                        break;
+                    }
+
+                    name = tmp;
+                    allocated_name = length + 2;
+                }
+
+                // Key is part of file name so it cant leave prefix directory
+                for (size_t k = 0; k < length; k++)
+                    name[k] = (key[k] == '/' || (unsigned char)key[k] < ' ') ? '_' : key[k];
+                strcpy(name + length, (length == 0) ? "_" : "");
+
+                if ((ret_val = key_map_insert(&names, name, &index)) != NO_ERROR)
+                    break;
+                partition_name = name;
+            }
+            else
+            {
+                index = (first + i) / rows_per_file;
+                if (index == set.num_of_writers)
+                    snprintf(number, sizeof(number), "%lld", index + 1);
+            }
+
+            if (index == set.num_of_writers)
+                ret_val = partition_set_add(&set, prefix, partition_name);
+
+            if (ret_val == NO_ERROR)
+                ret_val = partition_set_put(&set, index, buffers[chunk].data + row_start, row_end - row_start);
+        }
+    }
+
+    int close_ret_val = partition_set_close(&set, ret_val == NO_ERROR);
+
+    for (int i = 0; i < SAVE_ROUND_CHUNKS; i++)
+    {
+        free(buffers[i].data);
+        free(scratch[i].content);
+    }
+
+    free(round.row_ends);
+    free(name);
+    key_map_destroy(&names);
+
+    return (ret_val != NO_ERROR) ? ret_val : close_ret_val;
+}
+
+int init_temp_var_store(TempVariableStore *temp_var_store)
+{
+    /**
+     * @brief Init array of temporary variables
+     *
+     * @param temp_var_store Pointer to instance of #TempVariableStore structure
+     *
+     * @return #NO_ERROR on success and #ALLOCATION_FAILED on error
+     */
+
+    temp_var_store->variables = (char**)malloc(NUMBER_OF_TEMPORARY_VARIABLES * sizeof(char*));
+    if (temp_var_store->variables == NULL)
+        return ALLOCATION_FAILED;
+
+    for (long long int i = 0; i < NUMBER_OF_TEMPORARY_VARIABLES; i++)
+    {
+        temp_var_store->variables[i] = NULL;
+    }
+
+    return NO_ERROR;
+}
+
+void copy_selector(Selector *source, Selector *dest)
+{
+    /**
+     * @brief Copy values from selector @p source to selector @p dest
+     *
+     * @param source Pointer to instance of #Selector struct from which we want copy data
+     * @param dest Pointer to instance of #Selector struct where we want save data
+     */
+
+    dest->lld_ir1 = source->lld_ir1;
+    dest->lld_ir2 = source->lld_ir2;
+    dest->lld_ic1 = source->lld_ic1;
+    dest->lld_ic2 = source->lld_ic2;
+}
+
+void selector_find(Selector *selector, Table *table, char *string)
+{
+    /**
+     * @brief Select cell that starts with @p string
+     *
+     * @param selector Pointer to instance of #Selector structure where data will be saved
+     * @param table Pointer to instance of #Table structure
+     * @param string String we want to find at the beginning of cell
+     */
+
+    _Bool found = false;
+
+    for (long long int i = selector->lld_ir1; (i <= selector->lld_ir2) && (i < table->num_of_rows); i++)
+    {
+        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < get_row(table, i)->num_of_cells); j++)
+        {
+            if (string_start_with(get_row(table, i)->cells[j].content, string))
+            {
+                selector->lld_ir1 = selector->lld_ir2 = i;
+                selector->lld_ic1 = selector->lld_ic2 = j;
+                found = true;
+            }
+
+            if (found)
+                break;
+        }
+
+        if (found)
+            break;
+    }
+}
+
+void extreme_chunk(void *arg, long long int chunk, long long int start, long long int end, int worker_id)
+{
+    /**
+     * @brief Find cell with maximum or minimum numeric value in chunk of selected rows
+     *
+     * First cell with extreme value is taken, so combined results are the same as when selection is searched sequentially
+     *
+     * @param arg Pointer to instance of #SelectionReduction structure
+     * @param chunk Index of chunk
+     * @param start Index of first row of chunk (relative to selection)
+     * @param end Index after last row of chunk (relative to selection)
+     * @param worker_id Index of worker (not used)
+     */
+
+    (void)worker_id;
+
+    SelectionReduction *reduction = (SelectionReduction*)arg;
+    Table *table = reduction->table;
+    Selector *selector = reduction->selector;
+
+    long double extreme = reduction->want_max ? -LDBL_MAX : LDBL_MAX;
+    char *testing_string = NULL;
+
+    // Numeric columns have no quoted cells, so cells are converted without copying
+    if (reduction->type <= DECIMAL_COLUMN)
+    {
+        for (long long int i = reduction->first_row + start; i < (reduction->first_row + end); i++)
+        {
+            Row *row = get_row(table, i);
+            for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < row->num_of_cells); j++)
+            {
+                long long int integer;
+                long double ret;
+
+                if (reduction->type <= INTEGER_COLUMN && string_to_integer(row->cells[j].content, &integer))
+                    ret = integer;
+                else if (string_to_ldouble(row->cells[j].content, &ret) != NO_ERROR)
+                    continue;
+
+                if (reduction->want_max ? (ret > extreme) : (ret < extreme))
+                {
+                    extreme = ret;
+                    reduction->rows[chunk] = i;
+                    reduction->cols[chunk] = j;
+                    reduction->flags[chunk] = true;
+                }
+            }
+        }
+
+        reduction->values[chunk] = extreme;
+        return;
+    }
+
+    for (long long int i = reduction->first_row + start; i < (reduction->first_row + end); i++)
+    {
+        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < get_row(table, i)->num_of_cells); j++)
+        {
+            if (string_copy(&get_row(table, i)->cells[j].content, &testing_string) != NO_ERROR)
+            {
+                reduction->results[chunk] = ALLOCATION_FAILED;
+                return;
+            }
+
+            if ((string_start_with(testing_string, "\"") && string_end_with(testing_string, "\"")) ||
+                (string_start_with(testing_string, "\'") && string_end_with(testing_string, "\'")))
+            {
+                if (trim_se(testing_string) != NO_ERROR)
+                {
+                    free(testing_string);
+                    reduction->results[chunk] = FUNCTION_ERROR;
+                    return;
+                }
+            }
+
+            if (is_string_ldouble(testing_string))
+            {
+                long double ret;
+                if ((reduction->results[chunk] = string_to_ldouble(testing_string, &ret)) != NO_ERROR)
+                {
+                    free(testing_string);
+                    return;
+                }
+
+                if (reduction->want_max ? (ret > extreme) : (ret < extreme))
+                {
+                    extreme = ret;
+                    reduction->rows[chunk] = i;
+                    reduction->cols[chunk] = j;
+                    reduction->flags[chunk] = true;
+                }
+            }
+
+            free(testing_string);
+            testing_string = NULL;
+        }
+    }
+
+    reduction->values[chunk] = extreme;
+}
+
+int selector_extreme(Selector *selector, Table *table, _Bool want_max)
+{
+    /**
+     * @brief Select cell with maximum or minimum numeric value in current selection
+     *
+     * Chunks of rows are searched in parallel and their results are compared in order of chunks
+     *
+     * @param selector Pointer to instance of #Selector structure where data will be saved
+     * @param table Pointer to instance of #Table structure
+     * @param want_max Flag if maximum (or minimum) is searched
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+    long long int r = 0, c = 0;
+    long double extreme = 0;
+    _Bool found = false;
+    SelectionReduction reduction = { .values = NULL, .counts = NULL, .rows = NULL, .cols = NULL, .flags = NULL, .results = NULL };
+    CachedResult cached = { .value = 0, .count = 0, .flag = false, .row = 0, .col = 0 };
+    _Bool cache_hit = cache_lookup(table, selector, want_max ? CACHED_MAX : CACHED_MIN, &cached);
+
+    if (cache_hit)
+    {
+        found = cached.flag;
+        r = cached.row;
+        c = cached.col;
+    }
+
+    // Shard searches only its own rows
+    Selector searched = *selector;
+    if (table->shard != NULL)
+        shard_localize_selector(table, &searched);
+
+    if (!cache_hit && (ret_val = init_selection_reduction(&reduction, table, &searched)) == NO_ERROR)
+    {
+        reduction.want_max = want_max;
+
+        long long int num_of_rows = get_number_of_selected_rows(table, &searched);
+        thread_pool_for(get_table_pool(table), num_of_rows, ROW_CHUNK_SIZE, extreme_chunk, &reduction);
+
+        for (long long int i = 0; i < get_number_of_chunks(num_of_rows, ROW_CHUNK_SIZE); i++)
+        {
+            if ((ret_val = reduction.results[i]) != NO_ERROR)
+                break;
+
+            if (reduction.flags[i] && (!found || (want_max ? (reduction.values[i] > extreme) : (reduction.values[i] < extreme))))
+            {
+                extreme = reduction.values[i];
+                r = reduction.rows[i];
+                c = reduction.cols[i];
+                found = true;
+            }
+        }
+    }
+
+    deallocate_selection_reduction(&reduction);
+
+    // Shards compare their extremes in order of shards
+    if (table->shard != NULL)
+    {
+        ShardPartial partial = { .result = ret_val, .flag = found, .want_max = want_max, .value = extreme, .row = r + table->shard->first_row, .col = c };
+        int exchange_ret_val = shard_exchange(table->shard, &partial, sizeof(partial), merge_shard_extremes);
+
+        ret_val = (exchange_ret_val != NO_ERROR) ? exchange_ret_val : partial.result;
+        found = partial.flag;
+        r = partial.row;
+        c = partial.col;
+    }
+
+    if (ret_val == NO_ERROR && !cache_hit)
+    {
+        cached.flag = found;
+        cached.row = r;
+        cached.col = c;
+        cache_store(table, selector, want_max ? CACHED_MAX : CACHED_MIN, &cached);
+    }
+
+    if (ret_val == NO_ERROR)
+    {
+        if (found)
+        {
+            selector->lld_ir1 = selector->lld_ir2 = r;
+            selector->lld_ic1 = selector->lld_ic2 = c;
+        }
+        else if (table->shard == NULL || table->shard->index == 0)
+        {
+            fprintf(stdout, "[WARNING] Cant find %s in [%llu, %llu, %llu, %llu] selection\n", want_max ? "maximum" : "minimum", selector->lld_ir1 + 1, selector->lld_ic1 + 1, selector->lld_ir2 + 1, selector->lld_ic2 + 1);
+        }
+    }
+
+    return ret_val;
+}
+
+int selector_max(Selector *selector, Table *table)
+{
+    /**
+     * @brief Select cell with maximum numeric value in current selection
+     *
+     * @param selector Pointer to instance of #Selector structure where data will be saved
+     * @param table Pointer to instance of #Table structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    return selector_extreme(selector, table, true);
+}
+
+int selector_min(Selector *selector, Table *table)
+{
+    /**
+     * @brief Select cell with minimum numeric value in current selection
+     *
+     * @param selector Pointer to instance of #Selector structure where data will be saved
+     * @param table Pointer to instance of #Table structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    return selector_extreme(selector, table, false);
+}
+
+void selector_select_all(Selector *selector, Table *table)
+{
+    /**
+     * @brief Select whole table
+     *
+     * @param selector Pointer to instance of #Selector structure where data will be saved
+     * @param table Pointer to instance of #Table structure
+     */
+
+    selector->lld_ir1 = selector->lld_ic1 = 0;
+    selector->lld_ir2 = get_number_of_rows(table) - 1;
+    selector->lld_ic1 = 0;
+    selector->lld_ic2 = get_row(table, 0)->num_of_cells - 1;
+}
+
+void selector_select_last(Selector *selector, Table *table)
+{
+    /**
+     * @brief Select last cell in last row
+     *
+     * @param selector Pointer to instance of #Selector structure where data will be saved
+     * @param table Pointer to instance of #Table structure
+     */
+
+    selector->lld_ir1 = selector->lld_ir2 = get_number_of_rows(table) - 1;
+    selector->lld_ic1 = selector->lld_ic2 = get_row(table, 0)->num_of_cells - 1;
+}
+
+void selector_select_last_colm(Selector *selector, Table *table)
+{
+    /**
+     * @brief Select last column
+     *
+     * @param selector Pointer to instance of #Selector structure where data will be saved
+     * @param table Pointer to instance of #Table structure
+     */
+
+    selector->lld_ir1 = 0;
+    selector->lld_ir2 = get_number_of_rows(table) - 1;
+    selector->lld_ic1 = selector->lld_ic2 = get_row(table, 0)->num_of_cells - 1;
+}
+
+void selector_select_last_row(Selector *selector, Table *table)
+{
+    /**
+     * @brief Select last row
+     *
+     * @param selector Pointer to instance of #Selector structure where data will be saved
+     * @param table Pointer to instance of #Table structure
+     */
+
+    selector->lld_ir1 = selector->lld_ir2 = get_number_of_rows(table) - 1;
+    selector->lld_ic1 = 0;
+    selector->lld_ic2 = get_row(table, 0)->num_of_cells - 1;
+}
+
+int selector_select_4p_area(Selector *selector, Table *table, char **parts, const _Bool *part_is_llint, const long long int *parts_llint)
+{
+    /**
+     * @brief Parse and set data to selector for 4 parameter selectors
+     *
+     * @param selector Pointer to instance of #Selector structure where data will be saved
+     * @param table Pointer to instance of #Table structure
+     * @param parts Pointer to string array where splited data are stored
+     * @param part_is_llint Pointer to array of bools that indicates if corespoding part is long long int
+     * @param parts_llint Pointer to array of long long ints that are converted values from @p parts array if it was possible
+     *
+     * @return #NO_ERROR on success and #SELECTOR_ERROR if something failed
+     */
+
+    // Check if there are no _ characters in parts of selector
+    if (!((!part_is_llint[2] && !strings_equal(parts[2], "-")) || (!part_is_llint[3] && !strings_equal(parts[3], "-"))) &&
+        !((!part_is_llint[0] && !strings_equal(parts[0], "-")) || (!part_is_llint[1] && !strings_equal(parts[1], "-"))))
+    {
+        // Check if - chars are only on valid positions ([-,C1,R2,C2] doesnt make sense)
+        if ((!part_is_llint[0] && part_is_llint[2]) || (!part_is_llint[1] && part_is_llint[3]) ||
+            // Check if rows and cols values are valid (R1 <= R2, etc.)
+            (part_is_llint[0] && part_is_llint[2] && parts_llint[0] > parts_llint[2]) ||
+            (part_is_llint[1] && part_is_llint[3] && parts_llint[1] > parts_llint[3]) ||
+            // Check ranges of numerical parts
+            (part_is_llint[0] && (parts_llint[0] > get_number_of_rows(table) || parts_llint[0] < 1)) || (part_is_llint[2] && (parts_llint[2] > get_number_of_rows(table) || parts_llint[2] < 1)) ||
+            (part_is_llint[1] && (parts_llint[1] > get_row(table, 0)->num_of_cells || parts_llint[1] < 1)) || (part_is_llint[3] && (parts_llint[3] > get_row(table, 0)->num_of_cells || parts_llint[3] < 1)))
+        {
+            return SELECTOR_ERROR;
+        }
+
+        selector->lld_ir1 = part_is_llint[0] ? parts_llint[0] - 1 : get_number_of_rows(table) - 1;
+        selector->lld_ic1 = part_is_llint[1] ? parts_llint[1] - 1 : get_row(table, 0)->num_of_cells - 1;
+        selector->lld_ir2 = part_is_llint[2] ? parts_llint[2] - 1 : get_number_of_rows(table) - 1;
+        selector->lld_ic2 = part_is_llint[3] ? parts_llint[3] - 1 : get_row(table, 0)->num_of_cells - 1;
+
+        return NO_ERROR;
+    }
+
+    return SELECTOR_ERROR;
+}
+
+int selector_select_2p_area(Selector *selector, Table *table, char **parts, const _Bool *part_is_llint, const long long int *parts_llint)
+{
+    /**
+     * @brief Parse and set data to selector for 2 parameter selectors
+     *
+     * @param selector Pointer to instance of #Selector structure where data will be saved
+     * @param table Pointer to instance of #Table structure
+     * @param parts Pointer to string array where splited data are stored
+     * @param part_is_llint Pointer to array of bools that indicates if corespoding part is long long int
+     * @param parts_llint Pointer to array of long long ints that are converted values from @p parts array if it was possible
+     *
+     * @return #NO_ERROR on success and #SELECTOR_ERROR if something failed
+     */
+
+    if (part_is_llint[0] && part_is_llint[1])
+    {
+        // [R,C]
+        if (parts_llint[0] > 0 && parts_llint[0] <= get_number_of_rows(table) && parts_llint[1] > 0 && parts_llint[1] <= get_row(table, 0)->num_of_cells)
+        {
+            selector->lld_ir1 = selector->lld_ir2 = parts_llint[0] - 1;
+            selector->lld_ic1 = selector->lld_ic2 = parts_llint[1] - 1;
+            return NO_ERROR;
+        }
+    }
+    else if (part_is_llint[0] && !part_is_llint[1])
+    {
+        // [R,_]
+        if (parts_llint[0] > 0 && parts_llint[0] <= get_number_of_rows(table) && strings_equal(parts[1], "_"))
+        {
+            selector->lld_ir1 = selector->lld_ir2 = parts_llint[0] - 1;
+            selector->lld_ic1 = 0;
+            selector->lld_ic2 = get_row(table, 0)->num_of_cells - 1;
+            return NO_ERROR;
+        }
+            // [R,-]
+        else if (parts_llint[0] > 0 && parts_llint[0] <= get_number_of_rows(table) && strings_equal(parts[1], "-"))
+        {
+            selector->lld_ir1 = selector->lld_ir2 = parts_llint[0] - 1;
+            selector->lld_ic1 = selector->lld_ic2 = get_row(table, 0)->num_of_cells - 1;
+            return NO_ERROR;
+        }
+    }
+    else if (!part_is_llint[0] && part_is_llint[1])
+    {
+        // [_,C]
+        if (strings_equal(parts[0], "_") && parts_llint[1] > 0 && parts_llint[1] <= get_row(table, 0)->num_of_cells)
+        {
+            selector->lld_ir1 = 0;
+            selector->lld_ir2 = get_number_of_rows(table) - 1;
+            selector->lld_ic1 = selector->lld_ic2 = parts_llint[1] - 1;
+            return NO_ERROR;
+        }
+            // [-,C]
+        else if (strings_equal(parts[0], "-") && parts_llint[1] > 0 && parts_llint[1] <= get_row(table, 0)->num_of_cells)
+        {
+            selector->lld_ir1 = selector->lld_ir2 = get_number_of_rows(table) - 1;
+            selector->lld_ic1 = selector->lld_ic2 = parts_llint[1] - 1;
+            return NO_ERROR;
+        }
+    }
+
+    return SELECTOR_ERROR;
+}
+
+int set_selector(Selector *selector, Selector *temp_selector, Command *command, Table *table) {
+    /**
+     * @brief Set values in @p selector
+     *
+     * Set values in selector based on inputed @p command and @p table
+     *
+     * @param selector Pointer to instance of #Selector structure (main selector)
+     * @param temp_selector Pointer to instance of #Selector structure (temporary selector)
+     * @param command Pointer to instance of #Command structure
+     * @param table Pointer to instance of #Table structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val;
+
+    if (!selector->initialized || !temp_selector->initialized)
+        return FUNCTION_ERROR;
+
+    // Get rid of []
+    if ((ret_val = trim_se(command->function)) != NO_ERROR)
+        return ret_val;
+
+    char *buffer = NULL;
+    char *rest_buf = NULL;
+    if ((ret_val = get_substring(command->function, &buffer, ' ', 0, true, &rest_buf, true)) != NO_ERROR)
+        return ret_val;
+
+    if (strings_equal(buffer, "find"))
+    {
+        selector_find(selector, table, rest_buf);
+    }
+    else
+    {
+        // Static selections
+        if (strings_equal(buffer, "max"))
+        {
+            ret_val = selector_max(selector, table);
+        }
+        else if (strings_equal(buffer, "min"))
+        {
+            ret_val = selector_min(selector, table);
+        }
+        else if (strings_equal(buffer, "_,_"))
+        {
+            selector_select_all(selector, table);
+        }
+        else if (strings_equal(buffer, "-,-") || strings_equal(buffer, "-,-,-,-"))
+        {
+            selector_select_last(selector, table);
+        }
+        else if (strings_equal(buffer, "_,-"))
+        {
+            selector_select_last_colm(selector, table);
+        }
+        else if (strings_equal(buffer, "-,_"))
+        {
+            selector_select_last_row(selector, table);
+        }
+        else if (strings_equal(buffer, "_"))
+        {
+            copy_selector(temp_selector, selector);
+        }
+        else if (strings_equal(buffer, "set"))
+        {
+            copy_selector(selector, temp_selector);
+        }
+        else
+        {
+            long long int num_of_parts = count_char(buffer, ',', true) + 1;
+            char *parts[4] = { NULL };
+            _Bool part_is_llint[4] = { false };
+            long long int parts_llint[4] = { 0 };
+
+            // Parse more complex selections
+            for (long long int i = 0; i < num_of_parts; i++)
+            {
+                if ((ret_val = get_substring(buffer, &parts[i], ',', i, true, NULL, false)) != NO_ERROR)
+                    break;
+
+                if ((part_is_llint[i] = is_string_llint(parts[i])) == true)
+                {
+                    if ((ret_val = string_to_llint(parts[i], &parts_llint[i])) != NO_ERROR)
+                        break;
+                }
+                else
+                {
+                    if (!strings_equal(parts[i], "-") && !strings_equal(parts[i], "_"))
+                    {
+                        ret_val = SELECTOR_ERROR;
+                        break;
+                    }
+                }
+            }
+
+            // If there is no error continue to validity check and setting new selector
+            if (ret_val == NO_ERROR)
+            {
+                switch (num_of_parts)
+                {
+                    case 2:
+                        // Parser for 2 parts selectors
+                        ret_val = selector_select_2p_area(selector, table, parts, part_is_llint, parts_llint);
+                        break;
+
+                    case 4:
+                        // Parser for 4 parts selectors like [R1,C1,R2,C2], [R1,C1,R2,-], etc
+                        ret_val = selector_select_4p_area(selector, table, parts, part_is_llint, parts_llint);
+                        break;
+
+                    default:
+                        ret_val = SELECTOR_ERROR;
+                        break;
+                }
+            }
+
+            for (int j = 0; j < 4; j++)
+                free(parts[j]);
+        }
+    }
+
+    free(buffer);
+    free(rest_buf);
+
+    return ret_val;
+}
+
+void parse_batch_chunk(void *arg, long long int chunk, long long int start, long long int end, int worker_id)
+{
+    /**
+     * @brief Parse chunk of lines of #LoadBatch
+     *
+     * Cells are allocated in arena of worker that parses the chunk and types of columns of chunk are inferred
+     *
+     * @param arg Pointer to instance of #LoadBatch structure
+     * @param chunk Index of chunk
+     * @param start Index of first line of chunk
+     * @param end Index after last line of chunk
+     * @param worker_id Index of worker
+     */
+
+    LoadBatch *batch = (LoadBatch*)arg;
+    Table *table = batch->table;
+
+    // Cells in arena cant be freed by spilling so with memory budget heap is used
+    Arena *arena = (table->spill == NULL) ? &table->arenas[worker_id] : NULL;
+
+    for (long long int i = start; i < end; i++)
+    {
+        char *line = batch->lines[i];
+
+        rm_newline_chars(line);
+        normalize_delims(line, batch->delims);
+
+        // New rows cant be spilled so they can be accessed directly
+        int ret_val = parse_row(line, &table->rows[batch->first_row + i], table->delim, arena);
+
+        free(line);
+        batch->lines[i] = NULL;
+
+        if (ret_val == NO_ERROR)
+            ret_val = widen_row_types(&batch->col_types[chunk], &batch->num_of_col_types[chunk], &table->rows[batch->first_row + i]);
+
+        if (ret_val != NO_ERROR)
+        {
+            batch->results[chunk] = ret_val;
+            batch->failed_lines[chunk] = i;
+            break;
+        }
+    }
+}
+
+int parse_batch(LoadBatch *batch)
+{
+    /**
+     * @brief Parse all lines of batch and append them as rows to table
+     *
+     * Chunks of lines are parsed in parallel by thread pool of table \n
+     * When parsing of some line fails then table ends with last row before it
+     *
+     * @param batch Pointer to instance of #LoadBatch structure with read lines
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+    Table *table = batch->table;
+    int num_of_arenas = (table->pool != NULL) ? table->pool->max_workers : 1;
+
+    batch->first_row = table->num_of_rows;
+
+    if ((ret_val = reserve_rows(table, table->num_of_rows + batch->num_of_lines)) != NO_ERROR ||
+        (table->spill == NULL && (ret_val = allocate_arenas(table, num_of_arenas)) != NO_ERROR))
+    {
+        for (long long int i = 0; i < batch->num_of_lines; i++)
+            free(batch->lines[i]);
+        return ret_val;
+    }
+
+    long long int num_of_chunks = get_number_of_chunks(batch->num_of_lines, LOAD_CHUNK_SIZE);
+    for (long long int i = 0; i < num_of_chunks; i++)
+    {
+        batch->results[i] = NO_ERROR;
+        batch->failed_lines[i] = batch->num_of_lines;
+        batch->col_types[i] = NULL;
+        batch->num_of_col_types[i] = 0;
+    }
+
+    thread_pool_for(table->pool, batch->num_of_lines, LOAD_CHUNK_SIZE, parse_batch_chunk, batch);
+
+    long long int parsed_lines = batch->num_of_lines;
+    for (long long int i = 0; i < num_of_chunks; i++)
+    {
+        if (batch->results[i] != NO_ERROR)
+        {
+            ret_val = batch->results[i];
+            parsed_lines = batch->failed_lines[i];
+            break;
+        }
+    }
+
+    // Merge types of columns of chunks to table
+    for (long long int i = 0; i < num_of_chunks; i++)
+    {
+        for (long long int j = 0; j < batch->num_of_col_types[i] && ret_val == NO_ERROR; j++)
+            ret_val = widen_column_type(&table->col_types, &table->num_of_col_types, j, batch->col_types[i][j]);
+
+        free(batch->col_types[i]);
+    }
+
+    // Throw away everything after failed line
+    for (long long int i = parsed_lines; i < batch->num_of_lines; i++)
+    {
+        free(batch->lines[i]);
+        deallocate_row(&table->rows[batch->first_row + i]);
+    }
+
+    table->num_of_rows += parsed_lines;
+
+    return ret_val;
+}
+
+int read_line_batch(ReadAheadReader *reader, LoadBatch *batch, _Bool *end_of_file, long long int *complete_lines, off_t *complete_offset)
+{
+    /**
+     * @brief Read up to #LOAD_BATCH_SIZE lines from @p reader to @p batch
+     *
+     * @param reader Pointer to instance of #ReadAheadReader structure with opened file
+     * @param batch Pointer to instance of #LoadBatch structure with allocated array of lines
+     * @param end_of_file Pointer where flag if end of file was reached will be saved
+     * @param complete_lines Pointer where number of lines of batch terminated by new line will be saved (-1 if there is none)
+     * @param complete_offset Pointer where offset right after last line terminated by new line will be saved
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error (lines of batch are freed)
+     */
+
+    *end_of_file = false;
+    *complete_lines = -1;
+
+    batch->num_of_lines = 0;
+    while (batch->num_of_lines < LOAD_BATCH_SIZE)
+    {
+        char *line = NULL;
+        if (read_ahead_get_line(reader, &line) == -1)
+        {
+            *end_of_file = true;
+            break;
+        }
+
+        if (line == NULL)
+        {
+            for (long long int i = 0; i < batch->num_of_lines; i++)
+                free(batch->lines[i]);
+            batch->num_of_lines = 0;
+            return ALLOCATION_FAILED;
+        }
+
+        batch->lines[batch->num_of_lines++] = line;
+
+        if (reader->line_complete)
+        {
+            *complete_lines = batch->num_of_lines;
+            *complete_offset = reader->consumed;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+int parse_lines(ReadAheadReader *reader, const char *delims, Table *table, long long int *complete_rows, off_t *complete_offset)
+{
+    /**
+     * @brief Parse lines from @p reader and append them as rows to @p table
+     *
+     * Lines are read in batches of #LOAD_BATCH_SIZE lines and each batch is parsed in parallel
+     *
+     * @param reader Pointer to instance of #ReadAheadReader structure with opened file
+     * @param delims Array with all posible delimiters
+     * @param table Pointer #Table where data will be saved
+     * @param complete_rows Pointer where number of rows created from lines terminated by new line will be saved (can be NULL)
+     * @param complete_offset Pointer where offset right after last line terminated by new line will be saved (can be NULL)
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    LoadBatch batch;
+    batch.table = table;
+    batch.delims = delims;
+    batch.lines = (char**)malloc(LOAD_BATCH_SIZE * sizeof(char*));
+    if (batch.lines == NULL)
+        return ALLOCATION_FAILED;
+
+    _Bool end_of_file = false;
+    while (!end_of_file && ret_val == NO_ERROR)
+    {
+        long long int batch_complete_lines = -1;
+        off_t batch_complete_offset = 0;
+
+        // Read batch of lines
+        if ((ret_val = read_line_batch(reader, &batch, &end_of_file, &batch_complete_lines, &batch_complete_offset)) != NO_ERROR)
+            break;
+
+        if (batch.num_of_lines == 0)
+            break;
+
+        if ((ret_val = parse_batch(&batch)) != NO_ERROR)
+            break;
+
+        if (batch_complete_lines >= 0)
+        {
+            if (complete_rows != NULL)
+                *complete_rows = batch.first_row + batch_complete_lines;
+            if (complete_offset != NULL)
+                *complete_offset = batch_complete_offset;
+        }
+
+        // Every finished batch is chance to spill older pages
+        if ((ret_val = enforce_memory_budget(table, -1)) != NO_ERROR)
+            break;
+    }
+
+    free(batch.lines);
+
+    return ret_val;
+}
+
+int load_table_range(const char *delims, char *filepath, off_t start, off_t end, Table *table)
+{
+    /**
+     * @brief Load table from byte range of file
+     *
+     * Load and parse data from file \n
+     * File is read by read-ahead thread so parsing of one buffer overlaps with reading of next ones
+     *
+     * @param delims Array with all posible delimiters
+     * @param filepath Path to input file
+     * @param start Offset of first line of range
+     * @param end Offset after last line of range (-1 to read until end of file)
+     * @param table Pointer #Table where data will be saved
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+    ReadAheadReader reader;
+
+    // Try to open input file
+    if ((ret_val = read_ahead_open(&reader, filepath, start, end)) != NO_ERROR)
+        return ret_val;
+
+    // Allocate first row
+    if (allocate_rows(table) != NO_ERROR)
+    {
+        read_ahead_close(&reader);
+        return ALLOCATION_FAILED;
+    }
+
+    ret_val = parse_lines(&reader, delims, table, NULL, NULL);
+
+    // Stop read-ahead thread and close input file
+    int close_ret_val = read_ahead_close(&reader);
+    if (ret_val == NO_ERROR)
+        ret_val = close_ret_val;
+
+    return ret_val;
+}
+
+int load_table(const char *delims, char *filepath, Table *table)
+{
+    /**
+     * @brief Load table from whole file
+     *
+     * @param delims Array with all posible delimiters
+     * @param filepath Path to input file
+     * @param table Pointer #Table where data will be saved
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    return load_table_range(delims, filepath, 0, -1, table);
+}
+
+int hash_tail_prefix(const char *filepath, off_t offset, uint64_t *hash)
+{
+    /**
+     * @brief Compute hash of all bytes of input file before @p offset
+     *
+     * Bytes are hashed by chunks of #IO_BUFFER_SIZE, so any change of already loaded part of file changes the hash
+     *
+     * @param filepath Path to input file
+     * @param offset Offset in input file
+     * @param hash Pointer where hash will be saved
+     *
+     * @return #NO_ERROR on success, #CANT_OPEN_FILE, #ALLOCATION_FAILED or #IO_ERROR on error
+     */
+
+    int fd = open(filepath, O_RDONLY);
+    if (fd < 0)
+        return CANT_OPEN_FILE;
+
+    char *buffer = (char*)malloc(IO_BUFFER_SIZE * sizeof(char));
+    if (buffer == NULL)
+    {
+        close(fd);
+        return ALLOCATION_FAILED;
+    }
+
+    int ret_val = NO_ERROR;
+    *hash = (uint64_t)offset;
+
+    for (off_t position = 0; position < offset;)
+    {
+        size_t length = (offset - position < IO_BUFFER_SIZE) ? (size_t)(offset - position) : IO_BUFFER_SIZE;
+        ssize_t loaded = pread(fd, buffer, length, position);
+
+        if (loaded < 0 && errno == EINTR)
+            continue;
+        if (loaded != (ssize_t)length)
+        {
+            ret_val = IO_ERROR;
+            break;
+        }
+
+        *hash = hash_bytes(buffer, length, *hash);
+        position += (off_t)length;
+    }
+
+    free(buffer);
+    close(fd);
+
+    return ret_val;
+}
+
+int load_tail_state(const char *filepath, const char *state_path, const char *delims, struct stat *input_stat, Table *table, off_t *offset)
+{
+    /**
+     * @brief Load rows cached by previous run in tail-follow mode
+     *
+     * State is used only when it was created for same input file with same delimiters and bytes before saved offset didnt change
+     *
+     * @param filepath Path to input file
+     * @param state_path Path to state file
+     * @param delims Array with all posible delimiters
+     * @param input_stat Pointer to stat of input file
+     * @param table Pointer #Table where cached rows will be saved
+     * @param offset Pointer where offset of first not loaded byte of input file will be saved
+     *
+     * @return #NO_ERROR when rows were loaded, #CANT_OPEN_FILE when there is no state, #VALUE_ERROR when state is not valid for input file
+     */
+
+    int ret_val = NO_ERROR;
+    FILE *file = fopen(state_path, "rb");
+    if (file == NULL)
+        return CANT_OPEN_FILE;
+
+    char magic[sizeof(TAIL_STATE_MAGIC)] = { 0 };
+    unsigned long long int device, inode;
+    uint64_t prefix_hash, state_prefix_hash;
+    long long int state_offset, num_of_rows, delims_length;
+
+    if (fread(magic, sizeof(char), sizeof(TAIL_STATE_MAGIC) - 1, file) != sizeof(TAIL_STATE_MAGIC) - 1 ||
+        !strings_equal(magic, TAIL_STATE_MAGIC) ||
+        fread(&device, sizeof(device), 1, file) != 1 || fread(&inode, sizeof(inode), 1, file) != 1 ||
+        fread(&state_offset, sizeof(state_offset), 1, file) != 1 || fread(&num_of_rows, sizeof(num_of_rows), 1, file) != 1 ||
+        fread(&state_prefix_hash, sizeof(state_prefix_hash), 1, file) != 1 ||
+        fread(&delims_length, sizeof(delims_length), 1, file) != 1)
+    {
+        fclose(file);
+        return VALUE_ERROR;
+    }
+
+    // Check if state belongs to the same file which only grew since last run
+    if (device != (unsigned long long int)input_stat->st_dev || inode != (unsigned long long int)input_stat->st_ino ||
+        state_offset < 0 || state_offset > (long long int)input_stat->st_size || num_of_rows < 0 ||
+        delims_length != (long long int)strlen(delims) ||
+        hash_tail_prefix(filepath, (off_t)state_offset, &prefix_hash) != NO_ERROR || prefix_hash != state_prefix_hash)
+    {
+        fclose(file);
+        return VALUE_ERROR;
+    }
+
+    char *state_delims = (char*)malloc((delims_length + 1) * sizeof(char));
+    if (state_delims == NULL)
+    {
+        fclose(file);
+        return ALLOCATION_FAILED;
+    }
+
+    if (fread(state_delims, sizeof(char), delims_length, file) != (size_t)delims_length)
+        ret_val = VALUE_ERROR;
+    state_delims[delims_length] = '\0';
+
+    if (ret_val == NO_ERROR && !strings_equal(state_delims, delims))
+        ret_val = VALUE_ERROR;
+
+    free(state_delims);
+
+    for (long long int i = 0; (i < num_of_rows) && (ret_val == NO_ERROR); i++)
+    {
+        if (table->rows == NULL || table->num_of_rows >= table->allocated_rows)
+            if ((ret_val = allocate_rows(table)) != NO_ERROR)
+                break;
+
+        // Count row even if it is only partialy loaded so it will be deallocated
+        ret_val = read_row_binary(get_row(table, table->num_of_rows), file);
+        table->num_of_rows++;
+
+        if (ret_val == IO_ERROR)
+            ret_val = VALUE_ERROR;
+
+        if (ret_val == NO_ERROR)
+            ret_val = widen_row_types(&table->col_types, &table->num_of_col_types, get_row(table, table->num_of_rows - 1));
+
+        if (ret_val == NO_ERROR && (table->num_of_rows % ROWS_PER_PAGE) == 0)
+            ret_val = enforce_memory_budget(table, -1);
+    }
+
+    fclose(file);
+
+    *offset = (off_t)state_offset;
+    return ret_val;
+}
+
+int save_tail_state(const char *filepath, const char *state_path, const char *delims, struct stat *input_stat, Table *table, long long int num_of_rows, off_t offset)
+{
+    /**
+     * @brief Save first @p num_of_rows rows of @p table and input offset to state file
+     *
+     * State is written to temporary file which then replace old state
+     *
+     * @param filepath Path to input file
+     * @param state_path Path to state file
+     * @param delims Array with all posible delimiters
+     * @param input_stat Pointer to stat of input file
+     * @param table Pointer #Table with freshly loaded data
+     * @param num_of_rows Number of rows that were created from complete lines
+     * @param offset Offset right after last complete line in input file
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    uint64_t prefix_hash;
+    if ((ret_val = hash_tail_prefix(filepath, offset, &prefix_hash)) != NO_ERROR)
+        return ret_val;
+
+    char *temp_path = (char*)malloc((strlen(state_path) + strlen(TEMP_FILE_SUFFIX) + 1) * sizeof(char));
+    if (temp_path == NULL)
+        return ALLOCATION_FAILED;
+
+    strcpy(temp_path, state_path);
+    strcat(temp_path, TEMP_FILE_SUFFIX);
+
+    FILE *file = fopen(temp_path, "wb");
+    if (file == NULL)
+    {
+        free(temp_path);
+        return CANT_OPEN_FILE;
+    }
+
+    unsigned long long int device = (unsigned long long int)input_stat->st_dev;
+    unsigned long long int inode = (unsigned long long int)input_stat->st_ino;
+    long long int state_offset = (long long int)offset;
+    long long int delims_length = (long long int)strlen(delims);
+
+    if (fwrite(TAIL_STATE_MAGIC, sizeof(char), sizeof(TAIL_STATE_MAGIC) - 1, file) != sizeof(TAIL_STATE_MAGIC) - 1 ||
+        fwrite(&device, sizeof(device), 1, file) != 1 || fwrite(&inode, sizeof(inode), 1, file) != 1 ||
+        fwrite(&state_offset, sizeof(state_offset), 1, file) != 1 || fwrite(&num_of_rows, sizeof(num_of_rows), 1, file) != 1 ||
+        fwrite(&prefix_hash, sizeof(prefix_hash), 1, file) != 1 ||
+        fwrite(&delims_length, sizeof(delims_length), 1, file) != 1 ||
+        fwrite(delims, sizeof(char), delims_length, file) != (size_t)delims_length)
+    {
+        ret_val = IO_ERROR;
+    }
+
+    for (long long int i = 0; (i < num_of_rows) && (ret_val == NO_ERROR); i++)
+        ret_val = write_row_binary(get_row(table, i), file);
+
+    if (fclose(file) != 0 && ret_val == NO_ERROR)
+        ret_val = IO_ERROR;
+
+    if (ret_val == NO_ERROR && rename(temp_path, state_path) != 0)
+        ret_val = IO_ERROR;
+
+    if (ret_val != NO_ERROR)
+        remove(temp_path);
+
+    free(temp_path);
+
+    return ret_val;
+}
+
+int load_table_incremental(const char *delims, char *filepath, char *state_path, Table *table)
+{
+    /**
+     * @brief Load table from file in tail-follow mode
+     *
+     * Rows parsed by previous run are loaded from @p state_path and only bytes appended to input file since then are parsed \n
+     * If state is missing or doesnt belong to input file, whole file is loaded \n
+     * At the end state is updated with all rows created from complete lines
+     *
+     * @param delims Array with all posible delimiters
+     * @param filepath Path to input file
+     * @param state_path Path to state file
+     * @param table Pointer #Table where data will be saved
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+    struct stat input_stat;
+    ReadAheadReader reader;
+    off_t offset = 0;
+
+    if (stat(filepath, &input_stat) != 0)
+        return CANT_OPEN_FILE;
+
+    if ((ret_val = load_tail_state(filepath, state_path, delims, &input_stat, table, &offset)) != NO_ERROR)
+    {
+        if (ret_val == ALLOCATION_FAILED)
+            return ret_val;
+
+        // State cant be used so start from the beginning of the file
+        deallocate_table(table);
+        offset = 0;
+    }
+
+    if (table->rows == NULL && allocate_rows(table) != NO_ERROR)
+        return ALLOCATION_FAILED;
+
+    long long int complete_rows = table->num_of_rows;
+    off_t complete_offset = offset;
+
+    if ((ret_val = read_ahead_open(&reader, filepath, offset, -1)) != NO_ERROR)
+        return ret_val;
+
+    ret_val = parse_lines(&reader, delims, table, &complete_rows, &complete_offset);
+
+    int close_ret_val = read_ahead_close(&reader);
+    if (ret_val == NO_ERROR)
+        ret_val = close_ret_val;
+
+    if (ret_val == NO_ERROR && save_tail_state(filepath, state_path, delims, &input_stat, table, complete_rows, complete_offset) != NO_ERROR)
+        fprintf(stderr, "[WARNING] Failed to save tail-follow state to %s\n", state_path);
+
+    return ret_val;
+}
+
+int delete_col(Table *table, long long int index)
+{
+    /**
+     * @brief Delete column
+     *
+     * Delete content of cells in colm of @p index and shift all cols on the right side of it leftside
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param index Index of column we want to delete
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (table->rows == NULL || table->num_of_rows == 0)
+        return VALUE_ERROR;
+
+
+    for (long long int i = 0; i < table->num_of_rows; i++)
+    {
+        if (get_row(table, i)->num_of_cells <= index || index < 0)
+            return FUNCTION_ARGUMENT_ERROR;
+
+        long long int j = index;
+        if ((get_row(table, i)->num_of_cells - 1) > index)
+        {
+            for (j = index + 1; j < get_row(table, i)->num_of_cells; j++)
+            {
+                if (get_row(table, i)->cells[j].content == NULL)
+                    return FUNCTION_ERROR;
+
+                if (set_cell(get_row(table, i)->cells[j].content, &get_row(table, i)->cells[j - 1]) != NO_ERROR)
+                    return ALLOCATION_FAILED;
+            }
+            j--;
+        }
+
+        deallocate_cell(&get_row(table, i)->cells[j]);
+        get_row(table, i)->num_of_cells--;
+    }
+
+    if (index < table->num_of_col_types)
+    {
+        memmove(&table->col_types[index], &table->col_types[index + 1], (size_t)(table->num_of_col_types - index - 1));
+        table->num_of_col_types--;
+    }
+
+    return shift_formulas(table, false, index, -1);
+}
+
+int delete_cols(Table *table, long long int start_index, long long int end_index)
+{
+    /**
+     * @brief Delete columns
+     *
+     * Delete content of cells in colms within range of @p start_index and @p end_index
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param start_index Start index of column we want to delete
+     * @param end_index End index of column we want to delete
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    if (end_index >= get_row(table, 0)->num_of_cells)
+        end_index = get_row(table, 0)->num_of_cells - 1;
+
+    for (long long int i = end_index; i >= start_index; i--)
+    {
+        if ((ret_val = delete_col(table, i)) != NO_ERROR)
+            break;
+    }
+
+    return ret_val;
+}
+
+int append_col(Table *table)
+{
+    /**
+     * @brief Append empty column to right of the table
+     *
+     * Iterate over all rows and add empty column to the end of each of them
+     *
+     * @param table Pointer to instance of #Table structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (table->rows == NULL || table->num_of_rows == 0)
+        return VALUE_ERROR;
+
+    int ret_val;
+
+    for (long long int i = 0; i < table->num_of_rows; i++)
+    {
+        if ((ret_val = append_empty_cell(get_row(table, i))) != NO_ERROR)
+            return ret_val;
+    }
+
+    return shift_formulas(table, false, get_row(table, 0)->num_of_cells - 1, 1);
+}
+
+int insert_col(Table *table, long long int index)
+{
+    /**
+     * @brief Insert column to table
+     *
+     * Insert empty column to table in the @p index and push all columns to the right
+     *
+     * @param table Pointer to instance of #Table struct
+     * @param index Index of column where we want insert new one
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (table->rows == NULL || table->num_of_rows == 0)
+        return VALUE_ERROR;
+
+    for (long long int i = 0; i < table->num_of_rows; i++)
+    {
+        if (get_row(table, i)->num_of_cells <= index || index < 0)
+            return FUNCTION_ARGUMENT_ERROR;
+
+        if (get_row(table, i)->cells == NULL)
+            return FUNCTION_ERROR;
+
+        if (get_row(table, i)->num_of_cells == get_row(table, i)->allocated_cells)
+        {
+            // Allocate more space
+            if (allocate_cells(get_row(table, i)) != NO_ERROR)
+                return ALLOCATION_FAILED;
+        }
+
+        for (long long j = get_row(table, i)->num_of_cells; j > index; j--)
+        {
+            if (get_row(table, i)->cells[j - 1].content == NULL)
+                return FUNCTION_ERROR;
+
+            if (set_cell(get_row(table, i)->cells[j - 1].content, &get_row(table, i)->cells[j]) != NO_ERROR)
+                return ALLOCATION_FAILED;
+        }
+
+        if (set_cell(EMPTY_CELL, &get_row(table, i)->cells[index]) != NO_ERROR)
+            return ALLOCATION_FAILED;
+
+        get_row(table, i)->num_of_cells++;
+    }
+
+    if (index < table->num_of_col_types)
+    {
+        // Widening of last column makes space for shifted types
+        int ret_val = widen_column_type(&table->col_types, &table->num_of_col_types, table->num_of_col_types, TEXT_COLUMN);
+        if (ret_val != NO_ERROR)
+            return ret_val;
+
+        memmove(&table->col_types[index + 1], &table->col_types[index], (size_t)(table->num_of_col_types - index - 1));
+        table->col_types[index] = EMPTY_COLUMN;
+    }
+
+    return shift_formulas(table, false, index, 1);
+}
+
+int append_row(Table *table)
+{
+    /**
+     * @brief Append row to the bottom of table
+     *
+     * @param table Pointer to instance of #Table structure
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    // if there is no reference row then create new row with one cell
+    long long int number_of_cells = table->num_of_rows > 0 ? get_row(table, 0)->num_of_cells : 1;
+
+    // If there is no more space
+    if (table->num_of_rows == table->allocated_rows)
+    {
+        // Allocate more rows
+        if (allocate_rows(table) != NO_ERROR)
+            return ALLOCATION_FAILED;
+    }
+
+    for (long long int i = 0; i < number_of_cells; i++)
+    {
+        if (append_empty_cell(get_row(table, table->num_of_rows)) != NO_ERROR)
+            return ALLOCATION_FAILED;
+    }
+
+    table->num_of_rows++;
+
+    return shift_formulas(table, true, table->num_of_rows - 1, 1);
+}
+
+int insert_row(Table *table, long long int index)
+{
+    /**
+     * @brief Insert row to table
+     *
+     * Insert empty row to the table on place of @p index and shift all rows down
+     *
+     * @param table Pointer to instance of #Table struct
+     * @param index Index of row where we want to place new row
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (table->rows == NULL || table->num_of_rows == 0)
+        return VALUE_ERROR;
+
+    if (table->num_of_rows <= index || index < 0)
+        return FUNCTION_ARGUMENT_ERROR;
+
+    // if there is no reference row then create new row with one cell
+    long long int number_of_cells = table->num_of_rows > 0 ? get_row(table, 0)->num_of_cells : 1;
+
+    // If there is no more space
+    if (table->num_of_rows == table->allocated_rows)
+    {
+        // Allocate more rows
+        if (allocate_rows(table) != NO_ERROR)
+            return ALLOCATION_FAILED;
+    }
+
+    // Only row headers are moved so spilled rows dont have to be loaded
+    for (long long int i = table->num_of_rows; i > index; i--)
+    {
+        if (table->rows[i - 1].cells == NULL && table->rows[i - 1].spill_offset < 0)
+            return FUNCTION_ERROR;
+
+        table->rows[i] = table->rows[i - 1];
+    }
+
+    // Clear what is in original index
+    table->rows[index].cells = NULL;
+    table->rows[index].num_of_cells = 0;
+    table->rows[index].allocated_cells = 0;
+    table->rows[index].cells_in_arena = false;
+    table->rows[index].spill_offset = -1;
+
+    for (long long int i = 0; i < number_of_cells; i++)
+        if (append_empty_cell(get_row(table, index)) != NO_ERROR)
+            return ALLOCATION_FAILED;
+
+    table->num_of_rows++;
+
+    return shift_formulas(table, true, index, 1);
+}
+
+int delete_row(Table *table, long long int index)
+{
+    /**
+     * @brief Delete row
+     *
+     * Delete content of row on @p index and shift all rows bellow it up
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param index Index of row we want to delete
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (table->rows == NULL || table->num_of_rows == 0)
+        return VALUE_ERROR;
+
+    if (index < 0 || index >= table->num_of_rows)
+        return FUNCTION_ARGUMENT_ERROR;
+
+    // Deleted row doesnt have to be loaded if it is spilled
+    deallocate_row(&table->rows[index]);
+    if (table->spill != NULL)
+        release_spilled_row(table->spill, &table->rows[index]);
+    table->rows[index].spill_offset = -1;
+
+    if (index < (table->num_of_rows - 1))
+    {
+        // Only row headers are moved so spilled rows dont have to be loaded
+        for (long long int i = (index + 1); i < table->num_of_rows; i++)
+        {
+            if (table->rows[i].cells == NULL && table->rows[i].spill_offset < 0)
+                return FUNCTION_ERROR;
+
+            table->rows[i - 1] = table->rows[i];
+        }
+
+        // Last row was moved up so its old place must not point to its cells
+        table->rows[table->num_of_rows - 1].cells = NULL;
+        table->rows[table->num_of_rows - 1].num_of_cells = 0;
+        table->rows[table->num_of_rows - 1].allocated_cells = 0;
+        table->rows[table->num_of_rows - 1].cells_in_arena = false;
+        table->rows[table->num_of_rows - 1].spill_offset = -1;
+    }
+
+    table->num_of_rows--;
+
+    return shift_formulas(table, true, index, -1);
+}
+
+int delete_rows(Table *table, long long int start_index, long long int end_index)
+{
+    /**
+     * @brief Delete rows
+     *
+     * Delete content of rows and cells in them in rows within range of @p start_index and @p end_index
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param start_index Start index of column we want to delete
+     * @param end_index End index of column we want to delete
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    if (end_index >= table->num_of_rows)
+        end_index = table->num_of_rows - 1;
+
+    for (long long int i = end_index; i >= start_index; i--)
+    {
+        if ((ret_val = delete_row(table, i)) != NO_ERROR)
+            return ret_val;
+    }
+
+    return ret_val;
+}
+
+int pad_rows(Table *table, long long int first_row)
+{
+    /**
+     * @brief Make rows from @p first_row as long as other rows of table
+     *
+     * When some of these rows is longer then all rows of table are padded to its length
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param first_row Index of first new row
+     *
+     * @return #NO_ERROR on success and #ALLOCATION_FAILED on error
+     */
+
+    long long int num_of_cols = (first_row > 0) ? get_row(table, 0)->num_of_cells : 0;
+
+    for (long long int i = first_row; i < table->num_of_rows; i++)
+        if (get_row(table, i)->num_of_cells > num_of_cols)
+            return normalize_row_lengths(table);
+
+    for (long long int i = first_row; i < table->num_of_rows; i++)
+        while (get_row(table, i)->num_of_cells < num_of_cols)
+            if (append_empty_cell(get_row(table, i)) != NO_ERROR)
+                return ALLOCATION_FAILED;
+
+    return NO_ERROR;
+}
+
+int append_rows_from_file(Table *table, char *filepath)
+{
+    /**
+     * @brief Append all rows of file to the bottom of table
+     *
+     * Lines are parsed by loader in parallel batches directly to new rows of table,
+     * then only new rows are filtered, padded and searched for formulas
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param filepath Path to appended file
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (filepath == NULL)
+        return COMMAND_ERROR;
+
+    int ret_val = NO_ERROR;
+    long long int first_row = table->num_of_rows;
+    ReadAheadReader reader;
+
+    if ((ret_val = read_ahead_open(&reader, filepath, 0, -1)) != NO_ERROR)
+        return ret_val;
+
+    ret_val = parse_lines(&reader, table->input_delims, table, NULL, NULL);
+
+    int close_ret_val = read_ahead_close(&reader);
+    if (ret_val == NO_ERROR)
+        ret_val = close_ret_val;
+
+    if (ret_val == NO_ERROR)
+        ret_val = filter_table(table, first_row);
+    if (ret_val == NO_ERROR)
+        ret_val = pad_rows(table, first_row);
+    if (ret_val == NO_ERROR)
+        ret_val = register_formula_cells(table, first_row, 0);
+
+    return ret_val;
+}
+
+int adopt_arenas(Table *table, Table *source)
+{
+    /**
+     * @brief Move arenas of @p source to the end of arenas of @p table
+     *
+     * Arenas of loading workers stay first, so they are used by next loading
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param source Pointer to instance of #Table structure
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    if (source->num_of_arenas == 0)
+        return NO_ERROR;
+
+    Arena *tmp = (Arena*)realloc(table->arenas, (table->num_of_arenas + source->num_of_arenas) * sizeof(Arena));
+    if (tmp == NULL)
+        return ALLOCATION_FAILED;
+
+    memcpy(tmp + table->num_of_arenas, source->arenas, source->num_of_arenas * sizeof(Arena));
+    table->arenas = tmp;
+    table->num_of_arenas += source->num_of_arenas;
+
+    free(source->arenas);
+    source->arenas = NULL;
+    source->num_of_arenas = 0;
+
+    return NO_ERROR;
+}
+
+int append_cols_from_file(Table *table, char *filepath)
+{
+    /**
+     * @brief Append all columns of file to the right of table
+     *
+     * File is loaded by loader to separate table, its cells are then moved to the end of rows of table
+     * (content is copied only with memory budget, because spilled rows cant hold cells from arenas) \n
+     * Missing rows and cells of both tables are filled with empty cells
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param filepath Path to appended file
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    if (filepath == NULL)
+        return COMMAND_ERROR;
+
+    Table source;
+    init_derived_table(&source, table);
+
+    int ret_val = load_table(table->input_delims, filepath, &source);
+    if (ret_val == NO_ERROR && source.num_of_rows > 0)
+        ret_val = normalize_number_of_cols(&source);
+    if (ret_val == NO_ERROR)
+        ret_val = filter_table(&source, 0);
+
+    long long int first_col = (table->num_of_rows > 0) ? get_row(table, 0)->num_of_cells : 0;
+    long long int source_cols = (source.num_of_rows > 0) ? source.rows[0].num_of_cells : 0;
+    _Bool move = (table->spill == NULL);
+
+    while (ret_val == NO_ERROR && table->num_of_rows < source.num_of_rows)
+        ret_val = append_row(table);
+
+    for (long long int i = 0; i < table->num_of_rows && ret_val == NO_ERROR; i++)
+    {
+        Row *row = get_row(table, i);
+        Row *source_row = (i < source.num_of_rows) ? &source.rows[i] : NULL;
+
+        while (row->num_of_cells < first_col && ret_val == NO_ERROR)
+            ret_val = append_empty_cell(row);
+
+        for (long long int j = 0; j < source_cols && ret_val == NO_ERROR; j++)
+        {
+            if (source_row == NULL || !move)
+            {
+                ret_val = append_empty_cell(row);
+                if (ret_val == NO_ERROR && source_row != NULL)
+                    ret_val = set_cell(source_row->cells[j].content, &row->cells[row->num_of_cells - 1]);
+                continue;
+            }
+
+            if (row->num_of_cells == row->allocated_cells && (ret_val = allocate_cells(row)) != NO_ERROR)
+                break;
+
+            row->cells[row->num_of_cells++] = source_row->cells[j];
+        }
+
+        // Moved cells belong only to table
+        if (source_row != NULL && move)
+            source_row->num_of_cells = 0;
+    }
+
+    for (long long int j = 0; j < source.num_of_col_types && ret_val == NO_ERROR; j++)
+        ret_val = widen_column_type(&table->col_types, &table->num_of_col_types, first_col + j, source.col_types[j]);
+
+    if (ret_val == NO_ERROR && move)
+        ret_val = adopt_arenas(table, &source);
+    if (ret_val == NO_ERROR)
+        ret_val = register_formula_cells(table, 0, first_col);
+
+    deallocate_table(&source);
+
+    return ret_val;
+}
+
+void diff_hash_chunk(void *arg, long long int chunk, long long int start, long long int end, int worker_id)
+{
+    /**
+     * @brief Hash key cells and content of chunk of rows of batch
+     *
+     * Trailing empty cells arent hashed, so rows padded to width of table match rows of file that wasnt normalized
+     *
+     * @param arg Pointer to instance of #DiffHashes structure
+     * @param chunk Index of chunk (not used)
+     * @param start Index of first row of chunk (relative to batch)
+     * @param end Index after last row of chunk (relative to batch)
+     * @param worker_id Index of worker (not used)
+     */
+
+    (void)chunk;
+    (void)worker_id;
+
+    DiffHashes *job = (DiffHashes*)arg;
+
+    for (long long int i = start; i < end; i++)
+    {
+        Row *row = get_row(job->table, job->first_row + i);
+
+        Selector content = { .lld_ir1 = 0, .lld_ic1 = 0, .lld_ir2 = 0, .lld_ic2 = row->num_of_cells - 1, .initialized = true };
+        while (content.lld_ic2 >= 0 && (row->cells[content.lld_ic2].content == NULL || row->cells[content.lld_ic2].content[0] == '\0'))
+            content.lld_ic2--;
+
+        job->hashes[i] = hash_row(row, &content, -1);
+
+        if (job->key_col >= 0)
+        {
+            const char *key = (job->key_col < row->num_of_cells && row->cells[job->key_col].content != NULL) ? row->cells[job->key_col].content : "";
+            job->keys[i] = hash_bytes(key, strlen(key), 0);
+        }
+        else
+            job->keys[i] = (uint64_t)(job->first_row + i);
+    }
+}
+
+void diff_index_destroy(DiffIndex *index)
+{
+    /**
+     * @brief Free entries and slots of @p index
+     *
+     * @param index Pointer to instance of #DiffIndex structure
+     */
+
+    free(index->entries);
+    free(index->slots);
+    index->entries = NULL;
+    index->slots = NULL;
+    index->num_of_entries = 0;
+    index->allocated_entries = 0;
+    index->num_of_slots = 0;
+}
+
+int diff_index_add(DiffIndex *index, uint64_t key, uint64_t hash, _Bool keyed)
+{
+    /**
+     * @brief Append entry of next row of file to @p index
+     *
+     * @param index Pointer to instance of #DiffIndex structure
+     * @param key Hash of key cell of row
+     * @param hash Hash of content of row
+     * @param keyed Flag if entry is inserted to slots by its key
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    if (index->num_of_entries == index->allocated_entries)
+    {
+        long long int allocated = (index->allocated_entries > 0) ? index->allocated_entries * 2 : BASE_NUMBER_OF_KEYS;
+
+        DiffEntry *entries = (DiffEntry*)realloc(index->entries, (size_t)allocated * sizeof(DiffEntry));
+        if (entries == NULL)
+            return ALLOCATION_FAILED;
+
+        index->entries = entries;
+        index->allocated_entries = allocated;
+
+        if (keyed)
+        {
+            long long int *slots = (long long int*)calloc((size_t)allocated * 4, sizeof(long long int));
+            if (slots == NULL)
+                return ALLOCATION_FAILED;
+
+            free(index->slots);
+            index->slots = slots;
+            index->num_of_slots = allocated * 4;
+
+            for (long long int i = 0; i < index->num_of_entries; i++)
+            {
+                long long int slot = (long long int)(index->entries[i].key & (uint64_t)(index->num_of_slots - 1));
+                while (index->slots[slot] != 0)
+                    slot = (slot + 1) & (index->num_of_slots - 1);
+                index->slots[slot] = i + 1;
+            }
+        }
+    }
+
+    DiffEntry *entry = &index->entries[index->num_of_entries];
+    entry->key = key;
+    entry->hash = hash;
+    entry->matched = false;
+
+    if (keyed)
+    {
+        long long int slot = (long long int)(key & (uint64_t)(index->num_of_slots - 1));
+        while (index->slots[slot] != 0)
+            slot = (slot + 1) & (index->num_of_slots - 1);
+        index->slots[slot] = index->num_of_entries + 1;
+    }
+
+    index->num_of_entries++;
+
+    return NO_ERROR;
+}
+
+long long int diff_index_match(DiffIndex *index, uint64_t key)
+{
+    /**
+     * @brief Find first not matched row of file with key @p key and mark it as matched
+     *
+     * Rows with duplicate key are matched in order of file
+     *
+     * @param index Pointer to instance of #DiffIndex structure
+     * @param key Hash of key cell (position of row when rows are compared by position)
+     *
+     * @return Index of matched row of file or -1 when there is none
+     */
+
+    long long int found = -1;
+
+    if (index->slots == NULL)
+    {
+        if (key < (uint64_t)index->num_of_entries)
+            found = (long long int)key;
+    }
+    else
+    {
+        for (long long int slot = (long long int)(key & (uint64_t)(index->num_of_slots - 1)); index->slots[slot] != 0;
+             slot = (slot + 1) & (index->num_of_slots - 1))
+        {
+            long long int candidate = index->slots[slot] - 1;
+            if (index->entries[candidate].key == key && !index->entries[candidate].matched && (found < 0 || candidate < found))
+                found = candidate;
+        }
+    }
+
+    if (found >= 0)
+        index->entries[found].matched = true;
+
+    return found;
+}
+
+int build_diff_index(Table *table, const char *filepath, long long int key_col, DiffIndex *index)
+{
+    /**
+     * @brief Hash all rows of file in one pass and save them to @p index
+     *
+     * File is parsed in batches of #LOAD_BATCH_SIZE lines to temporary table that is freed after its rows are hashed,
+     * so only hashes of rows of file are kept in memory
+     *
+     * @param table Pointer to instance of #Table structure with delimiters and thread pool
+     * @param filepath Path to other file
+     * @param key_col Index of key column (-1 when rows are compared by position)
+     * @param index Pointer to empty instance of #DiffIndex structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+    ReadAheadReader reader;
+
+    if ((ret_val = read_ahead_open(&reader, (char*)filepath, 0, -1)) != NO_ERROR)
+        return ret_val;
+
+    LoadBatch batch;
+    batch.delims = table->input_delims;
+    batch.lines = (char**)malloc(LOAD_BATCH_SIZE * sizeof(char*));
+    DiffHashes *job = (DiffHashes*)malloc(sizeof(DiffHashes));
+    if (batch.lines == NULL || job == NULL)
+        ret_val = ALLOCATION_FAILED;
+
+    _Bool end_of_file = false;
+    while (!end_of_file && ret_val == NO_ERROR)
+    {
+        long long int complete_lines;
+        off_t complete_offset;
+
+        if ((ret_val = read_line_batch(&reader, &batch, &end_of_file, &complete_lines, &complete_offset)) != NO_ERROR || batch.num_of_lines == 0)
+            break;
+
+        Table rows;
+        init_derived_table(&rows, table);
+        batch.table = &rows;
+
+        // Rows of file are filtered as rows of table, so same lines have same hash
+        if ((ret_val = parse_batch(&batch)) == NO_ERROR)
+            ret_val = filter_table(&rows, 0);
+
+        if (ret_val == NO_ERROR)
+        {
+            job->table = &rows;
+            job->first_row = 0;
+            job->key_col = key_col;
+            thread_pool_for(rows.pool, rows.num_of_rows, ROW_CHUNK_SIZE, diff_hash_chunk, job);
+
+            for (long long int i = 0; (i < rows.num_of_rows) && (ret_val == NO_ERROR); i++)
+                ret_val = diff_index_add(index, (key_col >= 0) ? job->keys[i] : (uint64_t)index->num_of_entries, job->hashes[i], key_col >= 0);
+        }
+
+        deallocate_table(&rows);
+    }
+
+    free(batch.lines);
+    free(job);
+
+    int close_ret_val = read_ahead_close(&reader);
+    if (ret_val == NO_ERROR)
+        ret_val = close_ret_val;
+
+    return ret_val;
+}
+
+int append_diff_row(Table *diff, const char *operation, long long int number, Row *row, long long int num_of_cols)
+{
+    /**
+     * @brief Append row of change set to @p diff
+     *
+     * @param diff Pointer to instance of #Table structure with change set
+     * @param operation Kind of change ("+" inserted, "-" deleted, "~" modified)
+     * @param number Number of row (counted from 1)
+     * @param row Pointer to changed row of table (NULL for deleted row)
+     * @param num_of_cols Number of columns of table
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
+
+    int ret_val = NO_ERROR;
+    if ((ret_val = reserve_rows(diff, diff->num_of_rows + 1)) != NO_ERROR)
+        return ret_val;
+
+    Row *target = &diff->rows[diff->num_of_rows];
+    diff->num_of_rows++;
+
+    if ((ret_val = create_row_cells(target, num_of_cols + 2)) != NO_ERROR)
+        return ret_val;
+
+    char number_string[MAX_INTEGER_DIGITS + 3];
+    snprintf(number_string, sizeof(number_string), "%lld", number);
+
+    if ((ret_val = set_cell((char*)operation, &target->cells[0])) == NO_ERROR)
+        ret_val = set_cell(number_string, &target->cells[1]);
+
+    for (long long int j = 0; row != NULL && j < row->num_of_cells && j < num_of_cols && ret_val == NO_ERROR; j++)
+        ret_val = set_cell(row->cells[j].content, &target->cells[j + 2]);
+
+    if (ret_val == NO_ERROR)
+        ret_val = widen_row_types(&diff->col_types, &diff->num_of_col_types, target);
+
+    return ret_val;
+}
+
+int diff_table(Table *table, long long int key_col, const char *filepath)
+{
+    /**
+     * @brief Replace table with change set against rows of other file
+     *
+     * Rows of file are hashed in one pass to hash join index (build side), then rows of table are hashed in batches
+     * and matched to rows of file by key column (or by position when @p key_col is -1) \n
+     * Change set has operation in first column and number of row in second one, followed by cells of row of table:
+     * "+" row of table that has no match in file, "~" row of table whose content differs from matched row of file,
+     * "-" row of file that has no match in table (only its number in file is known) \n
+     * Rows of table are listed in their order, deleted rows follow in order of file
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param key_col Index of key column (-1 when rows are compared by position)
+     * @param filepath Path to other file (old version of table)
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    long long int num_of_cols = get_row(table, 0)->num_of_cells;
+    if (key_col >= num_of_cols || key_col < -1)
+        return FUNCTION_ARGUMENT_ERROR;
+
+    DiffIndex index = { .entries = NULL, .num_of_entries = 0, .allocated_entries = 0, .slots = NULL, .num_of_slots = 0 };
+    DiffHashes *job = (DiffHashes*)malloc(sizeof(DiffHashes));
+    if (job == NULL)
+        return ALLOCATION_FAILED;
+
+    Table diff;
+    init_derived_table(&diff, table);
+
+    int ret_val = build_diff_index(table, filepath, key_col, &index);
+
+    // Probe side is hashed in batches, so memory holds only hashes of file
+    for (long long int first = 0; first < table->num_of_rows && ret_val == NO_ERROR; first += LOAD_BATCH_SIZE)
+    {
+        long long int num_of_rows = (table->num_of_rows - first < LOAD_BATCH_SIZE) ? table->num_of_rows - first : LOAD_BATCH_SIZE;
+
+        job->table = table;
+        job->first_row = first;
+        job->key_col = key_col;
+        thread_pool_for(get_table_pool(table), num_of_rows, ROW_CHUNK_SIZE, diff_hash_chunk, job);
+
+        for (long long int i = 0; i < num_of_rows && ret_val == NO_ERROR; i++)
+        {
+            long long int match = diff_index_match(&index, job->keys[i]);
+
+            if (match < 0)
+                ret_val = append_diff_row(&diff, "+", first + i + 1, get_row(table, first + i), num_of_cols);
+            else if (index.entries[match].hash != job->hashes[i])
+                ret_val = append_diff_row(&diff, "~", first + i + 1, get_row(table, first + i), num_of_cols);
+        }
+
+        if (ret_val == NO_ERROR)
+            ret_val = enforce_memory_budget(table, -1);
+    }
+
+    for (long long int i = 0; i < index.num_of_entries && ret_val == NO_ERROR; i++)
+        if (!index.entries[i].matched)
+            ret_val = append_diff_row(&diff, "-", i + 1, NULL, num_of_cols);
+
+    if (ret_val == NO_ERROR)
+        ret_val = replace_table(table, &diff);
+
+    deallocate_table(&diff);
+    diff_index_destroy(&index);
+    free(job);
+
+    return ret_val;
+}
+
+int set_temporary_variable(Table *table, Selector *selector, TempVariableStore *temp_var_store, long long int index)
+{
+    /**
+     * @brief Set temporary variable
+     *
+     * Allocate and set value in temporary variable of @p index
+     *
+     * @param table Pointer to instance of #Table structure that will be eddited
+     * @param selector Pointer to instance of #Selector structure for selecting value we want to save
+     * @param temp_var_store Pointer to instance of #TempVariableStore structure used for stroring values
+     * @param index Index of temporary variable we want to work with
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    if (table->num_of_rows > 0 && get_row(table, 0)->num_of_cells > 0 &&
+        table->num_of_rows > selector->lld_ir1 && get_row(table, 0)->num_of_cells > selector->lld_ic1 &&
+        get_row(table, selector->lld_ir1)->cells[selector->lld_ic1].content != NULL)
+    {
+        if (temp_var_store->variables[index] != NULL)
+        {
+            free(temp_var_store->variables[index]);
+            temp_var_store->variables[index] = NULL;
+        }
+
+        char *temp_string = NULL;
+        if ((ret_val = string_copy(&get_row(table, selector->lld_ir1)->cells[selector->lld_ic1].content, &temp_string)) != NO_ERROR)
+            return ret_val;
+
+        temp_var_store->variables[index] = temp_string;
+    }
+
+    return ret_val;
+}
+
+int set_cell_from_temporary_variable(Table *table, Selector *selector, TempVariableStore *temp_var_store, long long int index)
+{
+    /**
+     * @brief Set value from temporary variable to cell
+     *
+     * Set temporary variable of @p index to cell selected by @p selector
+     *
+     * @param table Pointer to instance of #Table structure that will be eddited
+     * @param selector Pointer to instance of #Selector structure for selecting value we want to use
+     * @param temp_var_store Pointer to instance of #TempVariableStore structure used for stroring values
+     * @param index Index of temporary variable we want to work with
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    if (table->num_of_rows > 0 && get_row(table, 0)->num_of_cells > 0 &&
+        temp_var_store->variables[index] != NULL)
+    {
+        ret_val = set_value_in_area(table, selector, temp_var_store->variables[index]);
+    }
+
+    return ret_val;
+}
+
+int increase_temporary_variable(TempVariableStore *temp_var_store, long long int index)
+{
+    /**
+     * @brief Increase value in temporary variable
+     *
+     * Increase value of temporary variable if exist\n
+     * If value is no numeric value then set its value to 1
+     *
+     * @param temp_var_store Pointer to instance of #TempVariableStore structure used for stroring values
+     * @param index Index of temporary variable we want to work with
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    if (temp_var_store->variables[index] != NULL)
+    {
+        // Create temp variables
+        long double temp_val = 0;
+
+        if (is_string_ldouble(temp_var_store->variables[index]))
+        {
+            if ((ret_val = string_to_ldouble(temp_var_store->variables[index], &temp_val)) != NO_ERROR)
+                return ret_val;
+
+            temp_val += 1.0;
+        }
+        else
+            temp_val = 1.0;
+
+        char *temp_string = NULL;
+
+        // Format string value
+        if (is_ldouble_lint(temp_val))
+        {
+            if ((ret_val = lint_to_string((long int)temp_val, &temp_string)) != NO_ERROR)
+                return ret_val;
+        }
+        else
+        {
+            if ((ret_val = ldouble_to_string(temp_val, &temp_string)) != NO_ERROR)
+                return ret_val;
+        }
+
+        // Clear old variable
+        free(temp_var_store->variables[index]);
+
+        // Copy new string to variable
+        if ((ret_val = string_copy(&temp_string, &temp_var_store->variables[index])) != NO_ERROR)
+        {
+            free(temp_string);
+            return ret_val;
+        }
+
+        // Clear temporary string
+        free(temp_string);
+    }
+    else
+    {
+        temp_var_store->variables[index] = (char*)malloc(2 * sizeof(char));
+        if (temp_var_store->variables[index] == NULL)
+            return ALLOCATION_FAILED;
+
+        if (strcpy(temp_var_store->variables[index], "1") == NULL)
+            return FUNCTION_ERROR;
+    }
+
+    return ret_val;
+}
+
+_Bool is_command_selector(Command *command)
+{
+    /**
+     * @brief Check if command is selector
+     *
+     * @param command Pointer to instance of #Command structure
+     *
+     * @return true if it is selector command and false if not
+     */
+
+    if (command->arguments == NULL && string_start_with(command->function, "[") && string_end_with(command->function, "]"))
+        return true;
+    return false;
+}
+
+_Bool is_table_editing_command(Command *command)
+{
+    /**
+     * @brief Check if inputed command is table editing command
+     *
+     * @param command Pointer to instance of #Command structure
+     *
+     * @return true if its table editing command, false if not
+     */
+
+    for (int i = 0; i < NUMBER_OF_TABLE_EDITING_COMMANDS; i++)
+    {
+        if (strings_equal(command->function, TABLE_EDITING_COMMANDS[i]))
+            return true;
+    }
+
+    return false;
+}
+
+_Bool is_data_editing_command(Command *command)
+{
+    /**
+     * @brief Check if inputed command is table data command
+     *
+     * @param command Pointer to instance of #Command structure
+     *
+     * @return true if its data editing command, false if not
+     */
+
+    for (int i = 0; i < NUMBER_OF_DATA_EDITING_COMMANDS; i++)
+    {
+        if (strings_equal(command->function, DATA_EDITING_COMMANDS[i]))
+            return true;
+    }
+
+    return false;
+}
+
+_Bool is_temp_var_command(Command *command)
+{
+    /**
+     * @brief Check if inputed command is temporary variable command
+     *
+     * @param command Pointer to instance of #Command structure
+     *
+     * @return true if its temporary variable command, false if not
+     */
+
+    for (int i = 0; i < NUMBER_OF_TEMP_VAR_COMMANDS; i++)
+    {
+        if (strings_equal(command->function, TEMP_VAR_COMMANDS[i]))
+            return true;
+    }
+
+    return false;
+}
+
+int get_table_editing_command_index(Command *command)
+{
+    /**
+     * @brief Get index of table editing command from reference array
+     *
+     * @param command Pointer to instance of #Command structure
+     *
+     * @return Index of command from reference #TABLE_EDITING_COMMANDS array if command is found, in other cases return -1
+     */
+
+    if (!is_table_editing_command(command))
+        return -1;
+
+    for (int i = 0; i < NUMBER_OF_TABLE_EDITING_COMMANDS; i++)
+    {
+        if (strings_equal(command->function, TABLE_EDITING_COMMANDS[i]))
+            return i;
+    }
+
+    return -1;
+}
+
+int get_data_editing_command_index(Command *command)
+{
+    /**
+     * @brief Get index of data editing command from reference array
+     *
+     * @param command Pointer to instance of #Command structure
+     *
+     * @return Index of command from reference #DATA_EDITING_COMMANDS array if command is found, in other cases return -1
+     */
+
+    if (!is_data_editing_command(command))
+        return -1;
+
+    for (int i = 0; i < NUMBER_OF_DATA_EDITING_COMMANDS; i++)
+    {
+        if (strings_equal(command->function, DATA_EDITING_COMMANDS[i]))
+            return i;
+    }
+
+    return -1;
+}
+
+int get_temp_var_command_index(Command *command)
+{
+    /**
+     * @brief Get index of temporary variable command from reference array
+     *
+     * @param command Pointer to instance of #Command structure
+     *
+     * @return Index of command from reference #TEMP_VAR_COMMANDS array if command is found, in other cases return -1
+     */
+
+    if (!is_temp_var_command(command))
+        return -1;
+
+    for (int i = 0; i < NUMBER_OF_TEMP_VAR_COMMANDS; i++)
+    {
+        if (strings_equal(command->function, TEMP_VAR_COMMANDS[i]))
+            return i;
+    }
+
+    return -1;
+}
+
+int execute_table_editing_index(Table *table, Selector *selector, int findex, char *arguments)
+{
+    /**
+     * @brief Execute table editing command of index @p findex in #TABLE_EDITING_COMMANDS on @p table
+     *
+     * @param table Pointer to instance of #Table structure that will be eddited
+     * @param selector Pointer to instance of #Selector structure for selecting part of @p table to edit
+     * @param findex Index of command in #TABLE_EDITING_COMMANDS
+     * @param arguments Arguments of command (NULL if command has no arguments)
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+
+    switch (findex)
+    {
+        // irow
+        case 0:
+            ret_val = insert_row(table, selector->lld_ir1);
+            break;
+
+            // arow
+        case 1:
+            if (selector->lld_ir2 >= table->num_of_rows - 1)
+                ret_val = append_row(table);
+            else
+                ret_val = insert_row(table, selector->lld_ir2 + 1);
+            break;
+
+            // drow
+        case 2:
+            ret_val = delete_rows(table, selector->lld_ir1, selector->lld_ir2);
+            break;
+
+            // icol
+        case 3:
+            if (table->num_of_rows > 0)
+                ret_val = insert_col(table, selector->lld_ic1);
+            break;
+
+            // acol
+        case 4:
+            if (table->num_of_rows > 0)
+            {
+                if (selector->lld_ic2 >= get_row(table, 0)->num_of_cells - 1)
+                    ret_val = append_col(table);
+                else
+                    ret_val = insert_col(table, selector->lld_ic2 + 1);
+            }
+            break;
+
+            // dcol
+        case 5:
+            if (table->num_of_rows > 0)
+                ret_val = delete_cols(table, selector->lld_ic1, selector->lld_ic2);
+            break;
+
+            // cat FILE
+        case 6:
+            ret_val = append_rows_from_file(table, arguments);
+            break;
+
+            // paste FILE
+        case 7:
+            ret_val = append_cols_from_file(table, arguments);
+            break;
+
+        default:
+            ret_val = COMMAND_ERROR;
+            break;
+    }
+
+    return ret_val;
+}
+
+int execute_table_editing_comm(Table *table, Selector *selector, Command *command)
+{
+    /**
+     * @brief Execute table editing command on @p table
+     *
+     * Assign proper function to @p command and execute it to edit table
+     *
+     * @param table Pointer to instance of #Table structure that will be eddited
+     * @param selector Pointer to instance of #Selector structure for selecting part of @p table to edit
+     * @param command Pointer to instance of #Command structure that will select function to use
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int findex = get_table_editing_command_index(command);
+    if (findex == -1)
+        return NO_ERROR;
+
+    return execute_table_editing_index(table, selector, findex, command->arguments);
+}
+
+int execute_data_editing_command(Table *table, Selector *selector, Command *command)
+{
+    /**
+     * @brief Execute data editing command on @p table
+     *
+     * Assign proper function to @p command and execute it to edit table
+     *
+     * @param table Pointer to instance of #Table structure that will be eddited
+     * @param selector Pointer to instance of #Selector structure for selecting part of @p table to edit
+     * @param command Pointer to instance of #Command structure that will select function to use
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    int ret_val = NO_ERROR;
+    int findex = get_data_editing_command_index(command);
+    if (findex == -1)
+        return NO_ERROR;
+
+    long long int *advanced_args = NULL;
+
+    switch (findex)
+    {
+        // set STR
+        case 0:
+            ret_val = set_value_in_area(table, selector, command->arguments);
+            break;
+
+        // clear
+        case 1:
+            ret_val = set_value_in_area(table, selector, EMPTY_CELL);
+            break;
+
+        // swap [R,C]
+        case 2:
+            if ((ret_val = parse_command_argument(command->arguments, &advanced_args, table)) == NO_ERROR)
+            {
+                if (advanced_args != NULL)
+                    ret_val = swap_cells(table, selector, advanced_args[0], advanced_args[1]);
+                else
+                    ret_val = FUNCTION_ERROR;
+            }
+            break;
+
+        // sum [R,C]
+        case 3:
+            if ((ret_val = parse_command_argument(command->arguments, &advanced_args, table)) == NO_ERROR)
+            {
+                if (advanced_args != NULL && (ret_val = sum_cells(table, selector, advanced_args[0], advanced_args[1])) == NO_ERROR)
+                    ret_val = formula_cells_written(table, advanced_args[0], advanced_args[1], advanced_args[0], advanced_args[1]);
+                else if (advanced_args == NULL)
+                    ret_val = FUNCTION_ERROR;
+            }
+            break;
+
+        // avg [R,C]
+        case 4:
+            if ((ret_val = parse_command_argument(command->arguments, &advanced_args, table)) == NO_ERROR)
+            {
+                if (advanced_args != NULL && (ret_val = avg_cells(table, selector, advanced_args[0], advanced_args[1])) == NO_ERROR)
+                    ret_val = formula_cells_written(table, advanced_args[0], advanced_args[1], advanced_args[0], advanced_args[1]);
+                else if (advanced_args == NULL)
+                    ret_val = FUNCTION_ERROR;
+            }
+            break;
+
+        // count [R,C]
+        case 5:
+            if ((ret_val = parse_command_argument(command->arguments, &advanced_args, table)) == NO_ERROR)
+            {
+                if (advanced_args != NULL && (ret_val = count_cells(table, selector, advanced_args[0], advanced_args[1])) == NO_ERROR)
+                    ret_val = formula_cells_written(table, advanced_args[0], advanced_args[1], advanced_args[0], advanced_args[1]);
+                else if (advanced_args == NULL)
+                    ret_val = FUNCTION_ERROR;
+            }
+            break;
+
+        // len [R,C]
+        case 6:
+            if ((ret_val = parse_command_argument(command->arguments, &advanced_args, table)) == NO_ERROR)
+            {
+                if (advanced_args != NULL && (ret_val = cell_len(table, selector, advanced_args[0], advanced_args[1])) == NO_ERROR)
+                    ret_val = formula_cells_written(table, advanced_args[0], advanced_args[1], advanced_args[0], advanced_args[1]);
+                else if (advanced_args == NULL)
+                    ret_val = FUNCTION_ERROR;
+            }
+            break;
 
-    return (long int)(val) == val;
+        // cumsum [C]
+        case 7:
+            {
+                long long int col;
+                if ((ret_val = parse_window_argument(command->arguments, false, NULL, &col, table)) == NO_ERROR)
+                    ret_val = window_cells(table, selector, 0, 0, col);
+            }
+            break;
+
+        // mavg [W,C], mmin [W,C], mmax [W,C]
+        case 8:
+        case 9:
+        case 10:
+            {
+                long long int window, col;
+                if ((ret_val = parse_window_argument(command->arguments, true, &window, &col, table)) == NO_ERROR)
+                    ret_val = window_cells(table, selector, findex - 7, window, col);
+            }
+            break;
+
+        // median [R,C]
+        case 11:
+            if ((ret_val = parse_command_argument(command->arguments, &advanced_args, table)) == NO_ERROR)
+            {
+                if (advanced_args != NULL)
+                    ret_val = quantile_cells(table, selector, 0.5L, advanced_args[0], advanced_args[1]);
+                else
+                    ret_val = FUNCTION_ERROR;
+            }
+            break;
+
+        // quantile [Q,R,C]
+        case 12:
+            {
+                long double quantile;
+                long long int r, c;
+                int consumed = -1;
+
+                if (command->arguments == NULL ||
+                    sscanf(command->arguments, "[%Lf,%lld,%lld]%n", &quantile, &r, &c, &consumed) != 3 || consumed != (int)strlen(command->arguments))
+                    ret_val = COMMAND_ERROR;
+                else
+                    ret_val = quantile_cells(table, selector, quantile, r - 1, c - 1);
+            }
+            break;
+
+        // topk [K,C]
+        case 13:
+            {
+                long long int k, col;
+                if ((ret_val = parse_window_argument(command->arguments, true, &k, &col, table)) == NO_ERROR)
+                    ret_val = top_cells(table, selector, k, col);
+            }
+            break;
+
+        // distinct [R,C]
+        case 14:
+            if ((ret_val = parse_command_argument(command->arguments, &advanced_args, table)) == NO_ERROR)
+            {
+                if (advanced_args != NULL)
+                    ret_val = sketch_cells(table, selector, true, 0, advanced_args[0], advanced_args[1]);
+                else
+                    ret_val = FUNCTION_ERROR;
+            }
+            break;
+
+        // aquantile [Q,R,C]
+        case 15:
+            {
+                long double quantile;
+                long long int r, c;
+                int consumed = -1;
+
+                if (command->arguments == NULL ||
+                    sscanf(command->arguments, "[%Lf,%lld,%lld]%n", &quantile, &r, &c, &consumed) != 3 || consumed != (int)strlen(command->arguments))
+                    ret_val = COMMAND_ERROR;
+                else
+                    ret_val = sketch_cells(table, selector, false, quantile, r - 1, c - 1);
+            }
+            break;
+
+        // profile [FILE]
+        case 16:
+            ret_val = profile_columns(table, selector, command->arguments);
+            break;
+
+        // pivot [R,C,V,FUNC]
+        case 17:
+            {
+                long long int key_col, pivot_col, value_col;
+                char function[8];
+                int consumed = -1;
+
+                if (command->arguments == NULL ||
+                    sscanf(command->arguments, "[%lld,%lld,%lld,%5[a-z]]%n", &key_col, &pivot_col, &value_col, function, &consumed) != 4 ||
+                    consumed != (int)strlen(command->arguments))
+                    ret_val = COMMAND_ERROR;
+                else if (strings_equal(function, "sum"))
+                    ret_val = pivot_table(table, selector, key_col - 1, pivot_col - 1, value_col - 1, 0);
+                else if (strings_equal(function, "count"))
+                    ret_val = pivot_table(table, selector, key_col - 1, pivot_col - 1, value_col - 1, 1);
+                else if (strings_equal(function, "avg"))
+                    ret_val = pivot_table(table, selector, key_col - 1, pivot_col - 1, value_col - 1, 2);
+                else
+                    ret_val = COMMAND_ERROR;
+            }
+            break;
+
+        // transpose
+        case 18:
+            ret_val = transpose_table(table);
+            if (ret_val == NO_ERROR)
+                init_selector(selector);
+            break;
+
+        // partition [C] PREFIX, split [N] PREFIX
+        case 19:
+        case 20:
+            {
+                long long int value;
+                int consumed = -1;
+
+                if (command->arguments == NULL || sscanf(command->arguments, "[%lld]%n", &value, &consumed) != 1 ||
+                    command->arguments[consumed] != ' ' || command->arguments[consumed + 1] == '\0')
+                    ret_val = COMMAND_ERROR;
+                else if (findex == 19)
+                    ret_val = partition_rows(table, selector, value - 1, 0, command->arguments + consumed + 1);
+                else
+                    ret_val = partition_rows(table, selector, -1, value, command->arguments + consumed + 1);
+            }
+            break;
+
+        // hash [C], hash [R,C]
+        case 21:
+            if (command->arguments == NULL)
+                ret_val = COMMAND_ERROR;
+            else if (strchr(command->arguments, ',') == NULL)
+            {
+                long long int col;
+                if ((ret_val = parse_window_argument(command->arguments, false, NULL, &col, table)) == NO_ERROR)
+                    ret_val = hash_rows(table, selector, col);
+            }
+            else if ((ret_val = parse_command_argument(command->arguments, &advanced_args, table)) == NO_ERROR)
+            {
+                if (advanced_args != NULL && (ret_val = hash_selection(table, selector, advanced_args[0], advanced_args[1])) == NO_ERROR)
+                    ret_val = formula_cells_written(table, advanced_args[0], advanced_args[1], advanced_args[0], advanced_args[1]);
+                else if (advanced_args == NULL)
+                    ret_val = FUNCTION_ERROR;
+            }
+            break;
+
+        // diff FILE, diff [C] FILE
+        case 22:
+            {
+                long long int value = 0;
+                int consumed = 0;
+
+                if (command->arguments == NULL)
+                    ret_val = COMMAND_ERROR;
+                else if (command->arguments[0] == '[' &&
+                         (sscanf(command->arguments, "[%lld]%n", &value, &consumed) != 1 || value < 1 ||
+                          command->arguments[consumed] != ' ' || command->arguments[consumed + 1] == '\0'))
+                    ret_val = COMMAND_ERROR;
+                else
+                {
+                    ret_val = diff_table(table, value - 1, command->arguments + ((consumed > 0) ? consumed + 1 : 0));
+                    if (ret_val == NO_ERROR)
+                        init_selector(selector);
+                }
+            }
+            break;
+
+        default:
+            ret_val = COMMAND_ERROR;
+            break;
+    }
+
+    free(advanced_args);
+    return ret_val;
 }
 
-int string_to_llint(char *string, long long int *val)
+int execute_temp_var_command(Table *table, Selector *selector, Command *command, TempVariableStore *temp_var_store)
 {
     /**
-     * @brief Convert string to long long int
+     * @brief Execute temporary variable command on @p table
      *
-     * @param string String we want to convert
-     * @param val Pointer to long long int where output will be saved
+     * Assign proper function to @p command and execute it to edit table
+     *
+     * @param table Pointer to instance of #Table structure that will be eddited
+     * @param selector Pointer to instance of #Selector structure for selecting part of @p table to edit
+     * @param command Pointer to instance of #Command structure that will select function to use
+     * @param temp_var_store Pointer to instance of #TempVariableStore structure used for stroring values
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    if (string == NULL)
-        return FUNCTION_ARGUMENT_ERROR;
+    int ret_val = NO_ERROR;
+    int findex = get_temp_var_command_index(command);
+    if (findex == -1)
+        return NO_ERROR;
 
-    char *rest;
-    *val = strtoll(string, &rest, 10);
+    char *arg = NULL;
+    long long int arg_lli = -1;
 
-    if (!strings_equal(rest, EMPTY_CELL))
-        return NUM_CONVERSION_FAILED;
+    if (command->arguments == NULL)
+        return COMMAND_ERROR;
 
-    return NO_ERROR;
+    if ((ret_val = string_copy(&command->arguments, &arg)) != NO_ERROR)
+        return ret_val;
+
+    if ((ret_val = trim_start(arg)) == NO_ERROR)
+        ret_val = string_to_llint(arg, &arg_lli);
+
+    if (arg_lli < 0 || arg_lli >= NUMBER_OF_TEMPORARY_VARIABLES)
+        ret_val = COMMAND_ERROR;
+
+
+    if (ret_val == NO_ERROR)
+    {
+        switch (findex)
+        {
+            // def _X
+            case 0:
+                if ((selector->lld_ir1 != selector->lld_ir2) || (selector->lld_ic1 != selector->lld_ic2))
+                {
+                    ret_val = COMMAND_ERROR;
+                    break;
+                }
+
+                ret_val = set_temporary_variable(table, selector, temp_var_store, arg_lli);
+                break;
+
+            // use _X
+            case 1:
+                ret_val = set_cell_from_temporary_variable(table, selector, temp_var_store, arg_lli);
+                break;
+
+            // inc _X
+            case 2:
+                ret_val = increase_temporary_variable(temp_var_store, arg_lli);
+                break;
+
+            default:
+                ret_val = COMMAND_ERROR;
+                break;
+        }
+    }
+
+    free(arg);
+
+    return ret_val;
 }
 
-int string_to_ldouble(char *string, long double *val)
+int get_type_of_command(Command *command)
 {
     /**
-     * @brief Convert string to long double
+     * @brief Get type of inputed @p command
      *
-     * @param string String we want to convert
-     * @param val Pointer to long double where output will be saved
+     * @param command Pointer to instance of #Command structure that will be tested
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @return Type of command based on #CommandType
      */
 
-    if (string == NULL)
-        return FUNCTION_ARGUMENT_ERROR;
+    if (command == NULL)
+        return UNKNOWN;
 
-    char *rest;
-    *val = strtold(string, &rest);
+    if (is_table_editing_command(command))
+        return TABLE_EDITING_COMMAND;
 
-    if (!strings_equal(rest, EMPTY_CELL))
-        return NUM_CONVERSION_FAILED;
+    if (is_data_editing_command(command))
+        return DATA_EDITING_COMMAND;
 
-    return NO_ERROR;
+    if (is_temp_var_command(command))
+        return TEMP_VAR_COMMAND;
+
+    return UNKNOWN;
 }
 
-int ldouble_to_string(long double value, char **output_string)
+_Bool is_shardable_script(Commands *commands)
 {
     /**
-     * @brief Convert long double @p value to string
+     * @brief Check if script only aggregates data, so it can be executed by shards
      *
-     * @param value Long double value that we want to convert to string
-     * @param output_string Pointer to output string
+     * Shardable script has only selectors (without find) and sum, avg, count and profile commands
      *
-     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     * @param commands Pointer to instance of #Commands structure
+     *
+     * @return true if script can be executed by shards, false if not
      */
 
-    char *temp_string = (char*)malloc(BASE_CELL_LENGTH * sizeof(char));
-    if (temp_string == NULL)
-        return ALLOCATION_FAILED;
+    const char *aggregates[] = { "sum", "avg", "count", "profile" };
 
-    unsigned long long int tlength = snprintf(temp_string, BASE_CELL_LENGTH, "%Lg", value);
-    if ((tlength + 1) > BASE_CELL_LENGTH)
+    for (long long int i = 0; i < commands->num_of_commands; i++)
     {
-        char *tmp = (char*)realloc(temp_string, (tlength + 1) * sizeof(char));
-        if (tmp == NULL)
-        {
-            free(temp_string);
-            return ALLOCATION_FAILED;
-        }
+        Command *command = &commands->commands[i];
+        _Bool allowed = is_command_selector(command);
 
-        temp_string = tmp;
-        snprintf(temp_string, tlength + 1, "%Lg", value);
+        for (int j = 0; j < 4 && !allowed; j++)
+            allowed = strings_equal(command->function, aggregates[j]);
+
+        if (!allowed)
+            return false;
     }
 
-    *output_string = temp_string;
-    return NO_ERROR;
+    return true;
 }
 
-int lint_to_string(long int value, char **output_string)
+int split_input(const char *path, int num_of_shards, off_t *offsets, int *num_of_ranges)
 {
     /**
-     * @brief Convert long int @p value to string
+     * @brief Split input file to byte ranges of similar size that start at beginning of line
      *
-     * @param value Long int value that we want to convert to string
-     * @param output_string Pointer to output string
+     * Ranges without any line are dropped, so there can be less ranges than shards
      *
-     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     * @param path Path to input file
+     * @param num_of_shards Requested number of ranges
+     * @param offsets Array of at least @p num_of_shards + 1 offsets where starts of ranges and end of file will be saved
+     * @param num_of_ranges Pointer where number of ranges will be saved
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    char *temp_string = (char*)malloc(BASE_CELL_LENGTH * sizeof(char));
-    if (temp_string == NULL)
-        return ALLOCATION_FAILED;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return CANT_OPEN_FILE;
 
-    unsigned long long int tlength = snprintf(temp_string, BASE_CELL_LENGTH, "%li", value);
-    if ((tlength + 1) > BASE_CELL_LENGTH)
+    struct stat input_stat;
+    if (fstat(fd, &input_stat) != 0)
     {
-        char *tmp = (char*)realloc(temp_string, (tlength + 1) * sizeof(char));
-        if (tmp == NULL)
+        close(fd);
+        return IO_ERROR;
+    }
+
+    off_t size = input_stat.st_size;
+    int ret_val = NO_ERROR;
+    char buffer[4096];
+
+    offsets[0] = 0;
+    *num_of_ranges = 1;
+
+    for (int i = 1; i < num_of_shards && ret_val == NO_ERROR; i++)
+    {
+        off_t position = size / num_of_shards * i;
+        if (position <= offsets[*num_of_ranges - 1])
+            position = offsets[*num_of_ranges - 1] + 1;
+
+        // Range starts right after first new line character at or after position - 1
+        off_t start = -1;
+        for (position--; start < 0 && position < size;)
         {
-            free(temp_string);
-            return ALLOCATION_FAILED;
+            ssize_t loaded = pread(fd, buffer, sizeof(buffer), position);
+            if (loaded < 0 && errno == EINTR)
+                continue;
+            if (loaded <= 0)
+            {
+                ret_val = (loaded < 0) ? IO_ERROR : NO_ERROR;
+                break;
+            }
+
+            char *new_line = (char*)memchr(buffer, '\n', (size_t)loaded);
+            if (new_line != NULL)
+                start = position + (new_line - buffer) + 1;
+            else
+                position += loaded;
         }
 
-        temp_string = tmp;
-        snprintf(temp_string, tlength + 1, "%li", value);
+        if (start < 0 || start >= size)
+            break;
+
+        offsets[(*num_of_ranges)++] = start;
     }
 
-    *output_string = temp_string;
-    return NO_ERROR;
+    offsets[*num_of_ranges] = size;
+    close(fd);
+
+    return ret_val;
 }
 
-long long int count_char(char *string, char c, _Bool ignore_escapes)
+int shard_fork(ShardContext *shard, const char *path, int num_of_shards)
 {
     /**
-     * @brief Count specific character in string
+     * @brief Split input file to shards and fork worker process for every shard except first one
      *
-     * Count ocurences of specific character in string with option to ignore escaped characters and parts in parentecies
+     * Every worker is connected to coordinator (this process) by pair of pipes \n
+     * When input cant be split to more than one shard then no worker is forked
      *
-     * @param string Input string
-     * @param c Character we want to search
-     * @param ignore_escapes Flag if we want ignore if characte is escaped or in parentecies and count it too
+     * @param shard Pointer to instance of #ShardContext structure (in worker it describes shard of worker)
+     * @param path Path to input file
+     * @param num_of_shards Requested number of shards
      *
-     * @return Number of ocurences of searched character
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    if (string == NULL)
-        return 0;
+    int ret_val;
+    off_t offsets[MAX_NUMBER_OF_SHARDS + 1];
+    int num_of_ranges = 1;
 
-    size_t lenght_of_string = strlen(string);
-    _Bool in_double_parentecies = false;
-    long long int counter = 0;
+    shard->index = 0;
+    shard->num_of_shards = 1;
+    shard->first_row = 0;
+    shard->num_of_rows = 0;
+    shard->to_coordinator = -1;
+    shard->from_coordinator = -1;
 
-    long long int possible_occurencies = 0;
-    for (size_t i = 0; i < lenght_of_string; i++)
-        if (string[i] == '"')
-            possible_occurencies++;
+    if ((ret_val = split_input(path, num_of_shards, offsets, &num_of_ranges)) != NO_ERROR || num_of_ranges < 2)
+        return ret_val;
 
-    if ((possible_occurencies % 2) > 0)
-        possible_occurencies --;
+    // Write to pipe of finished process has to fail instead of killing writer
+    signal(SIGPIPE, SIG_IGN);
 
-    long long int occurencies = 0;
+    // Buffered output would be written by every process
+    fflush(NULL);
 
-    for (size_t i = 0; i < lenght_of_string; i++)
+    for (int i = 1; i < num_of_ranges; i++)
     {
-        char cc = string[i];
+        int up[2], down[2];
+        if (pipe(up) != 0)
+        {
+            ret_val = IO_ERROR;
+            break;
+        }
 
-        if (cc == '"')
+        if (pipe(down) != 0)
         {
-            occurencies++;
-            if ((i == 0 || string[i-1] != '\\') && (occurencies <= possible_occurencies))
-                in_double_parentecies = !in_double_parentecies;
+            close(up[0]);
+            close(up[1]);
+            ret_val = IO_ERROR;
+            break;
         }
 
-        if (cc == c)
+        pid_t pid = fork();
+        if (pid == 0)
         {
-            if (ignore_escapes || (!in_double_parentecies && (i != 0 && string[i-1] != '\\')))
+            // Worker keeps only its own pipes
+            for (int j = 1; j < i; j++)
             {
-                counter++;
+                close(shard->to_workers[j]);
+                close(shard->from_workers[j]);
+            }
+            close(up[0]);
+            close(down[1]);
+
+            shard->index = i;
+            shard->num_of_shards = num_of_ranges;
+            shard->start = offsets[i];
+            shard->end = offsets[i + 1];
+            shard->to_coordinator = up[1];
+            shard->from_coordinator = down[0];
+
+            // Results of all shards are merged, so errors are reported only by coordinator
+            int null_fd = open("/dev/null", O_WRONLY);
+            if (null_fd >= 0)
+            {
+                dup2(null_fd, STDERR_FILENO);
+                close(null_fd);
             }
+
+            return NO_ERROR;
+        }
+
+        close(up[1]);
+        close(down[0]);
+
+        if (pid < 0)
+        {
+            close(up[0]);
+            close(down[1]);
+            ret_val = FUNCTION_ERROR;
+            break;
         }
+
+        shard->to_workers[i] = down[1];
+        shard->from_workers[i] = up[0];
+        shard->workers[i] = pid;
+        shard->num_of_shards = i + 1;
     }
 
-    return counter;
+    if (ret_val != NO_ERROR)
+    {
+        // Workers that were already forked stop when they cant reach coordinator
+        for (int i = 1; i < shard->num_of_shards; i++)
+        {
+            close(shard->to_workers[i]);
+            close(shard->from_workers[i]);
+            kill(shard->workers[i], SIGTERM);
+            waitpid(shard->workers[i], NULL, 0);
+        }
+
+        shard->num_of_shards = 1;
+        return ret_val;
+    }
+
+    shard->start = 0;
+    shard->end = offsets[1];
+
+    return NO_ERROR;
 }
 
-long long int get_position_of_character(char *string, char ch, long long int index, _Bool ignore_escapes)
+void merge_shard_layouts(void *target, void *source, size_t size)
 {
     /**
-     * @brief Get position of character of certain index in string
+     * @brief Merge shape of later shard
      *
-     * Iterate over each character in string and count character ocurences
-     * If ocurence counter coresponse to @p index then return position of current char in string
+     * @param target Pointer to instance of #ShardLayout structure where result will be saved
+     * @param source Pointer to instance of #ShardLayout structure of later shard
+     * @param size Size of #ShardLayout structure (not used)
+     */
+
+    (void)size;
+
+    ShardLayout *merged = (ShardLayout*)target;
+    ShardLayout *layout = (ShardLayout*)source;
+
+    if (merged->result == NO_ERROR)
+        merged->result = layout->result;
+
+    merged->formulas = merged->formulas || layout->formulas;
+    if (layout->num_of_cols > merged->num_of_cols)
+        merged->num_of_cols = layout->num_of_cols;
+
+    for (int i = 0; i < MAX_NUMBER_OF_SHARDS; i++)
+        merged->rows[i] += layout->rows[i];
+}
+
+int shard_join(Table *table, int ret_val)
+{
+    /**
+     * @brief Agree with other shards on shape of whole table
      *
-     * @param string String where to find char
-     * @param ch Character we are looking for
-     * @param index Index of occurence of character in string we want position for
-     * @param ignore_escapes Flag if we want ignore if characte is escaped or in parentecies and count it too
+     * Every shard learns index of its first row in whole table and rows of all shards are padded to the widest shard \n
+     * Formula cells can reference rows of other shards, so table with formula cells cant be executed by shards
      *
-     * @return Position of @p index ocurence of @p ch in string if valid ocurence is found, if not -1
+     * @param table Pointer to instance of #Table structure with normalized rows of shard
+     * @param ret_val Result of loading of shard
      *
-     * @todo Rework to strchr
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes (result of any shard)
      */
 
-    long long int counter = 0;
-    _Bool in_double_parentecies = false;
-
-    long long int possible_occurencies = count_char(string, '"', true);
-    if ((possible_occurencies % 2) > 0)
-        possible_occurencies --;
-
-    long long int occurencies = 0;
+    ShardContext *shard = table->shard;
+    ShardLayout layout;
+    memset(&layout, 0, sizeof(layout));
+
+    layout.result = ret_val;
+    layout.formulas = (table->formulas.num_of_formulas > 0);
+    layout.num_of_cols = (table->num_of_rows > 0) ? get_row(table, 0)->num_of_cells : 0;
+    layout.rows[shard->index] = table->num_of_rows;
+
+    int exchange_ret_val = shard_exchange(shard, &layout, sizeof(layout), merge_shard_layouts);
+    if (exchange_ret_val != NO_ERROR)
+        return exchange_ret_val;
+    if (layout.result != NO_ERROR)
+        return layout.result;
+    if (layout.formulas)
+        return FUNCTION_ERROR;
 
-    for (size_t i = 0; string[i]; i++)
+    shard->first_row = 0;
+    shard->num_of_rows = 0;
+    for (int i = 0; i < shard->num_of_shards; i++)
     {
-        if (string[i] == '"')
-        {
-            occurencies++;
-            if ((i == 0 || string[i-1] != '\\') && (occurencies <= possible_occurencies))
-                in_double_parentecies = !in_double_parentecies;
-        }
-
-        if (string[i] == ch)
-        {
-            if (ignore_escapes || (!in_double_parentecies && (i != 0 && string[i-1] != '\\')))
-            {
-                counter++;
-                if ((counter - 1) == index)
-                    return i;
-            }
-        }
+        if (i < shard->index)
+            shard->first_row += layout.rows[i];
+        shard->num_of_rows += layout.rows[i];
     }
 
-    return -1;
+    for (long long int i = 0; i < table->num_of_rows; i++)
+        while (get_row(table, i)->num_of_cells < layout.num_of_cols)
+            if (append_empty_cell(get_row(table, i)) != NO_ERROR)
+                return ALLOCATION_FAILED;
+
+    return NO_ERROR;
 }
 
-void rm_newline_chars(char *s) {
+int append_file(int fd, const char *path)
+{
     /**
-     * @brief Removing new line character from string
+     * @brief Copy whole file to the end of opened file
      *
-     * Iterate over string until it new line character then replace it with 0
-     * @warning
-     * Rest of the string is REMOVED!
+     * @param fd File descriptor of file opened for writing
+     * @param path Path to copied file
      *
-     * @param s Pointer to string from which is new line character removed
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    while(*s && *s != '\n' && *s != '\r')
-        s++;
+    int source = open(path, O_RDONLY);
+    if (source < 0)
+        return CANT_OPEN_FILE;
 
-    *s = 0;
+    char *buffer = (char*)malloc(IO_BUFFER_SIZE);
+    int ret_val = (buffer == NULL) ? ALLOCATION_FAILED : NO_ERROR;
+
+    while (ret_val == NO_ERROR)
+    {
+        ssize_t loaded = read(source, buffer, IO_BUFFER_SIZE);
+        if (loaded < 0 && errno == EINTR)
+            continue;
+        if (loaded < 0)
+            ret_val = IO_ERROR;
+        if (loaded <= 0)
+            break;
+
+        ret_val = write_fully(fd, buffer, (size_t)loaded);
+    }
+
+    free(buffer);
+    close(source);
+
+    return ret_val;
 }
 
-int get_substring(char *string, char **substring, char delim, long long int index, _Bool ignore_escapes, char **rest, _Bool want_rest)
+int shard_save(Table *table, char *path)
 {
     /**
-     * @brief Get substring from string
+     * @brief Save rows of all shards to output file in order of shards
      *
-     * Extract Portion of string delimited by @p delim or by borders of main string @p string \n
-     * Wantend portion is selected by @p index
+     * Every worker saves its rows to file with #SHARD_FILE_SUFFIX and exits \n
+     * Coordinator waits for all workers, saves its own rows and appends files of workers to them
      *
-     * @param string Base string
-     * @param substring Place where result will be saved, should be allocated large enough but if its not provided this function will allocate it
-     * @param delim Deliminator character
-     * @param index Index of substring
-     * @param ignore_escapes Flag if we want ignore if characte is escaped or in parentecies and count it too
-     * @param rest There will be saved rest of the string
-     * @param want_rest Flag if we want save rest of the flag
+     * @param table Pointer to instance of #Table structure with rows of shard
+     * @param path Path to output file
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    if (string == NULL)
-        return FUNCTION_ERROR;
-
-    long long int number_of_delims = count_char(string, delim, ignore_escapes);
-    size_t string_length = strlen(string);
-
-    long long int start_index = (index == 0) ? 0 : get_position_of_character(string, delim, index - 1, ignore_escapes) + 1;
-    long long int end_index = (index >= number_of_delims) ? ((long long int)string_length - 1) : get_position_of_character(string, delim, index, ignore_escapes) - 1;
+    ShardContext *shard = table->shard;
+    size_t length = strlen(path) + strlen(SHARD_FILE_SUFFIX) + 16;
+    char *shard_path = (char*)malloc(length);
 
-    // If there is no substring pointer init it
-    if ((*substring) == NULL)
+    if (shard->index > 0)
     {
-        if ((end_index - start_index + 1) == 0)
-            return NO_ERROR;
+        close(shard->to_coordinator);
+        close(shard->from_coordinator);
 
-        (*substring) = (char*)malloc((string_length + 1) * sizeof(char));
-        if ((*substring) == NULL)
+        if (shard_path == NULL)
             return ALLOCATION_FAILED;
-    }
 
-    long long int i = 0, j = start_index;
+        snprintf(shard_path, length, "%s%s%d", path, SHARD_FILE_SUFFIX, shard->index);
+        int ret_val = save_table(table, shard_path);
+        free(shard_path);
 
-    for (; j <= end_index; i++, j++)
+        return ret_val;
+    }
+
+    // Closed pipes stop workers that still wait for coordinator
+    _Bool workers_saved = true;
+    for (int i = 1; i < shard->num_of_shards; i++)
     {
-        (*substring)[i] = string[j];
+        close(shard->to_workers[i]);
+        close(shard->from_workers[i]);
     }
-    (*substring)[end_index - start_index + 1] = '\0';
 
-    if (want_rest)
+    for (int i = 1; i < shard->num_of_shards; i++)
     {
-        j += 1;
-        long long int rest_len = (long long int)string_length - j + 1;
+        int status;
+        if (waitpid(shard->workers[i], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != NO_ERROR)
+            workers_saved = false;
+    }
 
-        if (rest_len == 0)
-            return NO_ERROR;
+    int ret_val = (shard_path == NULL) ? ALLOCATION_FAILED : save_table(table, path);
 
-        (*rest) = (char*)malloc((rest_len) * sizeof(char));
-        if (rest == NULL)
-        {
-            free(*substring);
-            (*substring) = NULL;
-            return ALLOCATION_FAILED;
-        }
+    int fd = -1;
+    if (ret_val == NO_ERROR && (fd = open(path, O_WRONLY | O_APPEND)) < 0)
+        ret_val = CANT_OPEN_FILE;
 
-        i = 0;
-        for (; j < (long long int)string_length; j++, i++)
-        {
-            (*rest)[i] = string[j];
-        }
-        (*rest)[i] = '\0';
+    for (int i = 1; i < shard->num_of_shards && shard_path != NULL; i++)
+    {
+        snprintf(shard_path, length, "%s%s%d", path, SHARD_FILE_SUFFIX, i);
+
+        if (ret_val == NO_ERROR && workers_saved)
+            ret_val = append_file(fd, shard_path);
+
+        unlink(shard_path);
     }
 
-    return NO_ERROR;
+    if (fd >= 0 && close(fd) != 0 && ret_val == NO_ERROR)
+        ret_val = IO_ERROR;
+
+    free(shard_path);
+
+    return (ret_val == NO_ERROR && !workers_saved) ? IO_ERROR : ret_val;
 }
 
-void normalize_delims(char *line, const char *delims)
+time_t monotonic_seconds(void)
 {
     /**
-     * @brief Normalize all delims to the first one
-     *
-     * Iterate over all delims and all characters in line and replace and valid delim from delims array in line by the first delim in delims array
+     * @brief Get time of monotonic clock in seconds
      *
-     * @param line Line string
-     * @param delims Array of deliminator characters
+     * @return Number of seconds since unspecified point in past
      */
 
-    size_t num_of_delims = strlen(delims);
-    size_t length_of_line = strlen(line);
-
-    long long int possible_occurencies = count_char(line, '"', true);
-    if ((possible_occurencies % 2) > 0)
-        possible_occurencies --;
-
-    for (size_t i = 1; i < num_of_delims; i++)
-    {
-        _Bool in_double_parentecies = false;
-        long long int occurencies = 0;
-
-        for (size_t j = 0; j < length_of_line; j++)
-        {
-            char cc = line[j];
-
-            if (cc == '"')
-            {
-                occurencies++;
-                if ((j == 0 || line[j-1] != '\\') && (occurencies <= possible_occurencies))
-                    in_double_parentecies = !in_double_parentecies;
-            }
-
-            if (cc == delims[i])
-            {
-                if (!in_double_parentecies && (j != 0 && line[j-1] != '\\'))
-                {
-                    line[j] = delims[0];
-                }
-            }
-        }
-    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec;
 }
 
-void deallocate_cell(Cell *cell)
+uint64_t hash_script(Commands *commands)
 {
     /**
-     * @brief Deallocate cell
+     * @brief Compute hash of all commands, so checkpoint is resumed only by same script
      *
-     * Free content of cell
+     * @param commands Pointer to instance of #Commands structure
      *
-     * @param cell Pointer to instance of #Cell strucutre
+     * @return Hash of commands
      */
 
-    if (cell->content == NULL)
-        return;
+    uint64_t hash = (uint64_t)commands->num_of_commands;
 
-    free(cell->content);
-    cell->content = NULL;
-    cell->allocated_chars = 0;
+    for (long long int i = 0; i < commands->num_of_commands; i++)
+    {
+        const char *function = commands->commands[i].function;
+        const char *arguments = (commands->commands[i].arguments != NULL) ? commands->commands[i].arguments : "";
+
+        hash = hash_bytes(function, strlen(function), hash);
+        hash = hash_bytes(arguments, strlen(arguments), hash);
+    }
+
+    return hash;
 }
 
-void deallocate_row(Row *row)
+uint64_t hash_page(Table *table, long long int page)
 {
     /**
-     * @brief Deallocate row
+     * @brief Compute hash of content of all rows of @p page
      *
-     * Iterate over all cells and deallocate them
+     * @param table Pointer to instance of #Table structure
+     * @param page Index of page
      *
-     * @param row Pointer to instance of #Row structure
+     * @return Hash of rows of page
      */
 
-    if (row->cells == NULL)
-        return;
+    long long int end = (page + 1) * ROWS_PER_PAGE;
+    if (end > table->num_of_rows)
+        end = table->num_of_rows;
 
-    for (long long int i = 0; i < row->num_of_cells; i++)
+    uint64_t hash = 0;
+
+    for (long long int r = page * ROWS_PER_PAGE; r < end; r++)
     {
-        deallocate_cell(&row->cells[i]);
+        Row *row = get_row(table, r);
+        hash = hash_bytes((const char*)&row->num_of_cells, sizeof(row->num_of_cells), hash);
+
+        for (long long int c = 0; c < row->num_of_cells; c++)
+        {
+            const char *content = (row->cells[c].content != NULL) ? row->cells[c].content : "";
+            hash = hash_bytes(content, strlen(content), hash);
+        }
     }
 
-    free(row->cells);
-    row->cells = NULL;
-    row->num_of_cells = 0;
-    row->allocated_cells = 0;
+    return hash;
 }
 
-void deallocate_table(Table *table)
+char *checkpoint_pages_path(const char *path, long long int generation)
 {
     /**
-     * @brief Dealocate whole table from memory
+     * @brief Create path of pages file of checkpoint
      *
-     * Iterate over all rows and dealocate them
+     * @param path Path to manifest of checkpoint
+     * @param generation Generation of pages file
      *
-     * @param table Pointer to instance of #Table structure
+     * @return Allocated path (caller has to free it) or NULL on error
      */
 
-    if (table->rows == NULL)
-        return;
-
-    for (long long int i = 0; i < table->num_of_rows; i++)
-    {
-        deallocate_row(&table->rows[i]);
-    }
+    size_t length = strlen(path) + strlen(CHECKPOINT_PAGES_SUFFIX) + MAX_INTEGER_DIGITS + 3;
+    char *pages_path = (char*)malloc(length * sizeof(char));
+    if (pages_path != NULL)
+        snprintf(pages_path, length, "%s%s%lld", path, CHECKPOINT_PAGES_SUFFIX, generation);
 
-    free(table->rows);
-    table->rows = NULL;
-    table->num_of_rows = 0;
-    table->allocated_rows = 0;
+    return pages_path;
 }
 
-void deallocate_raw_commands(Raw_commands *commands_store)
+void checkpoint_init(Checkpoint *checkpoint, const char *path, Commands *commands)
 {
     /**
-     * @brief Deallocate raw commands structure
+     * @brief Init checkpoint of execution of @p commands
      *
-     * @param commands_store Pointer to instance of #Raw_commands structure
+     * @param checkpoint Pointer to instance of #Checkpoint structure
+     * @param path Path to manifest of checkpoint (NULL if checkpoints are disabled)
+     * @param commands Pointer to instance of #Commands structure with commands that will be executed
      */
 
-    if (commands_store->commands == NULL)
-        return;
-
-    for (long long int i = 0; i < commands_store->num_of_commands; i++)
-    {
-        free(commands_store->commands[i]);
-        commands_store->commands[i] = NULL;
-    }
+    checkpoint->path = path;
+    checkpoint->script_hash = hash_script(commands);
+    checkpoint->generation = 0;
+    checkpoint->pages_file = NULL;
+    checkpoint->file_size = 0;
+    checkpoint->pages = NULL;
+    checkpoint->num_of_pages = 0;
+    checkpoint->allocated_pages = 0;
+    checkpoint->last_time = monotonic_seconds();
+    checkpoint->resumed = false;
+    checkpoint->next_command = 0;
+    init_selector(&checkpoint->selector);
+    init_selector(&checkpoint->temp_selector);
 
-    free(commands_store->commands);
-    commands_store->commands = NULL;
-    commands_store->num_of_commands = 0;
+    for (long long int i = 0; i < NUMBER_OF_TEMPORARY_VARIABLES; i++)
+        checkpoint->variables[i] = NULL;
 }
 
-void deallocate_base_commands(Commands *base_commands)
+void checkpoint_destroy(Checkpoint *checkpoint, _Bool remove_files)
 {
     /**
-     * @brief Deallocate content of istance @p base_commands of #Commands structure
+     * @brief Close checkpoint and free its memory
      *
-     * @param base_commands Pointer to instance of #Commands structure
+     * @param checkpoint Pointer to instance of #Checkpoint structure
+     * @param remove_files Flag if manifest and pages file should be removed (execution finished)
      */
 
-    if (base_commands->commands == NULL)
-        return;
+    if (checkpoint->pages_file != NULL)
+        fclose(checkpoint->pages_file);
+    checkpoint->pages_file = NULL;
 
-    for (long long int i = 0; i < base_commands->num_of_commands; i++)
+    if (remove_files && checkpoint->path != NULL)
     {
-        free(base_commands->commands[i].function);
-        base_commands->commands[i].function = NULL;
-        free(base_commands->commands[i].arguments);
-        base_commands->commands[i].arguments = NULL;
+        remove(checkpoint->path);
+
+        char *pages_path = (checkpoint->generation > 0) ? checkpoint_pages_path(checkpoint->path, checkpoint->generation) : NULL;
+        if (pages_path != NULL)
+            remove(pages_path);
+        free(pages_path);
     }
 
-    free(base_commands->commands);
-    base_commands->commands = NULL;
+    free(checkpoint->pages);
+    checkpoint->pages = NULL;
+    checkpoint->num_of_pages = 0;
+    checkpoint->allocated_pages = 0;
+
+    for (long long int i = 0; i < NUMBER_OF_TEMPORARY_VARIABLES; i++)
+    {
+        free(checkpoint->variables[i]);
+        checkpoint->variables[i] = NULL;
+    }
 }
 
-void deallocate_temp_var_store(TempVariableStore *temp_var_store)
+int reserve_checkpoint_pages(Checkpoint *checkpoint, long long int num_of_pages)
 {
     /**
-     * @brief Deallocate temporary variable store
+     * @brief Make sure that checkpoint has records for @p num_of_pages pages
      *
-     * @param temp_var_store Pointer to instance of #TempVariableStore structure
+     * @param checkpoint Pointer to instance of #Checkpoint structure
+     * @param num_of_pages Number of pages of table
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
      */
 
-    if (temp_var_store != NULL && temp_var_store->variables != NULL)
-    {
-        for (long long int i = 0; i < NUMBER_OF_TEMPORARY_VARIABLES; i++)
-        {
-            free(temp_var_store->variables[i]);
-            temp_var_store->variables[i] = NULL;
-        }
+    if (num_of_pages <= checkpoint->allocated_pages)
+        return NO_ERROR;
 
-        free(temp_var_store->variables);
-        temp_var_store->variables = NULL;
-    }
+    long long int allocated = (checkpoint->allocated_pages > 0) ? checkpoint->allocated_pages : 1;
+    while (allocated < num_of_pages)
+        allocated *= 2;
+
+    CheckpointPage *tmp = (CheckpointPage*)realloc(checkpoint->pages, (size_t)allocated * sizeof(CheckpointPage));
+    if (tmp == NULL)
+        return ALLOCATION_FAILED;
+
+    checkpoint->pages = tmp;
+    checkpoint->allocated_pages = allocated;
+
+    return NO_ERROR;
 }
 
-int allocate_rows(Table *table)
+int load_checkpoint(Checkpoint *checkpoint, Table *table)
 {
     /**
-     * @brief Allocate rows in table structure
+     * @brief Load table and state of execution from checkpoint
      *
-     * Allocate new rows array or extend existing one
+     * Whole manifest is checked before any row is loaded, so table stays empty when checkpoint cant be used
      *
-     * @param table Pointer to instance of #Table structure
+     * @param checkpoint Pointer to instance of #Checkpoint structure initialized by #checkpoint_init
+     * @param table Pointer to empty #Table where rows will be saved
      *
-     * @return #NO_ERROR when table is allocated properly in other cases return #ALLOCATION_FAILED
+     * @return #NO_ERROR when execution can be resumed, #CANT_OPEN_FILE when there is no checkpoint,
+     *         #VALUE_ERROR when manifest belongs to other commands or is damaged (table is empty),
+     *         #IO_ERROR when pages file is damaged, other codes from #ErrorCodes on error
      */
 
-    if (table->rows == NULL)
+    int ret_val = NO_ERROR;
+    FILE *file = fopen(checkpoint->path, "rb");
+    if (file == NULL)
+        return CANT_OPEN_FILE;
+
+    char magic[sizeof(CHECKPOINT_MAGIC)] = { 0 };
+    uint64_t script_hash;
+    long long int generation, next_command, num_of_rows, num_of_col_types, num_of_formulas, num_of_pages;
+
+    if (fread(magic, sizeof(char), sizeof(CHECKPOINT_MAGIC) - 1, file) != sizeof(CHECKPOINT_MAGIC) - 1 ||
+        !strings_equal(magic, CHECKPOINT_MAGIC) ||
+        fread(&script_hash, sizeof(script_hash), 1, file) != 1 || script_hash != checkpoint->script_hash ||
+        fread(&generation, sizeof(generation), 1, file) != 1 || generation <= 0 ||
+        fread(&next_command, sizeof(next_command), 1, file) != 1 || next_command < 0 ||
+        fread(&checkpoint->selector, sizeof(Selector), 1, file) != 1 ||
+        fread(&checkpoint->temp_selector, sizeof(Selector), 1, file) != 1)
     {
-        table->rows = (Row*)malloc(BASE_NUMBER_OF_ROWS * sizeof(Row));
-        if (table->rows == NULL)
-            return ALLOCATION_FAILED;
+        fclose(file);
+        return VALUE_ERROR;
+    }
 
-        table->num_of_rows = 0;
-        table->allocated_rows = BASE_NUMBER_OF_ROWS;
+    for (long long int i = 0; (i < NUMBER_OF_TEMPORARY_VARIABLES) && (ret_val == NO_ERROR); i++)
+    {
+        long long int length;
+        if (fread(&length, sizeof(length), 1, file) != 1 || length < -1)
+        {
+            ret_val = VALUE_ERROR;
+            break;
+        }
+
+        // Length -1 is variable that wasnt set
+        if (length < 0)
+            continue;
+
+        if ((checkpoint->variables[i] = (char*)malloc((length + 1) * sizeof(char))) == NULL)
+        {
+            ret_val = ALLOCATION_FAILED;
+            break;
+        }
+
+        if (fread(checkpoint->variables[i], sizeof(char), length, file) != (size_t)length)
+            ret_val = VALUE_ERROR;
+        checkpoint->variables[i][length] = '\0';
     }
-    else
+
+    unsigned char *col_types = NULL;
+    Formula *formulas = NULL;
+
+    if (ret_val == NO_ERROR &&
+        (fread(&num_of_rows, sizeof(num_of_rows), 1, file) != 1 || num_of_rows < 0 ||
+         fread(&num_of_col_types, sizeof(num_of_col_types), 1, file) != 1 || num_of_col_types < 0))
+        ret_val = VALUE_ERROR;
+
+    if (ret_val == NO_ERROR && num_of_col_types > 0)
     {
-        Row *tmp = (Row*)realloc(table->rows, (table->allocated_rows + BASE_NUMBER_OF_ROWS) * sizeof(Row));
-        if (tmp == NULL)
-            return ALLOCATION_FAILED;
+        if ((col_types = (unsigned char*)malloc((size_t)num_of_col_types * sizeof(unsigned char))) == NULL)
+            ret_val = ALLOCATION_FAILED;
+        else if (fread(col_types, sizeof(unsigned char), num_of_col_types, file) != (size_t)num_of_col_types)
+            ret_val = VALUE_ERROR;
+    }
 
-        table->allocated_rows += BASE_NUMBER_OF_ROWS;
-        table->rows = tmp;
+    if (ret_val == NO_ERROR && (fread(&num_of_formulas, sizeof(num_of_formulas), 1, file) != 1 || num_of_formulas < 0))
+        ret_val = VALUE_ERROR;
+
+    if (ret_val == NO_ERROR && num_of_formulas > 0)
+    {
+        if ((formulas = (Formula*)malloc((size_t)num_of_formulas * sizeof(Formula))) == NULL)
+            ret_val = ALLOCATION_FAILED;
+        else if (fread(formulas, sizeof(Formula), num_of_formulas, file) != (size_t)num_of_formulas)
+            ret_val = VALUE_ERROR;
     }
 
-    // Set default values
-    for (long long int i = table->num_of_rows; i < table->allocated_rows; i++)
+    if (ret_val == NO_ERROR &&
+        (fread(&num_of_pages, sizeof(num_of_pages), 1, file) != 1 || num_of_pages != (num_of_rows + ROWS_PER_PAGE - 1) / ROWS_PER_PAGE))
+        ret_val = VALUE_ERROR;
+
+    if (ret_val == NO_ERROR)
+        ret_val = reserve_checkpoint_pages(checkpoint, num_of_pages);
+
+    if (ret_val == NO_ERROR && num_of_pages > 0 && fread(checkpoint->pages, sizeof(CheckpointPage), num_of_pages, file) != (size_t)num_of_pages)
+        ret_val = VALUE_ERROR;
+
+    fclose(file);
+
+    char *pages_path = NULL;
+    if (ret_val == NO_ERROR && (pages_path = checkpoint_pages_path(checkpoint->path, generation)) == NULL)
+        ret_val = ALLOCATION_FAILED;
+
+    if (ret_val == NO_ERROR && (checkpoint->pages_file = fopen(pages_path, "r+b")) == NULL)
+        ret_val = VALUE_ERROR;
+
+    free(pages_path);
+
+    if (ret_val != NO_ERROR)
     {
-        table->rows[i].cells = NULL;
-        table->rows[i].num_of_cells = 0;
-        table->rows[i].allocated_cells = 0;
+        free(col_types);
+        free(formulas);
+        checkpoint_destroy(checkpoint, false);
+        return ret_val;
     }
 
-    return NO_ERROR;
-}
+    checkpoint->generation = generation;
+    checkpoint->num_of_pages = num_of_pages;
+    checkpoint->next_command = next_command;
 
-int allocate_raw_commands(Raw_commands *commands_store, long long int number_of_commands)
-{
-    /**
-     * @brief Allocate commands store
-     *
-     * @param commands_store Pointer to instance of #Raw_commands structure
-     * @param number_of_commands Number of commands we want to allocate
-     *
-     * @return #NO_ERROR on success, #ALLOCATION_FAILED on fail
-     */
+    table->col_types = col_types;
+    table->num_of_col_types = num_of_col_types;
+    table->formulas.formulas = formulas;
+    table->formulas.num_of_formulas = num_of_formulas;
+    table->formulas.allocated_formulas = num_of_formulas;
 
-    commands_store->commands = (char**)malloc(number_of_commands * sizeof(char*));
-    if (commands_store->commands == NULL)
-        return ALLOCATION_FAILED;
+    for (long long int i = 0; i < num_of_formulas; i++)
+        if (formulas[i].state == FORMULA_DIRTY)
+            table->formulas.num_of_dirty++;
 
-    commands_store->num_of_commands = number_of_commands;
-    return NO_ERROR;
+    // Rows of each page are read from its last record
+    for (long long int page = 0; (page < num_of_pages) && (ret_val == NO_ERROR); page++)
+    {
+        long long int record_page, record_rows;
+        long long int expected_rows = (num_of_rows - page * ROWS_PER_PAGE < ROWS_PER_PAGE) ? num_of_rows - page * ROWS_PER_PAGE : ROWS_PER_PAGE;
+
+        if (fseeko(checkpoint->pages_file, (off_t)checkpoint->pages[page].offset, SEEK_SET) != 0 ||
+            fread(&record_page, sizeof(record_page), 1, checkpoint->pages_file) != 1 || record_page != page ||
+            fread(&record_rows, sizeof(record_rows), 1, checkpoint->pages_file) != 1 || record_rows != expected_rows)
+        {
+            ret_val = IO_ERROR;
+            break;
+        }
+
+        for (long long int i = 0; (i < record_rows) && (ret_val == NO_ERROR); i++)
+        {
+            if (table->rows == NULL || table->num_of_rows >= table->allocated_rows)
+                if ((ret_val = allocate_rows(table)) != NO_ERROR)
+                    break;
+
+            // Count row even if it is only partialy loaded so it will be deallocated
+            ret_val = read_row_binary(get_row(table, table->num_of_rows), checkpoint->pages_file);
+            table->num_of_rows++;
+        }
+
+        if (ret_val == NO_ERROR)
+            ret_val = enforce_memory_budget(table, -1);
+    }
+
+    if (ret_val == NO_ERROR && fseeko(checkpoint->pages_file, 0, SEEK_END) != 0)
+        ret_val = IO_ERROR;
+
+    if (ret_val == NO_ERROR)
+    {
+        checkpoint->file_size = (long long int)ftello(checkpoint->pages_file);
+        checkpoint->resumed = true;
+    }
+
+    return ret_val;
 }
 
-int allocate_cells(Row *row)
+int write_checkpoint_manifest(Checkpoint *checkpoint, Table *table, long long int next_command, Selector *selector, Selector *temp_selector, TempVariableStore *temp_var_store)
 {
     /**
-     * @brief Allocate cells in row
-     *
-     * Allocate cell array in instance of #Row structure or extend existing one
+     * @brief Write manifest of checkpoint to temporary file which then replace old manifest
      *
-     * @param row Pointer to instance of #Row structure
+     * @param checkpoint Pointer to instance of #Checkpoint structure with saved pages
+     * @param table Pointer to instance of #Table structure
+     * @param next_command Index of first command that wasnt executed
+     * @param selector Pointer to current selector
+     * @param temp_selector Pointer to current temporary selector
+     * @param temp_var_store Pointer to current temporary variables
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    if (row->cells == NULL)
+    int ret_val = NO_ERROR;
+
+    char *temp_path = (char*)malloc((strlen(checkpoint->path) + strlen(TEMP_FILE_SUFFIX) + 1) * sizeof(char));
+    if (temp_path == NULL)
+        return ALLOCATION_FAILED;
+
+    strcpy(temp_path, checkpoint->path);
+    strcat(temp_path, TEMP_FILE_SUFFIX);
+
+    FILE *file = fopen(temp_path, "wb");
+    if (file == NULL)
     {
-        row->cells = (Cell*)malloc(BASE_NUMBER_OF_CELLS * sizeof(Cell));
-        if (row->cells == NULL)
-            return ALLOCATION_FAILED;
+        free(temp_path);
+        return CANT_OPEN_FILE;
+    }
 
-        row->num_of_cells = 0;
-        row->allocated_cells = BASE_NUMBER_OF_CELLS;
+    if (fwrite(CHECKPOINT_MAGIC, sizeof(char), sizeof(CHECKPOINT_MAGIC) - 1, file) != sizeof(CHECKPOINT_MAGIC) - 1 ||
+        fwrite(&checkpoint->script_hash, sizeof(checkpoint->script_hash), 1, file) != 1 ||
+        fwrite(&checkpoint->generation, sizeof(checkpoint->generation), 1, file) != 1 ||
+        fwrite(&next_command, sizeof(next_command), 1, file) != 1 ||
+        fwrite(selector, sizeof(Selector), 1, file) != 1 || fwrite(temp_selector, sizeof(Selector), 1, file) != 1)
+    {
+        ret_val = IO_ERROR;
     }
-    else
+
+    for (long long int i = 0; (i < NUMBER_OF_TEMPORARY_VARIABLES) && (ret_val == NO_ERROR); i++)
     {
-        Cell *tmp = (Cell*)realloc(row->cells, (row->allocated_cells + BASE_NUMBER_OF_CELLS) * sizeof(Cell));
-        if (tmp == NULL)
-            return ALLOCATION_FAILED;
+        char *variable = temp_var_store->variables[i];
+        long long int length = (variable != NULL) ? (long long int)strlen(variable) : -1;
 
-        row->allocated_cells += BASE_NUMBER_OF_CELLS;
-        row->cells = tmp;
+        if (fwrite(&length, sizeof(length), 1, file) != 1 || (length > 0 && fwrite(variable, sizeof(char), length, file) != (size_t)length))
+            ret_val = IO_ERROR;
     }
 
-    // Set default values
-    for (long long int i = row->num_of_cells; i < row->allocated_cells; i++)
+    FormulaStore *formulas = &table->formulas;
+
+    if (ret_val == NO_ERROR &&
+        (fwrite(&table->num_of_rows, sizeof(table->num_of_rows), 1, file) != 1 ||
+         fwrite(&table->num_of_col_types, sizeof(table->num_of_col_types), 1, file) != 1 ||
+         (table->num_of_col_types > 0 && fwrite(table->col_types, sizeof(unsigned char), table->num_of_col_types, file) != (size_t)table->num_of_col_types) ||
+         fwrite(&formulas->num_of_formulas, sizeof(formulas->num_of_formulas), 1, file) != 1 ||
+         (formulas->num_of_formulas > 0 && fwrite(formulas->formulas, sizeof(Formula), formulas->num_of_formulas, file) != (size_t)formulas->num_of_formulas) ||
+         fwrite(&checkpoint->num_of_pages, sizeof(checkpoint->num_of_pages), 1, file) != 1 ||
+         (checkpoint->num_of_pages > 0 && fwrite(checkpoint->pages, sizeof(CheckpointPage), checkpoint->num_of_pages, file) != (size_t)checkpoint->num_of_pages)))
     {
-        row->cells[i].content = NULL;
-        row->cells[i].allocated_chars = 0;
+        ret_val = IO_ERROR;
     }
 
-    return NO_ERROR;
+    // Manifest has to be on disk before it replaces old one
+    if (ret_val == NO_ERROR && (fflush(file) != 0 || fsync(fileno(file)) != 0))
+        ret_val = IO_ERROR;
+
+    if (fclose(file) != 0 && ret_val == NO_ERROR)
+        ret_val = IO_ERROR;
+
+    if (ret_val == NO_ERROR && rename(temp_path, checkpoint->path) != 0)
+        ret_val = IO_ERROR;
+
+    if (ret_val != NO_ERROR)
+        remove(temp_path);
+
+    free(temp_path);
+
+    return ret_val;
 }
 
-int allocate_content(Cell *cell)
+int save_checkpoint(Checkpoint *checkpoint, Table *table, long long int next_command, Selector *selector, Selector *temp_selector, TempVariableStore *temp_var_store)
 {
     /**
-     * @brief Allocate content in cell
+     * @brief Save checkpoint of table and state of execution
      *
-     * Allocate content (char array) in instance of #Cell strucutre or extend existing one
+     * Pages whose hash didnt change since their last record are not written again (only their offset is kept in manifest) \n
+     * When pages file grows #CHECKPOINT_COMPACT_RATIO times over size of last records, all pages are written to pages file of next generation
+     * and old one is removed after new manifest replaces old one
      *
-     * @param cell Pointer to instance of #Cell structure
+     * @param checkpoint Pointer to instance of #Checkpoint structure
+     * @param table Pointer to instance of #Table structure
+     * @param next_command Index of first command that wasnt executed
+     * @param selector Pointer to current selector
+     * @param temp_selector Pointer to current temporary selector
+     * @param temp_var_store Pointer to current temporary variables
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    if (cell->content == NULL)
+    int ret_val = NO_ERROR;
+    long long int num_of_pages = (table->num_of_rows + ROWS_PER_PAGE - 1) / ROWS_PER_PAGE;
+
+    if ((ret_val = reserve_checkpoint_pages(checkpoint, num_of_pages)) != NO_ERROR)
+        return ret_val;
+
+    // Pages that table didnt have in last checkpoint have no record
+    for (long long int page = checkpoint->num_of_pages; page < num_of_pages; page++)
+        checkpoint->pages[page].offset = -1;
+    checkpoint->num_of_pages = num_of_pages;
+
+    long long int live_size = 0;
+    for (long long int page = 0; page < num_of_pages; page++)
+        if (checkpoint->pages[page].offset >= 0)
+            live_size += checkpoint->pages[page].size;
+
+    long long int old_generation = checkpoint->generation;
+    _Bool compact = (checkpoint->pages_file == NULL || checkpoint->file_size > CHECKPOINT_COMPACT_RATIO * live_size);
+
+    if (compact)
     {
-        cell->content = (char*)malloc(BASE_CELL_LENGTH * sizeof(char));
-        if (cell->content == NULL)
-            return ALLOCATION_FAILED;
+        if (checkpoint->pages_file != NULL)
+            fclose(checkpoint->pages_file);
 
-        cell->allocated_chars = BASE_CELL_LENGTH * sizeof(char);
-        memset(cell->content, 0, cell->allocated_chars);
+        checkpoint->generation++;
+        checkpoint->file_size = 0;
+
+        char *pages_path = checkpoint_pages_path(checkpoint->path, checkpoint->generation);
+        checkpoint->pages_file = (pages_path != NULL) ? fopen(pages_path, "w+b") : NULL;
+        free(pages_path);
+
+        if (checkpoint->pages_file == NULL)
+        {
+            checkpoint->generation = old_generation;
+            return CANT_OPEN_FILE;
+        }
     }
-    else
+    else if (fseeko(checkpoint->pages_file, (off_t)checkpoint->file_size, SEEK_SET) != 0)
+        ret_val = IO_ERROR;
+
+    for (long long int page = 0; (page < num_of_pages) && (ret_val == NO_ERROR); page++)
     {
-        char *temp = NULL;
-        if (string_copy(&cell->content, &temp) != NO_ERROR)
-            return ALLOCATION_FAILED;
+        uint64_t hash = hash_page(table, page);
+        CheckpointPage *record = &checkpoint->pages[page];
 
-        char *tmp = (char*)realloc(cell->content, (cell->allocated_chars + BASE_CELL_LENGTH) * sizeof(char));
-        if (tmp == NULL)
+        if (!compact && record->offset >= 0 && record->hash == hash)
+            continue;
+
+        long long int first = page * ROWS_PER_PAGE;
+        long long int num_of_rows = (table->num_of_rows - first < ROWS_PER_PAGE) ? table->num_of_rows - first : ROWS_PER_PAGE;
+
+        if (fwrite(&page, sizeof(page), 1, checkpoint->pages_file) != 1 ||
+            fwrite(&num_of_rows, sizeof(num_of_rows), 1, checkpoint->pages_file) != 1)
+        {
+            ret_val = IO_ERROR;
+            break;
+        }
+
+        for (long long int r = first; (r < first + num_of_rows) && (ret_val == NO_ERROR); r++)
+            ret_val = write_row_binary(get_row(table, r), checkpoint->pages_file);
+
+        off_t end = ftello(checkpoint->pages_file);
+        if (ret_val == NO_ERROR && end < 0)
+            ret_val = IO_ERROR;
+
+        if (ret_val == NO_ERROR)
+        {
+            record->offset = checkpoint->file_size;
+            record->size = (long long int)end - checkpoint->file_size;
+            record->hash = hash;
+            checkpoint->file_size = (long long int)end;
+        }
+
+        // Hashing and writing fault spilled pages, so budget is enforced after each page
+        if (ret_val == NO_ERROR)
+            ret_val = enforce_memory_budget(table, -1);
+    }
+
+    // Pages have to be on disk before manifest points to them
+    if (ret_val == NO_ERROR && (fflush(checkpoint->pages_file) != 0 || fsync(fileno(checkpoint->pages_file)) != 0))
+        ret_val = IO_ERROR;
+
+    if (ret_val == NO_ERROR)
+        ret_val = write_checkpoint_manifest(checkpoint, table, next_command, selector, temp_selector, temp_var_store);
+
+    if (ret_val != NO_ERROR)
+    {
+        // Records of pages could be written only partialy, so next checkpoint starts new generation
+        fclose(checkpoint->pages_file);
+        checkpoint->pages_file = NULL;
+
+        if (compact)
         {
-            free(temp);
-            return ALLOCATION_FAILED;
+            char *pages_path = checkpoint_pages_path(checkpoint->path, checkpoint->generation);
+            if (pages_path != NULL)
+                remove(pages_path);
+            free(pages_path);
+
+            checkpoint->generation = old_generation;
         }
 
-        cell->allocated_chars += BASE_CELL_LENGTH;
-        cell->content = tmp;
+        return ret_val;
+    }
 
-        memset(cell->content, 0, cell->allocated_chars);
-        strcpy(cell->content, temp);
-        free(temp);
+    // Old generation isnt used by new manifest anymore
+    if (compact && old_generation > 0)
+    {
+        char *pages_path = checkpoint_pages_path(checkpoint->path, old_generation);
+        if (pages_path != NULL)
+            remove(pages_path);
+        free(pages_path);
     }
 
+    checkpoint->last_time = monotonic_seconds();
+
     return NO_ERROR;
 }
 
-long long int get_line(char **line_buffer, FILE *file)
+_Bool command_reads_formulas(Command *command)
 {
     /**
-     * @brief Load one line from file
-     *
-     * Load one line from file and save it to buffer
+     * @brief Check if @p command can read values of formula cells, so formulas have to be recalculated before it
      *
-     * @param line_buffer Empty pointer to char pointer where will be saved loaded line
-     * @param file Pointer to file from which will be line loaded
+     * @param command Pointer to instance of #Command structure
      *
-     * @return Number of alloacated bits in memory or -1 when there is nothing else to load
+     * @return true if formulas have to be recalculated before command, false if not
      */
 
-    int c;
-    long long int index = 0;
-    long long int allocated = 16;
+    return !strings_equal(command->function, "set") && !strings_equal(command->function, "clear") &&
+        get_type_of_command(command) != TABLE_EDITING_COMMAND;
+}
 
-    *line_buffer = NULL;
+int execute_typed_command(Table *table, Selector *selector, Command *command, int type, TempVariableStore *temp_var_store)
+{
+    /**
+     * @brief Execute one command (that isnt selector) on @p table
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure with current selection
+     * @param command Pointer to instance of #Command structure
+     * @param type Type of @p command from #CommandType
+     * @param temp_var_store Pointer to instance of #TempVariableStore structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
 
-    *line_buffer = (char*)malloc(allocated);
-    if (!*line_buffer)
-        return 0;
+    int ret_val = NO_ERROR;
 
-    while ((c = fgetc(file)) != '\n' && c != EOF)
+    switch (type)
     {
-        // Save loaded char to char array
-        (*line_buffer)[index++] = (char)c;
-
-        // If there is no space in allocated array try to reallocate it to larger array
-        // +1 for end string bit
-        if (index + 1 >= allocated)
-        {
-            char *tmp = (char*)realloc (*line_buffer, allocated + 16);
+        case TABLE_EDITING_COMMAND:
+            ret_val = execute_table_editing_comm(table, selector, command);
+            break;
 
-            // If reallocating failed free already used memory and return
-            if (!tmp)
+        case DATA_EDITING_COMMAND:
+            if (table->num_of_rows > 0 && get_row(table, 0)->num_of_cells > 0)
             {
-                free(*line_buffer);
-                *line_buffer = NULL;
-                return 0;
+                if (table->shard != NULL)
+                {
+                    // Selector holds rows of whole table, shard aggregates only its own rows
+                    Selector shard_selector = *selector;
+                    shard_localize_selector(table, &shard_selector);
+                    ret_val = execute_data_editing_command(table, &shard_selector, command);
+                }
+                else
+                    ret_val = execute_data_editing_command(table, selector, command);
             }
+            break;
 
-            *line_buffer = tmp;
-            allocated += 16;
-        }
-    }
-
-    // To the end add end string bit
-    (*line_buffer)[index] = 0;
+        case TEMP_VAR_COMMAND:
+            if (table->num_of_rows > 0 && get_row(table, 0)->num_of_cells > 0)
+                ret_val = execute_temp_var_command(table, selector, command, temp_var_store);
+            break;
 
-    // If we are here and no char is saved and current char in buffer is eof then there is nothing to load
-    if (index == 0 && c == EOF) {
-        free (*line_buffer);
-        *line_buffer = NULL;
-        return -1;
+        default:
+            ret_val = COMMAND_ERROR;
     }
 
-    return allocated;
+    if (ret_val != NO_ERROR)
+        return ret_val;
+
+    // Command could grow cells of resident pages over memory budget
+    return enforce_memory_budget(table, -1);
 }
 
-int get_commands(char *argv[], Raw_commands *commands_store, _Bool delim_flag_present)
+int execute_commands(Table *table, Commands *base_commands_store, Checkpoint *checkpoint)
 {
     /**
-     * @brief Get raw commands
+     * @brief Execute commands on @p table
      *
-     * Get command string for aguments and open it as file and parse it to individual commands or parse the argument as individual commands
+     * Iterate over all commands in @p base_commands_store and parse them and execute them on @p table \n
+     * State of execution is periodically saved to @p checkpoint, when it was loaded from checkpoint execution continues where it was saved
      *
-     * @param argv Array of arguments
-     * @param commands_store Pointer to instance of #Raw_commands structure where individual commands will be saved
-     * @param delim_flag_present Flag if in argument is delim flag (only for calculating proper position of commands argument)
+     * @param table Pointer to instance of #Table structure
+     * @param base_commands_store Pointer to instance of #Commands structure
+     * @param checkpoint Pointer to instance of #Checkpoint structure (NULL if checkpoints are disabled)
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    char *raw_commands = delim_flag_present ? argv[3] : argv[1];
-    long long int num_of_commands = 0;
+    int ret_val = NO_ERROR;
 
-    if (string_start_with(raw_commands, "-c"))
-    {
-        // Raw commands are path to command file
-        // Parse commands from commands file
+    Selector selector = { .initialized = false };
+    Selector temp_selector = { .initialized = false };
+    init_selector(&selector);
+    init_selector(&temp_selector);
 
-        // Trim out prefix
-        size_t len = strlen(raw_commands);
-        memmove(raw_commands, raw_commands + 2, len - 1);
+    TempVariableStore temp_var_store = { .variables = NULL };
+    if (init_temp_var_store(&temp_var_store) != NO_ERROR)
+        return ALLOCATION_FAILED;
 
-        // Try to open command file
-        FILE *file = fopen(raw_commands, "r");
-        if (file == NULL)
-            return CANT_OPEN_FILE;
+    long long int first_command = 0;
 
-        char *line = NULL;
+    if (checkpoint != NULL && checkpoint->resumed)
+    {
+        first_command = checkpoint->next_command;
+        copy_selector(&checkpoint->selector, &selector);
+        copy_selector(&checkpoint->temp_selector, &temp_selector);
+        selector.initialized = checkpoint->selector.initialized;
+        temp_selector.initialized = checkpoint->temp_selector.initialized;
 
-        // Count number of lines (commands because individual commands are on separated lines)
-        while (get_line(&line, file) != -1)
+        // Variables are moved to store, so they are deallocated only once
+        for (long long int i = 0; i < NUMBER_OF_TEMPORARY_VARIABLES; i++)
         {
-            rm_newline_chars(line);
-            if (line[0] != '\0')
-                num_of_commands++;
-
-            free(line);
-            line = NULL;
+            temp_var_store.variables[i] = checkpoint->variables[i];
+            checkpoint->variables[i] = NULL;
         }
+    }
 
-        // Rewind to start of file
-        rewind(file);
+    for (long long int i = first_command; i < base_commands_store->num_of_commands; i++)
+    {
+        Command c_comm = base_commands_store->commands[i];
 
-        if (allocate_raw_commands(commands_store, num_of_commands) != NO_ERROR)
-            return ALLOCATION_FAILED;
+        // Formulas are recalculated lazily before command that can read them
+        if (command_reads_formulas(&c_comm) && (ret_val = recalculate_formulas(table)) != NO_ERROR)
+            break;
 
-        long long int i = 0;
-        while (get_line(&line, file) != -1)
+        if (is_command_selector(&c_comm))
         {
-            rm_newline_chars(line);
-            if (line[0] == '\0')
-            {
-                free(line);
-                line = NULL;
-                continue;
-            }
+            // Set new selector
+            if ((ret_val = set_selector(&selector, &temp_selector, &c_comm, table)) != NO_ERROR)
+                break;
+            continue;
+        }
 
-            commands_store->commands[i] = line;
-            line = NULL;
+#ifdef DEBUG
+        printf("Current selector: [%llu,%llu,%llu,%llu]\n", selector.lld_ir1, selector.lld_ic1, selector.lld_ir2, selector.lld_ic2);
+        printf("Current command: [%s,%s]\n", c_comm.function, c_comm.arguments);
+        printf("Current variable store:\n[");
+        for (long long int j = 0; j < NUMBER_OF_TEMPORARY_VARIABLES; j++)
+        {
+            printf("_%llu:'%s',", j, temp_var_store.variables[j]);
+        }
+        printf("]\n\n");
+        printf("Before table:\n");
+        print_table(table);
+#endif
 
-            i++;
+        if ((ret_val = execute_typed_command(table, &selector, &c_comm, get_type_of_command(&c_comm), &temp_var_store)) != NO_ERROR)
+            break;
+
+        // Failed checkpoint doesnt stop execution, only next checkpoints are disabled
+        if (checkpoint != NULL && monotonic_seconds() - checkpoint->last_time >= CHECKPOINT_INTERVAL &&
+            save_checkpoint(checkpoint, table, i + 1, &selector, &temp_selector, &temp_var_store) != NO_ERROR)
+        {
+            fprintf(stdout, "[WARNING] Failed to save checkpoint, execution continues without checkpoints\n");
+            checkpoint = NULL;
         }
 
-        fclose(file);
+#ifdef DEBUG
+        printf("\n\nAfter variable store:\n[");
+        for (long long int j = 0; j < NUMBER_OF_TEMPORARY_VARIABLES; j++)
+        {
+            printf("_%llu:'%s',", j, temp_var_store.variables[j]);
+        }
+        printf("]\n");
+        printf("After table:\n");
+        print_table(table);
+        printf("\n#####################################################\n\n");
+#endif
     }
-    else
-    {
-        // Parse commands from argument
 
-        num_of_commands = count_char(raw_commands, ';', true) + 1;
-        char *command = NULL;
-        int ret_val;
+    deallocate_temp_var_store(&temp_var_store);
 
-        if (num_of_commands == 1 && strings_equal(raw_commands, EMPTY_CELL))
-            return NO_ERROR;
+    return ret_val;
+}
 
-        if (allocate_raw_commands(commands_store, num_of_commands) != NO_ERROR)
-            return ALLOCATION_FAILED;
+int compiled_select_area(CompiledEngine *engine, int num_of_parts, long long int r1, long long int c1, long long int r2, long long int c2)
+{
+    /**
+     * @brief Set selector of compiled script to area
+     *
+     * Parts are constants of compiled script, so only their ranges are checked against current table the same way as in set_selector()
+     *
+     * @param engine Pointer to instance of #CompiledEngine structure
+     * @param num_of_parts Number of parts of selector (2 or 4)
+     * @param r1 First part of selector (row)
+     * @param c1 Second part of selector (column)
+     * @param r2 Third part of selector (ignored by 2 parts selector)
+     * @param c2 Fourth part of selector (ignored by 2 parts selector)
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
 
-        for (long long int i = 0; i < num_of_commands; i++)
-        {
-            if ((ret_val = get_substring(raw_commands, &command, ';', i, true, NULL, false)) != NO_ERROR)
-                return ret_val;
+    CompiledContext *context = engine->context;
+    long long int parts[4] = { r1, c1, r2, c2 };
+    _Bool part_is_llint[4];
+    char *part_names[4];
 
-            commands_store->commands[i] = command;
-            command = NULL;
-        }
+    for (int i = 0; i < 4; i++)
+    {
+        part_is_llint[i] = parts[i] >= 1;
+        part_names[i] = (parts[i] == COMPILED_ALL_INDEX) ? "_" : "-";
     }
 
-    return NO_ERROR;
+    if (num_of_parts == 2 && !part_is_llint[0] && !part_is_llint[1])
+    {
+        // Static selections of set_selector()
+        if (r1 == COMPILED_ALL_INDEX && c1 == COMPILED_ALL_INDEX)
+            selector_select_all(&context->selector, context->table);
+        else if (r1 == COMPILED_LAST_INDEX && c1 == COMPILED_LAST_INDEX)
+            selector_select_last(&context->selector, context->table);
+        else if (r1 == COMPILED_ALL_INDEX)
+            selector_select_last_colm(&context->selector, context->table);
+        else
+            selector_select_last_row(&context->selector, context->table);
+
+        return NO_ERROR;
+    }
+
+    if (num_of_parts == 2)
+        return selector_select_2p_area(&context->selector, context->table, part_names, part_is_llint, parts);
+    if (num_of_parts == 4)
+        return selector_select_4p_area(&context->selector, context->table, part_names, part_is_llint, parts);
+
+    return SELECTOR_ERROR;
 }
 
-int parse_commands(Raw_commands *raw_command_store, Commands *base_command_store)
+int compiled_select(CompiledEngine *engine, const char *selector)
 {
     /**
-     * @brief Parse raw commands to base commands
-     *
-     * Split raw commands to function part and argument part
+     * @brief Set selector of compiled script by selector command
      *
-     * @param raw_command_store Pointer to instance of #Raw_commands structure where raw commands are stored
-     * @param base_command_store Pointer to instance #Commands structure where parsed commands will be stored
+     * @param engine Pointer to instance of #CompiledEngine structure
+     * @param selector Selector command (constant of compiled script)
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    if (raw_command_store == NULL)
-        return FUNCTION_ERROR;
+    CompiledContext *context = engine->context;
+    Command command = { .function = NULL, .arguments = NULL };
+    char *source = (char *)selector;
 
-    if (raw_command_store->num_of_commands != 0)
-    {
-        base_command_store->commands = (Command*)malloc(raw_command_store->num_of_commands * sizeof(Command));
-        if (base_command_store->commands == NULL)
-            return ALLOCATION_FAILED;
+    // Selector is trimmed in place, so copy of constant is used
+    if (string_copy(&source, &command.function) != NO_ERROR)
+        return ALLOCATION_FAILED;
 
-        base_command_store->num_of_commands = raw_command_store->num_of_commands;
+    int ret_val = set_selector(&context->selector, &context->temp_selector, &command, context->table);
 
-        for (long long int i = 0; i < base_command_store->num_of_commands; i++)
-        {
-            base_command_store->commands[i].function = NULL;
-            base_command_store->commands[i].arguments = NULL;
-        }
+    free(command.function);
 
-        char *substring_buf = NULL;
-        char *rest = NULL;
-        int ret_val;
+    return ret_val;
+}
 
-        for (long long int i = 0; i < raw_command_store->num_of_commands; i++)
-        {
-            // This is to not split find selector command
-            if (string_start_with(raw_command_store->commands[i], "[") && string_end_with(raw_command_store->commands[i], "]"))
-            {
-                if ((ret_val = get_substring(raw_command_store->commands[i], &substring_buf, '\0', 0, false, &rest, true)) != NO_ERROR)
-                    return ret_val;
-            }
-            else
-            {
-                if ((ret_val = get_substring(raw_command_store->commands[i], &substring_buf, ' ', 0, false, &rest, true)) != NO_ERROR)
-                    return ret_val;
-            }
+int compiled_execute(CompiledEngine *engine, int type, const char *function, const char *arguments)
+{
+    /**
+     * @brief Interpret command of compiled script that wasnt specialized when script was generated
+     *
+     * Temporary variables of compiled script are its locals, so interpreted temporary variable command (which has invalid argument)
+     * gets only empty variables
+     *
+     * @param engine Pointer to instance of #CompiledEngine structure
+     * @param type Type of command from #CommandType
+     * @param function Function of command (constant of compiled script)
+     * @param arguments Arguments of command (constant of compiled script, NULL if command has no arguments)
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
 
-            if (rest != NULL && strings_equal(rest, EMPTY_CELL))
-            {
-                free(rest);
-                rest = NULL;
-            }
+    CompiledContext *context = engine->context;
+    Command command = { .function = NULL, .arguments = NULL };
+    char *sources[2] = { (char *)function, (char *)arguments };
+    char *variables[NUMBER_OF_TEMPORARY_VARIABLES] = { NULL };
+    TempVariableStore temp_var_store = { .variables = variables };
 
-            base_command_store->commands[i].function = substring_buf;
-            base_command_store->commands[i].arguments = rest;
+    // Commands can change their strings in place, so copies of constants are executed
+    int ret_val = string_copy(&sources[0], &command.function);
+    if (ret_val == NO_ERROR && arguments != NULL)
+        ret_val = string_copy(&sources[1], &command.arguments);
+
+    if (ret_val == NO_ERROR)
+        ret_val = execute_typed_command(context->table, &context->selector, &command, type, &temp_var_store);
 
-            substring_buf = NULL;
-            rest = NULL;
-        }
-    }
+    for (long long int i = 0; i < NUMBER_OF_TEMPORARY_VARIABLES; i++)
+        free(variables[i]);
+    free(command.function);
+    free(command.arguments);
 
-    return NO_ERROR;
+    return ret_val;
 }
 
-int parse_command_argument(char *command_argument, long long int **output_indexes, Table *table)
+int compiled_recalculate(CompiledEngine *engine)
 {
     /**
-     * @brief Parse command arguments
-     *
-     * Split command arguments, convert them to numbers and return as array
+     * @brief Recalculate formula cells of table of compiled script
      *
-     * @param command_argument String with command arguments
-     * @param output_indexes Pointer to output array of parsed arguments
-     * @param table Pointer to instance of #Table structure for checking if values in argument are right
+     * @param engine Pointer to instance of #CompiledEngine structure
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    int ret_val = NO_ERROR;
+    CompiledContext *context = engine->context;
 
-    if (!string_start_with(command_argument, "[") || !string_end_with(command_argument, "]"))
-        return COMMAND_ERROR;
+    return recalculate_formulas(context->table);
+}
 
-    if ((ret_val = trim_se(command_argument)) != NO_ERROR)
-        return ret_val;
+int compiled_edit(CompiledEngine *engine, int command, const char *arguments)
+{
+    /**
+     * @brief Execute table editing command of compiled script
+     *
+     * @param engine Pointer to instance of #CompiledEngine structure
+     * @param command Index of command in #TABLE_EDITING_COMMANDS
+     * @param arguments Arguments of command (constant of compiled script, NULL if command has no arguments)
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
 
-    long long int num_of_parts = count_char(command_argument, ',', true) + 1;
-    if (num_of_parts != 2)
-        return COMMAND_ERROR;
+    CompiledContext *context = engine->context;
 
-    if (table->num_of_rows == 0 || table->rows[0].num_of_cells == 0)
-        return FUNCTION_ERROR;
+    int ret_val = execute_table_editing_index(context->table, &context->selector, command, (char *)arguments);
+    if (ret_val != NO_ERROR)
+        return ret_val;
 
-    char *parts[2] = { NULL };
-    long long int *indexes = (long long int*)malloc(2 * sizeof(long long int));
-    if (indexes == NULL)
-        return ALLOCATION_FAILED;
+    return enforce_memory_budget(context->table, -1);
+}
 
-    memset(indexes, 0, 2 * sizeof(long long int));
+Selector *compiled_data_selector(CompiledContext *context, Selector *shard_selector)
+{
+    /**
+     * @brief Get selector for data editing command of compiled script, same as execute_typed_command() does
+     *
+     * @param context Pointer to instance of #CompiledContext structure
+     * @param shard_selector Pointer to instance of #Selector structure where selector localized to shard is saved
+     *
+     * @return Pointer to selector for command, NULL when table is empty and command isnt executed
+     */
 
-    for (long long int i = 0; i < num_of_parts; i++)
-    {
-        if ((ret_val = get_substring(command_argument, &parts[i], ',', i, true, NULL, false)) != NO_ERROR)
-            break;
+    Table *table = context->table;
 
-        if (is_string_llint(parts[i]))
-        {
-            if ((ret_val = string_to_llint(parts[i], &indexes[i])) != NO_ERROR)
-                break;
-        }
-        else
-        {
-            if (strings_equal(parts[i], "-"))
-                indexes[i] = (i == 0) ? table->num_of_rows : table->rows[0].num_of_cells;
-            else
-            {
-                ret_val = COMMAND_ERROR;
-                break;
-            }
-        }
-    }
+    if (table->num_of_rows == 0 || get_row(table, 0)->num_of_cells == 0)
+        return NULL;
 
-    for (int i = 0; i < num_of_parts; i++)
-    {
-        free(parts[i]);
-        indexes[i] -= 1;
+    if (table->shard == NULL)
+        return &context->selector;
 
-        if (ret_val == NO_ERROR)
-            if ((indexes[i]) < 0 || indexes[i] >= (((i == 0) ? table->num_of_rows : table->rows[0].num_of_cells)))
-                ret_val = COMMAND_ERROR;
-    }
+    // Selector holds rows of whole table, shard aggregates only its own rows
+    *shard_selector = context->selector;
+    shard_localize_selector(table, shard_selector);
 
-    (*output_indexes) = indexes;
-    return ret_val;
+    return shard_selector;
 }
 
-void print_table(Table *table)
+int compiled_set(CompiledEngine *engine, const char *value)
 {
     /**
-     * @brief Print table to console
+     * @brief Set @p value to area selected by compiled script (commands set STR and clear)
      *
-     * Debug functing for printing loaded table to console
-     * @todo Remove
+     * @param engine Pointer to instance of #CompiledEngine structure
+     * @param value Value that is set (constant of compiled script)
      *
-     * @param table Pointer to instance of #Table structure
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    if (table->rows == NULL)
-        return;
-
-    for (long long int i = 0; i < table->num_of_rows; i++)
-    {
-        if (table->rows[i].cells == NULL)
-            return;
+    CompiledContext *context = engine->context;
+    Selector shard_selector;
+    Selector *selector = compiled_data_selector(context, &shard_selector);
+    if (selector == NULL)
+        return NO_ERROR;
 
-        for (long long int j = 0; j < table->rows[i].num_of_cells; j++)
-        {
-            if (table->rows[i].cells[j].content != NULL)
-            {
-                printf("%s", table->rows[i].cells[j].content);
-                if (j < (table->rows[i].num_of_cells - 1))
-                    printf("%c", table->delim);
-            }
-        }
+    int ret_val = set_value_in_area(context->table, selector, (char *)value);
+    if (ret_val != NO_ERROR)
+        return ret_val;
 
-        printf("\n");
-    }
+    return enforce_memory_budget(context->table, -1);
 }
 
-int save_table(Table *table, char *path)
+int median_cells(Table *table, Selector *selector, long long int r, long long int c)
 {
     /**
-     * @brief Save table to file
+     * @brief Save median of selected cells to cell on [@p r, @p c]
+     *
+     * @param table Pointer to instance of #Table structure
+     * @param selector Pointer to instance of #Selector structure
+     * @param r Index of row of target cell
+     * @param c Index of column of target cell
      *
-     * Iterate over table and write to file its content
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    return quantile_cells(table, selector, 0.5L, r, c);
+}
+
+int distinct_cells(Table *table, Selector *selector, long long int r, long long int c)
+{
+    /**
+     * @brief Save approximate number of distinct selected cells to cell on [@p r, @p c]
      *
      * @param table Pointer to instance of #Table structure
-     * @param path Path to output file
+     * @param selector Pointer to instance of #Selector structure
+     * @param r Index of row of target cell
+     * @param c Index of column of target cell
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    // Try to open output file
-    FILE *file = fopen(path, "w");
-    if (file == NULL)
-        return CANT_OPEN_FILE;
+    return sketch_cells(table, selector, true, 0, r, c);
+}
 
-    for (long long int i = 0; i < table->num_of_rows; i++)
-    {
-        // This only means that there is no data left
-        if (table->rows[i].cells == NULL)
-        {
-            fclose(file);
-            return NO_ERROR;
-        }
+int compiled_cell_command(CompiledEngine *engine, int (*function)(Table *, Selector *, long long int, long long int), _Bool writes_formula,
+                          long long int row, long long int col)
+{
+    /**
+     * @brief Execute command of compiled script with argument [R,C]
+     *
+     * Argument was parsed when script was generated, so only its range is checked against current table the same way as in parse_command_argument()
+     *
+     * @param engine Pointer to instance of #CompiledEngine structure
+     * @param function Function that executes command
+     * @param writes_formula Flag if command writes to target cell that can be read by formulas
+     * @param row Row of target cell from 1 (#COMPILED_LAST_INDEX for last row)
+     * @param col Column of target cell from 1 (#COMPILED_LAST_INDEX for last column)
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
 
-        for (long long int j = 0; j < table->rows[i].num_of_cells; j++)
-        {
-            if (table->rows[i].cells[j].content != NULL)
-            {
-                fprintf(file, "%s", table->rows[i].cells[j].content);
-                if (j < (table->rows[i].num_of_cells - 1))
-                    fprintf(file, "%c", table->delim);
-            }
-        }
+    CompiledContext *context = engine->context;
+    Table *table = context->table;
+    Selector shard_selector;
+    Selector *selector = compiled_data_selector(context, &shard_selector);
+    if (selector == NULL)
+        return NO_ERROR;
 
-        fprintf(file, "\n");
-    }
+    long long int num_of_rows = get_number_of_rows(table);
+    long long int num_of_cols = get_row(table, 0)->num_of_cells;
+    long long int r = ((row == COMPILED_LAST_INDEX) ? num_of_rows : row) - 1;
+    long long int c = ((col == COMPILED_LAST_INDEX) ? num_of_cols : col) - 1;
 
-    fclose(file);
+    if (r < 0 || r >= num_of_rows || c < 0 || c >= num_of_cols)
+        return COMMAND_ERROR;
 
-    return NO_ERROR;
+    int ret_val = function(table, selector, r, c);
+    if (ret_val == NO_ERROR && writes_formula)
+        ret_val = formula_cells_written(table, r, c, r, c);
+    if (ret_val != NO_ERROR)
+        return ret_val;
+
+    return enforce_memory_budget(table, -1);
 }
 
-_Bool check_sanity_of_delims(char *delims)
+int compiled_swap(CompiledEngine *engine, long long int row, long long int col)
 {
     /**
-     * @brief Check delims
-     *
-     * Check if in delims are no blacklisted characters
-     *
-     * @param delims Array of deliminators
-     *
-     * @return true if deliminator are without blacklisted characters else false
+     * @brief Execute swap [R,C] of compiled script (see compiled_cell_command())
      */
 
-    size_t length_of_delims = strlen(delims);
-    size_t length_of_blacklisted_delims = strlen(BLACKLISTED_DELIMS);
+    return compiled_cell_command(engine, swap_cells, false, row, col);
+}
 
-    for (size_t i = 0; i < length_of_delims; i++)
-    {
-        for (size_t j = 0; j < length_of_blacklisted_delims; j++)
-        {
-            if (delims[i] == BLACKLISTED_DELIMS[j])
-                return false;
-        }
-    }
+int compiled_sum(CompiledEngine *engine, long long int row, long long int col)
+{
+    /**
+     * @brief Execute sum [R,C] of compiled script (see compiled_cell_command())
+     */
 
-    return true;
+    return compiled_cell_command(engine, sum_cells, true, row, col);
 }
 
-int add_backslashes(Cell *cell)
+int compiled_avg(CompiledEngine *engine, long long int row, long long int col)
 {
     /**
-     * @brief Add backslashes to cell if its needed
-     *
-     * @param cell Pointer to instance of #Cell structure that we want edit
-     *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @brief Execute avg [R,C] of compiled script (see compiled_cell_command())
      */
 
-    unsigned long long int length_of_string = strlen(cell->content);
-    int occurences = 0;
-    for (unsigned long long int i = 0; i < length_of_string; i++)
-    {
-        char c = cell->content[i];
-        if (c == '\\' || c == '\"')
-        {
-            if ((unsigned long long int)cell->allocated_chars <= (length_of_string + 1))
-                if (allocate_content(cell) != NO_ERROR)
-                    return ALLOCATION_FAILED;
+    return compiled_cell_command(engine, avg_cells, true, row, col);
+}
 
-            memmove(cell->content + i + 1, cell->content + i, strlen(cell->content + i));
-            cell->content[i] = '\\';
-            occurences++;
-            length_of_string++;
-            i++;
-            cell->content[length_of_string - occurences + 2] = '\0';
-        }
-    }
+int compiled_count(CompiledEngine *engine, long long int row, long long int col)
+{
+    /**
+     * @brief Execute count [R,C] of compiled script (see compiled_cell_command())
+     */
 
-    return NO_ERROR;
+    return compiled_cell_command(engine, count_cells, true, row, col);
 }
 
-int filter_string(char *string)
+int compiled_len(CompiledEngine *engine, long long int row, long long int col)
 {
     /**
-     * @brief Filter special characters from string
-     *
-     * @param string String to filter
-     *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @brief Execute len [R,C] of compiled script (see compiled_cell_command())
      */
 
-    int ret_val = NO_ERROR;
+    return compiled_cell_command(engine, cell_len, true, row, col);
+}
 
-    // If string string have parentecies on the both sides then trim them
-    if ((string_start_with(string, "\"") && string_end_with(string, "\"")) ||
-        (string_start_with(string, "\'") && string_end_with(string, "\'")))
-    {
-        if ((ret_val = trim_se(string)) != NO_ERROR)
-            return ret_val;
-    }
+int compiled_median(CompiledEngine *engine, long long int row, long long int col)
+{
+    /**
+     * @brief Execute median [R,C] of compiled script (see compiled_cell_command())
+     */
 
-    // Remove backslashes that are not in use
-    unsigned long long int lenghth_of_string = strlen(string);
-    for (unsigned long long int i = 0; i < lenghth_of_string; i++)
-    {
-        char c = string[i];
+    return compiled_cell_command(engine, median_cells, false, row, col);
+}
 
-        if (c == '\\' && (i + 1) < lenghth_of_string && (string[i + 1] != '\\' || string[i + 1] != '\"'))
-        {
-            memmove(string + i, string + i + 1, strlen(string + i));
-        }
-    }
+int compiled_distinct(CompiledEngine *engine, long long int row, long long int col)
+{
+    /**
+     * @brief Execute distinct [R,C] of compiled script (see compiled_cell_command())
+     */
 
-    return NO_ERROR;
+    return compiled_cell_command(engine, distinct_cells, false, row, col);
 }
 
-int filter_table(Table *table)
+int compiled_window(CompiledEngine *engine, int function, long long int window, long long int col)
 {
     /**
-     * @brief Filter special characters from all cells in table
+     * @brief Execute cumsum [C], mavg [W,C], mmin [W,C] or mmax [W,C] of compiled script
      *
-     * @param table Pointer to instance of #Table structure
+     * @param engine Pointer to instance of #CompiledEngine structure
+     * @param function Function of window_cells() (0 for cumsum)
+     * @param window Size of window (ignored by cumsum)
+     * @param col Target column from 1
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    int ret_val = NO_ERROR;
+    CompiledContext *context = engine->context;
+    Selector shard_selector;
+    Selector *selector = compiled_data_selector(context, &shard_selector);
+    if (selector == NULL)
+        return NO_ERROR;
 
-    for (long long int i = 0; (i < table->num_of_rows) && (ret_val == NO_ERROR); i++)
-    {
-        for (long long int j = 0; (j < table->rows[i].num_of_cells) && (ret_val == NO_ERROR); j++)
-        {
-            if ((ret_val = filter_string(table->rows[i].cells[j].content)) != NO_ERROR)
-                break;
+    // Same checks as in parse_window_argument()
+    if ((function > 0 && window < 1) || col < 1 || col > get_row(context->table, 0)->num_of_cells)
+        return COMMAND_ERROR;
 
-            if (is_string_ldouble(table->rows[i].cells[j].content) && string_start_with(table->rows[i].cells[j].content, " "))
-            {
-                while (string_start_with(table->rows[i].cells[j].content, " "))
-                {
-                    if ((ret_val = trim_start(table->rows[i].cells[j].content)) != NO_ERROR)
-                        break;
-                }
-            }
-        }
-    }
+    int ret_val = window_cells(context->table, selector, function, (function > 0) ? window : 0, col - 1);
+    if (ret_val != NO_ERROR)
+        return ret_val;
 
-    return ret_val;
+    return enforce_memory_budget(context->table, -1);
 }
 
-int surround_with_dparentecies(Cell *cell)
+int compiled_topk(CompiledEngine *engine, long long int k, long long int col)
 {
     /**
-     * @brief Surround content of cell with parentecies
+     * @brief Execute topk [K,C] of compiled script
      *
-     * @param cell Pointer to instance of #Cell structure where content string is located
+     * @param engine Pointer to instance of #CompiledEngine structure
+     * @param k Number of kept rows
+     * @param col Column from 1 by which rows are ordered
      *
-     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    size_t lenght_of_cell = strlen(cell->content);
+    CompiledContext *context = engine->context;
+    Selector shard_selector;
+    Selector *selector = compiled_data_selector(context, &shard_selector);
+    if (selector == NULL)
+        return NO_ERROR;
 
-    if ((unsigned long long int)cell->allocated_chars <= (lenght_of_cell + 3))
-    {
-        if (allocate_content(cell) != NO_ERROR)
-            return ALLOCATION_FAILED;
-    }
+    // Same checks as in parse_window_argument()
+    if (k < 1 || col < 1 || col > get_row(context->table, 0)->num_of_cells)
+        return COMMAND_ERROR;
 
-    memmove(cell->content + 1, cell->content, lenght_of_cell);
-    cell->content[0] = '\"';
-    cell->content[lenght_of_cell + 1] = '\"';
-    cell->content[lenght_of_cell + 2] = '\0';
+    int ret_val = top_cells(context->table, selector, k, col - 1);
+    if (ret_val != NO_ERROR)
+        return ret_val;
 
-    return NO_ERROR;
+    return enforce_memory_budget(context->table, -1);
 }
 
-int format_table_for_output(Table *table, const char *delims)
+int compiled_quantile(CompiledEngine *engine, int approximate, long double quantile, long long int row, long long int col)
 {
     /**
-     * @brief Format @p table for output
+     * @brief Execute quantile [Q,R,C] or aquantile [Q,R,C] of compiled script
      *
-     * @param table Pointer to instance of #Table structure that will be eddited
-     * @param delims Array of chars that was used as delims
+     * @param engine Pointer to instance of #CompiledEngine structure
+     * @param approximate Flag if quantile is approximated by sketch (aquantile)
+     * @param quantile Quantile from interval [0, 1]
+     * @param row Row of target cell from 1
+     * @param col Column of target cell from 1
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    int ret_val = NO_ERROR;
-    size_t number_of_delims = strlen(delims);
+    CompiledContext *context = engine->context;
+    Selector shard_selector;
+    Selector *selector = compiled_data_selector(context, &shard_selector);
+    if (selector == NULL)
+        return NO_ERROR;
 
-    for (long long int i = 0; (i < table->num_of_rows) && (ret_val == NO_ERROR); i++)
-    {
-        for (long long int j = 0; j < table->rows[i].num_of_cells; j++)
-        {
-            if ((ret_val = add_backslashes(&table->rows[i].cells[j])) != NO_ERROR)
-                break;
+    int ret_val = approximate ? sketch_cells(context->table, selector, false, quantile, row - 1, col - 1) :
+                                quantile_cells(context->table, selector, quantile, row - 1, col - 1);
+    if (ret_val != NO_ERROR)
+        return ret_val;
 
-            for (size_t k = 0; k < number_of_delims; k++)
-            {
-                if (count_char(table->rows[i].cells[j].content, delims[k], false) > 0)
-                {
-                    if ((ret_val = surround_with_dparentecies(&table->rows[i].cells[j])) != NO_ERROR)
-                        break;
-                }
-            }
-        }
-    }
-    return ret_val;
+    return enforce_memory_budget(context->table, -1);
 }
 
-int set_cell(char *string, Cell *cell)
+int compiled_def(CompiledEngine *engine, char **variable)
 {
     /**
-     * @brief Set value to cell content
-     *
-     * Try to allocate content in #Cell structure if content doesnt exist or rewrite existing data in it \n
-     * If content is too small then extend it
-     * @warning
-     * If there are some data in cell it will be rewritten
+     * @brief Execute def _X of compiled script
      *
-     * @param string String we want to set to cell
-     * @param cell Pointer to instance of #Cell structure
+     * @param engine Pointer to instance of #CompiledEngine structure
+     * @param variable Pointer to temporary variable (local of compiled script)
      *
-     * @return #NO_ERROR when setting value is successful or when allocation fails #ALLOCATION_FAILED
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    if (string == NULL)
-        return FUNCTION_ARGUMENT_ERROR;
+    CompiledContext *context = engine->context;
+    Table *table = context->table;
+    Selector *selector = &context->selector;
+    TempVariableStore temp_var_store = { .variables = variable };
 
-    if (cell->content == NULL)
-    {
-        // Allocate base cell
-        if (allocate_content(cell) != NO_ERROR)
-            return ALLOCATION_FAILED;
-    }
+    if (table->num_of_rows == 0 || get_row(table, 0)->num_of_cells == 0)
+        return NO_ERROR;
 
-    while ((strlen(string) + 1) > (unsigned long long)cell->allocated_chars)
-        if (allocate_content(cell) != NO_ERROR)
-            return ALLOCATION_FAILED;
+    if ((selector->lld_ir1 != selector->lld_ir2) || (selector->lld_ic1 != selector->lld_ic2))
+        return COMMAND_ERROR;
 
-    if (strcpy(cell->content, string) == NULL)
-        return FUNCTION_ERROR;
+    int ret_val = set_temporary_variable(table, selector, &temp_var_store, 0);
+    if (ret_val != NO_ERROR)
+        return ret_val;
 
-    return NO_ERROR;
+    return enforce_memory_budget(table, -1);
 }
 
-int set_value_in_area(Table *table, Selector *selector, char *string)
+int compiled_use(CompiledEngine *engine, char **variable)
 {
     /**
-     * @brief Set value of @p string in table area selected by @p selector in @p table
+     * @brief Execute use _X of compiled script
      *
-     * @param table Pointer to instance of #Table structure that will be eddited
-     * @param selector Pointer to instance of #Selector structure for selecting are where we will set values
-     * @param string String that we will set
+     * @param engine Pointer to instance of #CompiledEngine structure
+     * @param variable Pointer to temporary variable (local of compiled script)
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    int ret_val = NO_ERROR;
-    if (table->num_of_rows == 0 || table->rows[0].num_of_cells == 0 || string == NULL)
-        return COMMAND_ERROR;
+    CompiledContext *context = engine->context;
+    Table *table = context->table;
+    TempVariableStore temp_var_store = { .variables = variable };
 
-    for (long long int i = selector->lld_ir1; (i <= selector->lld_ir2) && (i < table->num_of_rows); i++)
-    {
-        for (long long j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < table->rows[i].num_of_cells); j++)
-        {
-            if ((ret_val = set_cell(string, &table->rows[i].cells[j])) != NO_ERROR)
-                return ret_val;
-        }
-    }
+    if (table->num_of_rows == 0 || get_row(table, 0)->num_of_cells == 0)
+        return NO_ERROR;
 
-    return ret_val;
+    int ret_val = set_cell_from_temporary_variable(table, &context->selector, &temp_var_store, 0);
+    if (ret_val != NO_ERROR)
+        return ret_val;
+
+    return enforce_memory_budget(table, -1);
 }
 
-int swap_cells(Table *table, Selector *selector, long long int r, long long int c)
+int compiled_inc(CompiledEngine *engine, char **variable)
 {
     /**
-     * @brief Swap cell with another one
-     *
-     * @warning
-     * If more than one cell is selected then all selected cells will be swaped row by row and then cell by cell
+     * @brief Execute inc _X of compiled script
      *
-     * @param table Pointer to instance of #Table structure where output data will be saved
-     * @param selector Pointer to instance of #Selector structure that tell us where to find data
-     * @param r Row index of base cell for swap
-     * @param c Column index of base cell for swap
+     * @param engine Pointer to instance of #CompiledEngine structure
+     * @param variable Pointer to temporary variable (local of compiled script)
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    if (r < 0 || r > (table->num_of_rows - 1) || c < 0 || c > (table->rows[0].num_of_cells - 1))
-        return FUNCTION_ARGUMENT_ERROR;
+    CompiledContext *context = engine->context;
+    Table *table = context->table;
+    TempVariableStore temp_var_store = { .variables = variable };
 
-    int ret_val = NO_ERROR;
+    if (table->num_of_rows == 0 || get_row(table, 0)->num_of_cells == 0)
+        return NO_ERROR;
 
-    for (long long int i = selector->lld_ir1; (i <= selector->lld_ir2) && (i < table->num_of_rows); i++)
-    {
-        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < table->rows[i].num_of_cells); j++)
-        {
-            if ((i == r) && (j == c))
-                continue;
+    int ret_val = increase_temporary_variable(&temp_var_store, 0);
+    if (ret_val != NO_ERROR)
+        return ret_val;
 
-            char *buff1 = NULL, *buff2 = NULL;
+    return enforce_memory_budget(table, -1);
+}
 
-            if (((ret_val = string_copy(&table->rows[r].cells[c].content, &buff1)) == NO_ERROR) && ((ret_val = string_copy(&table->rows[i].cells[j].content, &buff2)) == NO_ERROR))
-            {
-                ret_val = set_cell(buff2, &table->rows[r].cells[c]);
-                if (ret_val == NO_ERROR)
-                    ret_val = set_cell(buff1, &table->rows[i].cells[j]);
-            }
+void compiled_release(CompiledEngine *engine, char **variable)
+{
+    /**
+     * @brief Deallocate temporary variable of compiled script
+     *
+     * @param engine Pointer to instance of #CompiledEngine structure
+     * @param variable Pointer to temporary variable (local of compiled script)
+     */
 
-            free(buff1);
-            free(buff2);
+    (void)engine;
 
-            if (ret_val != NO_ERROR)
-                break;
-        }
+    free(*variable);
+    *variable = NULL;
+}
 
-        if (ret_val != NO_ERROR)
-            break;
+void write_c_string(FILE *file, const char *string)
+{
+    /**
+     * @brief Write @p string as C string literal
+     *
+     * Characters that arent printable are written as octal escapes, ? is escaped so literal doesnt contain trigraph
+     *
+     * @param file File where literal is written
+     * @param string String that is written
+     */
+
+    fputc('"', file);
+
+    for (const unsigned char *c = (const unsigned char *)string; *c != '\0'; c++)
+    {
+        if (*c == '"' || *c == '\\' || *c == '?')
+            fprintf(file, "\\%c", *c);
+        else if (*c < 32 || *c > 126)
+            fprintf(file, "\\%03o", *c);
+        else
+            fputc(*c, file);
     }
 
-    return NO_ERROR;
+    fputc('"', file);
 }
 
-int sum_cells(Table *table, Selector *selector, long long int r, long long int c)
+_Bool is_area_selector(const char *function, int *num_of_parts, long long int *parts)
 {
     /**
-     * @brief Set sum of all numeric cells to output cell
+     * @brief Check if selector command selects area given by numbers, _ and - ([R,C], [_,C], [R1,C1,R2,C2], [R1,C1,-,-], ...)
      *
-     * @warning
-     * If non numeric cell is found then NaN will be outputed
+     * Selector is split the same way as in set_selector(), so compiled selector selects same area \n
+     * Numbers smaller than 1 are out of range of every table, so such selectors arent accepted and they are interpreted
      *
-     * @param table Pointer to instance of #Table structure where output data will be saved
-     * @param selector Pointer to instance of #Selector structure that tell us where to find data
-     * @param r Row index of output cell
-     * @param c Column index of output cell
+     * @param function Function of selector command
+     * @param num_of_parts Pointer where number of parts is saved
+     * @param parts Array of 4 long long ints where parts are saved (numbers from 1, #COMPILED_LAST_INDEX or #COMPILED_ALL_INDEX)
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @return true if selector selects area, false if not (or if its parsing failed)
      */
 
-    if (r < 0 || r > (table->num_of_rows - 1) || c < 0 || c > (table->rows[0].num_of_cells - 1))
-        return FUNCTION_ARGUMENT_ERROR;
-
-    int ret_val = NO_ERROR;
+    _Bool area = false;
+    char *selector = NULL;
+    char *buffer = NULL;
 
-    long double sum = 0;
-    _Bool nan = false;
+    if ((selector = malloc(strlen(function) + 1)) == NULL)
+        return false;
+    strcpy(selector, function);
 
-    for (long long int i = selector->lld_ir1; (i <= selector->lld_ir2) && (i < table->num_of_rows); i++)
+    if (trim_se(selector) == NO_ERROR && get_substring(selector, &buffer, ' ', 0, true, NULL, false) == NO_ERROR)
     {
-        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < table->rows[i].num_of_cells); j++)
+        long long int count = count_char(buffer, ',', true) + 1;
+
+        if (count == 2 || count == 4)
         {
-            if (is_string_ldouble(table->rows[i].cells[j].content))
-            {
-                long double tmp = 0;
-                if ((ret_val = string_to_ldouble(table->rows[i].cells[j].content, &tmp)) != NO_ERROR)
-                    return ret_val;
+            area = true;
+            for (long long int i = 0; i < 4; i++)
+                parts[i] = 0;
 
-                sum += tmp;
-            }
-            else
+            for (long long int i = 0; i < count && area; i++)
             {
-                nan = true;
-                break;
-            }
-        }
+                char *part = NULL;
 
-        if (nan)
-            break;
-    }
+                if ((area = get_substring(buffer, &part, ',', i, true, NULL, false) == NO_ERROR))
+                {
+                    if (is_string_llint(part))
+                        area = string_to_llint(part, &parts[i]) == NO_ERROR && parts[i] >= 1;
+                    else if (strings_equal(part, "-"))
+                        parts[i] = COMPILED_LAST_INDEX;
+                    else if (strings_equal(part, "_"))
+                        parts[i] = COMPILED_ALL_INDEX;
+                    else
+                        area = false;
+                }
 
-    if (nan)
-    {
-        ret_val = set_cell("NaN", &table->rows[r].cells[c]);
-    }
-    else
-    {
-        char *temp_string = NULL;
-        if ((ret_val = ldouble_to_string(sum, &temp_string)) == NO_ERROR)
-        {
-            ret_val = set_cell(temp_string, &table->rows[r].cells[c]);
-            free(temp_string);
+                free(part);
+            }
+
+            *num_of_parts = (int)count;
         }
     }
 
-    return ret_val;
+    free(buffer);
+    free(selector);
+
+    return area;
 }
 
-int avg_cells(Table *table, Selector *selector, long long int r, long long int c)
+_Bool parse_compiled_cell_argument(const char *arguments, long long int *row, long long int *col)
 {
     /**
-     * @brief Set average value of numeric cells to output cell
+     * @brief Parse argument [R,C] of command of compiled script the same way as parse_command_argument() does
      *
-     * @warning
-     * If non numeric cell is found then NaN will be outputed
+     * Range of argument depends on table, so only numbers smaller than 1 (out of range of every table) arent accepted
      *
-     * @param table Pointer to instance of #Table structure where output data will be saved
-     * @param selector Pointer to instance of #Selector structure that tell us where to find data
-     * @param r Row index of output cell
-     * @param c Column index of output cell
+     * @param arguments Arguments of command (NULL if command has no arguments)
+     * @param row Pointer where row from 1 (#COMPILED_LAST_INDEX for -) is saved
+     * @param col Pointer where column from 1 (#COMPILED_LAST_INDEX for -) is saved
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @return true if argument was parsed, false if command has to be interpreted
      */
 
-    if (r < 0 || r > (table->num_of_rows - 1) || c < 0 || c > (table->rows[0].num_of_cells - 1))
-        return FUNCTION_ARGUMENT_ERROR;
-
-    int ret_val = NO_ERROR;
+    _Bool parsed = false;
+    long long int values[2] = { 0, 0 };
+    char *argument = NULL;
 
-    long double sum = 0;
-    long double num_of_vals = 0;
-    _Bool nan = false;
+    if (arguments == NULL || (argument = malloc(strlen(arguments) + 1)) == NULL)
+        return false;
+    strcpy(argument, arguments);
 
-    for (long long int i = selector->lld_ir1; (i <= selector->lld_ir2) && (i < table->num_of_rows); i++)
+    if (string_start_with(argument, "[") && string_end_with(argument, "]") && trim_se(argument) == NO_ERROR &&
+        count_char(argument, ',', true) + 1 == 2)
     {
-        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < table->rows[i].num_of_cells); j++)
+        parsed = true;
+
+        for (int i = 0; i < 2 && parsed; i++)
         {
-            if (is_string_ldouble(table->rows[i].cells[j].content))
-            {
-                long double tmp = 0;
-                if ((ret_val = string_to_ldouble(table->rows[i].cells[j].content, &tmp)) != NO_ERROR)
-                    return ret_val;
+            char *part = NULL;
 
-                sum += tmp;
-                num_of_vals++;
-            }
-            else
+            if ((parsed = get_substring(argument, &part, ',', i, true, NULL, false) == NO_ERROR))
             {
-                nan = true;
-                break;
+                if (is_string_llint(part))
+                    parsed = string_to_llint(part, &values[i]) == NO_ERROR && values[i] >= 1;
+                else
+                {
+                    parsed = strings_equal(part, "-");
+                    values[i] = COMPILED_LAST_INDEX;
+                }
             }
-        }
 
-        if (nan)
-            break;
+            free(part);
+        }
     }
 
-    if (nan)
-    {
-        ret_val = set_cell("NaN", &table->rows[r].cells[c]);
-    }
-    else
-    {
-        sum = sum / num_of_vals;
+    free(argument);
 
-        char *temp_string = NULL;
-        if ((ret_val = ldouble_to_string(sum, &temp_string)) == NO_ERROR)
-        {
-            ret_val = set_cell(temp_string, &table->rows[r].cells[c]);
-            free(temp_string);
-        }
-    }
+    *row = values[0];
+    *col = values[1];
 
-    return ret_val;
+    return parsed;
 }
 
-int count_cells(Table *table, Selector *selector, long long int r, long long int c)
+_Bool parse_compiled_variable(const char *arguments, long long int *index)
 {
     /**
-     * @brief Set number of non empty cells to output cell
+     * @brief Parse argument _X of temporary variable command of compiled script the same way as execute_temp_var_command() does
      *
-     * @param table Pointer to instance of #Table structure where output data will be saved
-     * @param selector Pointer to instance of #Selector structure that tell us where to find data
-     * @param r Row index of output cell
-     * @param c Column index of output cell
+     * @param arguments Arguments of command (NULL if command has no arguments)
+     * @param index Pointer where index of temporary variable is saved
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @return true if argument was parsed, false if command has to be interpreted
      */
 
-    if (r < 0 || r > (table->num_of_rows - 1) || c < 0 || c > (table->rows[0].num_of_cells - 1))
-        return FUNCTION_ARGUMENT_ERROR;
-
-    int ret_val = NO_ERROR;
+    _Bool parsed = false;
+    char *argument = NULL;
 
-    long double num_of_cells = 0;
+    if (arguments == NULL || (argument = malloc(strlen(arguments) + 1)) == NULL)
+        return false;
+    strcpy(argument, arguments);
 
-    for (long long int i = selector->lld_ir1; (i <= selector->lld_ir2) && (i < table->num_of_rows); i++)
-    {
-        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < table->rows[i].num_of_cells); j++)
-        {
-            if (!strings_equal(table->rows[i].cells[j].content, EMPTY_CELL))
-                num_of_cells++;
-        }
-    }
+    if (trim_start(argument) == NO_ERROR && string_to_llint(argument, index) == NO_ERROR)
+        parsed = *index >= 0 && *index < NUMBER_OF_TEMPORARY_VARIABLES;
 
-    char *temp_string = NULL;
-    if ((ret_val = ldouble_to_string(num_of_cells, &temp_string)) == NO_ERROR)
-    {
-        ret_val = set_cell(temp_string, &table->rows[r].cells[c]);
-        free(temp_string);
-    }
+    free(argument);
 
-    return ret_val;
+    return parsed;
 }
 
-int cell_len(Table *table, Selector *selector, long long int r, long long int c)
+_Bool write_specialized_command(FILE *file, Command *command)
 {
     /**
-     * @brief Set length of string to output cell
+     * @brief Write call of engine function of @p command with arguments parsed to constants
      *
-     * @warning
-     * If more that one cell is selected then only length of last cell will be outputed
+     * Arguments are parsed the same way as by interpreter, when they cant be parsed nothing is written and command is interpreted
+     * (so it fails the same way as in interpreter)
      *
-     * @param table Pointer to instance of #Table structure where output data will be saved
-     * @param selector Pointer to instance of #Selector structure that tell us where to find data
-     * @param r Row index of output cell
-     * @param c Column index of output cell
+     * @param file File of generated source
+     * @param command Pointer to instance of #Command structure (command must not be executed yet)
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @return true if call was written, false if command has to be interpreted
      */
 
-    if (r < 0 || r > (table->num_of_rows - 1) || c < 0 || c > (table->rows[0].num_of_cells - 1))
-        return FUNCTION_ARGUMENT_ERROR;
-
-    int ret_val = NO_ERROR;
+    int type = get_type_of_command(command);
+    const char *arguments = command->arguments;
+    long long int values[2];
+    long double quantile;
+    int consumed = -1;
+    int findex;
 
-    unsigned long int cell_length = (table->rows[selector->lld_ir2].cells[selector->lld_ic2].content != NULL) ? strlen(table->rows[selector->lld_ir2].cells[selector->lld_ic2].content) : 0;
+    if (type == TABLE_EDITING_COMMAND && (findex = get_table_editing_command_index(command)) != -1)
+    {
+        fprintf(file, "engine->edit(engine, %d, ", findex);
+        if (arguments != NULL)
+            write_c_string(file, arguments);
+        else
+            fprintf(file, "(const char *)0");
+        fprintf(file, ")");
+        return true;
+    }
 
-    char *temp_string = NULL;
-    if ((ret_val = ldouble_to_string((long double)cell_length, &temp_string)) == NO_ERROR)
+    if (type == TEMP_VAR_COMMAND && (findex = get_temp_var_command_index(command)) != -1)
     {
-        ret_val = set_cell(temp_string, &table->rows[r].cells[c]);
-        free(temp_string);
+        if (!parse_compiled_variable(arguments, &values[0]))
+            return false;
+
+        fprintf(file, "engine->%s(engine, &variables[%lld])", TEMP_VAR_COMMANDS[findex], values[0]);
+        return true;
     }
 
-    return ret_val;
-}
+    if (type != DATA_EDITING_COMMAND || (findex = get_data_editing_command_index(command)) == -1)
+        return false;
+
+    switch (findex)
+    {
+        // set STR, clear
+        case 0:
+        case 1:
+            if (findex == 0 && arguments == NULL)
+                return false;
+
+            fprintf(file, "engine->set(engine, ");
+            write_c_string(file, (findex == 0) ? arguments : EMPTY_CELL);
+            fprintf(file, ")");
+            return true;
+
+        // swap, sum, avg, count, len, median and distinct [R,C]
+        case 2:
+        case 3:
+        case 4:
+        case 5:
+        case 6:
+        case 11:
+        case 14:
+            if (!parse_compiled_cell_argument(arguments, &values[0], &values[1]))
+                return false;
+
+            fprintf(file, "engine->%s(engine, %lldLL, %lldLL)", DATA_EDITING_COMMANDS[findex], values[0], values[1]);
+            return true;
+
+        // cumsum [C]
+        case 7:
+            if (arguments == NULL || sscanf(arguments, "[%lld]%n", &values[1], &consumed) != 1 || consumed != (int)strlen(arguments) ||
+                values[1] < 1)
+                return false;
+
+            fprintf(file, "engine->window(engine, 0, 0LL, %lldLL)", values[1]);
+            return true;
 
-int append_empty_cell(Row *row)
-{
-    /**
-     * @brief Append empty cell to the end of the row
-     *
-     * @param row Pointer to instance of #Row structure where we want to append empty cell
-     *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
-     */
+        // mavg [W,C], mmin [W,C], mmax [W,C], topk [K,C]
+        case 8:
+        case 9:
+        case 10:
+        case 13:
+            if (arguments == NULL || sscanf(arguments, "[%lld,%lld]%n", &values[0], &values[1], &consumed) != 2 ||
+                consumed != (int)strlen(arguments) || values[0] < 1 || values[1] < 1)
+                return false;
 
-    // If row have no cells or its already full allocate new cols
-    if (row->cells == NULL || row->num_of_cells == row->allocated_cells)
-        if (allocate_cells(row) != NO_ERROR)
-            return ALLOCATION_FAILED;
+            if (findex == 13)
+                fprintf(file, "engine->topk(engine, %lldLL, %lldLL)", values[0], values[1]);
+            else
+                fprintf(file, "engine->window(engine, %d, %lldLL, %lldLL)", findex - 7, values[0], values[1]);
+            return true;
 
-    if (set_cell(EMPTY_CELL, &row->cells[row->num_of_cells]) != NO_ERROR)
-        return ALLOCATION_FAILED;
+        // quantile [Q,R,C], aquantile [Q,R,C]
+        case 12:
+        case 15:
+            if (arguments == NULL || sscanf(arguments, "[%Lf,%lld,%lld]%n", &quantile, &values[0], &values[1], &consumed) != 3 ||
+                consumed != (int)strlen(arguments) || !isfinite(quantile))
+                return false;
 
-    row->num_of_cells++;
+            // Hexadecimal literal keeps exactly the same value that interpreter parses
+            fprintf(file, "engine->quantile(engine, %d, %LaL, %lldLL, %lldLL)", findex == 15, quantile, values[0], values[1]);
+            return true;
 
-    return NO_ERROR;
+        default:
+            return false;
+    }
 }
 
-int normalize_row_lengths(Table *table)
+int generate_compiled_script(Commands *commands, const char *path)
 {
     /**
-     * @brief Normalize lengths of rows
+     * @brief Translate @p commands to C source file of compiled script
      *
-     * Append empty cells to the end of smaller rows than the longest one to make all rows same length
+     * Commands are translated to direct calls of engine functions with their arguments parsed to constants (area selectors,
+     * table editing, set, clear, swap, sum, avg, count, len, median, distinct, cumsum, mavg, mmin, mmax, topk, quantile, aquantile,
+     * def, use and inc), temporary variables are locals of compiled script and formulas are recalculated only before commands that
+     * can read them \n
+     * Other commands (and commands with arguments that cant be parsed) are interpreted by engine
      *
-     * @param table Pointer to instance of #Table structure
+     * @param commands Pointer to instance of #Commands structure (commands must not be executed yet)
+     * @param path Path of generated source file
      *
-     * @return #NO_ERROR on success and #ALLOCATION_FAILED on error
+     * @return #NO_ERROR on success, #CANT_OPEN_FILE or #IO_ERROR when source cant be written
      */
 
-    long long int max_number_of_cols = 0;
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+        return CANT_OPEN_FILE;
 
-    // Get maximum cols in whole table
-    for (long long int i = 0; i < table->num_of_rows; i++)
-    {
-        if (table->rows[i].num_of_cells > max_number_of_cols)
-            max_number_of_cols = table->rows[i].num_of_cells;
-    }
+    fprintf(file, "/* Script compiled by sps, do not edit */\n\n");
+    fprintf(file, "typedef struct CompiledEngine\n{\n");
+    fprintf(file, "    void *context;\n");
+    fprintf(file, "    int (*select_area)(struct CompiledEngine *engine, int num_of_parts, long long int r1, long long int c1, long long int r2, long long int c2);\n");
+    fprintf(file, "    int (*select)(struct CompiledEngine *engine, const char *selector);\n");
+    fprintf(file, "    int (*execute)(struct CompiledEngine *engine, int type, const char *function, const char *arguments);\n");
+    fprintf(file, "    int (*recalculate)(struct CompiledEngine *engine);\n");
+    fprintf(file, "    int (*edit)(struct CompiledEngine *engine, int command, const char *arguments);\n");
+    fprintf(file, "    int (*set)(struct CompiledEngine *engine, const char *value);\n");
+    for (int i = 0; i < NUMBER_OF_DATA_EDITING_COMMANDS; i++)
+        if ((i >= 2 && i <= 6) || i == 11 || i == 14)
+            fprintf(file, "    int (*%s)(struct CompiledEngine *engine, long long int row, long long int col);\n", DATA_EDITING_COMMANDS[i]);
+    fprintf(file, "    int (*window)(struct CompiledEngine *engine, int function, long long int window, long long int col);\n");
+    fprintf(file, "    int (*topk)(struct CompiledEngine *engine, long long int k, long long int col);\n");
+    fprintf(file, "    int (*quantile)(struct CompiledEngine *engine, int approximate, long double quantile, long long int row, long long int col);\n");
+    for (int i = 0; i < NUMBER_OF_TEMP_VAR_COMMANDS; i++)
+        fprintf(file, "    int (*%s)(struct CompiledEngine *engine, char **variable);\n", TEMP_VAR_COMMANDS[i]);
+    fprintf(file, "    void (*release)(struct CompiledEngine *engine, char **variable);\n");
+    fprintf(file, "} CompiledEngine;\n\n");
+    fprintf(file, "const int %s = %d;\n", COMPILED_ABI_SYMBOL, COMPILED_ABI_VERSION);
 
-    for (long long int i = 0; i < table->num_of_rows; i++)
+    for (long long int i = 0; i < commands->num_of_commands; i++)
     {
-        long long int length_diff = max_number_of_cols - table->rows[i].num_of_cells;
+        Command *command = &commands->commands[i];
 
-        if (length_diff > 0)
+        // Long scripts are split to functions, so compiler doesnt optimize one huge function
+        if (i % COMPILED_BLOCK_COMMANDS == 0)
         {
-            for (long long int j = 0; j < length_diff; j++)
-                if (append_empty_cell(&table->rows[i]) != NO_ERROR)
-                    return ALLOCATION_FAILED;
+            if (i > 0)
+                fprintf(file, "\n    return ret_val;\n}\n");
+            fprintf(file, "\nstatic int execute_block_%lld(CompiledEngine *engine, char **variables)\n{\n    int ret_val = 0;\n\n    (void)variables;\n",
+                    i / COMPILED_BLOCK_COMMANDS);
         }
-    }
+        int num_of_parts = 0;
+        long long int parts[4];
 
-    return NO_ERROR;
-}
+        fprintf(file, "\n    /* Command %lld */\n", i + 1);
 
-void normalize_empty_cols(Table *table)
-{
-    /**
-     * @brief Trim excess colms
-     *
-     * Destroy empty cols on the end of rows
-     *
-     * @param table Pointer to instance of #Table structure
-     */
+        if (command_reads_formulas(command))
+            fprintf(file, "    if ((ret_val = engine->recalculate(engine)) != 0)\n        return ret_val;\n");
 
-    if (table->num_of_rows > 0)
-    {
-        for (long long int i = (table->rows[0].num_of_cells - 1); i > 0; i--)
+        if (is_command_selector(command) && is_area_selector(command->function, &num_of_parts, parts))
         {
-            _Bool all_empty = true;
-
-            for (long long int j = 0; j < table->num_of_rows; j++)
-            {
-                if (!strings_equal(table->rows[j].cells[i].content, EMPTY_CELL))
-                    all_empty = false;
-            }
-
-            if (all_empty)
-            {
-                // Destroy the empty ones
-                for (long long int j = 0; j < table->num_of_rows; j++)
-                {
-                    deallocate_cell(&table->rows[j].cells[i]);
-                    table->rows[j].num_of_cells--;
-                }
+            fprintf(file, "    if ((ret_val = engine->select_area(engine, %d, %lldLL, %lldLL, %lldLL, %lldLL)) != 0)\n        return ret_val;\n",
+                    num_of_parts, parts[0], parts[1], parts[2], parts[3]);
+            continue;
+        }
 
-                continue;
-            }
+        if (is_command_selector(command))
+        {
+            fprintf(file, "    if ((ret_val = engine->select(engine, ");
+            write_c_string(file, command->function);
+            fprintf(file, ")) != 0)\n        return ret_val;\n");
+            continue;
+        }
 
-            break;
+        fprintf(file, "    if ((ret_val = ");
+        if (!write_specialized_command(file, command))
+        {
+            fprintf(file, "engine->execute(engine, %d, ", get_type_of_command(command));
+            write_c_string(file, command->function);
+            fprintf(file, ", ");
+            if (command->arguments != NULL)
+                write_c_string(file, command->arguments);
+            else
+                fprintf(file, "(const char *)0");
+            fprintf(file, ")");
         }
+        fprintf(file, ") != 0)\n        return ret_val;\n");
     }
-}
 
-int normalize_number_of_cols(Table *table)
-{
-    /**
-     * @brief Normalize end of the rows
-     *
-     * Fill short rows to same size as the longest one and then trim all empty cols at the end
-     *
-     * @param table Pointer to instance of #Table structure
-     *
-     * @return #NO_ERROR on success and #ALLOCATION_FAILED on error
-     */
+    if (commands->num_of_commands > 0)
+        fprintf(file, "\n    return ret_val;\n}\n");
 
-    int ret_code;
-    if ((ret_code = normalize_row_lengths(table) != NO_ERROR))
-        return ret_code;
+    // Temporary variables are locals, so they are released by script on every exit
+    fprintf(file, "\nint %s(CompiledEngine *engine)\n{\n    int ret_val = 0;\n    char *variables[%d] = { 0 };\n\n",
+            COMPILED_SCRIPT_SYMBOL, NUMBER_OF_TEMPORARY_VARIABLES);
+    for (long long int i = 0; i * COMPILED_BLOCK_COMMANDS < commands->num_of_commands; i++)
+        fprintf(file, "    if (ret_val == 0)\n        ret_val = execute_block_%lld(engine, variables);\n", i);
+    fprintf(file, "\n    for (int i = 0; i < %d; i++)\n        engine->release(engine, &variables[i]);\n", NUMBER_OF_TEMPORARY_VARIABLES);
+    fprintf(file, "\n    return ret_val;\n}\n");
 
-    normalize_empty_cols(table);
+    int ret_val = ferror(file) ? IO_ERROR : NO_ERROR;
+    if (fclose(file) != 0)
+        ret_val = IO_ERROR;
 
-    return ret_code;
+    return ret_val;
 }
 
-int create_row_from_data(char *line, Table *table)
+int build_compiled_script(const char *source_path, const char *library_path)
 {
     /**
-     * @brief Create row from line data
-     *
-     * Parse and save line data
+     * @brief Compile generated source to shared library by system compiler (CC environment variable or #DEFAULT_COMPILER)
      *
-     * @param line Input string to parse
-     * @param table Pointer to instance #Table structure where row will be saved
+     * @param source_path Path of generated source file
+     * @param library_path Path of compiled library
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @return #NO_ERROR on success, #FUNCTION_ERROR when compiler cant be started or when it failed
      */
 
-    if (line == NULL)
-        return FUNCTION_ERROR;
-
-    // Allocate base number of cells in row
-    if (allocate_cells(&table->rows[table->num_of_rows]) != NO_ERROR)
-        return ALLOCATION_FAILED;
+    const char *compiler = getenv("CC");
+    if (compiler == NULL || compiler[0] == '\0')
+        compiler = DEFAULT_COMPILER;
 
-    long long int number_of_cells = count_char(line, table->delim, false) + 1;
+    // Output of table could be written to stdout, so messages of compiler are only on stderr
+    fflush(stdout);
 
-    char *substring_buffer = NULL;
-    int ret_val;
+    pid_t pid = fork();
+    if (pid < 0)
+        return FUNCTION_ERROR;
 
-    for (long long int i = 0; i < number_of_cells; i++)
+    if (pid == 0)
     {
-        if (i >= table->rows[table->num_of_rows].allocated_cells)
-        {
-            if (allocate_cells(&table->rows[table->num_of_rows]) != NO_ERROR)
-                return ALLOCATION_FAILED;
-        }
-
-        if ((ret_val = get_substring(line, &substring_buffer, table->delim, i, false, NULL, false)) != NO_ERROR)
-            return ret_val;
-
-        if (set_cell(substring_buffer, &table->rows[table->num_of_rows].cells[i]) != NO_ERROR)
-            return ALLOCATION_FAILED;
-
-        table->rows[table->num_of_rows].num_of_cells++;
+        // Compiled script is only sequence of calls, higher optimization would only make compilation slower
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+        execlp(compiler, compiler, "-std=c99", "-O1", "-fPIC", "-shared", "-o", library_path, source_path, (char *)NULL);
+        _exit(127);
     }
 
-    free(substring_buffer);
+    int status;
+    while (waitpid(pid, &status, 0) < 0)
+    {
+        if (errno != EINTR)
+            return FUNCTION_ERROR;
+    }
 
-    table->num_of_rows++;
-    return NO_ERROR;
+    return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? NO_ERROR : FUNCTION_ERROR;
 }
 
-void init_selector(Selector *selector)
+void unload_compiled_script(CompiledScript *script)
 {
     /**
-     * @brief Initialize @p selector to default values
+     * @brief Unload library of compiled script
      *
-     * @param selector Pointer to instance of #Selector structure
+     * @param script Pointer to instance of #CompiledScript structure
      */
 
-    selector->lld_ic1 = 0;
-    selector->lld_ic2 = 0;
-    selector->lld_ir1 = 0;
-    selector->lld_ir2 = 0;
-    selector->initialized = true;
+    if (script->handle != NULL)
+        dlclose(script->handle);
+
+    script->handle = NULL;
+    script->function = NULL;
 }
 
-int init_temp_var_store(TempVariableStore *temp_var_store)
+int load_compiled_script(CompiledScript *script, const char *library_path)
 {
     /**
-     * @brief Init array of temporary variables
+     * @brief Load library of compiled script
      *
-     * @param temp_var_store Pointer to instance of #TempVariableStore structure
+     * @param script Pointer to instance of #CompiledScript structure where loaded script will be saved
+     * @param library_path Path of compiled library
      *
-     * @return #NO_ERROR on success and #ALLOCATION_FAILED on error
+     * @return #NO_ERROR on success, #CANT_OPEN_FILE when library cant be loaded, #VALUE_ERROR when it was compiled for other engine
      */
 
-    temp_var_store->variables = (char**)malloc(NUMBER_OF_TEMPORARY_VARIABLES * sizeof(char*));
-    if (temp_var_store->variables == NULL)
-        return ALLOCATION_FAILED;
+    script->handle = dlopen(library_path, RTLD_NOW | RTLD_LOCAL);
+    script->function = NULL;
+    if (script->handle == NULL)
+        return CANT_OPEN_FILE;
 
-    for (long long int i = 0; i < NUMBER_OF_TEMPORARY_VARIABLES; i++)
+    const int *abi = dlsym(script->handle, COMPILED_ABI_SYMBOL);
+    void *function = dlsym(script->handle, COMPILED_SCRIPT_SYMBOL);
+    if (abi == NULL || *abi != COMPILED_ABI_VERSION || function == NULL)
     {
-        temp_var_store->variables[i] = NULL;
+        unload_compiled_script(script);
+        return VALUE_ERROR;
     }
 
+    // POSIX guarantees that pointer returned by dlsym can be converted to function pointer
+    *(void **)&script->function = function;
+
     return NO_ERROR;
 }
 
-void copy_selector(Selector *source, Selector *dest)
+int compile_script(CompiledScript *script, Commands *commands, const char *cache_dir)
 {
     /**
-     * @brief Copy values from selector @p source to selector @p dest
+     * @brief Load compiled @p commands from @p cache_dir, script is compiled and saved to cache when it isnt there
      *
-     * @param source Pointer to instance of #Selector struct from which we want copy data
-     * @param dest Pointer to instance of #Selector struct where we want save data
+     * Library is named by hash of commands and version of interface, it is compiled to temporary file and renamed, so concurrent runs
+     * never load partially written library
+     *
+     * @param script Pointer to instance of #CompiledScript structure where loaded script will be saved
+     * @param commands Pointer to instance of #Commands structure (commands must not be executed yet)
+     * @param cache_dir Directory of cache of compiled scripts
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    dest->lld_ir1 = source->lld_ir1;
-    dest->lld_ir2 = source->lld_ir2;
-    dest->lld_ic1 = source->lld_ic1;
-    dest->lld_ic2 = source->lld_ic2;
-}
+    int ret_val;
+    int abi = COMPILED_ABI_VERSION;
+    unsigned long long int hash = hash_bytes((const char *)&abi, sizeof(abi), hash_script(commands));
+    long int pid = (long int)getpid();
 
-void selector_find(Selector *selector, Table *table, char *string)
-{
-    /**
-     * @brief Select cell that starts with @p string
-     *
-     * @param selector Pointer to instance of #Selector structure where data will be saved
-     * @param table Pointer to instance of #Table structure
-     * @param string String we want to find at the beginning of cell
-     */
+    script->handle = NULL;
+    script->function = NULL;
 
-    _Bool found = false;
+    size_t length = strlen(cache_dir) + 64;
+    char *library_path = malloc(length);
+    char *source_path = malloc(length);
+    char *temp_library_path = malloc(length);
+    char *temp_source_path = malloc(length);
 
-    for (long long int i = selector->lld_ir1; (i <= selector->lld_ir2) && (i < table->num_of_rows); i++)
+    if (library_path == NULL || source_path == NULL || temp_library_path == NULL || temp_source_path == NULL)
+    {
+        free(library_path);
+        free(source_path);
+        free(temp_library_path);
+        free(temp_source_path);
+        return ALLOCATION_FAILED;
+    }
+
+    snprintf(library_path, length, "%s/sps-%016llx.so", cache_dir, hash);
+    snprintf(source_path, length, "%s/sps-%016llx.c", cache_dir, hash);
+    snprintf(temp_library_path, length, "%s/sps-%016llx.%ld.so", cache_dir, hash, pid);
+    snprintf(temp_source_path, length, "%s/sps-%016llx.%ld.c", cache_dir, hash, pid);
+
+    // Cached library is compiled again only when it cant be loaded
+    if ((ret_val = load_compiled_script(script, library_path)) != NO_ERROR)
     {
-        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < table->rows[i].num_of_cells); j++)
+        if ((ret_val = generate_compiled_script(commands, temp_source_path)) == NO_ERROR &&
+            (ret_val = build_compiled_script(temp_source_path, temp_library_path)) == NO_ERROR)
         {
-            if (string_start_with(table->rows[i].cells[j].content, string))
+            if (rename(temp_library_path, library_path) != 0)
+                ret_val = IO_ERROR;
+            else
             {
-                selector->lld_ir1 = selector->lld_ir2 = i;
-                selector->lld_ic1 = selector->lld_ic2 = j;
-                found = true;
+                // Source is kept next to library only for inspection
+                rename(temp_source_path, source_path);
+                ret_val = load_compiled_script(script, library_path);
             }
-
-            if (found)
-                break;
         }
 
-        if (found)
-            break;
+        remove(temp_library_path);
+        remove(temp_source_path);
     }
+
+    free(library_path);
+    free(source_path);
+    free(temp_library_path);
+    free(temp_source_path);
+
+    return ret_val;
 }
 
-int selector_max(Selector *selector, Table *table)
+int execute_compiled_script(Table *table, CompiledScript *script)
 {
     /**
-     * @brief Select cell with maximum numeric value in current selection
+     * @brief Execute compiled script on @p table
      *
-     * @param selector Pointer to instance of #Selector structure where data will be saved
      * @param table Pointer to instance of #Table structure
+     * @param script Pointer to instance of loaded #CompiledScript structure
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    int ret_val = NO_ERROR;
-    long double max = -LDBL_MAX;
-    long long int r = 0, c = 0;
-    _Bool found = false;
+    CompiledContext context = { .table = table };
+    init_selector(&context.selector);
+    init_selector(&context.temp_selector);
+
+    CompiledEngine engine = {
+        .context = &context,
+        .select_area = compiled_select_area,
+        .select = compiled_select,
+        .execute = compiled_execute,
+        .recalculate = compiled_recalculate,
+        .edit = compiled_edit,
+        .set = compiled_set,
+        .swap = compiled_swap,
+        .sum = compiled_sum,
+        .avg = compiled_avg,
+        .count = compiled_count,
+        .len = compiled_len,
+        .median = compiled_median,
+        .distinct = compiled_distinct,
+        .window = compiled_window,
+        .topk = compiled_topk,
+        .quantile = compiled_quantile,
+        .def = compiled_def,
+        .use = compiled_use,
+        .inc = compiled_inc,
+        .release = compiled_release,
+    };
+
+    return script->function(&engine);
+}
 
-    char *testing_string = NULL;
+char *shared_segment_name(const char *name, long long int generation)
+{
+    /**
+     * @brief Create name of shared memory segment of published table
+     *
+     * @param name Name of published table
+     * @param generation Generation of segment with table (-1 for control segment)
+     *
+     * @return Allocated name of segment, NULL on error
+     */
 
-    for (long long int i = selector->lld_ir1; (i <= selector->lld_ir2) && (i < table->num_of_rows); i++)
-    {
-        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < table->rows[i].num_of_cells); j++)
-        {
-            if (string_copy(&table->rows[i].cells[j].content, &testing_string) != NO_ERROR)
-                return ALLOCATION_FAILED;
+    size_t length = strlen(name) + 2 + ((generation >= 0) ? 21 : 0);
+    char *segment_name = (char*)malloc(length * sizeof(char));
+    if (segment_name == NULL)
+        return NULL;
 
-            if ((string_start_with(testing_string, "\"") && string_end_with(testing_string, "\"")) ||
-                (string_start_with(testing_string, "\'") && string_end_with(testing_string, "\'")))
-            {
-                if (trim_se(testing_string) != NO_ERROR)
-                {
-                    free(testing_string);
-                    return FUNCTION_ERROR;
-                }
-            }
+    if (generation >= 0)
+        snprintf(segment_name, length, "/%s.%lld", name, generation);
+    else
+        snprintf(segment_name, length, "/%s", name);
 
-            if (is_string_ldouble(testing_string))
-            {
-                long double ret;
-                if ((ret_val = string_to_ldouble(testing_string, &ret)) != NO_ERROR)
-                    break;
+    return segment_name;
+}
 
-                if (ret > max)
-                {
-                    max = ret;
-                    r = i;
-                    c = j;
-                    found = true;
-                }
-            }
+long long int read_shared_generation(const char *name)
+{
+    /**
+     * @brief Read generation of currently published segment of table
+     *
+     * @param name Name of published table
+     *
+     * @return Generation of segment, 0 if nothing was published, -1 on error
+     */
 
-            free(testing_string);
-            testing_string = NULL;
-        }
-    }
+    char *control_name = shared_segment_name(name, -1);
+    if (control_name == NULL)
+        return -1;
 
-    if (ret_val == NO_ERROR)
+    int fd = shm_open(control_name, O_RDONLY, 0);
+    _Bool missing = (fd < 0 && errno == ENOENT);
+    free(control_name);
+    if (fd < 0)
+        return missing ? 0 : -1;
+
+    long long int generation = -1;
+    struct stat info;
+
+    if (fstat(fd, &info) == 0 && info.st_size >= (off_t)sizeof(SharedTableControl))
     {
-        if (found)
-        {
-            selector->lld_ir1 = selector->lld_ir2 = r;
-            selector->lld_ic1 = selector->lld_ic2 = c;
-        }
-        else
+        SharedTableControl *control = (SharedTableControl*)mmap(NULL, sizeof(SharedTableControl), PROT_READ, MAP_SHARED, fd, 0);
+        if (control != MAP_FAILED)
         {
-            fprintf(stdout, "[WARNING] Cant find maximum in [%llu, %llu, %llu, %llu] selection\n", selector->lld_ir1 + 1, selector->lld_ic1 + 1, selector->lld_ir2 + 1, selector->lld_ic2 + 1);
+            generation = (memcmp(control->magic, SHARED_TABLE_MAGIC, sizeof(control->magic)) == 0) ?
+                         (long long int)__atomic_load_n(&control->generation, __ATOMIC_ACQUIRE) : 0;
+            munmap(control, sizeof(SharedTableControl));
         }
     }
 
-    return ret_val;
+    close(fd);
+
+    return generation;
 }
 
-int selector_min(Selector *selector, Table *table)
+int publish_table(Table *table, const char *name)
 {
     /**
-     * @brief Select cell with minimum numeric value in current selection
+     * @brief Publish copy of table to new shared memory segment and make it current version of table @p name
+     *
+     * Segment of new version is complete before its generation is stored to control segment,
+     * so readers attach either old or new version and mapped old versions stay valid after they are unlinked
+     * @warning
+     * Table can be published only by one process at a time
      *
-     * @param selector Pointer to instance of #Selector structure where data will be saved
      * @param table Pointer to instance of #Table structure
+     * @param name Name of published table
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    int ret_val = NO_ERROR;
-    long double min = LDBL_MAX;
-    long long int r = 0, c = 0;
-    _Bool found = false;
+    int ret_val = NO_ERROR;
+    long long int num_of_rows = 0;
+    uint64_t num_of_cells = 0;
+    uint64_t num_of_chars = 0;
+
+    // Rows after first row without cells contain no data (same as in output)
+    for (; num_of_rows < table->num_of_rows && get_row(table, num_of_rows)->cells != NULL; num_of_rows++)
+    {
+        Row *row = get_row(table, num_of_rows);
+        num_of_cells += (uint64_t)row->num_of_cells;
+        for (long long int j = 0; j < row->num_of_cells; j++)
+            num_of_chars += ((row->cells[j].content != NULL) ? strlen(row->cells[j].content) : 0) + 1;
+    }
+
+    SharedTableHeader header;
+    memcpy(header.magic, SHARED_TABLE_MAGIC, sizeof(header.magic));
+    header.num_of_rows = (uint64_t)num_of_rows;
+    header.rows_offset = sizeof(SharedTableHeader);
+    header.cells_offset = header.rows_offset + ((uint64_t)num_of_rows + 1) * sizeof(uint64_t);
+    header.size = header.cells_offset + num_of_cells * sizeof(uint64_t) + num_of_chars;
+
+    long long int old_generation = read_shared_generation(name);
+    if (old_generation < 0)
+        return IO_ERROR;
 
-    char *testing_string = NULL;
+    char *control_name = shared_segment_name(name, -1);
+    char *segment_name = shared_segment_name(name, old_generation + 1);
+    if (control_name == NULL || segment_name == NULL)
+        ret_val = ALLOCATION_FAILED;
 
-    for (long long int i = selector->lld_ir1; (i <= selector->lld_ir2) && (i < table->num_of_rows); i++)
+    // Segment of same generation can be left by publisher that failed
+    int fd = -1;
+    if (ret_val == NO_ERROR)
     {
-        for (long long int j = selector->lld_ic1; (j <= selector->lld_ic2) && (j < table->rows[i].num_of_cells); j++)
-        {
-            if (string_copy(&table->rows[i].cells[j].content, &testing_string) != NO_ERROR)
-                return ALLOCATION_FAILED;
+        shm_unlink(segment_name);
+        if ((fd = shm_open(segment_name, O_RDWR | O_CREAT | O_EXCL, 0644)) < 0 || ftruncate(fd, (off_t)header.size) != 0)
+            ret_val = IO_ERROR;
+    }
 
-            if ((string_start_with(testing_string, "\"") && string_end_with(testing_string, "\"")) ||
-                (string_start_with(testing_string, "\'") && string_end_with(testing_string, "\'")))
-            {
-                if (trim_se(testing_string) != NO_ERROR)
-                {
-                    free(testing_string);
-                    return FUNCTION_ERROR;
-                }
-            }
+    unsigned char *data = MAP_FAILED;
+    if (ret_val == NO_ERROR && (data = (unsigned char*)mmap(NULL, header.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+        ret_val = IO_ERROR;
 
-            if (is_string_ldouble(testing_string))
+    if (ret_val == NO_ERROR)
+    {
+        uint64_t *rows = (uint64_t*)(data + header.rows_offset);
+        uint64_t *cells = (uint64_t*)(data + header.cells_offset);
+        uint64_t cell = 0;
+        uint64_t offset = header.cells_offset + num_of_cells * sizeof(uint64_t);
+
+        memcpy(data, &header, sizeof(SharedTableHeader));
+
+        for (long long int i = 0; i < num_of_rows; i++)
+        {
+            Row *row = get_row(table, i);
+            rows[i] = cell;
+
+            for (long long int j = 0; j < row->num_of_cells; j++)
             {
-                long double ret;
-                if ((ret_val = string_to_ldouble(testing_string, &ret)) != NO_ERROR)
-                    break;
+                const char *content = (row->cells[j].content != NULL) ? row->cells[j].content : EMPTY_CELL;
+                size_t length = strlen(content) + 1;
 
-                if (ret < min)
-                {
-                    min = ret;
-                    r = i;
-                    c = j;
-                    found = true;
-                }
+                cells[cell++] = offset;
+                memcpy(data + offset, content, length);
+                offset += length;
             }
-
-            free(testing_string);
-            testing_string = NULL;
         }
+
+        rows[num_of_rows] = cell;
+        munmap(data, header.size);
     }
 
+    if (fd >= 0)
+        close(fd);
+
+    // Generation is stored only after whole segment is written
     if (ret_val == NO_ERROR)
     {
-        if (found)
-        {
-            selector->lld_ir1 = selector->lld_ir2 = r;
-            selector->lld_ic1 = selector->lld_ic2 = c;
-        }
+        SharedTableControl *control = MAP_FAILED;
+        if ((fd = shm_open(control_name, O_RDWR | O_CREAT, 0644)) < 0 || ftruncate(fd, sizeof(SharedTableControl)) != 0 ||
+            (control = (SharedTableControl*)mmap(NULL, sizeof(SharedTableControl), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+            ret_val = IO_ERROR;
         else
         {
-            fprintf(stdout, "[WARNING] Cant find minimum in [%llu, %llu, %llu, %llu] selection\n", selector->lld_ir1 + 1, selector->lld_ic1 + 1, selector->lld_ir2 + 1, selector->lld_ic2 + 1);
+            memcpy(control->magic, SHARED_TABLE_MAGIC, sizeof(control->magic));
+            __atomic_store_n(&control->generation, (uint64_t)(old_generation + 1), __ATOMIC_RELEASE);
+            munmap(control, sizeof(SharedTableControl));
         }
+
+        if (fd >= 0)
+            close(fd);
     }
 
+    if (ret_val != NO_ERROR && segment_name != NULL)
+        shm_unlink(segment_name);
+
+    // Readers that mapped old version keep it until they detach
+    if (ret_val == NO_ERROR && old_generation > 0)
+    {
+        free(segment_name);
+        if ((segment_name = shared_segment_name(name, old_generation)) != NULL)
+            shm_unlink(segment_name);
+    }
+
+    free(control_name);
+    free(segment_name);
+
     return ret_val;
 }
 
-void selector_select_all(Selector *selector, Table *table)
+void shared_table_detach(SharedTable *shared)
 {
     /**
-     * @brief Select whole table
+     * @brief Unmap attached table
      *
-     * @param selector Pointer to instance of #Selector structure where data will be saved
-     * @param table Pointer to instance of #Table structure
+     * @param shared Pointer to instance of #SharedTable structure
      */
 
-    selector->lld_ir1 = selector->lld_ic1 = 0;
-    selector->lld_ir2 = table->num_of_rows - 1;
-    selector->lld_ic1 = 0;
-    selector->lld_ic2 = table->rows[0].num_of_cells - 1;
+    if (shared->data != NULL)
+        munmap(shared->data, shared->size);
+
+    shared->data = NULL;
+    shared->size = 0;
+    shared->num_of_rows = 0;
 }
 
-void selector_select_last(Selector *selector, Table *table)
+int shared_table_attach(SharedTable *shared, const char *name)
 {
     /**
-     * @brief Select last cell in last row
+     * @brief Map current version of published table @p name
      *
-     * @param selector Pointer to instance of #Selector structure where data will be saved
-     * @param table Pointer to instance of #Table structure
+     * Segment is mapped privately, so attached process can edit cells in place without changing published version
+     *
+     * @param shared Pointer to instance of #SharedTable structure
+     * @param name Name of published table
+     *
+     * @return #NO_ERROR on success, #CANT_OPEN_FILE if table isnt published, #VALUE_ERROR if segment is damaged, #IO_ERROR on other errors
      */
 
-    selector->lld_ir1 = selector->lld_ir2 = table->num_of_rows - 1;
-    selector->lld_ic1 = selector->lld_ic2 = table->rows[0].num_of_cells - 1;
+    shared->data = NULL;
+
+    for (int attempt = 0; attempt < SHARED_ATTACH_RETRIES; attempt++)
+    {
+        long long int generation = read_shared_generation(name);
+        if (generation <= 0)
+            return (generation == 0) ? CANT_OPEN_FILE : IO_ERROR;
+
+        char *segment_name = shared_segment_name(name, generation);
+        if (segment_name == NULL)
+            return ALLOCATION_FAILED;
+
+        int fd = shm_open(segment_name, O_RDONLY, 0);
+        free(segment_name);
+
+        // Version was replaced after its generation was read
+        if (fd < 0 && errno == ENOENT)
+            continue;
+        if (fd < 0)
+            return IO_ERROR;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(SharedTableHeader))
+        {
+            close(fd);
+            return VALUE_ERROR;
+        }
+
+        shared->size = (size_t)info.st_size;
+        shared->data = (unsigned char*)mmap(NULL, shared->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (shared->data == MAP_FAILED)
+        {
+            shared->data = NULL;
+            return IO_ERROR;
+        }
+
+        break;
+    }
+
+    if (shared->data == NULL)
+        return IO_ERROR;
+
+    // Offsets are checked, so damaged segment cant make reader access memory outside of it
+    SharedTableHeader *header = (SharedTableHeader*)shared->data;
+    uint64_t size = (uint64_t)shared->size;
+    _Bool valid = memcmp(header->magic, SHARED_TABLE_MAGIC, sizeof(header->magic)) == 0 && header->size == size &&
+                  header->rows_offset == sizeof(SharedTableHeader) && header->num_of_rows < size / sizeof(uint64_t) &&
+                  header->cells_offset == header->rows_offset + (header->num_of_rows + 1) * sizeof(uint64_t) && header->cells_offset <= size;
+
+    if (valid)
+    {
+        shared->num_of_rows = (long long int)header->num_of_rows;
+        shared->rows = (const uint64_t*)(shared->data + header->rows_offset);
+        shared->cells = (const uint64_t*)(shared->data + header->cells_offset);
+
+        uint64_t num_of_cells = shared->rows[shared->num_of_rows];
+        valid = num_of_cells <= (size - header->cells_offset) / sizeof(uint64_t) &&
+                (num_of_cells == 0 || shared->data[size - 1] == '\0');
+
+        for (long long int i = 0; i < shared->num_of_rows && valid; i++)
+            valid = shared->rows[i] <= shared->rows[i + 1];
+
+        for (uint64_t i = 0; i < num_of_cells && valid; i++)
+            valid = shared->cells[i] >= header->cells_offset + num_of_cells * sizeof(uint64_t) && shared->cells[i] < size;
+    }
+
+    if (!valid)
+    {
+        shared_table_detach(shared);
+        return VALUE_ERROR;
+    }
+
+    return NO_ERROR;
 }
 
-void selector_select_last_colm(Selector *selector, Table *table)
+long long int shared_table_num_of_cells(SharedTable *shared, long long int row)
 {
     /**
-     * @brief Select last column
+     * @brief Get number of cells of row of attached table
      *
-     * @param selector Pointer to instance of #Selector structure where data will be saved
-     * @param table Pointer to instance of #Table structure
+     * @param shared Pointer to instance of #SharedTable structure
+     * @param row Index of row
+     *
+     * @return Number of cells, -1 if row doesnt exist
      */
 
-    selector->lld_ir1 = 0;
-    selector->lld_ir2 = table->num_of_rows - 1;
-    selector->lld_ic1 = selector->lld_ic2 = table->rows[0].num_of_cells - 1;
+    if (row < 0 || row >= shared->num_of_rows)
+        return -1;
+
+    return (long long int)(shared->rows[row + 1] - shared->rows[row]);
 }
 
-void selector_select_last_row(Selector *selector, Table *table)
+char *shared_table_cell(SharedTable *shared, long long int row, long long int col)
 {
     /**
-     * @brief Select last row
+     * @brief Get content of cell of attached table
      *
-     * @param selector Pointer to instance of #Selector structure where data will be saved
-     * @param table Pointer to instance of #Table structure
+     * Content is returned directly from mapped segment without copying
+     *
+     * @param shared Pointer to instance of #SharedTable structure
+     * @param row Index of row
+     * @param col Index of column
+     *
+     * @return Pointer to content, NULL if cell doesnt exist
      */
 
-    selector->lld_ir1 = selector->lld_ir2 = table->num_of_rows - 1;
-    selector->lld_ic1 = 0;
-    selector->lld_ic2 = table->rows[0].num_of_cells - 1;
+    if (col < 0 || col >= shared_table_num_of_cells(shared, row))
+        return NULL;
+
+    return (char*)(shared->data + shared->cells[shared->rows[row] + col]);
 }
 
-int selector_select_4p_area(Selector *selector, Table *table, char **parts, const _Bool *part_is_llint, const long long int *parts_llint)
+int load_shared_table(SharedTable *shared, const char *name, Table *table)
 {
     /**
-     * @brief Parse and set data to selector for 4 parameter selectors
+     * @brief Attach published table @p name and load its rows to @p table
      *
-     * @param selector Pointer to instance of #Selector structure where data will be saved
+     * Cells point directly to mapped segment as cells in #Arena, so rows are neither copied nor parsed \n
+     * Segment has to stay attached until table is deallocated
+     *
+     * @param shared Pointer to instance of #SharedTable structure
+     * @param name Name of published table
      * @param table Pointer to instance of #Table structure
-     * @param parts Pointer to string array where splited data are stored
-     * @param part_is_llint Pointer to array of bools that indicates if corespoding part is long long int
-     * @param parts_llint Pointer to array of long long ints that are converted values from @p parts array if it was possible
      *
-     * @return #NO_ERROR on success and #SELECTOR_ERROR if something failed
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    // Check if there are no _ characters in parts of selector
-    if (!((!part_is_llint[2] && !strings_equal(parts[2], "-")) || (!part_is_llint[3] && !strings_equal(parts[3], "-"))) &&
-        !((!part_is_llint[0] && !strings_equal(parts[0], "-")) || (!part_is_llint[1] && !strings_equal(parts[1], "-"))))
+    int ret_val;
+
+    if ((ret_val = shared_table_attach(shared, name)) != NO_ERROR)
+        return ret_val;
+
+    if ((ret_val = reserve_rows(table, shared->num_of_rows)) != NO_ERROR)
+        return ret_val;
+
+    for (long long int i = 0; i < shared->num_of_rows && ret_val == NO_ERROR; i++)
     {
-        // Check if - chars are only on valid positions ([-,C1,R2,C2] doesnt make sense)
-        if ((!part_is_llint[0] && part_is_llint[2]) || (!part_is_llint[1] && part_is_llint[3]) ||
-            // Check if rows and cols values are valid (R1 <= R2, etc.)
-            (part_is_llint[0] && part_is_llint[2] && parts_llint[0] > parts_llint[2]) ||
-            (part_is_llint[1] && part_is_llint[3] && parts_llint[1] > parts_llint[3]) ||
-            // Check ranges of numerical parts
-            (part_is_llint[0] && (parts_llint[0] > table->num_of_rows || parts_llint[0] < 1)) || (part_is_llint[2] && (parts_llint[2] > table->num_of_rows || parts_llint[2] < 1)) ||
-            (part_is_llint[1] && (parts_llint[1] > table->rows[0].num_of_cells || parts_llint[1] < 1)) || (part_is_llint[3] && (parts_llint[3] > table->rows[0].num_of_cells || parts_llint[3] < 1)))
+        long long int num_of_cells = shared_table_num_of_cells(shared, i);
+        Row *row = &table->rows[table->num_of_rows];
+
+        row->cells = (Cell*)malloc((size_t)((num_of_cells > 0) ? num_of_cells : 1) * sizeof(Cell));
+        if (row->cells == NULL)
+            return ALLOCATION_FAILED;
+
+        row->allocated_cells = num_of_cells;
+        row->num_of_cells = num_of_cells;
+        table->num_of_rows++;
+
+        for (long long int j = 0; j < num_of_cells; j++)
         {
-            return SELECTOR_ERROR;
+            row->cells[j].content = shared_table_cell(shared, i, j);
+            row->cells[j].allocated_chars = (long long int)strlen(row->cells[j].content) + 1;
+            row->cells[j].in_arena = true;
         }
 
-        selector->lld_ir1 = part_is_llint[0] ? parts_llint[0] - 1 : table->num_of_rows - 1;
-        selector->lld_ic1 = part_is_llint[1] ? parts_llint[1] - 1 : table->rows[0].num_of_cells - 1;
-        selector->lld_ir2 = part_is_llint[2] ? parts_llint[2] - 1 : table->num_of_rows - 1;
-        selector->lld_ic2 = part_is_llint[3] ? parts_llint[3] - 1 : table->rows[0].num_of_cells - 1;
+        ret_val = widen_row_types(&table->col_types, &table->num_of_col_types, row);
 
-        return NO_ERROR;
+        if (ret_val == NO_ERROR && (table->num_of_rows % ROWS_PER_PAGE) == 0)
+            ret_val = enforce_memory_budget(table, -1);
     }
 
-    return SELECTOR_ERROR;
+    return ret_val;
 }
 
-int selector_select_2p_area(Selector *selector, Table *table, char **parts, const _Bool *part_is_llint, const long long int *parts_llint)
+int copy_commands(Commands *source, Commands *dest)
 {
     /**
-     * @brief Parse and set data to selector for 2 parameter selectors
+     * @brief Create deep copy of commands
      *
-     * @param selector Pointer to instance of #Selector structure where data will be saved
-     * @param table Pointer to instance of #Table structure
-     * @param parts Pointer to string array where splited data are stored
-     * @param part_is_llint Pointer to array of bools that indicates if corespoding part is long long int
-     * @param parts_llint Pointer to array of long long ints that are converted values from @p parts array if it was possible
+     * Commands are edited in place when they are executed, so resident script is executed only through its copy
      *
-     * @return #NO_ERROR on success and #SELECTOR_ERROR if something failed
+     * @param source Pointer to instance of #Commands structure
+     * @param dest Pointer to empty instance of #Commands structure
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
      */
 
-    if (part_is_llint[0] && part_is_llint[1])
-    {
-        // [R,C]
-        if (parts_llint[0] > 0 && parts_llint[0] <= table->num_of_rows && parts_llint[1] > 0 && parts_llint[1] <= table->rows[0].num_of_cells)
-        {
-            selector->lld_ir1 = selector->lld_ir2 = parts_llint[0] - 1;
-            selector->lld_ic1 = selector->lld_ic2 = parts_llint[1] - 1;
-            return NO_ERROR;
-        }
-    }
-    else if (part_is_llint[0] && !part_is_llint[1])
-    {
-        // [R,_]
-        if (parts_llint[0] > 0 && parts_llint[0] <= table->num_of_rows && strings_equal(parts[1], "_"))
-        {
-            selector->lld_ir1 = selector->lld_ir2 = parts_llint[0] - 1;
-            selector->lld_ic1 = 0;
-            selector->lld_ic2 = table->rows[0].num_of_cells - 1;
-            return NO_ERROR;
-        }
-            // [R,-]
-        else if (parts_llint[0] > 0 && parts_llint[0] <= table->num_of_rows && strings_equal(parts[1], "-"))
-        {
-            selector->lld_ir1 = selector->lld_ir2 = parts_llint[0] - 1;
-            selector->lld_ic1 = selector->lld_ic2 = table->rows[0].num_of_cells - 1;
-            return NO_ERROR;
-        }
-    }
-    else if (!part_is_llint[0] && part_is_llint[1])
+    dest->num_of_commands = 0;
+    dest->commands = (Command*)calloc((source->num_of_commands > 0) ? (size_t)source->num_of_commands : 1, sizeof(Command));
+    if (dest->commands == NULL)
+        return ALLOCATION_FAILED;
+
+    dest->num_of_commands = source->num_of_commands;
+
+    for (long long int i = 0; i < source->num_of_commands; i++)
     {
-        // [_,C]
-        if (strings_equal(parts[0], "_") && parts_llint[1] > 0 && parts_llint[1] <= table->rows[0].num_of_cells)
-        {
-            selector->lld_ir1 = 0;
-            selector->lld_ir2 = table->num_of_rows - 1;
-            selector->lld_ic1 = selector->lld_ic2 = parts_llint[1] - 1;
-            return NO_ERROR;
-        }
-            // [-,C]
-        else if (strings_equal(parts[0], "-") && parts_llint[1] > 0 && parts_llint[1] <= table->rows[0].num_of_cells)
-        {
-            selector->lld_ir1 = selector->lld_ir2 = table->num_of_rows - 1;
-            selector->lld_ic1 = selector->lld_ic2 = parts_llint[1] - 1;
-            return NO_ERROR;
-        }
+        if (string_copy(&source->commands[i].function, &dest->commands[i].function) != NO_ERROR ||
+            (source->commands[i].arguments != NULL && string_copy(&source->commands[i].arguments, &dest->commands[i].arguments) != NO_ERROR))
+            return ALLOCATION_FAILED;
     }
 
-    return SELECTOR_ERROR;
+    return NO_ERROR;
 }
 
-int set_selector(Selector *selector, Selector *temp_selector, Command *command, Table *table) {
+void watch_state_destroy(WatchState *state)
+{
     /**
-     * @brief Set values in @p selector
-     *
-     * Set values in selector based on inputed @p command and @p table
-     *
-     * @param selector Pointer to instance of #Selector structure (main selector)
-     * @param temp_selector Pointer to instance of #Selector structure (temporary selector)
-     * @param command Pointer to instance of #Command structure
-     * @param table Pointer to instance of #Table structure
+     * @brief Free all blocks of @p state
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @param state Pointer to instance of #WatchState structure
      */
 
-    int ret_val;
+    for (long long int i = 0; i < state->num_of_blocks; i++)
+        deallocate_table(&state->blocks[i].rows);
 
-    if (!selector->initialized || !temp_selector->initialized)
-        return FUNCTION_ERROR;
+    free(state->blocks);
+    state->blocks = NULL;
+    state->num_of_blocks = 0;
+    state->allocated_blocks = 0;
+}
 
-    // Get rid of []
-    if ((ret_val = trim_se(command->function)) != NO_ERROR)
-        return ret_val;
+int watch_add_block(WatchState *old, WatchState *scanned, Table *table, LoadBatch *batch, uint64_t hash, long long int *hint)
+{
+    /**
+     * @brief Append block of read lines to @p scanned
+     *
+     * Rows of block of last scan with same lines are reused, other lines are parsed and filtered
+     *
+     * @param old Pointer to instance of #WatchState structure with blocks of last scan
+     * @param scanned Pointer to instance of #WatchState structure with blocks of current scan
+     * @param table Pointer to instance of #Table structure with delimiters and thread pool
+     * @param batch Pointer to instance of #LoadBatch structure with lines of block (lines are freed)
+     * @param hash Hash of lines of block
+     * @param hint Pointer to index of block of last scan that is checked first (blocks are usually found in order)
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
 
-    char *buffer = NULL;
-    char *rest_buf = NULL;
-    if ((ret_val = get_substring(command->function, &buffer, ' ', 0, true, &rest_buf, true)) != NO_ERROR)
-        return ret_val;
+    int ret_val = NO_ERROR;
 
-    if (strings_equal(buffer, "find"))
-    {
-        selector_find(selector, table, rest_buf);
-    }
-    else
+    if (scanned->num_of_blocks == scanned->allocated_blocks)
     {
-        // Static selections
-        if (strings_equal(buffer, "max"))
-        {
-            ret_val = selector_max(selector, table);
-        }
-        else if (strings_equal(buffer, "min"))
-        {
-            ret_val = selector_min(selector, table);
-        }
-        else if (strings_equal(buffer, "_,_"))
-        {
-            selector_select_all(selector, table);
-        }
-        else if (strings_equal(buffer, "-,-") || strings_equal(buffer, "-,-,-,-"))
-        {
-            selector_select_last(selector, table);
-        }
-        else if (strings_equal(buffer, "_,-"))
-        {
-            selector_select_last_colm(selector, table);
-        }
-        else if (strings_equal(buffer, "-,_"))
-        {
-            selector_select_last_row(selector, table);
-        }
-        else if (strings_equal(buffer, "_"))
-        {
-            copy_selector(temp_selector, selector);
-        }
-        else if (strings_equal(buffer, "set"))
-        {
-            copy_selector(selector, temp_selector);
-        }
+        long long int allocated = (scanned->allocated_blocks > 0) ? scanned->allocated_blocks * 2 : BASE_NUMBER_OF_KEYS;
+        WatchBlock *tmp = (WatchBlock*)realloc(scanned->blocks, (size_t)allocated * sizeof(WatchBlock));
+        if (tmp == NULL)
+            ret_val = ALLOCATION_FAILED;
         else
         {
-            long long int num_of_parts = count_char(buffer, ',', true) + 1;
-            char *parts[4] = { NULL };
-            _Bool part_is_llint[4] = { false };
-            long long int parts_llint[4] = { 0 };
+            scanned->blocks = tmp;
+            scanned->allocated_blocks = allocated;
+        }
+    }
 
-            // Parse more complex selections
-            for (long long int i = 0; i < num_of_parts; i++)
-            {
-                if ((ret_val = get_substring(buffer, &parts[i], ',', i, true, NULL, false)) != NO_ERROR)
-                    break;
+    long long int found = -1;
+    for (long long int i = 0; i < old->num_of_blocks && ret_val == NO_ERROR; i++)
+    {
+        long long int candidate = (*hint + i) % old->num_of_blocks;
+        if (old->blocks[candidate].hash == hash && old->blocks[candidate].num_of_lines == batch->num_of_lines)
+        {
+            found = candidate;
+            break;
+        }
+    }
 
-                if ((part_is_llint[i] = is_string_llint(parts[i])) == true)
-                {
-                    if ((ret_val = string_to_llint(parts[i], &parts_llint[i])) != NO_ERROR)
-                        break;
-                }
-                else
-                {
-                    if (!strings_equal(parts[i], "-") && !strings_equal(parts[i], "_"))
-                    {
-                        ret_val = SELECTOR_ERROR;
-                        break;
-                    }
-                }
-            }
+    if (ret_val != NO_ERROR || found >= 0)
+    {
+        for (long long int i = 0; i < batch->num_of_lines; i++)
+            free(batch->lines[i]);
+    }
 
-            // If there is no error continue to validity check and setting new selector
-            if (ret_val == NO_ERROR)
-            {
-                switch (num_of_parts)
-                {
-                    case 2:
-                        // Parser for 2 parts selectors
-                        ret_val = selector_select_2p_area(selector, table, parts, part_is_llint, parts_llint);
-                        break;
+    if (ret_val != NO_ERROR)
+        return ret_val;
 
-                    case 4:
-                        // Parser for 4 parts selectors like [R1,C1,R2,C2], [R1,C1,R2,-], etc
-                        ret_val = selector_select_4p_area(selector, table, parts, part_is_llint, parts_llint);
-                        break;
+    WatchBlock *block = &scanned->blocks[scanned->num_of_blocks];
+    block->hash = hash;
+    block->num_of_lines = batch->num_of_lines;
 
-                    default:
-                        ret_val = SELECTOR_ERROR;
-                        break;
-                }
-            }
+    if (found >= 0)
+    {
+        // Rows are moved, block of last scan stays empty
+        block->rows = old->blocks[found].rows;
+        init_derived_table(&old->blocks[found].rows, table);
+        old->blocks[found].num_of_lines = -1;
+        *hint = found + 1;
+    }
+    else
+    {
+        init_derived_table(&block->rows, table);
+        batch->table = &block->rows;
 
-            for (int j = 0; j < 4; j++)
-                free(parts[j]);
-        }
+        if ((ret_val = parse_batch(batch)) == NO_ERROR)
+            ret_val = filter_table(&block->rows, 0);
     }
 
-    free(buffer);
-    free(rest_buf);
+    scanned->num_of_blocks++;
 
     return ret_val;
 }
 
-int load_table(const char *delims, char *filepath, Table *table)
+int watch_scan(WatchState *state, Table *table, char *filepath)
 {
     /**
-     * @brief Load table from file
+     * @brief Split input file to blocks and parse only blocks that are not in @p state
      *
-     * Load and parse data from file
+     * Block ends after line whose hash is multiple of #WATCH_BLOCK_LINES (or after #LOAD_BATCH_SIZE lines),
+     * so lines inserted, changed or appended to file change only blocks that contain them \n
+     * Blocks of last scan that werent found in file are freed
      *
-     * @param delims Array with all posible delimiters
+     * @param state Pointer to instance of #WatchState structure with blocks of last scan
+     * @param table Pointer to instance of #Table structure with delimiters and thread pool
      * @param filepath Path to input file
-     * @param table Pointer #Table where data will be saved
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
     int ret_val = NO_ERROR;
-    FILE *file;
-    char *line = NULL;
-    long long int line_index = 0;
+    ReadAheadReader reader;
 
-    // Try to open input file
-    file = fopen(filepath, "r");
-    if (file == NULL)
-        return CANT_OPEN_FILE;
+    if ((ret_val = read_ahead_open(&reader, filepath, 0, -1)) != NO_ERROR)
+        return ret_val;
 
-    // Allocate first row
-    if (allocate_rows(table) != NO_ERROR)
-    {
-        fclose(file);
-        return ALLOCATION_FAILED;
-    }
+    WatchState scanned = { .blocks = NULL, .num_of_blocks = 0, .allocated_blocks = 0 };
+    LoadBatch batch;
+    batch.delims = table->input_delims;
+    batch.num_of_lines = 0;
+    batch.lines = (char**)malloc(LOAD_BATCH_SIZE * sizeof(char*));
+    if (batch.lines == NULL)
+        ret_val = ALLOCATION_FAILED;
+
+    uint64_t hash = 0;
+    long long int hint = 0;
+    _Bool end_of_file = false;
 
-    // Iterate thru input file
-    // When we set buffer size to 0 and output char pointer to NULL then getline will allocate memory itself
-    while (get_line(&line, file) != -1)
+    while (!end_of_file && ret_val == NO_ERROR)
     {
-        if (line == NULL)
+        _Bool boundary = false;
+        char *line = NULL;
+
+        if (read_ahead_get_line(&reader, &line) == -1)
         {
+            free(line);
+            end_of_file = true;
+        }
+        else if (line == NULL)
             ret_val = ALLOCATION_FAILED;
-            break;
+        else
+        {
+            uint64_t line_hash = hash_bytes(line, strlen(line), 0);
+            hash = hash_bytes((const char*)&line_hash, sizeof(line_hash), hash);
+            batch.lines[batch.num_of_lines++] = line;
+            boundary = ((line_hash & (WATCH_BLOCK_LINES - 1)) == 0 || batch.num_of_lines == LOAD_BATCH_SIZE);
         }
 
-        rm_newline_chars(line);
+        if (ret_val == NO_ERROR && (boundary || end_of_file) && batch.num_of_lines > 0)
+        {
+            ret_val = watch_add_block(state, &scanned, table, &batch, hash, &hint);
+            batch.num_of_lines = 0;
+            hash = 0;
+        }
+    }
 
-        normalize_delims(line, delims);
+    for (long long int i = 0; i < batch.num_of_lines; i++)
+        free(batch.lines[i]);
+    free(batch.lines);
 
-        // Check if we still have room in rows array
-        if (line_index >= table->allocated_rows)
-            // Allocate larger array of rows
-            if (allocate_rows(table) != NO_ERROR)
-            {
-                ret_val = ALLOCATION_FAILED;
-                break;
-            }
+    int close_ret_val = read_ahead_close(&reader);
+    if (ret_val == NO_ERROR)
+        ret_val = close_ret_val;
 
-        if ((ret_val = create_row_from_data(line, table)) != NO_ERROR)
-            break;
+    // Blocks that werent reused are freed (all blocks on error, so next scan parses whole file)
+    watch_state_destroy(state);
+    if (ret_val == NO_ERROR)
+        *state = scanned;
+    else
+        watch_state_destroy(&scanned);
 
-        free(line);
-        line_index++;
-    }
+    return ret_val;
+}
+
+int copy_row_cells(Row *target, Row *source)
+{
+    /**
+     * @brief Copy all cells of @p source to @p target row without cells
+     *
+     * @param target Pointer to instance of #Row structure without cells
+     * @param source Pointer to instance of #Row structure
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
 
+    if (source->num_of_cells == 0)
+        return NO_ERROR;
 
-    // Close input file
-    fclose(file);
+    if (create_row_cells(target, source->num_of_cells) != NO_ERROR)
+        return ALLOCATION_FAILED;
 
-    return ret_val;
+    for (long long int j = 0; j < source->num_of_cells; j++)
+        if (set_cell((source->cells[j].content != NULL) ? source->cells[j].content : EMPTY_CELL, &target->cells[j]) != NO_ERROR)
+            return ALLOCATION_FAILED;
+
+    return NO_ERROR;
 }
 
-int delete_col(Table *table, long long int index)
+int watch_build_table(WatchState *state, Table *table)
 {
     /**
-     * @brief Delete column
+     * @brief Replace rows of @p table with copy of rows of all blocks
      *
-     * Delete content of cells in colm of @p index and shift all cols on the right side of it leftside
+     * Blocks stay untouched, so script can edit table and they are reused by next scan
      *
+     * @param state Pointer to instance of #WatchState structure
      * @param table Pointer to instance of #Table structure
-     * @param index Index of column we want to delete
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    if (table->rows == NULL || table->num_of_rows == 0)
-        return VALUE_ERROR;
+    int ret_val = NO_ERROR;
 
+    Table empty;
+    init_derived_table(&empty, table);
+    if ((ret_val = replace_table(table, &empty)) != NO_ERROR)
+        return ret_val;
 
-    for (long long int i = 0; i < table->num_of_rows; i++)
+    for (long long int b = 0; b < state->num_of_blocks && ret_val == NO_ERROR; b++)
     {
-        if (table->rows[i].num_of_cells <= index || index < 0)
-            return FUNCTION_ARGUMENT_ERROR;
+        Table *rows = &state->blocks[b].rows;
 
-        long long int j = index;
-        if ((table->rows[i].num_of_cells - 1) > index)
+        for (long long int j = 0; j < rows->num_of_col_types && ret_val == NO_ERROR; j++)
+            ret_val = widen_column_type(&table->col_types, &table->num_of_col_types, j, rows->col_types[j]);
+
+        for (long long int i = 0; i < rows->num_of_rows && ret_val == NO_ERROR; i++)
         {
-            for (j = index + 1; j < table->rows[i].num_of_cells; j++)
-            {
-                if (table->rows[i].cells[j].content == NULL)
-                    return FUNCTION_ERROR;
+            if (table->rows == NULL || table->num_of_rows >= table->allocated_rows)
+                if ((ret_val = allocate_rows(table)) != NO_ERROR)
+                    break;
 
-                if (set_cell(table->rows[i].cells[j].content, &table->rows[i].cells[j - 1]) != NO_ERROR)
-                    return ALLOCATION_FAILED;
-            }
-            j--;
-        }
+            // Count row even if it is only partialy copied so it will be deallocated
+            ret_val = copy_row_cells(get_row(table, table->num_of_rows), &rows->rows[i]);
+            table->num_of_rows++;
 
-        deallocate_cell(&table->rows[i].cells[j]);
-        table->rows[i].num_of_cells--;
+            if (ret_val == NO_ERROR && (table->num_of_rows % ROWS_PER_PAGE) == 0)
+                ret_val = enforce_memory_budget(table, -1);
+        }
     }
 
-    return NO_ERROR;
+    return ret_val;
 }
 
-int delete_cols(Table *table, long long int start_index, long long int end_index)
+int watch_execute(Table *table, Commands *script, char *delims, char *output_path, const char *publish_name)
 {
     /**
-     * @brief Delete columns
-     *
-     * Delete content of cells in colms within range of @p start_index and @p end_index
+     * @brief Execute copy of resident script on table built from blocks and save output
      *
      * @param table Pointer to instance of #Table structure
-     * @param start_index Start index of column we want to delete
-     * @param end_index End index of column we want to delete
+     * @param script Pointer to instance of #Commands structure with resident script
+     * @param delims Array with all posible delimiters
+     * @param output_path Path to output file
+     * @param publish_name Name of shared memory table the result is published to (NULL if it isnt published)
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    int ret_val = NO_ERROR;
+    int error_flag = NO_ERROR;
+    Commands commands = { .num_of_commands = 0, .commands = NULL };
 
-    if (end_index >= table->rows[0].num_of_cells)
-        end_index = table->rows[0].num_of_cells - 1;
+    if (table->rows != NULL && table->num_of_rows != 0)
+    {
+        if ((error_flag = normalize_number_of_cols(table)) != NO_ERROR)
+            fprintf(stderr, "Failed to normalize colums\n");
 
-    for (long long int i = end_index; i >= start_index; i--)
+        if (error_flag == NO_ERROR && (error_flag = register_formula_cells(table, 0, 0)) != NO_ERROR)
+            fprintf(stderr, "Failed to find formula cells\n");
+
+        if (error_flag == NO_ERROR && (error_flag = copy_commands(script, &commands)) != NO_ERROR)
+            fprintf(stderr, "Failed to get commands\n");
+
+        if (error_flag == NO_ERROR && (error_flag = execute_commands(table, &commands, NULL)) != NO_ERROR)
+            fprintf(stderr, "Failed to execute all commands\n");
+
+        if (error_flag == NO_ERROR && (error_flag = recalculate_formulas(table)) != NO_ERROR)
+            fprintf(stderr, "Failed to recalculate formula cells\n");
+
+        if (error_flag == NO_ERROR && publish_name != NULL && (error_flag = publish_table(table, publish_name)) != NO_ERROR)
+            fprintf(stderr, "Failed to publish table\n");
+
+        if (error_flag == NO_ERROR && (error_flag = format_table_for_output(table, delims)) != NO_ERROR)
+            fprintf(stderr, "Failed to execute format table for output\n");
+    }
+
+    deallocate_base_commands(&commands);
+
+    int save_flag = save_table(table, output_path);
+
+    return (error_flag != NO_ERROR) ? error_flag : save_flag;
+}
+
+void request_stop(int signal_number)
+{
+    /**
+     * @brief Signal handler that stops watch mode or daemon
+     *
+     * @param signal_number Number of received signal (not used)
+     */
+
+    (void)signal_number;
+    stop_requested = 1;
+}
+
+void handle_stop_signals(void)
+{
+    /**
+     * @brief Set #request_stop as handler of SIGINT and SIGTERM
+     *
+     * Handler is set without SA_RESTART, so signal interrupts waiting and resident data are freed before exit
+     */
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = request_stop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+}
+
+int watch_wait(int fd, const char *name, long long int delay)
+{
+    /**
+     * @brief Wait until file @p name of watched directory changes and then stays unchanged for @p delay milliseconds
+     *
+     * @param fd Inotify descriptor that watches directory of file
+     * @param name Name of file in directory
+     * @param delay Milliseconds without change
+     *
+     * @return #NO_ERROR when file changed or watch mode was stopped, #IO_ERROR on error
+     */
+
+    char buffer[WATCH_EVENT_BUFFER] __attribute__((aligned(__alignof__(struct inotify_event))));
+    _Bool changed = false;
+
+    while (!stop_requested)
     {
-        if ((ret_val = delete_col(table, i)) != NO_ERROR)
-            break;
+        struct pollfd watched = { .fd = fd, .events = POLLIN, .revents = 0 };
+        int ready = poll(&watched, 1, changed ? (int)delay : -1);
+
+        if (ready < 0 && errno == EINTR)
+            continue;
+        if (ready < 0)
+            return IO_ERROR;
+
+        // File stayed unchanged for whole delay
+        if (ready == 0)
+            return NO_ERROR;
+
+        ssize_t length = read(fd, buffer, sizeof(buffer));
+        if (length < 0 && errno == EINTR)
+            continue;
+        if (length <= 0)
+            return IO_ERROR;
+
+        for (char *position = buffer; position < buffer + length;)
+        {
+            struct inotify_event *event = (struct inotify_event*)position;
+            if (event->len > 0 && strings_equal(event->name, name))
+                changed = true;
+            position += sizeof(struct inotify_event) + event->len;
+        }
     }
 
-    return ret_val;
+    return NO_ERROR;
 }
 
-int append_col(Table *table)
+int watch_input(Options *options, Table *table, Commands *script)
 {
     /**
-     * @brief Append empty column to right of the table
+     * @brief Execute script on input file and again after every change of the file until process is interrupted
      *
-     * Iterate over all rows and add empty column to the end of each of them
+     * Directory of file is watched, so file replaced by rename is watched too \n
+     * Parsed blocks of file and script stay resident, change of file parses only blocks that changed
      *
+     * @param options Pointer to instance of #Options structure
      * @param table Pointer to instance of #Table structure
+     * @param script Pointer to instance of #Commands structure with parsed script
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @return #NO_ERROR when watch mode was interrupted, other codes from #ErrorCodes on error
      */
 
-    if (table->rows == NULL || table->num_of_rows == 0)
-        return VALUE_ERROR;
+    int ret_val = NO_ERROR;
 
-    int ret_val;
+    const char *slash = strrchr(options->input_path, '/');
+    const char *name = (slash != NULL) ? slash + 1 : options->input_path;
+    size_t directory_length = (slash != NULL) ? (size_t)(slash - options->input_path) + 1 : 1;
 
-    for (long long int i = 0; i < table->num_of_rows; i++)
+    char *directory = (char*)malloc((directory_length + 1) * sizeof(char));
+    if (directory == NULL)
+        return ALLOCATION_FAILED;
+
+    if (slash != NULL)
+        memcpy(directory, options->input_path, directory_length);
+    else
+        directory[0] = '.';
+    directory[directory_length] = '\0';
+
+    int fd = inotify_init1(IN_CLOEXEC);
+    if (fd < 0 || inotify_add_watch(fd, directory, IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0)
+        ret_val = IO_ERROR;
+
+    free(directory);
+
+    handle_stop_signals();
+
+    WatchState state = { .blocks = NULL, .num_of_blocks = 0, .allocated_blocks = 0 };
+
+    while (ret_val == NO_ERROR && !stop_requested)
     {
-        if ((ret_val = append_empty_cell(&table->rows[i])) != NO_ERROR)
-            return ret_val;
+        int scan_ret_val = watch_scan(&state, table, options->input_path);
+
+        // File can be missing for a while when it is replaced
+        if (scan_ret_val == CANT_OPEN_FILE)
+            fprintf(stderr, "Failed to load table properly\n");
+        else if (scan_ret_val != NO_ERROR || (scan_ret_val = watch_build_table(&state, table)) != NO_ERROR)
+            fprintf(stderr, "Failed to load table properly\n");
+        else
+            watch_execute(table, script, options->delims, options->output_path, options->publish_name);
+
+        if (scan_ret_val == ALLOCATION_FAILED)
+            ret_val = scan_ret_val;
+
+        if (ret_val == NO_ERROR)
+            ret_val = watch_wait(fd, name, options->watch_delay);
     }
 
-    return NO_ERROR;
+    watch_state_destroy(&state);
+    if (fd >= 0)
+        close(fd);
+
+    return ret_val;
 }
 
-int insert_col(Table *table, long long int index)
+int parse_script(char *script, Commands *commands)
 {
     /**
-     * @brief Insert column to table
+     * @brief Parse command sequence received by daemon
      *
-     * Insert empty column to table in the @p index and push all columns to the right
+     * Script cant name command file, so clients cant read files of daemon
      *
-     * @param table Pointer to instance of #Table struct
-     * @param index Index of column where we want insert new one
+     * @param script Command sequence (it is edited)
+     * @param commands Pointer to empty instance of #Commands structure
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    if (table->rows == NULL || table->num_of_rows == 0)
-        return VALUE_ERROR;
+    int ret_val;
+    Raw_commands raw_commands = { .commands = NULL, .num_of_commands = 0 };
 
-    for (long long int i = 0; i < table->num_of_rows; i++)
-    {
-        if (table->rows[i].num_of_cells <= index || index < 0)
-            return FUNCTION_ARGUMENT_ERROR;
+    commands->commands = NULL;
+    commands->num_of_commands = 0;
 
-        if (table->rows[i].cells == NULL)
-            return FUNCTION_ERROR;
+    if (string_start_with(script, "-c"))
+        return COMMAND_ERROR;
 
-        if (table->rows[i].num_of_cells == table->rows[i].allocated_cells)
-        {
-            // Allocate more space
-            if (allocate_cells(&table->rows[i]) != NO_ERROR)
-                return ALLOCATION_FAILED;
-        }
+    if ((ret_val = get_commands(script, &raw_commands)) == NO_ERROR)
+        ret_val = parse_commands(&raw_commands, commands);
 
-        for (long long j = table->rows[i].num_of_cells; j > index; j--)
-        {
-            if (table->rows[i].cells[j - 1].content == NULL)
-                return FUNCTION_ERROR;
+    deallocate_raw_commands(&raw_commands);
 
-            if (set_cell(table->rows[i].cells[j - 1].content, &table->rows[i].cells[j]) != NO_ERROR)
-                return ALLOCATION_FAILED;
-        }
+    return ret_val;
+}
 
-        if (set_cell(EMPTY_CELL, &table->rows[i].cells[index]) != NO_ERROR)
-            return ALLOCATION_FAILED;
+void release_row_block(RowBlock *block)
+{
+    /**
+     * @brief Drop one reference of @p block and free it when no version contains it
+     *
+     * @param block Pointer to instance of #RowBlock structure
+     */
+
+    if (--block->references > 0)
+        return;
+
+    for (long long int i = 0; i < block->num_of_rows; i++)
+        deallocate_row(&block->rows[i]);
+
+    free(block->rows);
+    free(block);
+}
+
+void free_version(TableVersion *version)
+{
+    /**
+     * @brief Free version and blocks that arent contained in any other version
+     *
+     * @param version Pointer to instance of #TableVersion structure
+     */
 
-        table->rows[i].num_of_cells++;
-    }
+    for (long long int i = 0; i < version->num_of_blocks; i++)
+        if (version->blocks[i] != NULL)
+            release_row_block(version->blocks[i]);
 
-    return NO_ERROR;
+    free(version->blocks);
+    free(version->rows);
+    free(version->col_types);
+    free(version);
 }
 
-int append_row(Table *table)
+int copy_row_block(Table *table, long long int page, uint64_t hash, uint64_t id, RowBlock **block)
 {
     /**
-     * @brief Append row to the bottom of table
+     * @brief Create block with deep copy of rows of @p page
      *
      * @param table Pointer to instance of #Table structure
+     * @param page Index of page
+     * @param hash Hash of rows of page
+     * @param id Identifier of block
+     * @param block Pointer where created block will be saved
      *
      * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
      */
 
-    // if there is no reference row then create new row with one cell
-    long long int number_of_cells = table->num_of_rows > 0 ? table->rows[0].num_of_cells : 1;
+    long long int first_row = page * ROWS_PER_PAGE;
+    long long int num_of_rows = (table->num_of_rows - first_row < ROWS_PER_PAGE) ? table->num_of_rows - first_row : ROWS_PER_PAGE;
 
-    // If there is no more space
-    if (table->num_of_rows == table->allocated_rows)
-    {
-        // Allocate more rows
-        if (allocate_rows(table) != NO_ERROR)
-            return ALLOCATION_FAILED;
-    }
+    *block = (RowBlock*)malloc(sizeof(RowBlock));
+    if (*block == NULL)
+        return ALLOCATION_FAILED;
 
-    for (long long int i = 0; i < number_of_cells; i++)
+    (*block)->references = 1;
+    (*block)->id = id;
+    (*block)->hash = hash;
+    (*block)->num_of_rows = 0;
+    (*block)->rows = (Row*)malloc((size_t)num_of_rows * sizeof(Row));
+    if ((*block)->rows == NULL)
+        return ALLOCATION_FAILED;
+
+    for (long long int i = 0; i < num_of_rows; i++)
     {
-        if (append_empty_cell(&table->rows[table->num_of_rows]) != NO_ERROR)
+        Row *row = &(*block)->rows[i];
+        row->cells = NULL;
+        row->num_of_cells = 0;
+        row->allocated_cells = 0;
+        row->cells_in_arena = false;
+        row->spill_offset = -1;
+        (*block)->num_of_rows++;
+
+        if (copy_row_cells(row, get_row(table, first_row + i)) != NO_ERROR)
             return ALLOCATION_FAILED;
     }
 
-    table->num_of_rows++;
-
     return NO_ERROR;
 }
 
-int insert_row(Table *table, long long int index)
+int create_version(Table *table, TableVersion *previous, uint64_t *next_block_id, TableVersion **version)
 {
     /**
-     * @brief Insert row to table
+     * @brief Create version with current content of writer table
      *
-     * Insert empty row to the table on place of @p index and shift all rows down
+     * Pages whose rows have same hash as block of @p previous version share that block, only changed pages are copied
      *
-     * @param table Pointer to instance of #Table struct
-     * @param index Index of row where we want to place new row
+     * @param table Pointer to instance of #Table structure of writer
+     * @param previous Pointer to instance of #TableVersion structure with current version (NULL if there is none)
+     * @param next_block_id Pointer to identifier of next created block
+     * @param version Pointer where created version will be saved
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
      */
 
-    if (table->rows == NULL || table->num_of_rows == 0)
-        return VALUE_ERROR;
+    int ret_val = NO_ERROR;
+    long long int num_of_blocks = get_number_of_chunks(table->num_of_rows, ROWS_PER_PAGE);
 
-    if (table->num_of_rows <= index || index < 0)
-        return FUNCTION_ARGUMENT_ERROR;
+    TableVersion *created = (TableVersion*)calloc(1, sizeof(TableVersion));
+    if (created == NULL)
+        return ALLOCATION_FAILED;
 
-    // if there is no reference row then create new row with one cell
-    long long int number_of_cells = table->num_of_rows > 0 ? table->rows[0].num_of_cells : 1;
+    created->generation = (previous != NULL) ? previous->generation + 1 : 1;
+    created->blocks = (RowBlock**)calloc((num_of_blocks > 0) ? (size_t)num_of_blocks : 1, sizeof(RowBlock*));
+    created->rows = (Row*)malloc((table->num_of_rows > 0) ? (size_t)table->num_of_rows * sizeof(Row) : sizeof(Row));
+    created->col_types = (unsigned char*)malloc((table->num_of_col_types > 0) ? (size_t)table->num_of_col_types : 1);
+    if (created->blocks == NULL || created->rows == NULL || created->col_types == NULL)
+        ret_val = ALLOCATION_FAILED;
+    else
+        created->num_of_blocks = num_of_blocks;
 
-    // If there is no more space
-    if (table->num_of_rows == table->allocated_rows)
-    {
-        // Allocate more rows
-        if (allocate_rows(table) != NO_ERROR)
-            return ALLOCATION_FAILED;
-    }
+    if (ret_val == NO_ERROR && table->num_of_col_types > 0)
+        memcpy(created->col_types, table->col_types, (size_t)table->num_of_col_types);
+    created->num_of_col_types = table->num_of_col_types;
 
-    for (long long int i = table->num_of_rows; i > index; i--)
+    for (long long int page = 0; page < created->num_of_blocks && ret_val == NO_ERROR; page++)
     {
-        if (table->rows[i - 1].cells == NULL)
-            return FUNCTION_ERROR;
+        uint64_t hash = hash_page(table, page);
+        long long int first_row = page * ROWS_PER_PAGE;
+        long long int num_of_rows = (table->num_of_rows - first_row < ROWS_PER_PAGE) ? table->num_of_rows - first_row : ROWS_PER_PAGE;
+        RowBlock *old = (previous != NULL && page < previous->num_of_blocks) ? previous->blocks[page] : NULL;
 
-        table->rows[i].cells = table->rows[i - 1].cells;
-        table->rows[i].num_of_cells = table->rows[i - 1].num_of_cells;
-        table->rows[i].allocated_cells = table->rows[i - 1].allocated_cells;
-    }
+        if (old != NULL && old->hash == hash && old->num_of_rows == num_of_rows)
+        {
+            old->references++;
+            created->blocks[page] = old;
+        }
+        else if ((ret_val = copy_row_block(table, page, hash, (*next_block_id)++, &created->blocks[page])) != NO_ERROR)
+            break;
 
-    // Clear what is in original index
-    table->rows[index].cells = NULL;
-    table->rows[index].num_of_cells = 0;
-    table->rows[index].allocated_cells = 0;
+        memcpy(&created->rows[first_row], created->blocks[page]->rows, (size_t)num_of_rows * sizeof(Row));
+        created->num_of_rows += num_of_rows;
+    }
 
-    for (long long int i = 0; i < number_of_cells; i++)
-        if (append_empty_cell(&table->rows[index]) != NO_ERROR)
-            return ALLOCATION_FAILED;
+    if (ret_val != NO_ERROR)
+    {
+        free_version(created);
+        return ret_val;
+    }
 
-    table->num_of_rows++;
+    *version = created;
 
     return NO_ERROR;
 }
 
-int delete_row(Table *table, long long int index)
+void init_version_view(Table *view, TableVersion *version, Table *source, ResultCache *cache)
 {
     /**
-     * @brief Delete row
+     * @brief Initialize @p view as read-only table over rows of @p version
      *
-     * Delete content of row on @p index and shift all rows bellow it up
+     * View has no pool, so reader computes on its own thread
      *
-     * @param table Pointer to instance of #Table structure
-     * @param index Index of row we want to delete
+     * @param view Pointer to instance of #Table structure that will be initialized
+     * @param version Pointer to instance of #TableVersion structure
+     * @param source Pointer to instance of #Table structure with delimiters
+     * @param cache Pointer to instance of #ResultCache structure with results of aggregations of versions
+     */
+
+    init_derived_table(view, source);
+    view->pool = NULL;
+    view->rows = version->rows;
+    view->num_of_rows = version->num_of_rows;
+    view->allocated_rows = version->num_of_rows;
+    view->col_types = version->col_types;
+    view->num_of_col_types = version->num_of_col_types;
+    view->version = version;
+    view->cache = cache;
+}
+
+int version_store_init(VersionStore *store, Table *table, int num_of_readers)
+{
+    /**
+     * @brief Initialize store and publish first version of @p table
+     *
+     * @param store Pointer to instance of #VersionStore structure
+     * @param table Pointer to instance of #Table structure of writer
+     * @param num_of_readers Number of slots of readers
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    if (table->rows == NULL || table->num_of_rows == 0)
-        return VALUE_ERROR;
+    void *readers = NULL;
 
-    if (index < 0 || index >= table->num_of_rows)
-        return FUNCTION_ARGUMENT_ERROR;
+    store->current = NULL;
+    store->epoch = 1;
+    store->retired = NULL;
+    store->table = table;
+    store->num_of_readers = 0;
+    store->next_block_id = 0;
 
-    deallocate_row(&table->rows[index]);
+    if (posix_memalign(&readers, READER_SLOT_SIZE, (size_t)num_of_readers * sizeof(ReaderSlot)) != 0)
+        return ALLOCATION_FAILED;
 
-    if (index < (table->num_of_rows - 1))
+    store->readers = (ReaderSlot*)readers;
+    store->num_of_readers = num_of_readers;
+    memset(store->readers, 0, (size_t)num_of_readers * sizeof(ReaderSlot));
+
+    if (pthread_mutex_init(&store->writer_lock, NULL) != 0)
     {
-        for (long long int i = (index + 1); i < table->num_of_rows; i++)
-        {
-            if (table->rows[i].cells == NULL)
-                return FUNCTION_ERROR;
+        free(store->readers);
+        return FUNCTION_ERROR;
+    }
 
-            table->rows[i - 1].num_of_cells = table->rows[i].num_of_cells;
-            table->rows[i - 1].allocated_cells = table->rows[i].allocated_cells;
-            table->rows[i - 1].cells = table->rows[i].cells;
-        }
+    if ((store->cache = (ResultCache*)malloc(sizeof(ResultCache))) == NULL)
+    {
+        pthread_mutex_destroy(&store->writer_lock);
+        free(store->readers);
+        return ALLOCATION_FAILED;
     }
 
-    table->num_of_rows--;
+    for (int i = 0; i < RESULT_CACHE_SIZE; i++)
+        store->cache->entries[i].used = false;
+    for (int i = 0; i < RESULT_CACHE_STRIPES; i++)
+        pthread_mutex_init(&store->cache->locks[i], NULL);
 
-    return NO_ERROR;
+    int ret_val = create_version(table, NULL, &store->next_block_id, &store->current);
+    if (ret_val != NO_ERROR)
+    {
+        for (int i = 0; i < RESULT_CACHE_STRIPES; i++)
+            pthread_mutex_destroy(&store->cache->locks[i]);
+        free(store->cache);
+        pthread_mutex_destroy(&store->writer_lock);
+        free(store->readers);
+    }
+
+    return ret_val;
 }
 
-int delete_rows(Table *table, long long int start_index, long long int end_index)
+TableVersion *pin_version(VersionStore *store, int slot)
 {
     /**
-     * @brief Delete rows
+     * @brief Pin current version for reader in @p slot
      *
-     * Delete content of rows and cells in them in rows within range of @p start_index and @p end_index
+     * Epoch is announced before version is loaded, so writer that replaces loaded version sees it
      *
-     * @param table Pointer to instance of #Table structure
-     * @param start_index Start index of column we want to delete
-     * @param end_index End index of column we want to delete
+     * @param store Pointer to instance of #VersionStore structure
+     * @param slot Index of slot of reader
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @return Pointer to pinned version
      */
 
-    int ret_val = NO_ERROR;
+    uint64_t epoch = __atomic_load_n(&store->epoch, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&store->readers[slot].epoch, epoch, __ATOMIC_SEQ_CST);
 
-    if (end_index >= table->num_of_rows)
-        end_index = table->num_of_rows - 1;
+    return __atomic_load_n(&store->current, __ATOMIC_SEQ_CST);
+}
 
-    for (long long int i = end_index; i >= start_index; i--)
-    {
-        if ((ret_val = delete_row(table, i)) != NO_ERROR)
-            return ret_val;
-    }
+void unpin_version(VersionStore *store, int slot)
+{
+    /**
+     * @brief Release version pinned by reader in @p slot
+     *
+     * @param store Pointer to instance of #VersionStore structure
+     * @param slot Index of slot of reader
+     */
 
-    return ret_val;
+    __atomic_store_n(&store->readers[slot].epoch, 0, __ATOMIC_RELEASE);
 }
 
-int set_temporary_variable(Table *table, Selector *selector, TempVariableStore *temp_var_store, long long int index)
+void reclaim_versions(VersionStore *store)
 {
     /**
-     * @brief Set temporary variable
+     * @brief Free replaced versions that no reader can read
      *
-     * Allocate and set value in temporary variable of @p index
-     *
-     * @param table Pointer to instance of #Table structure that will be eddited
-     * @param selector Pointer to instance of #Selector structure for selecting value we want to save
-     * @param temp_var_store Pointer to instance of #TempVariableStore structure used for stroring values
-     * @param index Index of temporary variable we want to work with
+     * Version replaced in epoch E can be read only by readers that pinned epoch E or older
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @param store Pointer to instance of #VersionStore structure
      */
 
-    int ret_val = NO_ERROR;
+    uint64_t oldest = UINT64_MAX;
+    for (int i = 0; i < store->num_of_readers; i++)
+    {
+        uint64_t epoch = __atomic_load_n(&store->readers[i].epoch, __ATOMIC_SEQ_CST);
+        if (epoch != 0 && epoch < oldest)
+            oldest = epoch;
+    }
 
-    if (table->num_of_rows > 0 && table->rows[0].num_of_cells > 0 &&
-        table->num_of_rows > selector->lld_ir1 && table->rows[0].num_of_cells > selector->lld_ic1 &&
-        table->rows[selector->lld_ir1].cells[selector->lld_ic1].content != NULL)
+    TableVersion **link = &store->retired;
+    while (*link != NULL)
     {
-        if (temp_var_store->variables[index] != NULL)
+        TableVersion *version = *link;
+        if (version->retired_epoch < oldest)
         {
-            free(temp_var_store->variables[index]);
-            temp_var_store->variables[index] = NULL;
+            *link = version->next_retired;
+            free_version(version);
         }
-
-        char *temp_string = NULL;
-        if ((ret_val = string_copy(&table->rows[selector->lld_ir1].cells[selector->lld_ic1].content, &temp_string)) != NO_ERROR)
-            return ret_val;
-
-        temp_var_store->variables[index] = temp_string;
+        else
+            link = &version->next_retired;
     }
-
-    return ret_val;
 }
 
-int set_cell_from_temporary_variable(Table *table, Selector *selector, TempVariableStore *temp_var_store, long long int index)
+int publish_version(VersionStore *store)
 {
     /**
-     * @brief Set value from temporary variable to cell
+     * @brief Publish current content of writer table as new version
      *
-     * Set temporary variable of @p index to cell selected by @p selector
+     * Must be called with writer lock held
      *
-     * @param table Pointer to instance of #Table structure that will be eddited
-     * @param selector Pointer to instance of #Selector structure for selecting value we want to use
-     * @param temp_var_store Pointer to instance of #TempVariableStore structure used for stroring values
-     * @param index Index of temporary variable we want to work with
+     * @param store Pointer to instance of #VersionStore structure
      *
      * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    int ret_val = NO_ERROR;
+    TableVersion *previous = store->current;
+    TableVersion *version = NULL;
+    int ret_val;
 
-    if (table->num_of_rows > 0 && table->rows[0].num_of_cells > 0 &&
-        temp_var_store->variables[index] != NULL)
-    {
-        ret_val = set_value_in_area(table, selector, temp_var_store->variables[index]);
-    }
+    if ((ret_val = create_version(store->table, previous, &store->next_block_id, &version)) != NO_ERROR)
+        return ret_val;
 
-    return ret_val;
+    __atomic_store_n(&store->current, version, __ATOMIC_SEQ_CST);
+    previous->retired_epoch = __atomic_fetch_add(&store->epoch, 1, __ATOMIC_SEQ_CST);
+    previous->next_retired = store->retired;
+    store->retired = previous;
+
+    reclaim_versions(store);
+
+    return NO_ERROR;
 }
 
-int increase_temporary_variable(TempVariableStore *temp_var_store, long long int index)
+void version_store_destroy(VersionStore *store)
 {
     /**
-     * @brief Increase value in temporary variable
-     *
-     * Increase value of temporary variable if exist\n
-     * If value is no numeric value then set its value to 1
+     * @brief Free all versions of store
      *
-     * @param temp_var_store Pointer to instance of #TempVariableStore structure used for stroring values
-     * @param index Index of temporary variable we want to work with
+     * @warning
+     * No reader can read any version
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @param store Pointer to instance of #VersionStore structure
      */
 
-    int ret_val = NO_ERROR;
-
-    if (temp_var_store->variables[index] != NULL)
+    while (store->retired != NULL)
     {
-        // Create temp variables
-        long double temp_val = 0;
+        TableVersion *next = store->retired->next_retired;
+        free_version(store->retired);
+        store->retired = next;
+    }
 
-        if (is_string_ldouble(temp_var_store->variables[index]))
-        {
-            if ((ret_val = string_to_ldouble(temp_var_store->variables[index], &temp_val)) != NO_ERROR)
-                return ret_val;
+    if (store->current != NULL)
+        free_version(store->current);
+    store->current = NULL;
 
-            temp_val += 1.0;
-        }
-        else
-            temp_val = 1.0;
+    pthread_mutex_destroy(&store->writer_lock);
+    for (int i = 0; i < RESULT_CACHE_STRIPES; i++)
+        pthread_mutex_destroy(&store->cache->locks[i]);
+    free(store->cache);
+    free(store->readers);
+    store->readers = NULL;
+}
 
-        char *temp_string = NULL;
+int append_number_response(OutputBuffer *response, long double value, _Bool nan)
+{
+    /**
+     * @brief Append one line response with number to @p response
+     *
+     * @param response Pointer to instance of #OutputBuffer structure
+     * @param value Number
+     * @param nan Flag if NaN is responded instead of number
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
+     */
 
-        // Format string value
-        if (is_ldouble_lint(temp_val))
-        {
-            if ((ret_val = lint_to_string((long int)temp_val, &temp_string)) != NO_ERROR)
-                return ret_val;
-        }
-        else
-        {
-            if ((ret_val = ldouble_to_string(temp_val, &temp_string)) != NO_ERROR)
-                return ret_val;
-        }
+    char *string = NULL;
+    int ret_val;
 
-        // Clear old variable
-        free(temp_var_store->variables[index]);
+    if (nan)
+        return output_buffer_append(response, "OK 1\nNaN\n", strlen("OK 1\nNaN\n"));
 
-        // Copy new string to variable
-        if ((ret_val = string_copy(&temp_string, &temp_var_store->variables[index])) != NO_ERROR)
-        {
-            free(temp_string);
-            return ret_val;
-        }
+    if ((ret_val = ldouble_to_string(value, &string)) != NO_ERROR)
+        return ret_val;
 
-        // Clear temporary string
-        free(temp_string);
-    }
-    else
-    {
-        temp_var_store->variables[index] = (char*)malloc(2 * sizeof(char));
-        if (temp_var_store->variables[index] == NULL)
-            return ALLOCATION_FAILED;
+    if ((ret_val = output_buffer_append(response, "OK 1\n", strlen("OK 1\n"))) == NO_ERROR &&
+        (ret_val = output_buffer_append(response, string, strlen(string))) == NO_ERROR)
+        ret_val = output_buffer_append(response, "\n", 1);
 
-        if (strcpy(temp_var_store->variables[index], "1") == NULL)
-            return FUNCTION_ERROR;
-    }
+    free(string);
 
     return ret_val;
 }
 
-_Bool is_command_selector(Command *command)
+int query_version(Table *view, Commands *commands, OutputBuffer *response)
 {
     /**
-     * @brief Check if command is selector
+     * @brief Execute read-only query on version and append its result to @p response
      *
-     * @param command Pointer to instance of #Command structure
+     * Query is sequence of selection commands, that can end with sum, avg or count \n
+     * Result is value of aggregate or cells of last selection (one line per selected row)
      *
-     * @return true if it is selector command and false if not
+     * @param view Pointer to instance of #Table structure with view of pinned version
+     * @param commands Pointer to instance of #Commands structure with query
+     * @param response Pointer to instance of #OutputBuffer structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    if (command->arguments == NULL && string_start_with(command->function, "[") && string_end_with(command->function, "]"))
-        return true;
-    return false;
-}
+    int ret_val = NO_ERROR;
 
-_Bool is_table_editing_command(Command *command)
-{
-    /**
-     * @brief Check if inputed command is table editing command
-     *
-     * @param command Pointer to instance of #Command structure
-     *
-     * @return true if its table editing command, false if not
-     */
+    if (view->num_of_rows == 0 || view->rows[0].num_of_cells == 0)
+        return FUNCTION_ARGUMENT_ERROR;
+
+    Selector selector = { .initialized = false };
+    Selector temp_selector = { .initialized = false };
+    init_selector(&selector);
+    init_selector(&temp_selector);
+
+    long long int num_of_commands = commands->num_of_commands;
+    Command *last = (num_of_commands > 0) ? &commands->commands[num_of_commands - 1] : NULL;
+    _Bool aggregate = (last != NULL && !is_command_selector(last));
+
+    if (aggregate && (last->arguments != NULL || (!strings_equal(last->function, "sum") && !strings_equal(last->function, "avg") &&
+        !strings_equal(last->function, "count"))))
+        return COMMAND_ERROR;
+
+    for (long long int i = 0; i < num_of_commands - (aggregate ? 1 : 0) && ret_val == NO_ERROR; i++)
+    {
+        if (!is_command_selector(&commands->commands[i]))
+            return COMMAND_ERROR;
+
+        ret_val = set_selector(&selector, &temp_selector, &commands->commands[i], view);
+    }
 
-    for (int i = 0; i < NUMBER_OF_TABLE_EDITING_COMMANDS; i++)
+    if (ret_val != NO_ERROR)
+        return ret_val;
+
+    if (aggregate)
     {
-        if (strings_equal(command->function, TABLE_EDITING_COMMANDS[i]))
-            return true;
+        long double value = 0;
+        long double num_of_vals = 0;
+        _Bool nan = false;
+
+        if (strings_equal(last->function, "count"))
+            ret_val = count_selection(view, &selector, &value);
+        else if ((ret_val = sum_selection(view, &selector, &value, &num_of_vals, &nan)) == NO_ERROR && strings_equal(last->function, "avg"))
+            value /= num_of_vals;
+
+        return (ret_val == NO_ERROR) ? append_number_response(response, value, nan) : ret_val;
     }
 
-    return false;
+    char header[32];
+    snprintf(header, sizeof(header), "OK %lld\n", selector.lld_ir2 - selector.lld_ir1 + 1);
+    ret_val = output_buffer_append(response, header, strlen(header));
+
+    for (long long int i = selector.lld_ir1; i <= selector.lld_ir2 && ret_val == NO_ERROR; i++)
+    {
+        Row *row = &view->rows[i];
+        for (long long int j = selector.lld_ic1; j <= selector.lld_ic2 && j < row->num_of_cells && ret_val == NO_ERROR; j++)
+        {
+            if (j > selector.lld_ic1)
+                ret_val = output_buffer_append(response, &view->delim, 1);
+            if (ret_val == NO_ERROR)
+                ret_val = output_buffer_append(response, row->cells[j].content, strlen(row->cells[j].content));
+        }
+
+        if (ret_val == NO_ERROR)
+            ret_val = output_buffer_append(response, "\n", 1);
+
+        // Response has to fit to quota of client
+        if (ret_val == NO_ERROR && response->length > SERVE_CLIENT_QUOTA)
+            ret_val = VALUE_ERROR;
+    }
+
+    return ret_val;
 }
 
-_Bool is_data_editing_command(Command *command)
+int update_table(VersionStore *store, Commands *commands, OutputBuffer *response)
 {
     /**
-     * @brief Check if inputed command is table data command
+     * @brief Execute script on writer table and publish new version
      *
-     * @param command Pointer to instance of #Command structure
+     * Readers arent blocked, they read previous version until new one is published
      *
-     * @return true if its data editing command, false if not
+     * @param store Pointer to instance of #VersionStore structure
+     * @param commands Pointer to instance of #Commands structure with script
+     * @param response Pointer to instance of #OutputBuffer structure
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
      */
 
-    for (int i = 0; i < NUMBER_OF_DATA_EDITING_COMMANDS; i++)
-    {
-        if (strings_equal(command->function, DATA_EDITING_COMMANDS[i]))
-            return true;
-    }
+    int ret_val;
 
-    return false;
+    pthread_mutex_lock(&store->writer_lock);
+
+    if ((ret_val = execute_commands(store->table, commands, NULL)) == NO_ERROR &&
+        (ret_val = recalculate_formulas(store->table)) == NO_ERROR)
+        ret_val = publish_version(store);
+
+    uint64_t generation = store->current->generation;
+
+    pthread_mutex_unlock(&store->writer_lock);
+
+    if (ret_val != NO_ERROR)
+        return ret_val;
+
+    return append_number_response(response, (long double)generation, false);
 }
 
-_Bool is_temp_var_command(Command *command)
+int handle_request(VersionStore *store, int slot, char *request, OutputBuffer *response)
 {
     /**
-     * @brief Check if inputed command is temporary variable command
+     * @brief Execute one request of client and append response to @p response
      *
-     * @param command Pointer to instance of #Command structure
+     * Request has form "query CMD_SEQUENCE" or "update CMD_SEQUENCE" \n
+     * Response is "OK N" followed by N lines of result or "ERROR CODE"
      *
-     * @return true if its temporary variable command, false if not
+     * @param store Pointer to instance of #VersionStore structure
+     * @param slot Index of reader slot of calling thread
+     * @param request Request line (it is edited)
+     * @param response Pointer to instance of #OutputBuffer structure
+     *
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED when response cant be created
      */
 
-    for (int i = 0; i < NUMBER_OF_TEMP_VAR_COMMANDS; i++)
+    int ret_val = COMMAND_ERROR;
+    Commands commands = { .commands = NULL, .num_of_commands = 0 };
+    char *script = strchr(request, ' ');
+
+    if (script != NULL)
     {
-        if (strings_equal(command->function, TEMP_VAR_COMMANDS[i]))
-            return true;
+        *script++ = '\0';
+
+        if (strings_equal(request, "query"))
+        {
+            if ((ret_val = parse_script(script, &commands)) == NO_ERROR)
+            {
+                Table view;
+                TableVersion *version = pin_version(store, slot);
+                init_version_view(&view, version, store->table, store->cache);
+                ret_val = query_version(&view, &commands, response);
+                unpin_version(store, slot);
+            }
+        }
+        else if (strings_equal(request, "update"))
+        {
+            if ((ret_val = parse_script(script, &commands)) == NO_ERROR)
+                ret_val = update_table(store, &commands, response);
+        }
     }
 
-    return false;
+    deallocate_base_commands(&commands);
+
+    if (ret_val == NO_ERROR || ret_val == ALLOCATION_FAILED)
+        return ret_val;
+
+    // Partial result is replaced by error
+    char error[32];
+    snprintf(error, sizeof(error), "ERROR %d\n", ret_val);
+    response->length = 0;
+
+    return output_buffer_append(response, error, strlen(error));
 }
 
-int get_table_editing_command_index(Command *command)
+void *serve_worker(void *arg)
 {
     /**
-     * @brief Get index of table editing command from reference array
+     * @brief Worker that executes pending requests until workers are stopped
      *
-     * @param command Pointer to instance of #Command structure
+     * @param arg Pointer to instance of #ServeWorker structure
      *
-     * @return Index of command from reference #TABLE_EDITING_COMMANDS array if command is found, in other cases return -1
+     * @return NULL
      */
 
-    if (!is_table_editing_command(command))
-        return -1;
+    ServeWorker *worker = (ServeWorker*)arg;
+    ServeQueue *queue = worker->queue;
 
-    for (int i = 0; i < NUMBER_OF_TABLE_EDITING_COMMANDS; i++)
+    pthread_mutex_lock(&queue->lock);
+
+    while (true)
     {
-        if (strings_equal(command->function, TABLE_EDITING_COMMANDS[i]))
-            return i;
+        while (queue->pending == NULL && !queue->stop)
+            pthread_cond_wait(&queue->ready, &queue->lock);
+
+        if (queue->stop)
+            break;
+
+        ServeRequest *request = queue->pending;
+        queue->pending = request->next;
+        if (queue->pending == NULL)
+            queue->last_pending = NULL;
+
+        pthread_mutex_unlock(&queue->lock);
+
+        // Response that cant be created closes connection
+        if (handle_request(queue->store, worker->slot, request->line, &request->response) != NO_ERROR)
+            request->response.length = 0;
+
+        pthread_mutex_lock(&queue->lock);
+
+        request->next = queue->done;
+        queue->done = request;
+
+        uint64_t wake = 1;
+        if (write(queue->wake_fd, &wake, sizeof(wake)) < 0)
+            fprintf(stderr, "Failed to wake event loop\n");
     }
 
-    return -1;
+    pthread_mutex_unlock(&queue->lock);
+
+    return NULL;
 }
 
-int get_data_editing_command_index(Command *command)
+void free_serve_request(ServeRequest *request)
 {
     /**
-     * @brief Get index of data editing command from reference array
-     *
-     * @param command Pointer to instance of #Command structure
+     * @brief Free request
      *
-     * @return Index of command from reference #DATA_EDITING_COMMANDS array if command is found, in other cases return -1
+     * @param request Pointer to instance of #ServeRequest structure
      */
 
-    if (!is_data_editing_command(command))
-        return -1;
-
-    for (int i = 0; i < NUMBER_OF_DATA_EDITING_COMMANDS; i++)
-    {
-        if (strings_equal(command->function, DATA_EDITING_COMMANDS[i]))
-            return i;
-    }
-
-    return -1;
+    free(request->line);
+    free(request->response.data);
+    free(request);
 }
 
-int get_temp_var_command_index(Command *command)
+void free_serve_requests(ServeRequest *requests)
 {
     /**
-     * @brief Get index of temporary variable command from reference array
+     * @brief Free list of requests
      *
-     * @param command Pointer to instance of #Command structure
-     *
-     * @return Index of command from reference #TEMP_VAR_COMMANDS array if command is found, in other cases return -1
+     * @param requests Pointer to first instance of #ServeRequest structure of list
      */
 
-    if (!is_temp_var_command(command))
-        return -1;
-
-    for (int i = 0; i < NUMBER_OF_TEMP_VAR_COMMANDS; i++)
+    while (requests != NULL)
     {
-        if (strings_equal(command->function, TEMP_VAR_COMMANDS[i]))
-            return i;
+        ServeRequest *next = requests->next;
+        free_serve_request(requests);
+        requests = next;
     }
-
-    return -1;
 }
 
-int execute_table_editing_comm(Table *table, Selector *selector, Command *command)
+int dispatch_request(ServeQueue *queue, ServeClient *client)
 {
     /**
-     * @brief Execute table editing command on @p table
+     * @brief Pass next complete request line of @p client to workers
      *
-     * Assign proper function to @p command and execute it to edit table
+     * Nothing is dispatched while request of client is executed or while its unsent responses exceed quota
      *
-     * @param table Pointer to instance of #Table structure that will be eddited
-     * @param selector Pointer to instance of #Selector structure for selecting part of @p table to edit
-     * @param command Pointer to instance of #Command structure that will select function to use
+     * @param queue Pointer to instance of #ServeQueue structure
+     * @param client Pointer to instance of #ServeClient structure
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @return #NO_ERROR on success, #ALLOCATION_FAILED on error
      */
 
-    int ret_val = NO_ERROR;
-    int findex = get_table_editing_command_index(command);
-    if (findex == -1)
+    if (client->busy || client->failed || client->output.length - client->output_start > SERVE_CLIENT_QUOTA)
         return NO_ERROR;
 
-    switch (findex)
-    {
-        // irow
-        case 0:
-            ret_val = insert_row(table, selector->lld_ir1);
-            break;
-
-            // arow
-        case 1:
-            if (selector->lld_ir2 >= table->num_of_rows - 1)
-                ret_val = append_row(table);
-            else
-                ret_val = insert_row(table, selector->lld_ir2 + 1);
-            break;
+    char *start = client->input.data + client->input_start;
+    size_t available = client->input.length - client->input_start;
+    char *end = (available > 0) ? (char*)memchr(start, '\n', available) : NULL;
 
-            // drow
-        case 2:
-            ret_val = delete_rows(table, selector->lld_ir1, selector->lld_ir2);
-            break;
+    if (end == NULL)
+        return NO_ERROR;
 
-            // icol
-        case 3:
-            if (table->num_of_rows > 0)
-                ret_val = insert_col(table, selector->lld_ic1);
-            break;
+    ServeRequest *request = (ServeRequest*)malloc(sizeof(ServeRequest));
+    if (request == NULL)
+        return ALLOCATION_FAILED;
 
-            // acol
-        case 4:
-            if (table->num_of_rows > 0)
-            {
-                if (selector->lld_ic2 >= table->rows[0].num_of_cells - 1)
-                    ret_val = append_col(table);
-                else
-                    ret_val = insert_col(table, selector->lld_ic2 + 1);
-            }
-            break;
+    size_t length = (size_t)(end - start);
+    request->client = client;
+    request->next = NULL;
+    request->response.data = NULL;
+    request->response.length = 0;
+    request->response.allocated = 0;
+    request->line = (char*)malloc(length + 1);
+    if (request->line == NULL)
+    {
+        free(request);
+        return ALLOCATION_FAILED;
+    }
 
-            // dcol
-        case 5:
-            if (table->num_of_rows > 0)
-                ret_val = delete_cols(table, selector->lld_ic1, selector->lld_ic2);
-            break;
+    memcpy(request->line, start, length);
+    request->line[length] = '\0';
+    rm_newline_chars(request->line);
+    client->input_start += length + 1;
+    client->busy = true;
 
-        default:
-            ret_val = COMMAND_ERROR;
-            break;
-    }
+    pthread_mutex_lock(&queue->lock);
+    if (queue->last_pending != NULL)
+        queue->last_pending->next = request;
+    else
+        queue->pending = request;
+    queue->last_pending = request;
+    pthread_cond_signal(&queue->ready);
+    pthread_mutex_unlock(&queue->lock);
 
-    return ret_val;
+    return NO_ERROR;
 }
 
-int execute_data_editing_command(Table *table, Selector *selector, Command *command)
+void read_client(ServeClient *client)
 {
     /**
-     * @brief Execute data editing command on @p table
-     *
-     * Assign proper function to @p command and execute it to edit table
+     * @brief Read available requests of client
      *
-     * @param table Pointer to instance of #Table structure that will be eddited
-     * @param selector Pointer to instance of #Selector structure for selecting part of @p table to edit
-     * @param command Pointer to instance of #Command structure that will select function to use
+     * At most #SERVE_IO_CHUNK bytes are read in one pass, so other clients arent starved \n
+     * Reading stops when unprocessed requests reach quota of client
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @param client Pointer to instance of #ServeClient structure
      */
 
-    int ret_val = NO_ERROR;
-    int findex = get_data_editing_command_index(command);
-    if (findex == -1)
-        return NO_ERROR;
+    // Processed requests are dropped before buffer grows
+    if (client->input_start > 0)
+    {
+        memmove(client->input.data, client->input.data + client->input_start, client->input.length - client->input_start);
+        client->input.length -= client->input_start;
+        client->input_start = 0;
+    }
 
-    long long int *advanced_args = NULL;
+    size_t space = SERVE_CLIENT_QUOTA - client->input.length;
+    if (space > SERVE_IO_CHUNK)
+        space = SERVE_IO_CHUNK;
 
-    switch (findex)
+    if (space == 0)
+        return;
+
+    if (client->input.allocated < client->input.length + space)
     {
-        // set STR
-        case 0:
-            ret_val = set_value_in_area(table, selector, command->arguments);
-            break;
+        char *tmp = (char*)realloc(client->input.data, client->input.length + space);
+        if (tmp == NULL)
+        {
+            client->failed = true;
+            return;
+        }
 
-        // clear
-        case 1:
-            ret_val = set_value_in_area(table, selector, EMPTY_CELL);
-            break;
+        client->input.data = tmp;
+        client->input.allocated = client->input.length + space;
+    }
 
-        // swap [R,C]
-        case 2:
-            if ((ret_val = parse_command_argument(command->arguments, &advanced_args, table)) == NO_ERROR)
-            {
-                if (advanced_args != NULL)
-                    ret_val = swap_cells(table, selector, advanced_args[0], advanced_args[1]);
-                else
-                    ret_val = FUNCTION_ERROR;
-            }
-            break;
+    ssize_t received = recv(client->fd, client->input.data + client->input.length, space, 0);
 
-        // sum [R,C]
-        case 3:
-            if ((ret_val = parse_command_argument(command->arguments, &advanced_args, table)) == NO_ERROR)
-            {
-                if (advanced_args != NULL)
-                    ret_val = sum_cells(table, selector, advanced_args[0], advanced_args[1]);
-                else
-                    ret_val = FUNCTION_ERROR;
-            }
-            break;
+    if (received > 0)
+        client->input.length += (size_t)received;
+    else if (received == 0)
+        client->end_of_input = true;
+    else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        client->failed = true;
+}
 
-        // avg [R,C]
-        case 4:
-            if ((ret_val = parse_command_argument(command->arguments, &advanced_args, table)) == NO_ERROR)
-            {
-                if (advanced_args != NULL)
-                    ret_val = avg_cells(table, selector, advanced_args[0], advanced_args[1]);
-                else
-                    ret_val = FUNCTION_ERROR;
-            }
-            break;
+void write_client(ServeClient *client)
+{
+    /**
+     * @brief Send part of unsent responses of client
+     *
+     * At most #SERVE_IO_CHUNK bytes are sent in one pass, so large response doesnt starve other clients
+     *
+     * @param client Pointer to instance of #ServeClient structure
+     */
 
-        // count [R,C]
-        case 5:
-            if ((ret_val = parse_command_argument(command->arguments, &advanced_args, table)) == NO_ERROR)
-            {
-                if (advanced_args != NULL)
-                    ret_val = count_cells(table, selector, advanced_args[0], advanced_args[1]);
-                else
-                    ret_val = FUNCTION_ERROR;
-            }
-            break;
+    size_t length = client->output.length - client->output_start;
+    if (length > SERVE_IO_CHUNK)
+        length = SERVE_IO_CHUNK;
 
-        // len [R,C]
-        case 6:
-            if ((ret_val = parse_command_argument(command->arguments, &advanced_args, table)) == NO_ERROR)
-            {
-                if (advanced_args != NULL)
-                    ret_val = cell_len(table, selector, advanced_args[0], advanced_args[1]);
-                else
-                    ret_val = FUNCTION_ERROR;
-            }
-            break;
+    if (length == 0)
+        return;
 
-        default:
-            ret_val = COMMAND_ERROR;
-            break;
-    }
+    ssize_t sent = send(client->fd, client->output.data + client->output_start, length, MSG_NOSIGNAL);
+
+    if (sent > 0)
+        client->output_start += (size_t)sent;
+    else if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        client->failed = true;
 
-    free(advanced_args);
-    return ret_val;
+    if (client->output_start == client->output.length)
+    {
+        client->output.length = 0;
+        client->output_start = 0;
+    }
 }
 
-int execute_temp_var_command(Table *table, Selector *selector, Command *command, TempVariableStore *temp_var_store)
+_Bool update_client(ServeQueue *queue, int epoll_fd, ServeClient *client)
 {
     /**
-     * @brief Execute temporary variable command on @p table
+     * @brief Dispatch next request of client, update events the loop waits for and find out if client can be closed
      *
-     * Assign proper function to @p command and execute it to edit table
+     * Client is read only while it has space in quota and written only while it has unsent responses (back-pressure)
      *
-     * @param table Pointer to instance of #Table structure that will be eddited
-     * @param selector Pointer to instance of #Selector structure for selecting part of @p table to edit
-     * @param command Pointer to instance of #Command structure that will select function to use
-     * @param temp_var_store Pointer to instance of #TempVariableStore structure used for stroring values
+     * @param queue Pointer to instance of #ServeQueue structure
+     * @param epoll_fd Epoll descriptor of event loop
+     * @param client Pointer to instance of #ServeClient structure
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @return True if client should be closed
      */
 
-    int ret_val = NO_ERROR;
-    int findex = get_temp_var_command_index(command);
-    if (findex == -1)
-        return NO_ERROR;
+    if (dispatch_request(queue, client) != NO_ERROR)
+        client->failed = true;
 
-    char *arg = NULL;
-    long long int arg_lli = -1;
+    size_t unprocessed = client->input.length - client->input_start;
+    _Bool has_request = unprocessed > 0 && memchr(client->input.data + client->input_start, '\n', unprocessed) != NULL;
 
-    if ((ret_val = string_copy(&command->arguments, &arg)) != NO_ERROR)
-        return ret_val;
+    // Request longer than quota can never be completed
+    if (!has_request && unprocessed >= SERVE_CLIENT_QUOTA)
+        client->failed = true;
 
-    if ((ret_val = trim_start(arg)) == NO_ERROR)
-        ret_val = string_to_llint(arg, &arg_lli);
+    if (client->busy)
+        return false;
 
-    if (arg_lli < 0 || arg_lli >= NUMBER_OF_TEMPORARY_VARIABLES)
-        ret_val = COMMAND_ERROR;
+    if (client->failed || (client->end_of_input && !has_request && client->output.length == 0))
+        return true;
 
+    uint32_t events = 0;
+    if (!client->end_of_input && client->input.length < SERVE_CLIENT_QUOTA)
+        events |= EPOLLIN;
+    if (client->output.length > 0)
+        events |= EPOLLOUT;
 
-    if (ret_val == NO_ERROR)
+    if (events != client->events)
     {
-        switch (findex)
-        {
-            // def _X
-            case 0:
-                if ((selector->lld_ir1 != selector->lld_ir2) || (selector->lld_ic1 != selector->lld_ic2))
-                {
-                    ret_val = COMMAND_ERROR;
-                    break;
-                }
+        struct epoll_event event = { .events = events, .data.ptr = client };
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, client->fd, &event);
+        client->events = events;
+    }
 
-                ret_val = set_temporary_variable(table, selector, temp_var_store, arg_lli);
-                break;
+    return false;
+}
 
-            // use _X
-            case 1:
-                ret_val = set_cell_from_temporary_variable(table, selector, temp_var_store, arg_lli);
-                break;
+void close_serve_client(ServeClient **clients, long long int *num_of_clients, ServeClient *client)
+{
+    /**
+     * @brief Close connection and remove client from array of clients
+     *
+     * @param clients Array of clients
+     * @param num_of_clients Pointer to number of clients
+     * @param client Pointer to instance of #ServeClient structure without executed request
+     */
 
-            // inc _X
-            case 2:
-                ret_val = increase_temporary_variable(temp_var_store, arg_lli);
-                break;
+    close(client->fd);
+    free(client->input.data);
+    free(client->output.data);
 
-            default:
-                ret_val = COMMAND_ERROR;
-                break;
+    clients[client->index] = clients[*num_of_clients - 1];
+    clients[client->index]->index = client->index;
+    (*num_of_clients)--;
+
+    free(client);
+}
+
+int accept_clients(int listener, int epoll_fd, ServeClient **clients, long long int *num_of_clients)
+{
+    /**
+     * @brief Accept all waiting connections
+     *
+     * Connections over #SERVE_MAX_CLIENTS are refused
+     *
+     * @param listener Listening socket
+     * @param epoll_fd Epoll descriptor of event loop
+     * @param clients Array of clients
+     * @param num_of_clients Pointer to number of clients
+     *
+     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     */
+
+    while (true)
+    {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0)
+            return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ECONNABORTED) ? NO_ERROR : IO_ERROR;
+
+        ServeClient *client = NULL;
+        if (*num_of_clients < SERVE_MAX_CLIENTS && fcntl(fd, F_SETFL, O_NONBLOCK) == 0)
+            client = (ServeClient*)calloc(1, sizeof(ServeClient));
+
+        if (client == NULL)
+        {
+            char error[32];
+            snprintf(error, sizeof(error), "ERROR %d\n", IO_ERROR);
+            if (send(fd, error, strlen(error), MSG_NOSIGNAL | MSG_DONTWAIT) < 0)
+                fprintf(stderr, "Failed to refuse client\n");
+            close(fd);
+            continue;
         }
-    }
 
-    free(arg);
+        client->fd = fd;
+        client->events = EPOLLIN;
+        client->index = *num_of_clients;
 
-    return ret_val;
+        struct epoll_event event = { .events = EPOLLIN, .data.ptr = client };
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            close(fd);
+            free(client);
+            continue;
+        }
+
+        clients[(*num_of_clients)++] = client;
+    }
 }
 
-int get_type_of_command(Command *command)
+void serve_events(ServeQueue *queue, int listener, int epoll_fd, ServeClient **clients, long long int *num_of_clients)
 {
     /**
-     * @brief Get type of inputed @p command
+     * @brief Event loop of daemon that runs until daemon is interrupted
      *
-     * @param command Pointer to instance of #Command structure that will be tested
+     * Loop only moves bytes between sockets and buffers, requests are executed by workers
      *
-     * @return Type of command based on #CommandType
+     * @param queue Pointer to instance of #ServeQueue structure
+     * @param listener Listening socket
+     * @param epoll_fd Epoll descriptor of event loop
+     * @param clients Array of clients
+     * @param num_of_clients Pointer to number of clients
      */
 
-    if (command == NULL)
-        return UNKNOWN;
+    struct epoll_event events[SERVE_MAX_EVENTS];
 
-    if (is_table_editing_command(command))
-        return TABLE_EDITING_COMMAND;
+    while (!stop_requested)
+    {
+        int num_of_events = epoll_wait(epoll_fd, events, SERVE_MAX_EVENTS, -1);
+        if (num_of_events < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
 
-    if (is_data_editing_command(command))
-        return DATA_EDITING_COMMAND;
+        for (int i = 0; i < num_of_events; i++)
+        {
+            // Listener is registered without pointer, event descriptor with queue and clients with their structures
+            if (events[i].data.ptr == NULL)
+            {
+                if (accept_clients(listener, epoll_fd, clients, num_of_clients) != NO_ERROR)
+                    fprintf(stderr, "Failed to accept client\n");
+                continue;
+            }
 
-    if (is_temp_var_command(command))
-        return TEMP_VAR_COMMAND;
+            if (events[i].data.ptr == (void*)queue)
+            {
+                uint64_t counter;
+                if (read(queue->wake_fd, &counter, sizeof(counter)) < 0 && errno != EAGAIN)
+                    fprintf(stderr, "Failed to read event descriptor\n");
 
-    return UNKNOWN;
+                pthread_mutex_lock(&queue->lock);
+                ServeRequest *done = queue->done;
+                queue->done = NULL;
+                pthread_mutex_unlock(&queue->lock);
+
+                while (done != NULL)
+                {
+                    ServeRequest *next = done->next;
+                    ServeClient *client = done->client;
+
+                    client->busy = false;
+                    if (done->response.length == 0 || output_buffer_append(&client->output, done->response.data, done->response.length) != NO_ERROR)
+                        client->failed = true;
+                    else
+                        write_client(client);
+
+                    free_serve_request(done);
+
+                    if (update_client(queue, epoll_fd, client))
+                        close_serve_client(clients, num_of_clients, client);
+
+                    done = next;
+                }
+                continue;
+            }
+
+            ServeClient *client = (ServeClient*)events[i].data.ptr;
+
+            // Closed connection is removed from loop at once, because its errors are reported even while it waits for worker
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+            {
+                client->failed = true;
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, client->fd, NULL);
+            }
+            else
+            {
+                if (events[i].events & EPOLLIN)
+                    read_client(client);
+                if (events[i].events & EPOLLOUT)
+                    write_client(client);
+            }
+
+            // Client with executed request is closed when request returns
+            if (update_client(queue, epoll_fd, client))
+                close_serve_client(clients, num_of_clients, client);
+        }
+    }
 }
 
-int execute_commands(Table *table, Commands *base_commands_store)
+int serve_table(Table *table, char *socket_path)
 {
     /**
-     * @brief Execute commands on @p table
+     * @brief Serve @p table to clients connected to unix socket until daemon is interrupted
      *
-     * Iterate over all commands in @p base_commands_store and parse them and execute them on @p table
+     * Single threaded event loop accepts clients, reads pipelined requests and sends responses,
+     * requests are executed by workers (one per worker of pool of table) \n
+     * Queries read pinned immutable version of table without locks, updates change table of writer and publish new version
      *
      * @param table Pointer to instance of #Table structure
-     * @param base_commands_store Pointer to instance of #Commands structure
+     * @param socket_path Path to unix socket
      *
-     * @return #NO_ERROR on success in other cases coresponding error code from #ErrorCodes
+     * @return #NO_ERROR when daemon was interrupted, other codes from #ErrorCodes on error
      */
 
-    int ret_val = NO_ERROR;
-
-    Selector selector = { .initialized = false };
-    Selector temp_selector = { .initialized = false };
-    init_selector(&selector);
-    init_selector(&temp_selector);
+    int ret_val;
+    int num_of_workers = (table->pool != NULL) ? table->pool->max_workers : 1;
+    VersionStore store;
+    ServeQueue queue;
+    ServeWorker workers[MAX_NUMBER_OF_THREADS];
+    int num_of_started = 0;
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path))
+        return VALUE_ERROR;
+    strcpy(address.sun_path, socket_path);
 
-    TempVariableStore temp_var_store = { .variables = NULL };
-    if (init_temp_var_store(&temp_var_store) != NO_ERROR)
+    ServeClient **clients = (ServeClient**)malloc(SERVE_MAX_CLIENTS * sizeof(ServeClient*));
+    if (clients == NULL)
         return ALLOCATION_FAILED;
+    long long int num_of_clients = 0;
 
-    for (long long int i = 0; i < base_commands_store->num_of_commands; i++)
+    if ((ret_val = version_store_init(&store, table, num_of_workers)) != NO_ERROR)
     {
-        Command c_comm = base_commands_store->commands[i];
-        if (is_command_selector(&c_comm))
-        {
-            // Set new selector
-            if ((ret_val = set_selector(&selector, &temp_selector, &c_comm, table)) != NO_ERROR)
-                break;
-            continue;
-        }
+        free(clients);
+        return ret_val;
+    }
 
-#ifdef DEBUG
-        printf("Current selector: [%llu,%llu,%llu,%llu]\n", selector.lld_ir1, selector.lld_ic1, selector.lld_ir2, selector.lld_ic2);
-        printf("Current command: [%s,%s]\n", c_comm.function, c_comm.arguments);
-        printf("Current variable store:\n[");
-        for (long long int j = 0; j < NUMBER_OF_TEMPORARY_VARIABLES; j++)
-        {
-            printf("_%llu:'%s',", j, temp_var_store.variables[j]);
-        }
-        printf("]\n\n");
-        printf("Before table:\n");
-        print_table(table);
-#endif
+    queue.store = &store;
+    queue.pending = NULL;
+    queue.last_pending = NULL;
+    queue.done = NULL;
+    queue.stop = false;
+    queue.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.ready, NULL);
+
+    // Socket left by previous daemon would block binding
+    unlink(socket_path);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event listener_event = { .events = EPOLLIN, .data.ptr = NULL };
+    struct epoll_event wake_event = { .events = EPOLLIN, .data.ptr = &queue };
+
+    if (listener < 0 || epoll_fd < 0 || queue.wake_fd < 0 || bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listener, &listener_event) != 0 ||
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, queue.wake_fd, &wake_event) != 0)
+        ret_val = IO_ERROR;
+
+    for (int i = 0; ret_val == NO_ERROR && i < num_of_workers; i++)
+    {
+        workers[i].queue = &queue;
+        workers[i].slot = i;
+        if (pthread_create(&workers[i].thread, NULL, serve_worker, &workers[i]) != 0)
+            ret_val = FUNCTION_ERROR;
+        else
+            num_of_started++;
+    }
 
-        switch (get_type_of_command(&c_comm))
-        {
-            case TABLE_EDITING_COMMAND:
-                ret_val = execute_table_editing_comm(table, &selector, &c_comm);
-                break;
+    if (ret_val == NO_ERROR)
+    {
+        handle_stop_signals();
+        serve_events(&queue, listener, epoll_fd, clients, &num_of_clients);
+    }
 
-            case DATA_EDITING_COMMAND:
-                if (table->num_of_rows > 0 && table->rows[0].num_of_cells > 0)
-                    ret_val = execute_data_editing_command(table, &selector, &c_comm);
-                break;
+    // Workers finish executed requests before they stop, requests that wait are dropped
+    pthread_mutex_lock(&queue.lock);
+    queue.stop = true;
+    pthread_cond_broadcast(&queue.ready);
+    pthread_mutex_unlock(&queue.lock);
 
-            case TEMP_VAR_COMMAND:
-                if (table->num_of_rows > 0 && table->rows[0].num_of_cells > 0)
-                    ret_val = execute_temp_var_command(table, &selector, &c_comm, &temp_var_store);
-                break;
+    for (int i = 0; i < num_of_started; i++)
+        pthread_join(workers[i].thread, NULL);
 
-            default:
-                ret_val = COMMAND_ERROR;
-        }
+    free_serve_requests(queue.pending);
+    free_serve_requests(queue.done);
 
-        if (ret_val != NO_ERROR)
-            break;
+    while (num_of_clients > 0)
+        close_serve_client(clients, &num_of_clients, clients[num_of_clients - 1]);
+    free(clients);
 
-#ifdef DEBUG
-        printf("\n\nAfter variable store:\n[");
-        for (long long int j = 0; j < NUMBER_OF_TEMPORARY_VARIABLES; j++)
-        {
-            printf("_%llu:'%s',", j, temp_var_store.variables[j]);
-        }
-        printf("]\n");
-        printf("After table:\n");
-        print_table(table);
-        printf("\n#####################################################\n\n");
-#endif
+    if (epoll_fd >= 0)
+        close(epoll_fd);
+    if (queue.wake_fd >= 0)
+        close(queue.wake_fd);
+    if (listener >= 0)
+    {
+        close(listener);
+        unlink(socket_path);
     }
 
-    deallocate_temp_var_store(&temp_var_store);
+    pthread_mutex_destroy(&queue.lock);
+    pthread_cond_destroy(&queue.ready);
+    version_store_destroy(&store);
 
     return ret_val;
 }
@@ -3530,6 +16065,17 @@ void init_structures(Raw_commands *raw_commands, Commands *commands, Table *tabl
     table->num_of_rows = 0;
     table->allocated_rows = 0;
     table->delim = DEFAULT_DELIM[0];
+    table->input_delims = DEFAULT_DELIM;
+    table->spill = NULL;
+    table->arenas = NULL;
+    table->num_of_arenas = 0;
+    table->pool = NULL;
+    table->col_types = NULL;
+    table->num_of_col_types = 0;
+    table->shard = NULL;
+    table->version = NULL;
+    table->cache = NULL;
+    init_formula_store(&table->formulas);
 }
 
 int main(int argc, char *argv[]) {
@@ -3538,31 +16084,35 @@ int main(int argc, char *argv[]) {
      * @todo Refactor error handling - separate to own function
      */
 
-    // Check if number of arguments is larger than minimum posible number of arguments
-    if (argc < 3)
-    {
-        fprintf(stderr, "Some arguments are missing!\n");
-        return MISSING_ARGS;
-    }
-
     // Create program variables
     int error_flag;
-    _Bool delim_flag_present = strings_equal(argv[1], "-d");
-    char *delims = delim_flag_present ? argv[2] : DEFAULT_DELIM;
+    Options options;
     Raw_commands raw_commands_store;
     Commands base_commands_store;
     Table table;
 
-    if (delim_flag_present && argc < 4)
+    // Check if all required arguments are present
+    if ((error_flag = parse_options(argc, argv, &options)) != NO_ERROR)
     {
-        fprintf(stderr, "Some arguments are missing!\n");
-        return MISSING_ARGS;
+        if (error_flag == MISSING_ARGS)
+            fprintf(stderr, "Some arguments are missing!\n");
+        else
+            fprintf(stderr, "Invalid value of argument\n");
+        return error_flag;
     }
 
+    char *delims = options.delims;
+    SpillStore spill = { .file = NULL };
+    ThreadPool pool;
+    ShardContext shard;
+    Checkpoint checkpoint;
+    SharedTable shared = { .data = NULL };
+    int save_flag = NO_ERROR;
+
     // Init values in structure
     init_structures(&raw_commands_store, &base_commands_store, &table);
-    if (delim_flag_present)
-        table.delim = delims[0];
+    table.delim = delims[0];
+    table.input_delims = delims;
 
     // Check if there is no invalid characters in delim array
     if (!check_sanity_of_delims(delims))
@@ -3571,7 +16121,7 @@ int main(int argc, char *argv[]) {
         return INVALID_DELIMITER;
     }
 
-    if ((error_flag = get_commands(argv, &raw_commands_store, delim_flag_present)) != NO_ERROR)
+    if ((error_flag = get_commands(options.commands, &raw_commands_store)) != NO_ERROR)
         fprintf(stderr, "Failed to get commands\n");
 
     if (error_flag == NO_ERROR && (error_flag = parse_commands(&raw_commands_store, &base_commands_store)) != NO_ERROR)
@@ -3579,18 +16129,141 @@ int main(int argc, char *argv[]) {
 
     deallocate_raw_commands(&raw_commands_store);
 
-    if (error_flag == NO_ERROR && ((error_flag = load_table(delims, argv[argc-1], &table)) != NO_ERROR))
-        fprintf(stderr, "Failed to load table properly\n");
+    _Bool attached = string_start_with(options.input_path, SHARED_INPUT_PREFIX);
+
+    if (options.watch_delay >= 0 && (strings_equal(options.output_path, options.input_path) || options.state_path != NULL || options.checkpoint_path != NULL))
+    {
+        fprintf(stderr, "Watch mode needs output file (-o) and cant be combined with -t or --checkpoint\n");
+        deallocate_base_commands(&base_commands_store);
+        return VALUE_ERROR;
+    }
+
+    if (options.serve_path != NULL && (options.watch_delay >= 0 || options.checkpoint_path != NULL))
+    {
+        fprintf(stderr, "Daemon cant be combined with --watch or --checkpoint\n");
+        deallocate_base_commands(&base_commands_store);
+        return VALUE_ERROR;
+    }
+
+    if (attached && options.serve_path == NULL && (strings_equal(options.output_path, options.input_path) || options.state_path != NULL || options.watch_delay >= 0))
+    {
+        fprintf(stderr, "Published table needs output file (-o) and cant be combined with -t or --watch\n");
+        deallocate_base_commands(&base_commands_store);
+        return VALUE_ERROR;
+    }
+
+    if (options.compile_dir != NULL && (options.watch_delay >= 0 || options.checkpoint_path != NULL))
+    {
+        fprintf(stderr, "Compiled script cant be combined with --watch or --checkpoint\n");
+        deallocate_base_commands(&base_commands_store);
+        return VALUE_ERROR;
+    }
+
+    // Script is compiled before shards are forked, so they share loaded library
+    CompiledScript compiled = { .handle = NULL, .function = NULL };
+    if (error_flag == NO_ERROR && options.compile_dir != NULL && compile_script(&compiled, &base_commands_store, options.compile_dir) != NO_ERROR)
+        fprintf(stdout, "[WARNING] Failed to compile commands, commands are interpreted\n");
+
+    // Aggregate-only script can be executed by worker processes over byte ranges of input
+    if (error_flag == NO_ERROR && options.shards > 1 && options.state_path == NULL && options.checkpoint_path == NULL && options.watch_delay < 0 &&
+        options.publish_name == NULL && options.serve_path == NULL && !attached && is_shardable_script(&base_commands_store))
+    {
+        if (shard_fork(&shard, options.input_path, options.shards) != NO_ERROR)
+            fprintf(stdout, "[WARNING] Failed to start shard processes, input is processed by one process\n");
+        else if (shard.num_of_shards > 1)
+            table.shard = &shard;
+    }
+
+    if (options.memory_budget > 0)
+    {
+        if (spill_store_init(&spill, options.memory_budget) != NO_ERROR)
+        {
+            fprintf(stderr, "Failed to create spill file\n");
+            return IO_ERROR;
+        }
+
+        table.spill = &spill;
+    }
+
+    if (thread_pool_init(&pool, options.threads) != NO_ERROR)
+    {
+        fprintf(stderr, "Failed to create thread pool\n");
+        spill_store_destroy(&spill);
+        return FUNCTION_ERROR;
+    }
+
+    table.pool = &pool;
+
+    if (error_flag == NO_ERROR && options.watch_delay >= 0)
+    {
+        if ((error_flag = watch_input(&options, &table, &base_commands_store)) != NO_ERROR)
+            fprintf(stderr, "Failed to watch input file\n");
+
+        deallocate_table(&table);
+        deallocate_base_commands(&base_commands_store);
+        spill_store_destroy(&spill);
+        thread_pool_destroy(&pool);
+        return NO_ERROR;
+    }
+
+    // Commands are hashed before execution, because selector commands are trimmed in place
+    checkpoint_init(&checkpoint, options.checkpoint_path, &base_commands_store);
+
+    if (error_flag == NO_ERROR && options.restart)
+    {
+        // Without checkpoint (or with checkpoint of other commands) table is loaded from input file
+        if ((error_flag = load_checkpoint(&checkpoint, &table)) == VALUE_ERROR)
+            fprintf(stdout, "[WARNING] Checkpoint doesnt match commands, execution starts from beginning\n");
+        else if (error_flag != NO_ERROR && error_flag != CANT_OPEN_FILE)
+            fprintf(stderr, "Failed to load checkpoint\n");
+
+        if (error_flag == VALUE_ERROR || error_flag == CANT_OPEN_FILE)
+            error_flag = NO_ERROR;
+    }
+
+    // Stale manifest must not point to pages file that new checkpoints overwrite
+    if (error_flag == NO_ERROR && options.checkpoint_path != NULL && !checkpoint.resumed)
+        remove(options.checkpoint_path);
+
+    if (error_flag == NO_ERROR && !checkpoint.resumed)
+    {
+        if (attached)
+            error_flag = load_shared_table(&shared, options.input_path + strlen(SHARED_INPUT_PREFIX), &table);
+        else if (options.state_path != NULL)
+            error_flag = load_table_incremental(delims, options.input_path, options.state_path, &table);
+        else if (table.shard != NULL)
+            error_flag = load_table_range(delims, options.input_path, shard.start, shard.end, &table);
+        else
+            error_flag = load_table(delims, options.input_path, &table);
+
+        if (error_flag != NO_ERROR)
+            fprintf(stderr, "Failed to load table properly\n");
+    }
 
     if (table.rows != NULL && table.num_of_rows != 0)
     {
-        if (error_flag == NO_ERROR && (error_flag = normalize_number_of_cols(&table)) != NO_ERROR)
-            fprintf(stderr, "Failed to normalize colums\n");
+        // Rows of checkpoint are already normalized and filtered and their formulas are registered
+        if (!checkpoint.resumed)
+        {
+            if (error_flag == NO_ERROR && (error_flag = normalize_number_of_cols(&table)) != NO_ERROR)
+                fprintf(stderr, "Failed to normalize colums\n");
 
-        if (error_flag == NO_ERROR && (error_flag = filter_table(&table)) != NO_ERROR)
-            fprintf(stderr, "Failed to filter special characters from table\n");
+            // Published table contains already filtered cells
+            if (error_flag == NO_ERROR && !attached && (error_flag = filter_table(&table, 0)) != NO_ERROR)
+                fprintf(stderr, "Failed to filter special characters from table\n");
 
-        if (error_flag == NO_ERROR && (error_flag = execute_commands(&table, &base_commands_store)) != NO_ERROR)
+            if (error_flag == NO_ERROR && (error_flag = register_formula_cells(&table, 0, 0)) != NO_ERROR)
+                fprintf(stderr, "Failed to find formula cells\n");
+        }
+
+        // Every shard has to join, even when it failed, so others do not wait for it
+        if (table.shard != NULL && (error_flag = shard_join(&table, error_flag)) != NO_ERROR)
+            fprintf(stderr, (error_flag == FUNCTION_ERROR) ? "Formula cells cant be executed by shards\n" : "Failed to join shards of input\n");
+
+        if (error_flag == NO_ERROR && compiled.function != NULL && (error_flag = execute_compiled_script(&table, &compiled)) != NO_ERROR)
+            fprintf(stderr, "Failed to execute all commands\n");
+        else if (error_flag == NO_ERROR && compiled.function == NULL &&
+                 (error_flag = execute_commands(&table, &base_commands_store, (options.checkpoint_path != NULL) ? &checkpoint : NULL)) != NO_ERROR)
             fprintf(stderr, "Failed to execute all commands\n");
 
 #ifdef DEBUG
@@ -3598,10 +16271,31 @@ int main(int argc, char *argv[]) {
         print_table(&table);
 #endif
 
-        if (error_flag == NO_ERROR && (error_flag = format_table_for_output(&table, delims)) != NO_ERROR)
+        if (error_flag == NO_ERROR && (error_flag = recalculate_formulas(&table)) != NO_ERROR)
+            fprintf(stderr, "Failed to recalculate formula cells\n");
+
+        if (error_flag == NO_ERROR && options.publish_name != NULL && (error_flag = publish_table(&table, options.publish_name)) != NO_ERROR)
+            fprintf(stderr, "Failed to publish table\n");
+
+        // Served table keeps values without output formatting
+        if (error_flag == NO_ERROR && options.serve_path == NULL && (error_flag = format_table_for_output(&table, delims)) != NO_ERROR)
             fprintf(stderr, "Failed to execute format table for output\n");
     }
 
+    if (options.serve_path != NULL)
+    {
+        if (error_flag == NO_ERROR && (error_flag = serve_table(&table, options.serve_path)) != NO_ERROR)
+            fprintf(stderr, "Failed to serve table\n");
+
+        deallocate_table(&table);
+        shared_table_detach(&shared);
+        deallocate_base_commands(&base_commands_store);
+        unload_compiled_script(&compiled);
+        spill_store_destroy(&spill);
+        thread_pool_destroy(&pool);
+        return NO_ERROR;
+    }
+
 #ifdef DEBUG
     printf("\nFinal table:\n");
     print_table(&table);
@@ -3616,11 +16310,27 @@ int main(int argc, char *argv[]) {
     for (int i = 1; i < argc; i++)
         printf("%s%c", argv[i], i == (argc - 1) ? '\n' : ' ');
 #else
-    save_table(&table, argv[argc-1]);
+    if (table.shard != NULL)
+    {
+        if ((save_flag = shard_save(&table, options.output_path)) != NO_ERROR && shard.index == 0)
+            fprintf(stderr, "Failed to save output of shards\n");
+    }
+    else
+        save_flag = save_table(&table, options.output_path);
 #endif
 
+    // Checkpoint is needed only until output of whole execution is saved
+    checkpoint_destroy(&checkpoint, error_flag == NO_ERROR && save_flag == NO_ERROR);
+
+    _Bool is_worker = (table.shard != NULL && shard.index > 0);
+
     deallocate_table(&table);
+    shared_table_detach(&shared);
     deallocate_base_commands(&base_commands_store);
+    unload_compiled_script(&compiled);
+    spill_store_destroy(&spill);
+    thread_pool_destroy(&pool);
 
-    return NO_ERROR;
+    // Exit status of worker tells coordinator if its rows were saved
+    return is_worker ? save_flag : NO_ERROR;
 }
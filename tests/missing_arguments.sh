@@ -0,0 +1,25 @@
+#!/bin/sh
+# Commands that need argument must fail with error instead of crash when argument is missing
+# Usage: missing_arguments.sh PROGRAM
+
+PROGRAM="$1"
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+printf '1 2 3\n4 5 6\n7 8 9\n' > "$DIR/expected.txt"
+
+FAILED=0
+
+for COMMAND in cumsum mavg mmin mmax quantile topk aquantile swap sum avg count len median distinct def use inc; do
+    cp "$DIR/expected.txt" "$DIR/input.txt"
+    "$PROGRAM" "[_,_];$COMMAND" "$DIR/input.txt" > "$DIR/log.txt" 2>&1
+    STATUS=$?
+
+    # Status above 128 means that program was killed by signal
+    if [ $STATUS -ge 128 ] || ! grep -q "Failed to execute all commands" "$DIR/log.txt" || ! cmp -s "$DIR/input.txt" "$DIR/expected.txt"; then
+        echo "$COMMAND without argument didn't fail with error (status $STATUS)"
+        FAILED=1
+    fi
+done
+
+exit $FAILED
@@ -0,0 +1,47 @@
+#!/bin/sh
+# Spill file must stay bounded when the same pages are spilled and loaded again and again
+# Usage: spill_bounded.sh PROGRAM
+
+PROGRAM="$1"
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+awk 'BEGIN { srand(1); for (i = 0; i < 60000; i++) printf "%d %d %d %d %d\n", rand() * 1000000, rand() * 1000000, rand() * 1000000, rand() * 1000000, rand() * 1000000 }' > "$DIR/input.txt"
+cp "$DIR/input.txt" "$DIR/expected.txt"
+
+SCRIPT="[_,_];sum [1,1]"
+i=1
+while [ $i -lt 40 ]; do
+    SCRIPT="$SCRIPT;[_,_];sum [1,1]"
+    i=$((i + 1))
+done
+
+"$PROGRAM" "$SCRIPT" "$DIR/expected.txt" || exit 1
+
+"$PROGRAM" -m 4 "$SCRIPT" "$DIR/input.txt" &
+PID=$!
+
+# Spill file is unlinked temporary file, so it is found among open files of process
+MAX=0
+while kill -0 $PID 2>/dev/null; do
+    for FD in /proc/$PID/fd/*; do
+        case "$(readlink "$FD" 2>/dev/null)" in
+            *deleted*)
+                SIZE=$(stat -Lc %s "$FD" 2>/dev/null)
+                if [ -n "$SIZE" ] && [ "$SIZE" -gt "$MAX" ]; then MAX=$SIZE; fi
+                ;;
+        esac
+    done
+    sleep 0.05
+done
+wait $PID || exit 1
+
+cmp -s "$DIR/input.txt" "$DIR/expected.txt" || { echo "Output with memory budget differs"; exit 1; }
+
+LIMIT=$(($(stat -c %s "$DIR/expected.txt") * 3))
+if [ "$MAX" -gt "$LIMIT" ]; then
+    echo "Spill file grew to $MAX bytes (limit $LIMIT)"
+    exit 1
+fi
+
+echo "Spill file peaked at $MAX bytes"
@@ -0,0 +1,62 @@
+#!/bin/sh
+# Output must be same for any number of threads of work-stealing pool and pool must shut down cleanly
+# Usage: threads_determinism.sh PROGRAM
+
+PROGRAM="$1"
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+# Table has many chunks of loading and of loops over rows, so idle workers have to steal
+awk 'BEGIN {
+    srand(2);
+    for (i = 0; i < 200000; i++)
+        printf "%d %.6f %d %s %.3f 0\n", rand() * 1000000 - 500000, rand() * 1000 - 500, rand() * 100, (rand() < 0.1) ? "text" : sprintf("%d", rand() * 50), rand() * 1e9
+}' > "$DIR/input.txt"
+
+FAILED=0
+
+run()
+{
+    # run NAME THREADS SCRIPT
+    cp "$DIR/input.txt" "$DIR/$1.$2.txt"
+    # Program reports failed commands only by message
+    if ! timeout 120 "$PROGRAM" --threads "$2" "$3" "$DIR/$1.$2.txt" > "$DIR/$1.$2.log" 2>&1 || grep -q "Failed" "$DIR/$1.$2.log"; then
+        echo "$1 with $2 threads failed or didn't finish:"
+        cat "$DIR/$1.$2.log"
+        FAILED=1
+    fi
+}
+
+check()
+{
+    # check NAME SCRIPT
+    run "$1" 1 "$2"
+    for THREADS in 2 4 8; do
+        run "$1" $THREADS "$2"
+        if ! cmp -s "$DIR/$1.1.txt" "$DIR/$1.$THREADS.txt"; then
+            echo "$1 with $THREADS threads differs from single-threaded result"
+            FAILED=1
+        fi
+    done
+}
+
+check aggregates "[_,1];sum [1,6];[_,2];avg [2,6];[_,3];count [3,6];[_,4];count [4,6];[_,5];avg [5,6];[_,2];sum [6,6]"
+check selectors "[_,2];[max];set MAX;[_,5];[min];set MIN;[_,_];[max];def _0;[1,1];use _0"
+check formatting "[_,2];avg [1,1];[_,_];count [2,2]"
+
+# Pool is started and stopped by every run, short runs check that shutdown doesn't race with idle workers
+head -n 20000 "$DIR/input.txt" > "$DIR/small.txt"
+i=0
+while [ $i -lt 20 ]; do
+    cp "$DIR/small.txt" "$DIR/repeat.txt"
+    if ! timeout 30 "$PROGRAM" --threads 8 "[_,1];sum [1,1];[_,_];[max];set X" "$DIR/repeat.txt" > "$DIR/repeat.log" 2>&1 ||
+        grep -q "Failed" "$DIR/repeat.log"; then
+        echo "Run $i with 8 threads failed or didn't finish:"
+        cat "$DIR/repeat.log"
+        FAILED=1
+        break
+    fi
+    i=$((i + 1))
+done
+
+exit $FAILED